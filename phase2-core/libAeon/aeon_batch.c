@@ -0,0 +1,150 @@
+/**
+ * @file aeon_batch.c
+ * @brief Proyecto Eón - Inferencia por lotes sobre pesos compartidos
+ *
+ * Miles de streams con la misma semilla comparten una copia de los
+ * pesos; sus estados viven en un bloque SoA alineado a línea de caché.
+ */
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <string.h>
+
+/** Streams por línea de caché (el stride se redondea a este múltiplo) */
+#define BATCH_LANES (AEON_CACHE_LINE / sizeof(aeon_state_t))
+
+/* ============================================================
+ * CICLO DE VIDA
+ * ============================================================ */
+
+aeon_batch_t *aeon_batch_create(uint16_t reservoir_size, uint16_t n_streams,
+                                const aeon_allocator_t *allocator) {
+  if (reservoir_size == 0 || n_streams == 0)
+    return NULL;
+  if (allocator == NULL)
+    allocator = aeon_k_default_allocator();
+  if (allocator->alloc == NULL)
+    return NULL;
+
+  uint32_t stride =
+      (uint32_t)((n_streams + BATCH_LANES - 1) / BATCH_LANES * BATCH_LANES);
+  size_t header = aeon_k_align(sizeof(aeon_batch_t));
+  size_t block = aeon_k_align((size_t)reservoir_size * stride *
+                              sizeof(aeon_state_t));
+  size_t total = header + 2 * block;
+
+  uint8_t *arena = allocator->alloc(total, AEON_CACHE_LINE, allocator->ctx);
+  if (arena == NULL)
+    return NULL;
+  memset(arena, 0, total);
+
+  aeon_batch_t *batch = (aeon_batch_t *)(void *)arena;
+  batch->reservoir_size = reservoir_size;
+  batch->n_streams = n_streams;
+  batch->stride = stride;
+  batch->state = (aeon_state_t *)(void *)(arena + header);
+  batch->scratch = (aeon_state_t *)(void *)(arena + header + block);
+  batch->allocator = *allocator;
+
+  return batch;
+}
+
+void aeon_batch_destroy(aeon_batch_t *batch) {
+  if (batch == NULL)
+    return;
+  aeon_allocator_t allocator = batch->allocator;
+  if (allocator.free != NULL)
+    allocator.free(batch, allocator.ctx);
+}
+
+void aeon_batch_reset(aeon_batch_t *batch) {
+  if (batch == NULL)
+    return;
+  memset(batch->state, 0,
+         (size_t)batch->reservoir_size * batch->stride * sizeof(aeon_state_t));
+}
+
+void aeon_batch_reset_stream(aeon_batch_t *batch, uint16_t stream) {
+  if (batch == NULL || stream >= batch->n_streams)
+    return;
+  for (uint32_t i = 0; i < batch->reservoir_size; i++) {
+    batch->state[i * batch->stride + stream] = 0;
+  }
+}
+
+/* ============================================================
+ * PROCESAMIENTO
+ * ============================================================ */
+
+int aeon_update_batch(const aeon_core_t *core, aeon_batch_t *batch,
+                      const aeon_state_t *inputs) {
+  if (core == NULL || batch == NULL || inputs == NULL)
+    return -1;
+  if (batch->reservoir_size != AEON_RESERVOIR_SIZE)
+    return -2;
+
+  AEON_STATS_BEGIN(t0);
+  aeon_k_step_batch(AEON_RESERVOIR_SIZE, AEON_INPUT_SIZE, core->W_in,
+                    core->row_ptr, core->col_indices, core->W_reservoir,
+                    batch->state, inputs, batch->scratch, batch->n_streams,
+                    batch->stride, aeon_k_leak(core->leak_rate));
+  AEON_STATS_END(AEON_EVENT_UPDATE, t0);
+  return 0;
+}
+
+int aeon_predict_batch(const aeon_core_t *core, const aeon_batch_t *batch,
+                       aeon_state_t *outputs) {
+  if (core == NULL || batch == NULL || outputs == NULL)
+    return -1;
+  if (batch->reservoir_size != AEON_RESERVOIR_SIZE)
+    return -2;
+
+  AEON_STATS_BEGIN(t0);
+  aeon_k_readout_batch(AEON_RESERVOIR_SIZE, AEON_OUTPUT_SIZE, core->W_out,
+                       batch->state, outputs, batch->n_streams, batch->stride);
+  AEON_STATS_SCAN(outputs, NULL, AEON_OUTPUT_SIZE * batch->n_streams);
+  AEON_STATS_END(AEON_EVENT_PREDICT, t0);
+  return 0;
+}
+
+int aeon_core_update_batch(const aeon_dyn_core_t *core, aeon_batch_t *batch,
+                           const aeon_state_t *inputs) {
+  if (core == NULL || batch == NULL || inputs == NULL)
+    return -1;
+  if (batch->reservoir_size != core->config.reservoir_size)
+    return -2;
+
+  AEON_STATS_BEGIN(t0);
+  aeon_state_t leak = aeon_k_leak(core->config.leak_rate);
+  if (core->procedural) {
+    aeon_k_step_batch_procedural(
+        core->config.reservoir_size, core->config.input_size,
+        core->config.sparsity_factor, core->certificate.reservoir_seed,
+        batch->state, inputs, batch->scratch, batch->n_streams, batch->stride,
+        core->reservoir_gain, leak);
+  } else {
+    aeon_k_step_batch(core->config.reservoir_size, core->config.input_size,
+                      core->W_in, core->row_ptr, core->col_indices,
+                      core->W_reservoir, batch->state, inputs, batch->scratch,
+                      batch->n_streams, batch->stride, leak);
+  }
+  AEON_STATS_END(AEON_EVENT_UPDATE, t0);
+  return 0;
+}
+
+int aeon_core_predict_batch(const aeon_dyn_core_t *core,
+                            const aeon_batch_t *batch, aeon_state_t *outputs) {
+  if (core == NULL || batch == NULL || outputs == NULL)
+    return -1;
+  if (batch->reservoir_size != core->config.reservoir_size)
+    return -2;
+
+  AEON_STATS_BEGIN(t0);
+  aeon_k_readout_batch(core->config.reservoir_size, core->config.output_size,
+                       core->W_out, batch->state, outputs, batch->n_streams,
+                       batch->stride);
+  AEON_STATS_SCAN(outputs, NULL,
+                  (uint32_t)core->config.output_size * batch->n_streams);
+  AEON_STATS_END(AEON_EVENT_PREDICT, t0);
+  return 0;
+}
@@ -0,0 +1,374 @@
+/**
+ * @file aeon_bench.c
+ * @brief Proyecto Eón - Banco de pruebas del camino caliente
+ *
+ * Barre tamaño de reservoir, escasez y número de streams sobre núcleos
+ * dimensionados en tiempo de ejecución y cronometra cada paso
+ * (update + predict) por separado, así que informa percentiles y no
+ * solo la media. La aritmética (punto fijo o float) es de compilación:
+ * CMake genera aeon_bench con la configuración de la librería y, si es
+ * punto fijo, aeon_bench_float para comparar.
+ *
+ * Reloj: rdtsc en x86, DWT CYCCNT en Cortex-M (AEON_BENCH_CPU_HZ da la
+ * frecuencia) y clock_gettime en el resto.
+ *
+ * Los bytes por paso son la huella que recorre un paso: W_in, el CSR,
+ * W_out y, por stream, estado, scratch, entrada y salida.
+ *
+ * Uso:
+ *   aeon_bench [-n 16,32,64] [-p 2,4,8] [-b 1,8] [-s pasos] [-w calent.]
+ *              [-o resultados.json]
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "libAeon.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_TIMER "rdtsc"
+#elif defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) ||             \
+    defined(__ARM_ARCH_8M_MAIN__)
+#define BENCH_DWT 1
+#define BENCH_TIMER "dwt"
+#else
+#define BENCH_TIMER "clock_gettime"
+#endif
+
+#ifndef AEON_BENCH_CPU_HZ
+#define AEON_BENCH_CPU_HZ 64000000u /**< Reloj del núcleo con DWT */
+#endif
+
+/** Máximo de valores por lista de barrido (-n, -p, -b) */
+#define MAX_SWEEP 16
+
+/* ============================================================
+ * RELOJ
+ * ============================================================ */
+
+#ifdef BENCH_DWT
+#define DWT_CTRL (*(volatile uint32_t *)0xE0001000u)
+#define DWT_CYCCNT (*(volatile uint32_t *)0xE0001004u)
+#define DEM_CR (*(volatile uint32_t *)0xE000EDFCu)
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+#endif
+
+static inline uint64_t bench_ticks(void) {
+#if defined(BENCH_DWT)
+  return DWT_CYCCNT; /* 32 bits: un paso cabe de sobra */
+#elif defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/** Ticks por segundo (contra clock_gettime en el caso de rdtsc) */
+static double bench_timer_init(void) {
+#if defined(BENCH_DWT)
+  DEM_CR |= 1u << 24; /* TRCENA */
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= 1u;     /* CYCCNTENA */
+  return (double)AEON_BENCH_CPU_HZ;
+#elif defined(__x86_64__) || defined(__i386__)
+  double t0 = now_ms();
+  uint64_t c0 = __rdtsc();
+  while (now_ms() - t0 < 50.0) {
+  }
+  return (double)(__rdtsc() - c0) / ((now_ms() - t0) / 1e3);
+#else
+  return 1e9;
+#endif
+}
+
+/** Coste mínimo de dos lecturas seguidas, que se descuenta de cada paso */
+static uint64_t bench_timer_overhead(void) {
+  uint64_t best = UINT64_MAX;
+  for (int i = 0; i < 1000; i++) {
+    uint64_t t0 = bench_ticks();
+    uint64_t t1 = bench_ticks();
+    if (t1 - t0 < best)
+      best = t1 - t0;
+  }
+  return best;
+}
+
+/* ============================================================
+ * MEDIDA
+ * ============================================================ */
+
+typedef struct {
+  uint16_t neurons;
+  uint16_t sparsity;
+  uint16_t streams;
+  uint32_t connections;
+  uint64_t bytes_per_step;
+  double p50_ticks;
+  double p99_ticks;
+  double mean_ticks;
+} bench_result_t;
+
+static aeon_state_t to_state(float v) {
+#if AEON_USE_FIXED_POINT
+  return (aeon_state_t)(v * AEON_SCALE);
+#else
+  return v;
+#endif
+}
+
+static int cmp_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+/** Huella de un paso (ver cabecera) */
+static uint64_t step_bytes(const aeon_dyn_core_t *core, uint16_t streams) {
+  const aeon_config_t *c = &core->config;
+  uint64_t weights =
+      (uint64_t)c->reservoir_size * c->input_size * sizeof(aeon_weight_t) +
+      (uint64_t)core->sparse_count *
+          (sizeof(aeon_weight_t) + sizeof(uint16_t)) +
+      (uint64_t)(c->reservoir_size + 1) * sizeof(uint32_t) +
+      (uint64_t)c->output_size * c->reservoir_size * sizeof(aeon_weight_t);
+  uint64_t per_stream =
+      (uint64_t)(3 * c->reservoir_size + c->input_size + c->output_size) *
+      sizeof(aeon_state_t);
+  return weights + per_stream * streams;
+}
+
+/**
+ * @brief Cronometra `steps` pasos de una configuración
+ *
+ * Con un stream usa aeon_core_update/predict; con más, el camino por
+ * lotes. ticks debe tener `steps` elementos.
+ *
+ * @return 0 si éxito, -1 si no hay memoria
+ */
+static int bench_run(uint16_t neurons, uint16_t sparsity, uint16_t streams,
+                     uint32_t steps, uint32_t warmup, uint64_t overhead,
+                     uint64_t *ticks, bench_result_t *r) {
+  aeon_config_t cfg = {neurons, 1, 1, sparsity, AEON_SPECTRAL_RADIUS,
+                       AEON_LEAK_RATE};
+  aeon_dyn_core_t *core = aeon_core_create(&cfg, NULL);
+  aeon_batch_t *batch =
+      streams > 1 ? aeon_batch_create(neurons, streams, NULL) : NULL;
+  aeon_state_t *in = malloc(streams * sizeof(aeon_state_t));
+  aeon_state_t *out = malloc(streams * sizeof(aeon_state_t));
+  if (core == NULL || (streams > 1 && batch == NULL) || !in || !out ||
+      aeon_core_birth(core, 42) != 0) {
+    aeon_core_destroy(core);
+    aeon_batch_destroy(batch);
+    free(in);
+    free(out);
+    return -1;
+  }
+
+  for (uint32_t t = 0; t < warmup + steps; t++) {
+    for (uint16_t s = 0; s < streams; s++) {
+      in[s] = to_state(sinf((float)(t + s) * 0.1f));
+    }
+    uint64_t t0 = bench_ticks();
+    if (batch == NULL) {
+      aeon_core_update(core, in);
+      aeon_core_predict(core, out);
+    } else {
+      aeon_core_update_batch(core, batch, in);
+      aeon_core_predict_batch(core, batch, out);
+    }
+    uint64_t dt = bench_ticks() - t0;
+    if (t >= warmup)
+      ticks[t - warmup] = dt > overhead ? dt - overhead : 0;
+  }
+
+  double sum = 0.0;
+  for (uint32_t t = 0; t < steps; t++) {
+    sum += (double)ticks[t];
+  }
+  qsort(ticks, steps, sizeof(uint64_t), cmp_u64);
+
+  r->neurons = neurons;
+  r->sparsity = sparsity;
+  r->streams = streams;
+  r->connections = core->sparse_count;
+  r->bytes_per_step = step_bytes(core, streams);
+  r->p50_ticks = (double)ticks[(steps - 1) / 2];
+  r->p99_ticks = (double)ticks[(uint32_t)((steps - 1) * 0.99)];
+  r->mean_ticks = sum / steps;
+
+  aeon_core_destroy(core);
+  aeon_batch_destroy(batch);
+  free(in);
+  free(out);
+  return 0;
+}
+
+/* ============================================================
+ * INFORME
+ * ============================================================ */
+
+static void write_json(FILE *f, const bench_result_t *r, int n, double hz,
+                       uint32_t steps) {
+  fprintf(f,
+          "{\n  \"arith\": \"%s\",\n  \"kernels\": \"%s\",\n"
+          "  \"tanh\": \"%s\",\n  \"timer\": \"%s\",\n"
+          "  \"ticks_per_second\": %.0f,\n  \"steps\": %u,\n"
+          "  \"results\": [\n",
+          AEON_USE_FIXED_POINT ? "fixed" : "float", aeon_simd_backend(),
+          aeon_tanh_backend(), BENCH_TIMER, hz, steps);
+  for (int i = 0; i < n; i++) {
+    double ns = 1e9 / hz;
+    fprintf(f,
+            "    {\"neurons\": %u, \"sparsity\": %u, \"streams\": %u, "
+            "\"connections\": %u, \"p50_ns\": %.1f, \"p99_ns\": %.1f, "
+            "\"mean_ns\": %.1f, \"p50_ticks\": %.0f, \"p99_ticks\": %.0f, "
+            "\"samples_per_s\": %.0f, \"bytes_per_step\": %llu}%s\n",
+            r[i].neurons, r[i].sparsity, r[i].streams, r[i].connections,
+            r[i].p50_ticks * ns, r[i].p99_ticks * ns, r[i].mean_ticks * ns,
+            r[i].p50_ticks, r[i].p99_ticks,
+            r[i].streams * hz / (r[i].mean_ticks > 0 ? r[i].mean_ticks : 1),
+            (unsigned long long)r[i].bytes_per_step, i + 1 < n ? "," : "");
+  }
+  fprintf(f, "  ]\n}\n");
+}
+
+/* ============================================================
+ * LÍNEA DE COMANDOS
+ * ============================================================ */
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -n LIST     reservoir sizes (default 16,32,64,128,256)\n"
+          "  -p LIST     sparsity factors (default %d)\n"
+          "  -b LIST     streams per step, >1 uses the batch path "
+          "(default 1,8)\n"
+          "  -s N        timed steps per configuration (default 5000)\n"
+          "  -w N        warm-up steps (default 200)\n"
+          "  -o FILE     write JSON results ('-' = stdout)\n",
+          prog, AEON_SPARSITY_FACTOR);
+}
+
+static int parse_u16_list(const char *s, uint16_t *out) {
+  int n = 0;
+  char *end;
+  while (*s && n < MAX_SWEEP) {
+    long v = strtol(s, &end, 10);
+    if (end == s || v <= 0 || v > 65535)
+      return -1;
+    out[n++] = (uint16_t)v;
+    s = (*end == ',') ? end + 1 : end;
+  }
+  return n;
+}
+
+int main(int argc, char *argv[]) {
+  uint16_t sizes[MAX_SWEEP] = {16, 32, 64, 128, 256};
+  uint16_t sparsity[MAX_SWEEP] = {AEON_SPARSITY_FACTOR};
+  uint16_t streams[MAX_SWEEP] = {1, 8};
+  int n_sizes = 5, n_sparsity = 1, n_streams = 2;
+  uint32_t steps = 5000, warmup = 200;
+  const char *json_path = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:p:b:s:w:o:h")) != -1) {
+    switch (opt) {
+    case 'n':
+      n_sizes = parse_u16_list(optarg, sizes);
+      break;
+    case 'p':
+      n_sparsity = parse_u16_list(optarg, sparsity);
+      break;
+    case 'b':
+      n_streams = parse_u16_list(optarg, streams);
+      break;
+    case 's':
+      steps = (uint32_t)atoi(optarg);
+      break;
+    case 'w':
+      warmup = (uint32_t)atoi(optarg);
+      break;
+    case 'o':
+      json_path = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (n_sizes <= 0 || n_sparsity <= 0 || n_streams <= 0 || steps == 0) {
+    fprintf(stderr, "Invalid sizes, sparsity, streams or step count\n");
+    return 1;
+  }
+
+  int n_runs = n_sizes * n_sparsity * n_streams;
+  bench_result_t *results = calloc((size_t)n_runs, sizeof(bench_result_t));
+  uint64_t *ticks = malloc(steps * sizeof(uint64_t));
+  if (results == NULL || ticks == NULL) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  double hz = bench_timer_init();
+  uint64_t overhead = bench_timer_overhead();
+  double ns = 1e9 / hz;
+  int to_stdout = json_path != NULL && strcmp(json_path, "-") == 0;
+  FILE *log = to_stdout ? stderr : stdout;
+
+  fprintf(log, "aeon_bench: %s, %s kernels, tanh %s, %s at %.0f MHz\n",
+          AEON_USE_FIXED_POINT ? "fixed point" : "float", aeon_simd_backend(),
+          aeon_tanh_backend(), BENCH_TIMER, hz / 1e6);
+  fprintf(log, "%7s %5s %7s %8s %10s %10s %12s %10s\n", "neurons", "1/p",
+          "streams", "conns", "p50 ns", "p99 ns", "samples/s", "bytes");
+
+  int n = 0;
+  for (int a = 0; a < n_sizes; a++) {
+    for (int b = 0; b < n_sparsity; b++) {
+      for (int c = 0; c < n_streams; c++) {
+        bench_result_t *r = &results[n];
+        if (bench_run(sizes[a], sparsity[b], streams[c], steps, warmup,
+                      overhead, ticks, r) != 0) {
+          fprintf(stderr, "Skipping %u neurons, 1/%u, %u streams\n",
+                  sizes[a], sparsity[b], streams[c]);
+          continue;
+        }
+        fprintf(log, "%7u %5u %7u %8u %10.1f %10.1f %12.0f %10llu\n",
+                r->neurons, r->sparsity, r->streams, r->connections,
+                r->p50_ticks * ns, r->p99_ticks * ns,
+                r->streams * hz / (r->mean_ticks > 0 ? r->mean_ticks : 1),
+                (unsigned long long)r->bytes_per_step);
+        n++;
+      }
+    }
+  }
+
+  if (json_path != NULL) {
+    FILE *f = to_stdout ? stdout : fopen(json_path, "w");
+    if (f == NULL) {
+      fprintf(stderr, "Cannot write %s\n", json_path);
+      return 1;
+    }
+    write_json(f, results, n, hz, steps);
+    if (!to_stdout)
+      fclose(f);
+  }
+
+  free(results);
+  free(ticks);
+  return n == n_runs ? 0 : 1;
+}
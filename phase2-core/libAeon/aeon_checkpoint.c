@@ -0,0 +1,652 @@
+/**
+ * @file aeon_checkpoint.c
+ * @brief Proyecto Eón - Log incremental de checkpoints
+ *
+ * Dos instantáneas por manejador: back es la última que ha pedido el
+ * bucle de alimentación y front la que está escribiendo el hilo. Al
+ * guardar, solo se copian a back las secciones que difieren de ella,
+ * así que back sirve a la vez de referencia del diff; el hilo pasa a
+ * front las secciones pendientes con el cerrojo tomado (unos cientos
+ * de bytes) y escribe sin él. Si el hilo aún escribe cuando llega otra
+ * instantánea, las dos se funden en un solo registro.
+ *
+ * Cada registro se vuelca con fflush + fsync antes de tomar el
+ * siguiente: tras un corte, a lo sumo el último queda a medias y el
+ * CRC lo descarta. Sin AEON_USE_THREADS se escribe al guardar.
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <unistd.h>
+#define AEON_HAVE_FSYNC 1
+#else
+#define AEON_HAVE_FSYNC 0
+#endif
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <stdio.h>
+#include <string.h>
+
+#if AEON_USE_THREADS
+#include <pthread.h>
+#endif
+
+#define LOG_MAGIC "EONC"
+#define RECORD_MAGIC "CKPT"
+#define LOG_HEADER_SIZE 56
+#define RECORD_HEADER_SIZE 16
+#define COUNTERS_SIZE 16
+
+#define FLAG_TRAINED 0x01
+#define FLAG_READOUT_SPARSE 0x02
+
+#if AEON_USE_FIXED_POINT
+#define LOG_WEIGHT_FORMAT AEON_FILE_WEIGHTS_Q8_8
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F16
+#define LOG_WEIGHT_FORMAT AEON_FILE_WEIGHTS_F16
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_BF16
+#define LOG_WEIGHT_FORMAT AEON_FILE_WEIGHTS_BF16
+#else
+#define LOG_WEIGHT_FORMAT AEON_FILE_WEIGHTS_F32
+#endif
+
+/** Lo que cambia entre checkpoints */
+typedef struct {
+  uint32_t samples_processed;
+  uint32_t learning_sessions;
+  bool is_trained;
+  bool readout_sparse;
+  float leak_rate;
+  aeon_state_t state[AEON_RESERVOIR_SIZE];
+  aeon_weight_t W_out[AEON_OUTPUT_SIZE * AEON_RESERVOIR_SIZE];
+} snapshot_t;
+
+#if AEON_USE_THREADS
+typedef struct {
+  pthread_mutex_t lock;
+  pthread_cond_t work; /**< Hay secciones pendientes o hay que parar */
+  pthread_cond_t idle; /**< Todo lo pendiente está escrito */
+  pthread_t thread;
+  bool busy;
+  bool stop;
+} writer_t;
+#endif
+
+/* ============================================================
+ * CODIFICACIÓN
+ * ============================================================ */
+
+static bool host_is_le(void) {
+  const uint16_t probe = 1;
+  return *(const uint8_t *)&probe == 1;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p) {
+  return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+/** float como su patrón IEEE 754 en u32 */
+static void put_float(uint8_t *p, float v) {
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  put32(p, bits);
+}
+
+static float get_float(const uint8_t *p) {
+  uint32_t bits = get32(p);
+  float v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+/** Invierte el orden de bytes de count elementos de elem bytes */
+static void swap_elements(void *data, size_t elem, size_t count) {
+  uint8_t *p = data;
+  for (size_t i = 0; i < count; i++, p += elem) {
+    for (size_t a = 0, b = elem - 1; a < b; a++, b--) {
+      uint8_t t = p[a];
+      p[a] = p[b];
+      p[b] = t;
+    }
+  }
+}
+
+/** Cabecera del log para el núcleo: identidad, forma y radio */
+static void encode_header(uint8_t *h, const aeon_core_t *core) {
+  const aeon_certificate_t *cert = &core->certificate;
+  memset(h, 0, LOG_HEADER_SIZE);
+  memcpy(h, LOG_MAGIC, 4);
+  put16(h + 4, AEON_CHECKPOINT_VERSION);
+  put16(h + 6, LOG_HEADER_SIZE);
+  put16(h + 8, AEON_RESERVOIR_SIZE);
+  put16(h + 10, AEON_INPUT_SIZE);
+  put16(h + 12, AEON_OUTPUT_SIZE);
+  put16(h + 14, AEON_SPARSITY_FACTOR);
+  h[16] = LOG_WEIGHT_FORMAT;
+  put16(h + 18, cert->version);
+  put32(h + 20, cert->reservoir_seed);
+  uint64_t birth = (uint64_t)(int64_t)cert->birth_time;
+  put32(h + 24, (uint32_t)birth);
+  put32(h + 28, (uint32_t)(birth >> 32));
+  memcpy(h + 32, cert->birth_hash.bytes, sizeof(cert->birth_hash.bytes));
+  put_float(h + 48, core->spectral_radius);
+  put32(h + 52, aeon_k_crc32(0, h, 52));
+}
+
+/** Bytes de carga de un registro con estas secciones */
+static uint32_t payload_size(uint32_t sections) {
+  uint32_t n = 0;
+  if (sections & AEON_CHECKPOINT_COUNTERS)
+    n += COUNTERS_SIZE;
+  if (sections & AEON_CHECKPOINT_STATE)
+    n += sizeof(((snapshot_t *)0)->state);
+  if (sections & AEON_CHECKPOINT_W_OUT)
+    n += sizeof(((snapshot_t *)0)->W_out);
+  return n;
+}
+
+/** Copia de src a dst las secciones indicadas */
+static void copy_sections(snapshot_t *dst, const snapshot_t *src,
+                          uint32_t sections) {
+  if (sections & AEON_CHECKPOINT_COUNTERS) {
+    dst->samples_processed = src->samples_processed;
+    dst->learning_sessions = src->learning_sessions;
+    dst->is_trained = src->is_trained;
+    dst->readout_sparse = src->readout_sparse;
+    dst->leak_rate = src->leak_rate;
+  }
+  if (sections & AEON_CHECKPOINT_STATE)
+    memcpy(dst->state, src->state, sizeof(dst->state));
+  if (sections & AEON_CHECKPOINT_W_OUT)
+    memcpy(dst->W_out, src->W_out, sizeof(dst->W_out));
+}
+
+/* ============================================================
+ * ESCRITURA
+ * ============================================================ */
+
+static int write_chunk(FILE *f, const void *data, size_t n, uint32_t *crc) {
+  *crc = aeon_k_crc32(*crc, data, n);
+  return fwrite(data, 1, n, f) == n ? 0 : -3;
+}
+
+/** Añade un registro y lo vuelca al disco; s pasa a little-endian */
+static int write_record(FILE *f, uint32_t sequence, uint32_t sections,
+                        snapshot_t *s) {
+  uint8_t head[RECORD_HEADER_SIZE];
+  memcpy(head, RECORD_MAGIC, 4);
+  put32(head + 4, sequence);
+  put32(head + 8, sections);
+  put32(head + 12, payload_size(sections));
+
+  uint32_t crc = 0;
+  int err = write_chunk(f, head, sizeof(head), &crc);
+  if (err == 0 && (sections & AEON_CHECKPOINT_COUNTERS)) {
+    uint8_t c[COUNTERS_SIZE] = {0};
+    put32(c, s->samples_processed);
+    put32(c + 4, s->learning_sessions);
+    c[8] = (uint8_t)((s->is_trained ? FLAG_TRAINED : 0) |
+                     (s->readout_sparse ? FLAG_READOUT_SPARSE : 0));
+    put_float(c + 12, s->leak_rate);
+    err = write_chunk(f, c, sizeof(c), &crc);
+  }
+  if (!host_is_le()) {
+    swap_elements(s->state, sizeof(aeon_state_t), AEON_RESERVOIR_SIZE);
+    swap_elements(s->W_out, sizeof(aeon_weight_t),
+                  AEON_OUTPUT_SIZE * AEON_RESERVOIR_SIZE);
+  }
+  if (err == 0 && (sections & AEON_CHECKPOINT_STATE))
+    err = write_chunk(f, s->state, sizeof(s->state), &crc);
+  if (err == 0 && (sections & AEON_CHECKPOINT_W_OUT))
+    err = write_chunk(f, s->W_out, sizeof(s->W_out), &crc);
+
+  uint8_t tail[4];
+  put32(tail, crc);
+  if (err == 0 && fwrite(tail, 1, sizeof(tail), f) != sizeof(tail))
+    err = -3;
+  if (err == 0 && fflush(f) != 0)
+    err = -3;
+#if AEON_HAVE_FSYNC
+  if (err == 0 && fsync(fileno(f)) != 0)
+    err = -3;
+#endif
+  return err;
+}
+
+/** Escribe lo pendiente de back; con hilo, se llama con el cerrojo */
+static void write_pending(aeon_checkpoint_t *ckpt) {
+  uint32_t sections = ckpt->pending;
+  uint32_t sequence = ckpt->sequence + 1;
+  ckpt->pending = 0;
+  copy_sections(ckpt->front, ckpt->back, sections);
+
+#if AEON_USE_THREADS
+  writer_t *w = ckpt->writer;
+  if (w != NULL)
+    pthread_mutex_unlock(&w->lock);
+#endif
+  int err = write_record(ckpt->file, sequence, sections, ckpt->front);
+#if AEON_USE_THREADS
+  if (w != NULL)
+    pthread_mutex_lock(&w->lock);
+#endif
+
+  if (err != 0) {
+    ckpt->error = err; /* Un registro a medias: no se añade nada más */
+    return;
+  }
+  ckpt->sequence = sequence;
+  ckpt->records++;
+  ckpt->bytes += RECORD_HEADER_SIZE + payload_size(sections) + 4;
+}
+
+#if AEON_USE_THREADS
+static void *writer_main(void *p) {
+  aeon_checkpoint_t *ckpt = p;
+  writer_t *w = ckpt->writer;
+
+  pthread_mutex_lock(&w->lock);
+  for (;;) {
+    while (!w->stop && ckpt->pending == 0)
+      pthread_cond_wait(&w->work, &w->lock);
+    if (ckpt->pending == 0)
+      break; /* stop sin nada pendiente */
+    if (ckpt->error != 0) {
+      ckpt->pending = 0;
+    } else {
+      w->busy = true;
+      write_pending(ckpt);
+      w->busy = false;
+    }
+    if (ckpt->pending == 0)
+      pthread_cond_broadcast(&w->idle);
+  }
+  pthread_mutex_unlock(&w->lock);
+  return NULL;
+}
+#endif
+
+/* ============================================================
+ * LECTURA
+ * ============================================================ */
+
+static int read_chunk(FILE *f, void *data, size_t n, uint32_t *crc) {
+  if (fread(data, 1, n, f) != n)
+    return -1;
+  *crc = aeon_k_crc32(*crc, data, n);
+  return 0;
+}
+
+/**
+ * @brief Recorre los registros válidos desde la posición actual
+ *
+ * Cada registro se lee entero en tmp y solo si su CRC cuadra se pasa a
+ * snap. Se detiene en el primer registro incompleto, corrupto o fuera
+ * de secuencia; end queda al final del último válido.
+ *
+ * @return Registros válidos
+ */
+static uint32_t scan_records(FILE *f, snapshot_t *snap, snapshot_t *tmp,
+                             uint32_t *sections_seen, uint32_t *sequence,
+                             long *end) {
+  uint32_t count = 0;
+  *sections_seen = 0;
+  *sequence = 0;
+  *end = ftell(f);
+
+  for (;;) {
+    uint8_t head[RECORD_HEADER_SIZE];
+    uint32_t crc = 0;
+    if (read_chunk(f, head, sizeof(head), &crc) != 0)
+      break;
+    uint32_t seq = get32(head + 4);
+    uint32_t sections = get32(head + 8);
+    if (memcmp(head, RECORD_MAGIC, 4) != 0 || seq != *sequence + 1 ||
+        sections == 0 || (sections & ~AEON_CHECKPOINT_ALL) != 0 ||
+        get32(head + 12) != payload_size(sections))
+      break;
+
+    uint8_t c[COUNTERS_SIZE];
+    if ((sections & AEON_CHECKPOINT_COUNTERS) &&
+        read_chunk(f, c, sizeof(c), &crc) != 0)
+      break;
+    if ((sections & AEON_CHECKPOINT_STATE) &&
+        read_chunk(f, tmp->state, sizeof(tmp->state), &crc) != 0)
+      break;
+    if ((sections & AEON_CHECKPOINT_W_OUT) &&
+        read_chunk(f, tmp->W_out, sizeof(tmp->W_out), &crc) != 0)
+      break;
+    uint8_t tail[4];
+    if (fread(tail, 1, sizeof(tail), f) != sizeof(tail) ||
+        get32(tail) != crc)
+      break;
+
+    if (sections & AEON_CHECKPOINT_COUNTERS) {
+      tmp->samples_processed = get32(c);
+      tmp->learning_sessions = get32(c + 4);
+      tmp->is_trained = (c[8] & FLAG_TRAINED) != 0;
+      tmp->readout_sparse = (c[8] & FLAG_READOUT_SPARSE) != 0;
+      tmp->leak_rate = get_float(c + 12);
+    }
+    if (!host_is_le()) {
+      swap_elements(tmp->state, sizeof(aeon_state_t), AEON_RESERVOIR_SIZE);
+      swap_elements(tmp->W_out, sizeof(aeon_weight_t),
+                    AEON_OUTPUT_SIZE * AEON_RESERVOIR_SIZE);
+    }
+    copy_sections(snap, tmp, sections);
+    *sections_seen |= sections;
+    *sequence = seq;
+    *end = ftell(f);
+    count++;
+  }
+  return count;
+}
+
+/** Lee y valida la cabecera (magia, versión y CRC) */
+static int read_header(FILE *f, uint8_t *h) {
+  if (fread(h, 1, LOG_HEADER_SIZE, f) != LOG_HEADER_SIZE)
+    return -4;
+  if (memcmp(h, LOG_MAGIC, 4) != 0 ||
+      get16(h + 4) != AEON_CHECKPOINT_VERSION ||
+      get16(h + 6) != LOG_HEADER_SIZE ||
+      get32(h + 52) != aeon_k_crc32(0, h, 52) || !(get_float(h + 48) >= 0.0f))
+    return -4;
+  return 0;
+}
+
+/* ============================================================
+ * API
+ * ============================================================ */
+
+aeon_checkpoint_t *aeon_checkpoint_open(const char *filename,
+                                        const aeon_core_t *core,
+                                        const aeon_allocator_t *allocator,
+                                        int *error) {
+  int dummy;
+  if (error == NULL)
+    error = &dummy;
+  *error = -1;
+  if (filename == NULL || core == NULL)
+    return NULL;
+  if (allocator == NULL)
+    allocator = aeon_k_default_allocator();
+  if (allocator->alloc == NULL)
+    return NULL;
+
+  size_t header = aeon_k_align(sizeof(aeon_checkpoint_t));
+  size_t snap = aeon_k_align(sizeof(snapshot_t));
+#if AEON_USE_THREADS
+  size_t writer = aeon_k_align(sizeof(writer_t));
+#else
+  size_t writer = 0;
+#endif
+  uint8_t *arena = allocator->alloc(header + 2 * snap + writer,
+                                    AEON_CACHE_LINE, allocator->ctx);
+  *error = -6;
+  if (arena == NULL)
+    return NULL;
+  memset(arena, 0, header + 2 * snap + writer);
+
+  aeon_checkpoint_t *ckpt = (aeon_checkpoint_t *)(void *)arena;
+  ckpt->front = arena + header;
+  ckpt->back = arena + header + snap;
+  ckpt->allocator = *allocator;
+
+  uint8_t expected[LOG_HEADER_SIZE];
+  encode_header(expected, core);
+
+  /* Log existente del mismo núcleo: se sigue tras el último registro
+   * válido. Si no existe o está vacío, se empieza. */
+  FILE *f = fopen(filename, "r+b");
+  bool fresh = f == NULL;
+  if (f == NULL)
+    f = fopen(filename, "w+b");
+  if (f == NULL) {
+    *error = -2;
+    aeon_checkpoint_close(ckpt);
+    return NULL;
+  }
+  ckpt->file = f;
+  if (!fresh && fseek(f, 0, SEEK_END) == 0 && ftell(f) == 0)
+    fresh = true;
+  rewind(f);
+
+  int err = 0;
+  if (fresh) {
+    if (fwrite(expected, 1, LOG_HEADER_SIZE, f) != LOG_HEADER_SIZE ||
+        fflush(f) != 0)
+      err = -3;
+    ckpt->bytes = LOG_HEADER_SIZE;
+  } else {
+    uint8_t h[LOG_HEADER_SIZE];
+    err = read_header(f, h);
+    if (err == 0 && memcmp(h, expected, LOG_HEADER_SIZE) != 0)
+      err = -5;
+    if (err == 0) {
+      uint32_t seen;
+      long end;
+      scan_records(f, ckpt->front, ckpt->back, &seen, &ckpt->sequence, &end);
+      /* Fuera la cola a medias que pudiera dejar un corte */
+#if AEON_HAVE_FSYNC
+      if (fflush(f) != 0 || ftruncate(fileno(f), (off_t)end) != 0)
+        err = -3;
+#endif
+      if (err == 0 && fseek(f, end, SEEK_SET) != 0)
+        err = -3;
+      ckpt->bytes = (uint64_t)end;
+    }
+  }
+  if (err != 0) {
+    *error = err;
+    aeon_checkpoint_close(ckpt);
+    return NULL;
+  }
+
+#if AEON_USE_THREADS
+  writer_t *w = (writer_t *)(void *)(arena + header + 2 * snap);
+  pthread_mutex_init(&w->lock, NULL);
+  pthread_cond_init(&w->work, NULL);
+  pthread_cond_init(&w->idle, NULL);
+  ckpt->writer = w;
+  if (pthread_create(&w->thread, NULL, writer_main, ckpt) != 0) {
+    ckpt->writer = NULL;
+    pthread_cond_destroy(&w->idle);
+    pthread_cond_destroy(&w->work);
+    pthread_mutex_destroy(&w->lock);
+    *error = -6;
+    aeon_checkpoint_close(ckpt);
+    return NULL;
+  }
+  ckpt->threaded = true;
+#endif
+
+  *error = 0;
+  return ckpt;
+}
+
+int aeon_checkpoint_save(aeon_checkpoint_t *ckpt, const aeon_core_t *core) {
+  if (ckpt == NULL || core == NULL)
+    return -1;
+#if AEON_USE_THREADS
+  writer_t *w = ckpt->writer;
+  if (w != NULL)
+    pthread_mutex_lock(&w->lock);
+#endif
+
+  int result = ckpt->error;
+  if (result == 0) {
+    /* Copia solo lo que difiere de la última instantánea */
+    snapshot_t *b = ckpt->back;
+    uint32_t changed = 0;
+    if (!ckpt->primed ||
+        b->samples_processed != core->samples_processed ||
+        b->learning_sessions != core->learning_sessions ||
+        b->is_trained != core->is_trained ||
+        b->readout_sparse != core->readout_sparse ||
+        b->leak_rate != core->leak_rate) {
+      b->samples_processed = core->samples_processed;
+      b->learning_sessions = core->learning_sessions;
+      b->is_trained = core->is_trained;
+      b->readout_sparse = core->readout_sparse;
+      b->leak_rate = core->leak_rate;
+      changed |= AEON_CHECKPOINT_COUNTERS;
+    }
+    if (!ckpt->primed ||
+        memcmp(b->state, core->state, sizeof(b->state)) != 0) {
+      memcpy(b->state, core->state, sizeof(b->state));
+      changed |= AEON_CHECKPOINT_STATE;
+    }
+    if (!ckpt->primed ||
+        memcmp(b->W_out, core->W_out, sizeof(b->W_out)) != 0) {
+      memcpy(b->W_out, core->W_out, sizeof(b->W_out));
+      changed |= AEON_CHECKPOINT_W_OUT;
+    }
+    ckpt->primed = true;
+
+    if (changed != 0 && ckpt->pending != 0)
+      ckpt->coalesced++;
+    ckpt->pending |= changed;
+    result = (int)changed;
+
+#if AEON_USE_THREADS
+    if (w != NULL) {
+      if (changed != 0)
+        pthread_cond_signal(&w->work);
+    } else
+#endif
+    if (changed != 0) {
+      write_pending(ckpt);
+      if (ckpt->error != 0)
+        result = ckpt->error;
+    }
+  }
+
+#if AEON_USE_THREADS
+  if (w != NULL)
+    pthread_mutex_unlock(&w->lock);
+#endif
+  return result;
+}
+
+int aeon_checkpoint_flush(aeon_checkpoint_t *ckpt) {
+  if (ckpt == NULL)
+    return -1;
+#if AEON_USE_THREADS
+  writer_t *w = ckpt->writer;
+  if (w != NULL) {
+    pthread_mutex_lock(&w->lock);
+    while (ckpt->error == 0 && (ckpt->pending != 0 || w->busy))
+      pthread_cond_wait(&w->idle, &w->lock);
+    int err = ckpt->error;
+    pthread_mutex_unlock(&w->lock);
+    return err;
+  }
+#endif
+  return ckpt->error;
+}
+
+int aeon_checkpoint_close(aeon_checkpoint_t *ckpt) {
+  if (ckpt == NULL)
+    return -1;
+  int err = aeon_checkpoint_flush(ckpt);
+
+#if AEON_USE_THREADS
+  writer_t *w = ckpt->writer;
+  if (w != NULL) {
+    pthread_mutex_lock(&w->lock);
+    w->stop = true;
+    pthread_cond_signal(&w->work);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+    pthread_cond_destroy(&w->idle);
+    pthread_cond_destroy(&w->work);
+    pthread_mutex_destroy(&w->lock);
+  }
+#endif
+
+  if (ckpt->file != NULL && fclose(ckpt->file) != 0 && err == 0)
+    err = -3;
+  aeon_allocator_t allocator = ckpt->allocator;
+  if (allocator.free != NULL)
+    allocator.free(ckpt, allocator.ctx);
+  return err;
+}
+
+int aeon_checkpoint_restore(aeon_core_t *core, const char *filename) {
+  if (core == NULL || filename == NULL)
+    return -1;
+  FILE *f = fopen(filename, "rb");
+  if (f == NULL)
+    return -2;
+
+  uint8_t h[LOG_HEADER_SIZE];
+  int err = read_header(f, h);
+  if (err == 0 &&
+      (get16(h + 8) != AEON_RESERVOIR_SIZE ||
+       get16(h + 10) != AEON_INPUT_SIZE ||
+       get16(h + 12) != AEON_OUTPUT_SIZE ||
+       get16(h + 14) != AEON_SPARSITY_FACTOR || h[16] != LOG_WEIGHT_FORMAT))
+    err = -5;
+
+  const aeon_allocator_t *a = aeon_k_default_allocator();
+  snapshot_t *snaps = NULL;
+  if (err == 0) {
+    snaps = a->alloc(2 * sizeof(snapshot_t), AEON_CACHE_LINE, a->ctx);
+    if (snaps == NULL)
+      err = -6;
+  }
+
+  uint32_t seen = 0, sequence;
+  int count = 0;
+  long end;
+  if (err == 0) {
+    memset(snaps, 0, 2 * sizeof(snapshot_t));
+    count = (int)scan_records(f, &snaps[0], &snaps[1], &seen, &sequence,
+                              &end);
+  }
+  fclose(f);
+
+  if (err == 0) {
+    /* W_in y el reservoir salen de la semilla y el radio, como en
+     * aeon_load */
+    aeon_birth_spectral(core, get32(h + 20), get_float(h + 48));
+    uint64_t birth = get32(h + 24) | ((uint64_t)get32(h + 28) << 32);
+    core->certificate.birth_time = (time_t)(int64_t)birth;
+    memcpy(core->certificate.birth_hash.bytes, h + 32, 16);
+    core->certificate.version = get16(h + 18);
+
+    const snapshot_t *s = &snaps[0];
+    if (seen & AEON_CHECKPOINT_STATE)
+      memcpy(core->state, s->state, sizeof(core->state));
+    if (seen & AEON_CHECKPOINT_W_OUT)
+      memcpy(core->W_out, s->W_out, sizeof(core->W_out));
+    if (seen & AEON_CHECKPOINT_COUNTERS) {
+      core->samples_processed = s->samples_processed;
+      core->learning_sessions = s->learning_sessions;
+      core->is_trained = s->is_trained;
+      core->leak_rate = s->leak_rate;
+      if (s->readout_sparse)
+        aeon_prune(core, 0.0f); /* Umbral 0: solo compacta */
+    }
+  }
+  if (snaps != NULL)
+    a->free(snaps, a->ctx);
+  return err != 0 ? err : count;
+}
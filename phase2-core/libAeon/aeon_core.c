@@ -0,0 +1,402 @@
+/**
+ * @file aeon_core.c
+ * @brief Proyecto Eón - Núcleo dimensionado en tiempo de ejecución
+ *
+ * Una sola arena contiene la estructura aeon_dyn_core_t seguida de
+ * todos sus arrays, cada uno alineado a AEON_CACHE_LINE. Los bucles
+ * calientes son los mismos kernels que usa el núcleo estático.
+ */
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================
+ * ASIGNADOR POR DEFECTO
+ * ============================================================ */
+
+/**
+ * @brief malloc alineado portable (C99)
+ *
+ * Reserva de más y guarda el puntero original justo antes del bloque.
+ */
+static void *default_alloc(size_t size, size_t alignment, void *ctx) {
+  (void)ctx;
+  uint8_t *raw = malloc(size + alignment + sizeof(void *));
+  if (raw == NULL)
+    return NULL;
+  uintptr_t base = (uintptr_t)(raw + sizeof(void *));
+  uintptr_t aligned = (base + alignment - 1) & ~(uintptr_t)(alignment - 1);
+  ((void **)aligned)[-1] = raw;
+  return (void *)aligned;
+}
+
+static void default_free(void *ptr, void *ctx) {
+  (void)ctx;
+  if (ptr != NULL)
+    free(((void **)ptr)[-1]);
+}
+
+static const aeon_allocator_t default_allocator = {default_alloc,
+                                                   default_free, NULL};
+
+const aeon_allocator_t *aeon_k_default_allocator(void) {
+  return &default_allocator;
+}
+
+/* ============================================================
+ * DISTRIBUCIÓN DE LA ARENA
+ * ============================================================ */
+
+/** Desplazamientos de cada array dentro de la arena */
+typedef struct {
+  size_t state;
+  size_t scratch;
+  size_t W_in;
+  size_t W_reservoir;
+  size_t W_out;
+  size_t col_indices;
+  size_t row_ptr;
+  size_t total;
+} arena_layout_t;
+
+static bool config_valid(const aeon_config_t *c) {
+  return c != NULL && c->reservoir_size > 0 && c->input_size > 0 &&
+         c->output_size > 0 && c->sparsity_factor > 0 &&
+         c->spectral_radius >= 0.0f;
+}
+
+static uint32_t sparse_capacity(const aeon_config_t *c) {
+  return (uint32_t)c->reservoir_size * c->reservoir_size / c->sparsity_factor;
+}
+
+/** Sin procedural, W_in y el CSR ocupan 0 bytes de la arena */
+static arena_layout_t compute_layout(const aeon_config_t *c, bool procedural) {
+  arena_layout_t l;
+  size_t n = c->reservoir_size;
+  size_t nnz = procedural ? 0 : sparse_capacity(c);
+  size_t n_w_in = procedural ? 0 : n * c->input_size;
+  size_t n_rows = procedural ? 0 : n + 1;
+  size_t off = aeon_k_align(sizeof(aeon_dyn_core_t));
+
+  l.state = off;
+  off += aeon_k_align(n * sizeof(aeon_state_t));
+  l.scratch = off;
+  off += aeon_k_align(n * sizeof(aeon_state_t));
+  l.W_in = off;
+  off += aeon_k_align(n_w_in * sizeof(aeon_weight_t));
+  l.W_reservoir = off;
+  off += aeon_k_align(nnz * sizeof(aeon_weight_t));
+  l.W_out = off;
+  off += aeon_k_align((size_t)c->output_size * n * sizeof(aeon_weight_t));
+  l.col_indices = off;
+  off += aeon_k_align(nnz * sizeof(uint16_t));
+  l.row_ptr = off;
+  off += aeon_k_align(n_rows * sizeof(uint32_t));
+  l.total = off;
+  return l;
+}
+
+static aeon_view_t dyn_view(const aeon_dyn_core_t *core) {
+  aeon_view_t v;
+  v.n_res = core->config.reservoir_size;
+  v.n_in = core->config.input_size;
+  v.n_out = core->config.output_size;
+  v.sparsity = core->config.sparsity_factor;
+  v.state = core->state;
+  v.scratch = core->scratch;
+  v.W_in = core->W_in;
+  v.W_reservoir = core->W_reservoir;
+  v.W_out = core->W_out;
+  v.col_indices = core->col_indices;
+  v.row_ptr = core->row_ptr;
+  v.procedural = core->procedural;
+  v.seed = core->certificate.reservoir_seed;
+  v.spectral_radius = core->config.spectral_radius;
+  v.leak = aeon_k_leak(core->config.leak_rate);
+  v.gain = core->reservoir_gain;
+  return v;
+}
+
+/* ============================================================
+ * CICLO DE VIDA
+ * ============================================================ */
+
+size_t aeon_core_arena_size(const aeon_config_t *config) {
+  if (!config_valid(config))
+    return 0;
+  return compute_layout(config, false).total;
+}
+
+static aeon_dyn_core_t *create_core(const aeon_config_t *config,
+                                    const aeon_allocator_t *allocator,
+                                    bool procedural) {
+  if (!config_valid(config))
+    return NULL;
+  if (allocator == NULL)
+    allocator = &default_allocator;
+  if (allocator->alloc == NULL)
+    return NULL;
+
+  arena_layout_t l = compute_layout(config, procedural);
+  uint8_t *arena = allocator->alloc(l.total, AEON_CACHE_LINE, allocator->ctx);
+  if (arena == NULL)
+    return NULL;
+  memset(arena, 0, l.total);
+
+  aeon_dyn_core_t *core = (aeon_dyn_core_t *)(void *)arena;
+  core->config = *config;
+  core->state = (aeon_state_t *)(void *)(arena + l.state);
+  core->scratch = (aeon_state_t *)(void *)(arena + l.scratch);
+  core->W_out = (aeon_weight_t *)(void *)(arena + l.W_out);
+  if (!procedural) {
+    core->W_in = (aeon_weight_t *)(void *)(arena + l.W_in);
+    core->W_reservoir = (aeon_weight_t *)(void *)(arena + l.W_reservoir);
+    core->col_indices = (uint16_t *)(void *)(arena + l.col_indices);
+    core->row_ptr = (uint32_t *)(void *)(arena + l.row_ptr);
+  }
+  core->procedural = procedural;
+  core->reservoir_gain = aeon_k_fraction(1.0f);
+  core->allocator = *allocator;
+  core->arena_size = l.total;
+
+  return core;
+}
+
+aeon_dyn_core_t *aeon_core_create(const aeon_config_t *config,
+                                  const aeon_allocator_t *allocator) {
+  return create_core(config, allocator, false);
+}
+
+aeon_dyn_core_t *aeon_core_create_procedural(const aeon_config_t *config,
+                                             const aeon_allocator_t *allocator) {
+  return create_core(config, allocator, true);
+}
+
+void aeon_core_destroy(aeon_dyn_core_t *core) {
+  if (core == NULL)
+    return;
+  aeon_allocator_t allocator = core->allocator;
+  aeon_k_unmap(core->mapping, core->mapping_size);
+  if (allocator.free != NULL)
+    allocator.free(core, allocator.ctx);
+}
+
+int aeon_core_birth(aeon_dyn_core_t *core, uint32_t seed) {
+  if (core == NULL)
+    return -1;
+  if (core->mapping != NULL)
+    return -4; /* Pesos de solo lectura */
+
+  /* Bitset de conexiones, solo durante el nacimiento */
+  uint32_t *seen = NULL;
+  if (!core->procedural) {
+    size_t seen_bytes = AEON_GENERATE_WORK_WORDS(core->config.reservoir_size) *
+                        sizeof(uint32_t);
+    seen =
+        core->allocator.alloc(seen_bytes, AEON_CACHE_LINE, core->allocator.ctx);
+    if (seen == NULL)
+      return -3;
+  }
+
+  /* Limpiar arrays y estadísticas, conservando la distribución */
+  uint8_t *arena = (uint8_t *)core;
+  size_t header = aeon_k_align(sizeof(aeon_dyn_core_t));
+  memset(arena + header, 0, core->arena_size - header);
+  memset(&core->certificate, 0, sizeof(core->certificate));
+
+  seed = aeon_k_certify(&core->certificate, seed, core->config.reservoir_size);
+
+  if (core->procedural) {
+    /* Solo la semilla: los pesos salen de ella en cada paso */
+    core->sparse_count = (uint32_t)core->config.reservoir_size *
+                         aeon_k_proc_fan_in(core->config.reservoir_size,
+                                            core->config.sparsity_factor);
+    aeon_view_t v = dyn_view(core);
+    core->reservoir_gain = aeon_k_proc_gain(&v);
+  } else {
+    aeon_view_t v = dyn_view(core);
+    core->sparse_count = aeon_k_generate(&v, seed, seen);
+    if (core->allocator.free != NULL)
+      core->allocator.free(seen, core->allocator.ctx);
+  }
+
+  core->samples_processed = 0;
+  core->learning_sessions = 0;
+  core->is_trained = false;
+
+  return 0;
+}
+
+/* ============================================================
+ * PROCESAMIENTO
+ * ============================================================ */
+
+void aeon_core_update(aeon_dyn_core_t *core, const aeon_state_t *input) {
+  if (core == NULL || input == NULL)
+    return;
+
+  AEON_STATS_BEGIN(t0);
+  aeon_view_t v = dyn_view(core);
+  aeon_k_view_step(&v, input);
+
+  core->samples_processed++;
+  AEON_STATS_END(AEON_EVENT_UPDATE, t0);
+}
+
+float aeon_core_spectral_radius(const aeon_dyn_core_t *core) {
+  if (core == NULL)
+    return -1.0f;
+
+  size_t block = aeon_k_align(core->config.reservoir_size *
+                              sizeof(aeon_state_t));
+  uint8_t *work =
+      core->allocator.alloc(2 * block, AEON_CACHE_LINE, core->allocator.ctx);
+  if (work == NULL)
+    return -3.0f;
+
+  aeon_view_t v = dyn_view(core);
+  v.state = (aeon_state_t *)(void *)work;
+  v.scratch = (aeon_state_t *)(void *)(work + block);
+  float radius = aeon_k_spectral_radius(&v);
+
+  if (core->allocator.free != NULL)
+    core->allocator.free(work, core->allocator.ctx);
+  return radius;
+}
+
+void aeon_core_predict(const aeon_dyn_core_t *core, aeon_state_t *output) {
+  if (core == NULL || output == NULL)
+    return;
+
+  AEON_STATS_BEGIN(t0);
+  aeon_k_readout(core->config.reservoir_size, core->config.output_size,
+                 core->W_out, core->state, output);
+  AEON_STATS_SCAN(output, NULL, core->config.output_size);
+  AEON_STATS_END(AEON_EVENT_PREDICT, t0);
+}
+
+int aeon_core_generate(const aeon_dyn_core_t *core, uint32_t horizon,
+                       aeon_state_t *out) {
+  if (core == NULL || out == NULL)
+    return -1;
+  if (core->config.input_size != core->config.output_size)
+    return -2;
+
+  uint16_t n = core->config.reservoir_size;
+  size_t bytes = 2 * aeon_k_align(n * sizeof(aeon_state_t));
+  uint8_t *work =
+      core->allocator.alloc(bytes, AEON_CACHE_LINE, core->allocator.ctx);
+  if (work == NULL)
+    return -3;
+
+  AEON_STATS_BEGIN(t0);
+  aeon_view_t v = dyn_view(core);
+  v.state = (aeon_state_t *)(void *)work;
+  v.scratch = (aeon_state_t *)(void *)(work + bytes / 2);
+  memcpy(v.state, core->state, n * sizeof(aeon_state_t));
+  aeon_k_forecast(&v, NULL, NULL, NULL, horizon, out);
+  AEON_STATS_SCAN(out, NULL, horizon * core->config.output_size);
+  AEON_STATS_END(AEON_EVENT_PREDICT, t0);
+
+  if (core->allocator.free != NULL)
+    core->allocator.free(work, core->allocator.ctx);
+  return 0;
+}
+
+void aeon_core_reset(aeon_dyn_core_t *core) {
+  if (core == NULL)
+    return;
+  memset(core->state, 0, core->config.reservoir_size * sizeof(aeon_state_t));
+}
+
+/* ============================================================
+ * ENTRENAMIENTO
+ * ============================================================ */
+
+float aeon_core_train(aeon_dyn_core_t *core, const aeon_state_t *inputs,
+                      const aeon_state_t *targets, uint32_t n_samples,
+                      uint32_t washout) {
+  if (core == NULL || inputs == NULL || targets == NULL)
+    return -1.0f;
+  if (n_samples <= washout)
+    return -2.0f;
+  if (core->mapping != NULL)
+    return -4.0f;
+
+  AEON_STATS_BEGIN(t0);
+  size_t work_bytes =
+      aeon_k_train_work_size(core->config.reservoir_size,
+                             core->config.output_size) * sizeof(float);
+  float *work =
+      core->allocator.alloc(work_bytes, AEON_CACHE_LINE, core->allocator.ctx);
+  if (work == NULL)
+    return -3.0f;
+
+  aeon_view_t v = dyn_view(core);
+  float mse = aeon_k_train(&v, inputs, targets, n_samples, washout, work);
+
+  if (core->allocator.free != NULL)
+    core->allocator.free(work, core->allocator.ctx);
+
+  /* Si S^T*S no se factoriza, W_out sigue como estaba */
+  if (mse >= 0.0f) {
+    core->is_trained = true;
+    core->learning_sessions++;
+    core->samples_processed += n_samples;
+  }
+  AEON_STATS_END(AEON_EVENT_TRAIN, t0);
+
+  return mse;
+}
+
+float aeon_core_train_parallel(aeon_dyn_core_t *core,
+                               const aeon_state_t *inputs,
+                               const aeon_state_t *targets,
+                               uint32_t n_samples, uint32_t washout,
+                               const aeon_executor_t *executor,
+                               uint16_t n_partials) {
+  if (core == NULL || inputs == NULL || targets == NULL)
+    return -1.0f;
+  if (n_samples <= washout || n_partials == 0)
+    return -2.0f;
+  if (core->mapping != NULL)
+    return -4.0f;
+
+  AEON_STATS_BEGIN(t0);
+  size_t work_bytes = aeon_k_train_parallel_work_size(
+                          core->config.reservoir_size,
+                          core->config.output_size, n_partials) *
+                      sizeof(float);
+  float *work =
+      core->allocator.alloc(work_bytes, AEON_CACHE_LINE, core->allocator.ctx);
+  if (work == NULL)
+    return -3.0f;
+
+  aeon_view_t v = dyn_view(core);
+  float mse = aeon_k_train_parallel(&v, inputs, targets, n_samples, washout,
+                                    executor, n_partials, work);
+
+  if (core->allocator.free != NULL)
+    core->allocator.free(work, core->allocator.ctx);
+
+  if (mse >= 0.0f) {
+    core->is_trained = true;
+    core->learning_sessions++;
+    core->samples_processed += n_samples;
+  }
+  AEON_STATS_END(AEON_EVENT_TRAIN, t0);
+
+  return mse;
+}
+
+/* ============================================================
+ * UTILIDADES
+ * ============================================================ */
+
+uint32_t aeon_core_memory_usage(const aeon_dyn_core_t *core) {
+  if (core == NULL)
+    return 0;
+  return (uint32_t)core->arena_size;
+}
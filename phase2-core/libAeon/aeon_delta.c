@@ -0,0 +1,249 @@
+/**
+ * @file aeon_delta.c
+ * @brief Proyecto Eón - Actualización por eventos (modo delta)
+ *
+ * Cada neurona guarda su preactivación W_in * u + W_res * s. En vez de
+ * recalcularla entera en cada paso, se le suma W * (nuevo - anterior)
+ * solo por las entradas y neuronas cuyo cambio supera el umbral. En
+ * punto fijo la preactivación se acumula sin desplazar, así que la
+ * suma incremental es exacta y con umbral 0 coincide con aeon_k_step.
+ */
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <string.h>
+
+/* ============================================================
+ * CICLO DE VIDA
+ * ============================================================ */
+
+aeon_delta_t *aeon_delta_create(uint16_t reservoir_size, uint16_t input_size,
+                                const aeon_allocator_t *allocator) {
+  if (reservoir_size == 0 || input_size == 0)
+    return NULL;
+  if (allocator == NULL)
+    allocator = aeon_k_default_allocator();
+  if (allocator->alloc == NULL)
+    return NULL;
+
+  size_t header = aeon_k_align(sizeof(aeon_delta_t));
+  size_t res = aeon_k_align(reservoir_size * sizeof(aeon_state_t));
+  size_t in = aeon_k_align(input_size * sizeof(aeon_state_t));
+  size_t total = header + 3 * res + 2 * in;
+
+  uint8_t *arena = allocator->alloc(total, AEON_CACHE_LINE, allocator->ctx);
+  if (arena == NULL)
+    return NULL;
+  memset(arena, 0, total);
+
+  aeon_delta_t *delta = (aeon_delta_t *)(void *)arena;
+  delta->reservoir_size = reservoir_size;
+  delta->input_size = input_size;
+  delta->acc = (aeon_state_t *)(void *)(arena + header);
+  delta->state_ref = (aeon_state_t *)(void *)(arena + header + res);
+  delta->change = (aeon_state_t *)(void *)(arena + header + 2 * res);
+  delta->input_ref = (aeon_state_t *)(void *)(arena + header + 3 * res);
+  delta->input_change =
+      (aeon_state_t *)(void *)(arena + header + 3 * res + in);
+  delta->allocator = *allocator;
+
+  aeon_delta_begin(delta, 0);
+  return delta;
+}
+
+void aeon_delta_destroy(aeon_delta_t *delta) {
+  if (delta == NULL)
+    return;
+  aeon_allocator_t allocator = delta->allocator;
+  if (allocator.free != NULL)
+    allocator.free(delta, allocator.ctx);
+}
+
+int aeon_delta_begin(aeon_delta_t *delta, aeon_state_t threshold) {
+  if (delta == NULL)
+    return -1;
+  if (!(threshold >= 0))
+    return -2;
+
+  delta->threshold = threshold;
+  delta->ops_total = 0;
+  delta->ops_skipped = 0;
+  delta->rows_skipped = 0;
+  delta->active = 0;
+  delta->primed = false;
+  return 0;
+}
+
+/* ============================================================
+ * PASO
+ * ============================================================ */
+
+/** Cambio respecto de ref si supera el umbral (y ref pasa a x), o 0 */
+static inline aeon_state_t take_change(aeon_state_t x, aeon_state_t *ref,
+                                       aeon_state_t threshold) {
+  aeon_state_t d = x - *ref;
+  if (d > threshold || d < -threshold) {
+    *ref = x;
+    return d;
+  }
+  return 0;
+}
+
+/** Preactivación desplazada a la escala del estado */
+static inline aeon_state_t scaled(aeon_state_t acc) {
+#if AEON_USE_FIXED_POINT
+  return acc >> AEON_SCALE_BITS;
+#else
+  return acc;
+#endif
+}
+
+/** No-linealidad de una neurona, la de aeon_k_activate */
+static inline void activate(aeon_state_t *state, aeon_state_t pre,
+                            aeon_state_t leak) {
+  aeon_state_t a = aeon_k_tanh(pre);
+  if (leak >= aeon_k_fraction(1.0f)) {
+    *state = a;
+    AEON_STATS_SCAN(&pre, state, 1);
+    return;
+  }
+  AEON_STATS_SCAN(&pre, NULL, 1);
+#if AEON_USE_FIXED_POINT
+  *state += (leak * (a - *state)) >> AEON_SCALE_BITS;
+#else
+  *state += leak * (a - *state);
+#endif
+  AEON_STATS_SCAN(NULL, state, 1);
+}
+
+/** Paso completo: recalcula todas las preactivaciones */
+static void delta_prime(aeon_delta_t *d, const aeon_weight_t *W_in,
+                        const uint32_t *row_ptr, const uint16_t *col_indices,
+                        const aeon_weight_t *W_reservoir, aeon_state_t *state,
+                        const aeon_state_t *input, aeon_state_t leak) {
+  const uint16_t n = d->reservoir_size;
+  const uint16_t n_in = d->input_size;
+
+  for (int i = 0; i < n; i++) {
+    aeon_state_t sum = 0;
+    for (int j = 0; j < n_in; j++) {
+      sum += aeon_k_weight(W_in[i * n_in + j]) * input[j];
+    }
+    for (uint32_t k = row_ptr[i]; k < row_ptr[i + 1]; k++) {
+      sum += aeon_k_weight(W_reservoir[k]) * state[col_indices[k]];
+    }
+    d->acc[i] = sum;
+  }
+
+  memcpy(d->state_ref, state, n * sizeof(aeon_state_t));
+  memcpy(d->input_ref, input, n_in * sizeof(aeon_state_t));
+  for (int i = 0; i < n; i++)
+    activate(&state[i], scaled(d->acc[i]), leak);
+
+  d->active = n;
+  d->primed = true;
+}
+
+static void delta_step(aeon_delta_t *d, const aeon_weight_t *W_in,
+                       const uint32_t *row_ptr, const uint16_t *col_indices,
+                       const aeon_weight_t *W_reservoir, aeon_state_t *state,
+                       const aeon_state_t *input, aeon_state_t leak) {
+  const uint16_t n = d->reservoir_size;
+  const uint16_t n_in = d->input_size;
+  uint64_t dense = (uint64_t)n * n_in + row_ptr[n];
+  d->ops_total += dense;
+
+  if (!d->primed) {
+    delta_prime(d, W_in, row_ptr, col_indices, W_reservoir, state, input,
+                leak);
+    return;
+  }
+
+  /* Eventos: entradas y neuronas cuyo cambio supera el umbral */
+  uint32_t active_in = 0, active = 0;
+  for (int j = 0; j < n_in; j++) {
+    d->input_change[j] = take_change(input[j], &d->input_ref[j], d->threshold);
+    active_in += d->input_change[j] != 0;
+  }
+  for (int j = 0; j < n; j++) {
+    d->change[j] = take_change(state[j], &d->state_ref[j], d->threshold);
+    active += d->change[j] != 0;
+  }
+  d->active = active;
+
+  uint64_t macs = 0;
+  for (int i = 0; i < n; i++) {
+    aeon_state_t sum = 0;
+    bool touched = false;
+
+    if (active_in > 0) {
+      for (int j = 0; j < n_in; j++) {
+        if (d->input_change[j] != 0) {
+          sum += aeon_k_weight(W_in[i * n_in + j]) * d->input_change[j];
+          macs++;
+          touched = true;
+        }
+      }
+    }
+    if (active > 0) {
+      uint32_t row_end = row_ptr[i + 1];
+      for (uint32_t k = row_ptr[i]; k < row_end; k++) {
+        aeon_state_t c = d->change[col_indices[k]];
+        if (c != 0) {
+          sum += aeon_k_weight(W_reservoir[k]) * c;
+          macs++;
+          touched = true;
+        }
+      }
+    }
+
+    /* Fila en reposo: misma preactivación y, sin fuga, mismo estado
+     * (con fuga el estado sigue acercándose a la activación) */
+    if (!touched) {
+      d->rows_skipped++;
+      if (leak < aeon_k_fraction(1.0f))
+        activate(&state[i], scaled(d->acc[i]), leak);
+      continue;
+    }
+    d->acc[i] += sum;
+    activate(&state[i], scaled(d->acc[i]), leak);
+  }
+
+  d->ops_skipped += dense - macs;
+}
+
+int aeon_delta_update(aeon_delta_t *delta, aeon_core_t *core,
+                      const aeon_state_t *input) {
+  if (delta == NULL || core == NULL || input == NULL)
+    return -1;
+  if (delta->reservoir_size != AEON_RESERVOIR_SIZE ||
+      delta->input_size != AEON_INPUT_SIZE)
+    return -2;
+
+  AEON_STATS_BEGIN(t0);
+  delta_step(delta, core->W_in, core->row_ptr, core->col_indices,
+             core->W_reservoir, core->state, input,
+             aeon_k_leak(core->leak_rate));
+  core->samples_processed++;
+  AEON_STATS_END(AEON_EVENT_UPDATE, t0);
+  return 0;
+}
+
+int aeon_core_delta_update(aeon_delta_t *delta, aeon_dyn_core_t *core,
+                           const aeon_state_t *input) {
+  if (delta == NULL || core == NULL || input == NULL)
+    return -1;
+  if (delta->reservoir_size != core->config.reservoir_size ||
+      delta->input_size != core->config.input_size)
+    return -2;
+  if (core->procedural)
+    return -5; /* Sin CSR que recorrer */
+
+  AEON_STATS_BEGIN(t0);
+  delta_step(delta, core->W_in, core->row_ptr, core->col_indices,
+             core->W_reservoir, core->state, input,
+             aeon_k_leak(core->config.leak_rate));
+  core->samples_processed++;
+  AEON_STATS_END(AEON_EVENT_UPDATE, t0);
+  return 0;
+}
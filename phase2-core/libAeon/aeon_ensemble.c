@@ -0,0 +1,232 @@
+/**
+ * @file aeon_ensemble.c
+ * @brief Proyecto Eón - Ensamble de reservoirs enrutado por dominio
+ *
+ * La ruta y la afinidad siguen la Voluntad Verdadera de AeonESP32
+ * (evaluateTaskCost / recordProcessing); cada experto elegido es una
+ * tarea del ejecutor. Los expertos no comparten pesos, así que no hay
+ * carriles SIMD que aprovechar entre ellos como en aeon_batch: el
+ * paralelismo es por hilos y cada núcleo aprovecha sus propios kernels.
+ */
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <string.h>
+
+/* ============================================================
+ * CICLO DE VIDA
+ * ============================================================ */
+
+/** Afinidad base de los dominios no nativos (~10%, _initTrueWill) */
+#define BASE_AFFINITY 26
+
+aeon_ensemble_t *aeon_ensemble_create(uint16_t n_experts,
+                                      const uint32_t *seeds,
+                                      const uint8_t *domains,
+                                      const aeon_allocator_t *allocator) {
+  if (n_experts == 0 || seeds == NULL)
+    return NULL;
+  if (allocator == NULL)
+    allocator = aeon_k_default_allocator();
+  if (allocator->alloc == NULL)
+    return NULL;
+  if (domains != NULL) {
+    for (uint16_t e = 0; e < n_experts; e++) {
+      if (domains[e] >= AEON_DOMAIN_COUNT)
+        return NULL;
+    }
+  }
+
+  size_t header = aeon_k_align(sizeof(aeon_ensemble_t));
+  size_t experts = aeon_k_align(n_experts * sizeof(aeon_expert_t));
+  size_t active = aeon_k_align(n_experts * sizeof(uint16_t));
+  size_t total = header + experts + active;
+
+  uint8_t *arena = allocator->alloc(total, AEON_CACHE_LINE, allocator->ctx);
+  if (arena == NULL)
+    return NULL;
+  memset(arena, 0, total);
+
+  aeon_ensemble_t *ens = (aeon_ensemble_t *)(void *)arena;
+  ens->n_experts = n_experts;
+  ens->experts = (aeon_expert_t *)(void *)(arena + header);
+  ens->active = (uint16_t *)(void *)(arena + header + experts);
+  ens->reject_threshold = 77;
+  ens->high_threshold = 128;
+  ens->allocator = *allocator;
+
+  for (uint16_t e = 0; e < n_experts; e++) {
+    aeon_expert_t *x = &ens->experts[e];
+    if (aeon_birth(&x->core, seeds[e]) != 0) {
+      aeon_ensemble_destroy(ens);
+      return NULL;
+    }
+    x->domain = domains != NULL ? domains[e] : AEON_DOMAIN_GENERIC;
+    memset(x->affinity, BASE_AFFINITY, sizeof(x->affinity));
+    x->affinity[x->domain] = 255;
+    x->processed[x->domain] = 1;
+  }
+  return ens;
+}
+
+void aeon_ensemble_destroy(aeon_ensemble_t *ensemble) {
+  if (ensemble == NULL)
+    return;
+  aeon_allocator_t allocator = ensemble->allocator;
+  if (allocator.free != NULL)
+    allocator.free(ensemble, allocator.ctx);
+}
+
+void aeon_ensemble_reset(aeon_ensemble_t *ensemble) {
+  if (ensemble == NULL)
+    return;
+  for (uint16_t e = 0; e < ensemble->n_experts; e++)
+    aeon_reset(&ensemble->experts[e].core);
+}
+
+/* ============================================================
+ * RUTA
+ * ============================================================ */
+
+uint8_t aeon_ensemble_cost(const aeon_ensemble_t *ensemble, uint16_t expert,
+                           uint8_t domain) {
+  if (ensemble == NULL || expert >= ensemble->n_experts ||
+      domain >= AEON_DOMAIN_COUNT)
+    return AEON_ROUTE_REJECT;
+
+  uint8_t affinity = ensemble->experts[expert].affinity[domain];
+  if (affinity >= ensemble->high_threshold)
+    return affinity >= 200 ? AEON_ROUTE_ACCEPT : AEON_ROUTE_HIGH;
+  if (affinity >= ensemble->reject_threshold)
+    return AEON_ROUTE_LOW;
+  return AEON_ROUTE_REJECT;
+}
+
+int aeon_ensemble_route(aeon_ensemble_t *ensemble, uint8_t domain) {
+  if (ensemble == NULL)
+    return -1;
+  if (domain >= AEON_DOMAIN_COUNT)
+    return -2;
+
+  uint16_t n = 0;
+  for (uint16_t e = 0; e < ensemble->n_experts; e++) {
+    if (aeon_ensemble_cost(ensemble, e, domain) != AEON_ROUTE_REJECT)
+      ensemble->active[n++] = e;
+  }
+  ensemble->n_active = n;
+  return n;
+}
+
+/* ============================================================
+ * EJECUCIÓN
+ * ============================================================ */
+
+/** Ejecuta task para cada experto elegido, con el ejecutor si hay */
+static void run_active(aeon_ensemble_t *ens, aeon_task_fn task) {
+  /* Los contadores de AEON_ENABLE_STATS son globales: en orden */
+  if (ens->executor != NULL && ens->executor->run != NULL &&
+      !AEON_ENABLE_STATS) {
+    ens->executor->run(ens->executor->ctx, task, ens, ens->n_active);
+    return;
+  }
+  for (uint32_t i = 0; i < ens->n_active; i++)
+    task(ens, i);
+}
+
+static void step_task(void *arg, uint32_t index) {
+  aeon_ensemble_t *ens = arg;
+  aeon_expert_t *x = &ens->experts[ens->active[index]];
+  aeon_update(&x->core, ens->task_input);
+  aeon_predict(&x->core, x->output);
+}
+
+static void train_task(void *arg, uint32_t index) {
+  aeon_ensemble_t *ens = arg;
+  aeon_expert_t *x = &ens->experts[ens->active[index]];
+  x->mse = aeon_train(&x->core, ens->task_input, ens->task_target,
+                      ens->task_samples, ens->task_washout);
+}
+
+int aeon_ensemble_step(aeon_ensemble_t *ensemble, uint8_t domain,
+                       const aeon_state_t *input, aeon_state_t *output) {
+  if (ensemble == NULL || input == NULL || output == NULL)
+    return -1;
+  int n = aeon_ensemble_route(ensemble, domain);
+  if (n < 0)
+    return n;
+  if (n == 0)
+    return -3;
+
+  ensemble->task_input = input;
+  run_active(ensemble, step_task);
+
+  /* Media de las salidas ponderada por afinidad */
+  uint32_t weight = 0;
+  for (int i = 0; i < n; i++)
+    weight += ensemble->experts[ensemble->active[i]].affinity[domain];
+
+  for (int o = 0; o < AEON_OUTPUT_SIZE; o++) {
+#if AEON_USE_FIXED_POINT
+    int64_t sum = 0;
+#else
+    float sum = 0.0f;
+#endif
+    for (int i = 0; i < n; i++) {
+      const aeon_expert_t *x = &ensemble->experts[ensemble->active[i]];
+      sum += (aeon_state_t)x->affinity[domain] * x->output[o];
+    }
+#if AEON_USE_FIXED_POINT
+    output[o] = (aeon_state_t)(sum / (int64_t)weight);
+#else
+    output[o] = sum / (float)weight;
+#endif
+  }
+  return n;
+}
+
+/** Ajuste de afinidad por el resultado de un entrenamiento */
+static void record_processing(aeon_expert_t *x, uint8_t domain) {
+  if (x->processed[domain] < UINT16_MAX)
+    x->processed[domain]++;
+
+  if (x->mse < 0.1f) { /* Muy bien */
+    if (x->affinity[domain] < 250)
+      x->affinity[domain] += 5;
+  } else if (x->mse < 0.3f) { /* Aceptable */
+    if (x->affinity[domain] < 253)
+      x->affinity[domain] += 2;
+  } else if (x->mse > 0.7f) { /* Mal */
+    if (x->affinity[domain] > 3)
+      x->affinity[domain] -= 3;
+  }
+}
+
+float aeon_ensemble_train(aeon_ensemble_t *ensemble, uint8_t domain,
+                          const aeon_state_t *inputs,
+                          const aeon_state_t *targets, uint32_t n_samples,
+                          uint32_t washout) {
+  if (ensemble == NULL || inputs == NULL || targets == NULL)
+    return -1.0f;
+  int n = aeon_ensemble_route(ensemble, domain);
+  if (n < 0)
+    return (float)n;
+  if (n == 0)
+    return -3.0f;
+  if (n_samples <= washout)
+    return -4.0f;
+
+  ensemble->task_input = inputs;
+  ensemble->task_target = targets;
+  ensemble->task_samples = n_samples;
+  ensemble->task_washout = washout;
+  run_active(ensemble, train_task);
+
+  /* Afinidades después del lote, en orden de experto */
+  float mse = 0.0f;
+  for (int i = 0; i < n; i++) {
+    aeon_expert_t *x = &ensemble->experts[ensemble->active[i]];
+    record_processing(x, domain);
+    mse += x->mse;
+  }
+  return mse / (float)n;
+}
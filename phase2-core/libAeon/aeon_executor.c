@@ -0,0 +1,157 @@
+/**
+ * @file aeon_executor.c
+ * @brief Proyecto Eón - Pool de hilos para lotes de tareas
+ *
+ * Hilos persistentes que esperan un lote en una variable de condición.
+ * Cada lote lleva un número de generación; los hilos (y el que llama a
+ * run) toman índices de uno en uno hasta agotarlo, así que tareas de
+ * coste desigual (expertos que entrenan y otros que no) se reparten
+ * solas. Sin AEON_USE_THREADS, aeon_executor_create devuelve NULL y
+ * quien lo usa ejecuta las tareas en orden.
+ */
+
+#if AEON_USE_THREADS && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "libAeon.h"
+
+#if AEON_USE_THREADS
+
+#include <pthread.h>
+#include <stdlib.h>
+
+typedef struct {
+  aeon_executor_t executor; /* Primero: el puntero público es el pool */
+
+  pthread_mutex_t lock;
+  pthread_cond_t work;
+  pthread_cond_t done;
+  pthread_t *threads;
+  uint16_t n_threads;
+
+  /* Lote en curso, protegido por lock */
+  aeon_task_fn task;
+  void *arg;
+  uint32_t n_tasks;
+  uint32_t next;    /**< Siguiente índice sin tomar */
+  uint32_t pending; /**< Tareas tomadas o por tomar que no han acabado */
+  uint32_t generation;
+  bool stop;
+} aeon_pool_t;
+
+/** Ejecuta tareas del lote en curso hasta que no quedan; con lock */
+static void drain(aeon_pool_t *pool) {
+  while (pool->next < pool->n_tasks) {
+    uint32_t i = pool->next++;
+    pthread_mutex_unlock(&pool->lock);
+    pool->task(pool->arg, i);
+    pthread_mutex_lock(&pool->lock);
+    if (--pool->pending == 0)
+      pthread_cond_signal(&pool->done);
+  }
+}
+
+static void *worker(void *p) {
+  aeon_pool_t *pool = p;
+  uint32_t seen = 0;
+
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (!pool->stop && pool->generation == seen)
+      pthread_cond_wait(&pool->work, &pool->lock);
+    if (pool->stop)
+      break;
+    seen = pool->generation;
+    drain(pool);
+  }
+  pthread_mutex_unlock(&pool->lock);
+  return NULL;
+}
+
+static void pool_run(void *ctx, aeon_task_fn task, void *arg, uint32_t n) {
+  aeon_pool_t *pool = ctx;
+  if (n == 0)
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->task = task;
+  pool->arg = arg;
+  pool->n_tasks = n;
+  pool->next = 0;
+  pool->pending = n;
+  pool->generation++;
+  pthread_cond_broadcast(&pool->work);
+
+  drain(pool);
+  while (pool->pending > 0)
+    pthread_cond_wait(&pool->done, &pool->lock);
+  pthread_mutex_unlock(&pool->lock);
+}
+
+/** Detiene y espera los primeros n hilos */
+static void pool_stop(aeon_pool_t *pool, uint16_t n) {
+  pthread_mutex_lock(&pool->lock);
+  pool->stop = true;
+  pthread_cond_broadcast(&pool->work);
+  pthread_mutex_unlock(&pool->lock);
+  for (uint16_t t = 0; t < n; t++)
+    pthread_join(pool->threads[t], NULL);
+}
+
+aeon_executor_t *aeon_executor_create(uint16_t n_threads) {
+  if (n_threads == 0)
+    return NULL;
+
+  aeon_pool_t *pool = calloc(1, sizeof(aeon_pool_t));
+  if (pool == NULL)
+    return NULL;
+  pool->n_threads = n_threads - 1; /* El que llama a run es el último */
+  if (pool->n_threads > 0) {
+    pool->threads = calloc(pool->n_threads, sizeof(pthread_t));
+    if (pool->threads == NULL) {
+      free(pool);
+      return NULL;
+    }
+  }
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work, NULL);
+  pthread_cond_init(&pool->done, NULL);
+
+  for (uint16_t t = 0; t < pool->n_threads; t++) {
+    if (pthread_create(&pool->threads[t], NULL, worker, pool) != 0) {
+      pool_stop(pool, t);
+      pool->n_threads = 0;
+      aeon_executor_destroy(&pool->executor);
+      return NULL;
+    }
+  }
+
+  pool->executor.run = pool_run;
+  pool->executor.ctx = pool;
+  return &pool->executor;
+}
+
+void aeon_executor_destroy(aeon_executor_t *executor) {
+  if (executor == NULL)
+    return;
+  aeon_pool_t *pool = (aeon_pool_t *)(void *)executor;
+  if (pool->n_threads > 0)
+    pool_stop(pool, pool->n_threads);
+  pthread_cond_destroy(&pool->done);
+  pthread_cond_destroy(&pool->work);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->threads);
+  free(pool);
+}
+
+#else
+
+aeon_executor_t *aeon_executor_create(uint16_t n_threads) {
+  (void)n_threads;
+  return NULL;
+}
+
+void aeon_executor_destroy(aeon_executor_t *executor) { (void)executor; }
+
+#endif
@@ -0,0 +1,1073 @@
+/**
+ * @file aeon_io.c
+ * @brief Proyecto Eón - Formato de archivo de modelos
+ *
+ * Cabecera fija de 64 bytes (72 desde la versión 3), tabla de
+ * secciones y secciones alineadas a 64 bytes, todo en little-endian con
+ * anchos fijos: el archivo no depende del relleno del compilador, del
+ * ancho de time_t ni del tamaño de reservoir de compilación.
+ *
+ *   0  "AEON"               4  u16 versión de formato
+ *   6  u16 tamaño cabecera  8  u16 versión de libAeon
+ *  10  u16 neuronas        12  u16 entradas      14  u16 salidas
+ *  16  u16 escasez         18  u8 formato pesos  19  u8 flags
+ *  20  u32 semilla         24  u32 conexiones    28  u32 nº secciones
+ *  32  i64 nacimiento      40  hash (16 bytes)
+ *  56  u32 muestras        60  u32 sesiones
+ *  64  f32 radio espectral 68  f32 fuga          (versión 3)
+ *
+ * Cada entrada de la tabla: u32 id, u32 offset, u32 bytes, u32 CRC-32.
+ * Las secciones del reservoir son opcionales: si faltan, se regeneran
+ * desde la semilla. Un núcleo procedural nunca las escribe. Como las
+ * secciones están alineadas, un archivo completo puede proyectarse con
+ * mmap y usarse sin copiar pesos.
+ *
+ * W_out va denso o, desde la versión 2 del formato, como dos secciones
+ * escasas alineadas a 4: índices planos (o * neuronas + j, en orden
+ * estrictamente creciente; u16 si caben, si no u32) y pesos. Los
+ * archivos sin W_out escaso se siguen escribiendo como versión 1.
+ *
+ * La versión 3 guarda el radio al que se normalizó el reservoir (las
+ * secciones ausentes se regeneran con él) y la fuga del paso. Solo se
+ * escribe si alguno no es el de antes (radio 0, sin fuga): los demás
+ * archivos salen idénticos a los de las versiones 1 y 2.
+ */
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AEON_HAVE_MMAP 1
+#else
+#define AEON_HAVE_MMAP 0
+#endif
+
+#define FILE_MAGIC "AEON"
+#define FILE_HEADER_SIZE 64
+#define FILE_ENTRY_SIZE 16
+#define FILE_ALIGN 64
+#define FILE_MAX_SECTIONS 16
+
+/** Identificadores de sección en disco */
+enum {
+  SEC_W_IN = 1,
+  SEC_W_RESERVOIR = 2,
+  SEC_COL_INDICES = 3,
+  SEC_ROW_PTR = 4,
+  SEC_W_OUT = 5,
+  SEC_STATE = 6,
+  SEC_W_OUT_INDEX = 7,
+  SEC_W_OUT_VALUES = 8
+};
+
+#define FILE_FORMAT_DENSE 1    /**< Última versión sin W_out escaso */
+#define FILE_FORMAT_SPARSE 2   /**< Última versión sin dinámica */
+#define FILE_HEADER_SIZE_V3 72 /**< Cabecera con radio y fuga */
+
+#if AEON_USE_FIXED_POINT
+#define FILE_WEIGHT_FORMAT AEON_FILE_WEIGHTS_Q8_8
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F16
+#define FILE_WEIGHT_FORMAT AEON_FILE_WEIGHTS_F16
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_BF16
+#define FILE_WEIGHT_FORMAT AEON_FILE_WEIGHTS_BF16
+#else
+#define FILE_WEIGHT_FORMAT AEON_FILE_WEIGHTS_F32
+#endif
+
+#define FILE_FLAG_TRAINED 0x01
+#define FILE_FLAG_PROCEDURAL 0x02 /**< Reservoir procedural (sin pesos) */
+
+/** Cabecera decodificada */
+typedef struct {
+  uint16_t format_version;
+  uint16_t lib_version;
+  aeon_config_t config;
+  uint8_t weight_format;
+  uint8_t flags;
+  uint32_t seed;
+  uint32_t sparse_count;
+  uint32_t section_count;
+  int64_t birth_time;
+  aeon_hash_t birth_hash;
+  uint32_t samples_processed;
+  uint32_t learning_sessions;
+} file_header_t;
+
+typedef struct {
+  uint32_t id;
+  uint32_t offset;
+  uint32_t size;
+  uint32_t crc;
+} file_section_t;
+
+/** Origen de lectura: archivo abierto o memoria proyectada */
+typedef struct {
+  FILE *f;
+  const uint8_t *mem;
+  size_t size;
+} model_src_t;
+
+/* ============================================================
+ * CODIFICACIÓN PORTABLE
+ * ============================================================ */
+
+static bool host_is_le(void) {
+  const uint16_t probe = 1;
+  return *(const uint8_t *)&probe == 1;
+}
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p) {
+  return (uint32_t)get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+/** float como su patrón IEEE 754 en u32 */
+static void put_float(uint8_t *p, float v) {
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  put32(p, bits);
+}
+
+static float get_float(const uint8_t *p) {
+  uint32_t bits = get32(p);
+  float v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+/** Invierte el orden de bytes de count elementos de elem bytes */
+static void swap_elements(void *data, size_t elem, size_t count) {
+  uint8_t *p = data;
+  for (size_t i = 0; i < count; i++, p += elem) {
+    for (size_t a = 0, b = elem - 1; a < b; a++, b--) {
+      uint8_t t = p[a];
+      p[a] = p[b];
+      p[b] = t;
+    }
+  }
+}
+
+/** CRC-32 (IEEE 802.3) con tabla de 16 entradas */
+static uint32_t crc32_update(uint32_t crc, const void *data, size_t len) {
+  static const uint32_t table[16] = {
+      0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+      0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+      0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+  const uint8_t *p = data;
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc = table[(crc ^ p[i]) & 0x0F] ^ (crc >> 4);
+    crc = table[(crc ^ (p[i] >> 4)) & 0x0F] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+uint32_t aeon_k_crc32(uint32_t crc, const void *data, size_t len) {
+  return crc32_update(crc, data, len);
+}
+
+static uint32_t align_up(uint32_t off) {
+  return (off + FILE_ALIGN - 1) & ~(uint32_t)(FILE_ALIGN - 1);
+}
+
+/* ============================================================
+ * ESCRITURA
+ * ============================================================ */
+
+/** Sección a escribir */
+typedef struct {
+  uint32_t id;
+  const void *data;
+  size_t elem; /**< Bytes por elemento (para el orden de bytes) */
+  size_t count;
+  /* Sección escasa: índices o valores de los no nulos de nonzero_of */
+  const aeon_weight_t *nonzero_of;
+  size_t source_count; /**< Elementos de nonzero_of */
+} out_section_t;
+
+/** Bytes por índice plano de W_out escaso */
+static size_t sparse_index_size(size_t n_weights) {
+  return n_weights <= 0x10000 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+/** Escribe un array en little-endian y acumula su CRC */
+static int write_array(FILE *f, const out_section_t *s, uint32_t *crc) {
+  const uint8_t *p = s->data;
+  size_t bytes = s->elem * s->count;
+  *crc = 0;
+
+  if (host_is_le()) {
+    *crc = crc32_update(0, p, bytes);
+    return fwrite(p, 1, bytes, f) == bytes ? 0 : -3;
+  }
+
+  uint8_t chunk[256];
+  size_t step = sizeof(chunk) / s->elem * s->elem;
+  for (size_t done = 0; done < bytes; done += step) {
+    size_t n = bytes - done < step ? bytes - done : step;
+    memcpy(chunk, p + done, n);
+    swap_elements(chunk, s->elem, n / s->elem);
+    *crc = crc32_update(*crc, chunk, n);
+    if (fwrite(chunk, 1, n, f) != n)
+      return -3;
+  }
+  return 0;
+}
+
+/** Escribe índices o valores de los pesos no nulos, por trozos */
+static int write_nonzero(FILE *f, const out_section_t *s, uint32_t *crc) {
+  uint8_t chunk[256];
+  size_t used = 0;
+  *crc = 0;
+
+  for (size_t i = 0; i < s->source_count; i++) {
+    aeon_weight_t w = s->nonzero_of[i];
+    if (aeon_k_weight(w) == 0)
+      continue;
+    if (s->id == SEC_W_OUT_INDEX) {
+      if (s->elem == sizeof(uint16_t))
+        put16(chunk + used, (uint16_t)i);
+      else
+        put32(chunk + used, (uint32_t)i);
+    } else {
+      memcpy(chunk + used, &w, sizeof(w));
+      if (!host_is_le())
+        swap_elements(chunk + used, sizeof(w), 1);
+    }
+    used += s->elem;
+    if (used + s->elem > sizeof(chunk)) {
+      *crc = crc32_update(*crc, chunk, used);
+      if (fwrite(chunk, 1, used, f) != used)
+        return -3;
+      used = 0;
+    }
+  }
+  if (used > 0) {
+    *crc = crc32_update(*crc, chunk, used);
+    if (fwrite(chunk, 1, used, f) != used)
+      return -3;
+  }
+  return 0;
+}
+
+static int write_model(const char *filename, const aeon_certificate_t *cert,
+                       const aeon_view_t *v, uint32_t sparse_count,
+                       uint32_t samples, uint32_t sessions, bool trained,
+                       float leak_rate, uint32_t sections) {
+  if (filename == NULL)
+    return -1;
+  if (v->procedural)
+    sections &= ~(uint32_t)(AEON_SECTION_W_IN | AEON_SECTION_RESERVOIR);
+
+  out_section_t out[FILE_MAX_SECTIONS];
+  uint32_t n_out = 0;
+  uint32_t n = v->n_res;
+
+  if (sections & AEON_SECTION_W_IN) {
+    out[n_out++] = (out_section_t){SEC_W_IN, v->W_in, sizeof(aeon_weight_t),
+                                   (size_t)n * v->n_in, NULL, 0};
+  }
+  if (sections & AEON_SECTION_RESERVOIR) {
+    out[n_out++] = (out_section_t){SEC_W_RESERVOIR, v->W_reservoir,
+                                   sizeof(aeon_weight_t), sparse_count, NULL,
+                                   0};
+    out[n_out++] = (out_section_t){SEC_COL_INDICES, v->col_indices,
+                                   sizeof(uint16_t), sparse_count, NULL, 0};
+    out[n_out++] = (out_section_t){SEC_ROW_PTR, v->row_ptr, sizeof(uint32_t),
+                                   (size_t)n + 1, NULL, 0};
+  }
+  size_t n_weights = (size_t)v->n_out * n;
+  bool sparse_out = (sections & AEON_SECTION_W_OUT_SPARSE) != 0;
+  if (sparse_out) {
+    size_t nnz = 0;
+    for (size_t i = 0; i < n_weights; i++)
+      nnz += aeon_k_weight(v->W_out[i]) != 0;
+    out[n_out++] = (out_section_t){SEC_W_OUT_INDEX, NULL,
+                                   sparse_index_size(n_weights), nnz,
+                                   v->W_out, n_weights};
+    out[n_out++] = (out_section_t){SEC_W_OUT_VALUES, NULL,
+                                   sizeof(aeon_weight_t), nnz, v->W_out,
+                                   n_weights};
+  } else if (sections & AEON_SECTION_W_OUT) {
+    out[n_out++] = (out_section_t){SEC_W_OUT, v->W_out, sizeof(aeon_weight_t),
+                                   n_weights, NULL, 0};
+  }
+  if (sections & AEON_SECTION_STATE) {
+    out[n_out++] =
+        (out_section_t){SEC_STATE, v->state, sizeof(aeon_state_t), n, NULL, 0};
+  }
+
+  /* Cabecera: la versión más antigua que describe el archivo */
+  bool dynamics = v->spectral_radius != 0.0f ||
+                  aeon_k_leak(leak_rate) < aeon_k_fraction(1.0f);
+  uint16_t version = dynamics     ? AEON_FILE_FORMAT_VERSION
+                     : sparse_out ? FILE_FORMAT_SPARSE
+                                  : FILE_FORMAT_DENSE;
+  uint32_t header_size = dynamics ? FILE_HEADER_SIZE_V3 : FILE_HEADER_SIZE;
+  uint8_t header[FILE_HEADER_SIZE_V3];
+  memset(header, 0, sizeof(header));
+  memcpy(header, FILE_MAGIC, 4);
+  put16(header + 4, version);
+  put16(header + 6, (uint16_t)header_size);
+  put16(header + 8, AEON_VERSION);
+  put16(header + 10, v->n_res);
+  put16(header + 12, v->n_in);
+  put16(header + 14, v->n_out);
+  put16(header + 16, v->sparsity);
+  header[18] = FILE_WEIGHT_FORMAT;
+  header[19] = (uint8_t)((trained ? FILE_FLAG_TRAINED : 0) |
+                         (v->procedural ? FILE_FLAG_PROCEDURAL : 0));
+  put32(header + 20, cert->reservoir_seed);
+  put32(header + 24, sparse_count);
+  put32(header + 28, n_out);
+  uint64_t birth = (uint64_t)(int64_t)cert->birth_time;
+  put32(header + 32, (uint32_t)birth);
+  put32(header + 36, (uint32_t)(birth >> 32));
+  memcpy(header + 40, cert->birth_hash.bytes, 16);
+  put32(header + 56, samples);
+  put32(header + 60, sessions);
+  put_float(header + 64, v->spectral_radius);
+  put_float(header + 68, leak_rate);
+
+  /* Tabla (los CRC se rellenan al escribir cada sección) */
+  uint8_t table[FILE_MAX_SECTIONS * FILE_ENTRY_SIZE];
+  uint32_t offset = header_size + n_out * FILE_ENTRY_SIZE;
+  for (uint32_t i = 0; i < n_out; i++) {
+    uint8_t *e = table + i * FILE_ENTRY_SIZE;
+    uint32_t bytes = (uint32_t)(out[i].elem * out[i].count);
+    /* Las escasas nunca se proyectan: basta alinear a 4 */
+    offset = out[i].nonzero_of != NULL ? (offset + 3) & ~(uint32_t)3
+                                       : align_up(offset);
+    put32(e, out[i].id);
+    put32(e + 4, offset);
+    put32(e + 8, bytes);
+    put32(e + 12, 0);
+    offset += bytes;
+  }
+
+  FILE *f = fopen(filename, "wb");
+  if (f == NULL)
+    return -2;
+
+  int err = 0;
+  uint32_t pos = header_size + n_out * FILE_ENTRY_SIZE;
+  if (fwrite(header, 1, header_size, f) != header_size ||
+      fwrite(table, 1, n_out * FILE_ENTRY_SIZE, f) != n_out * FILE_ENTRY_SIZE)
+    err = -3;
+
+  static const uint8_t zeros[FILE_ALIGN] = {0};
+  for (uint32_t i = 0; i < n_out && err == 0; i++) {
+    uint8_t *e = table + i * FILE_ENTRY_SIZE;
+    uint32_t start = get32(e + 4);
+    uint32_t crc;
+    if (fwrite(zeros, 1, start - pos, f) != start - pos) {
+      err = -3;
+      break;
+    }
+    err = out[i].nonzero_of != NULL ? write_nonzero(f, &out[i], &crc)
+                                    : write_array(f, &out[i], &crc);
+    put32(e + 12, crc);
+    pos = start + get32(e + 8);
+  }
+
+  /* Reescribir la tabla con los CRC */
+  if (err == 0 && (fseek(f, (long)header_size, SEEK_SET) != 0 ||
+                   fwrite(table, 1, n_out * FILE_ENTRY_SIZE, f) !=
+                       n_out * FILE_ENTRY_SIZE))
+    err = -3;
+
+  if (fclose(f) != 0 && err == 0)
+    err = -3;
+  return err;
+}
+
+/* ============================================================
+ * LECTURA Y VALIDACIÓN
+ * ============================================================ */
+
+static int src_read(const model_src_t *s, uint32_t offset, void *dst,
+                    size_t bytes) {
+  if ((size_t)offset + bytes > s->size)
+    return -4;
+  if (s->mem != NULL) {
+    memcpy(dst, s->mem + offset, bytes);
+    return 0;
+  }
+  if (fseek(s->f, (long)offset, SEEK_SET) != 0 ||
+      fread(dst, 1, bytes, s->f) != bytes)
+    return -3;
+  return 0;
+}
+
+/** Lee y valida cabecera y tabla de secciones */
+static int parse_model(const model_src_t *s, file_header_t *h,
+                       file_section_t *table) {
+  uint8_t b[FILE_HEADER_SIZE];
+  int err = src_read(s, 0, b, sizeof(b));
+  if (err != 0)
+    return err == -3 ? -3 : -4;
+  if (memcmp(b, FILE_MAGIC, 4) != 0)
+    return -4;
+
+  h->format_version = get16(b + 4);
+  h->lib_version = get16(b + 8);
+  if (h->format_version < FILE_FORMAT_DENSE ||
+      h->format_version > AEON_FILE_FORMAT_VERSION ||
+      (h->lib_version >> 8) != AEON_VERSION_MAJOR)
+    return -6;
+
+  uint16_t header_size = get16(b + 6);
+  h->config.reservoir_size = get16(b + 10);
+  h->config.input_size = get16(b + 12);
+  h->config.output_size = get16(b + 14);
+  h->config.sparsity_factor = get16(b + 16);
+  h->weight_format = b[18];
+  h->flags = b[19];
+  h->seed = get32(b + 20);
+  h->sparse_count = get32(b + 24);
+  h->section_count = get32(b + 28);
+  h->birth_time =
+      (int64_t)((uint64_t)get32(b + 32) | ((uint64_t)get32(b + 36) << 32));
+  memcpy(h->birth_hash.bytes, b + 40, 16);
+  h->samples_processed = get32(b + 56);
+  h->learning_sessions = get32(b + 60);
+
+  if (header_size < FILE_HEADER_SIZE || h->section_count > FILE_MAX_SECTIONS)
+    return -4;
+
+  /* Antes de la versión 3: pesos crudos y sin fuga */
+  h->config.spectral_radius = 0.0f;
+  h->config.leak_rate = 1.0f;
+  if (h->format_version > FILE_FORMAT_SPARSE) {
+    uint8_t d[FILE_HEADER_SIZE_V3 - FILE_HEADER_SIZE];
+    if (header_size < FILE_HEADER_SIZE_V3)
+      return -4;
+    err = src_read(s, FILE_HEADER_SIZE, d, sizeof(d));
+    if (err != 0)
+      return err == -3 ? -3 : -4;
+    h->config.spectral_radius = get_float(d);
+    h->config.leak_rate = get_float(d + 4);
+    if (!(h->config.spectral_radius >= 0.0f) ||
+        !(h->config.spectral_radius < 1e6f) ||
+        !(h->config.leak_rate >= 0.0f) || !(h->config.leak_rate <= 1.0f))
+      return -4;
+  }
+  if (h->weight_format != FILE_WEIGHT_FORMAT)
+    return -5;
+  if (h->config.reservoir_size == 0 || h->config.input_size == 0 ||
+      h->config.output_size == 0 || h->config.sparsity_factor == 0)
+    return -4;
+
+  uint8_t t[FILE_MAX_SECTIONS * FILE_ENTRY_SIZE];
+  err = src_read(s, header_size, t, h->section_count * FILE_ENTRY_SIZE);
+  if (err != 0)
+    return err == -3 ? -3 : -4;
+
+  for (uint32_t i = 0; i < h->section_count; i++) {
+    const uint8_t *e = t + i * FILE_ENTRY_SIZE;
+    table[i].id = get32(e);
+    table[i].offset = get32(e + 4);
+    table[i].size = get32(e + 8);
+    table[i].crc = get32(e + 12);
+    if ((uint64_t)table[i].offset + table[i].size > s->size ||
+        table[i].offset % sizeof(uint32_t) != 0)
+      return -4;
+  }
+  return 0;
+}
+
+/**
+ * @brief Busca una sección y comprueba su tamaño
+ *
+ * @param bytes Tamaño esperado (SIZE_MAX = cualquiera)
+ * @return Sección, NULL si no está; *err = -4 si está con otro tamaño
+ */
+static const file_section_t *find_section(const file_header_t *h,
+                                          const file_section_t *table,
+                                          uint32_t id, size_t bytes,
+                                          int *err) {
+  for (uint32_t i = 0; i < h->section_count; i++) {
+    if (table[i].id == id) {
+      if (bytes != SIZE_MAX && table[i].size != bytes)
+        *err = -4;
+      return &table[i];
+    }
+  }
+  return NULL;
+}
+
+/** Lee una sección en dst, verifica el CRC y la pasa al orden del host */
+static int read_section(const model_src_t *s, const file_section_t *sec,
+                        void *dst, size_t elem) {
+  int err = src_read(s, sec->offset, dst, sec->size);
+  if (err != 0)
+    return err;
+  if (crc32_update(0, dst, sec->size) != sec->crc)
+    return -7;
+  if (!host_is_le())
+    swap_elements(dst, elem, sec->size / elem);
+  return 0;
+}
+
+/**
+ * Comprueba que row_ptr/col_indices describen un CSR válido: filas en
+ * orden y columnas de cada fila estrictamente crecientes, como las deja
+ * aeon_k_generate (una columna repetida sumaría su peso dos veces)
+ */
+static bool csr_valid(const uint32_t *row_ptr, const uint16_t *col_indices,
+                      uint16_t n, uint32_t nnz) {
+  if (row_ptr[0] != 0 || row_ptr[n] != nnz)
+    return false;
+  for (uint32_t i = 0; i < n; i++) {
+    if (row_ptr[i + 1] < row_ptr[i])
+      return false;
+    for (uint32_t k = row_ptr[i]; k < row_ptr[i + 1]; k++) {
+      if (col_indices[k] >= n ||
+          (k > row_ptr[i] && col_indices[k] <= col_indices[k - 1]))
+        return false;
+    }
+  }
+  return true;
+}
+
+/** Secciones de un modelo ya validado */
+typedef struct {
+  const file_section_t *w_in;
+  const file_section_t *w_res;
+  const file_section_t *col;
+  const file_section_t *row;
+  const file_section_t *w_out;
+  const file_section_t *out_index;  /**< W_out escaso (con out_values) */
+  const file_section_t *out_values;
+  const file_section_t *state;
+} model_sections_t;
+
+static int locate_sections(const file_header_t *h, const file_section_t *t,
+                           model_sections_t *m) {
+  int err = 0;
+  size_t n = h->config.reservoir_size;
+  size_t nnz = h->sparse_count;
+
+  m->w_in = find_section(h, t, SEC_W_IN,
+                         n * h->config.input_size * sizeof(aeon_weight_t), &err);
+  m->w_res =
+      find_section(h, t, SEC_W_RESERVOIR, nnz * sizeof(aeon_weight_t), &err);
+  m->col = find_section(h, t, SEC_COL_INDICES, nnz * sizeof(uint16_t), &err);
+  m->row = find_section(h, t, SEC_ROW_PTR, (n + 1) * sizeof(uint32_t), &err);
+  m->w_out = find_section(
+      h, t, SEC_W_OUT, h->config.output_size * n * sizeof(aeon_weight_t), &err);
+  m->state = find_section(h, t, SEC_STATE, n * sizeof(aeon_state_t), &err);
+
+  /* W_out escaso: tamaño libre, pero índices y valores emparejados */
+  size_t n_weights = h->config.output_size * n;
+  size_t index_size = sparse_index_size(n_weights);
+  m->out_index = find_section(h, t, SEC_W_OUT_INDEX, SIZE_MAX, &err);
+  m->out_values = find_section(h, t, SEC_W_OUT_VALUES, SIZE_MAX, &err);
+  if ((m->out_index != NULL) != (m->out_values != NULL) ||
+      (m->out_index != NULL && m->w_out != NULL))
+    err = -4;
+  if (m->out_index != NULL &&
+      (m->out_index->size % index_size != 0 ||
+       m->out_values->size % sizeof(aeon_weight_t) != 0 ||
+       m->out_index->size / index_size !=
+           m->out_values->size / sizeof(aeon_weight_t) ||
+       m->out_values->size / sizeof(aeon_weight_t) > n_weights))
+    err = -4;
+
+  /* El reservoir va completo o no va */
+  int parts = (m->w_res != NULL) + (m->col != NULL) + (m->row != NULL);
+  if (parts != 0 && parts != 3)
+    err = -4;
+  return err;
+}
+
+/** Índice k de un trozo de índices planos little-endian */
+static uint32_t sparse_index_at(const uint8_t *chunk, size_t index_size,
+                                size_t k) {
+  return index_size == sizeof(uint16_t) ? get16(chunk + 2 * k)
+                                        : get32(chunk + 4 * k);
+}
+
+/**
+ * @brief Expande W_out escaso en W_out denso
+ *
+ * Los valores se leen al principio de W_out y se esparcen de atrás
+ * hacia delante: como los índices son estrictamente crecientes, el
+ * k-ésimo va a una posición >= k y nunca pisa uno sin mover.
+ */
+static int read_sparse_out(const model_src_t *s, const model_sections_t *m,
+                           aeon_weight_t *W_out, size_t n_weights) {
+  size_t index_size = sparse_index_size(n_weights);
+  size_t nnz = m->out_values->size / sizeof(aeon_weight_t);
+  uint8_t chunk[256];
+  const size_t per_chunk = sizeof(chunk) / index_size;
+
+  int err = read_section(s, m->out_values, W_out, sizeof(aeon_weight_t));
+  if (err != 0)
+    return err;
+
+  /* Primera pasada: CRC y orden de los índices */
+  uint32_t crc = 0;
+  int64_t prev = -1;
+  for (size_t k = 0; k < nnz; k += per_chunk) {
+    size_t count = nnz - k < per_chunk ? nnz - k : per_chunk;
+    err = src_read(s, m->out_index->offset + (uint32_t)(k * index_size), chunk,
+                   count * index_size);
+    if (err != 0)
+      return err;
+    crc = crc32_update(crc, chunk, count * index_size);
+    for (size_t c = 0; c < count; c++) {
+      int64_t idx = sparse_index_at(chunk, index_size, c);
+      if (idx <= prev || idx >= (int64_t)n_weights)
+        return -7;
+      prev = idx;
+    }
+  }
+  if (crc != m->out_index->crc)
+    return -7;
+
+  /* Segunda pasada: esparcir desde el final */
+  const aeon_weight_t zero = aeon_weight_from_float(0.0f);
+  size_t next = n_weights; /* Posiciones >= next ya son definitivas */
+  for (size_t end = nnz; end > 0;) {
+    size_t count = end < per_chunk ? end : per_chunk;
+    size_t first = end - count;
+    err = src_read(s, m->out_index->offset + (uint32_t)(first * index_size),
+                   chunk, count * index_size);
+    if (err != 0)
+      return err;
+    for (size_t c = count; c-- > 0;) {
+      size_t k = first + c;
+      size_t idx = sparse_index_at(chunk, index_size, c);
+      aeon_weight_t w = W_out[k];
+      for (size_t p = idx + 1; p < next; p++)
+        W_out[p] = zero;
+      W_out[idx] = w;
+      next = idx;
+    }
+    end = first;
+  }
+  for (size_t p = 0; p < next; p++)
+    W_out[p] = zero;
+  return 0;
+}
+
+/**
+ * @brief Rellena una vista (arrays a cero) desde el archivo
+ *
+ * @param seen Bitset para regenerar desde la semilla (NULL si el
+ *             archivo trae W_in y el reservoir, o si es procedural)
+ */
+static int load_view(const model_src_t *s, const file_header_t *h,
+                     const model_sections_t *m, const aeon_view_t *v,
+                     uint32_t *seen) {
+  int err = 0;
+
+  if (!v->procedural && (m->w_in == NULL || m->w_res == NULL)) {
+    if (seen == NULL)
+      return -3;
+    if (aeon_k_generate(v, h->seed, seen) != h->sparse_count)
+      return -7; /* La semilla no reproduce el reservoir guardado */
+  }
+
+  if (err == 0 && m->w_in != NULL)
+    err = read_section(s, m->w_in, v->W_in, sizeof(aeon_weight_t));
+  if (err == 0 && m->w_res != NULL) {
+    err = read_section(s, m->w_res, v->W_reservoir, sizeof(aeon_weight_t));
+    if (err == 0)
+      err = read_section(s, m->col, v->col_indices, sizeof(uint16_t));
+    if (err == 0)
+      err = read_section(s, m->row, v->row_ptr, sizeof(uint32_t));
+    if (err == 0 &&
+        !csr_valid(v->row_ptr, v->col_indices, v->n_res, h->sparse_count))
+      err = -7;
+  }
+  if (err == 0 && m->w_out != NULL)
+    err = read_section(s, m->w_out, v->W_out, sizeof(aeon_weight_t));
+  if (err == 0 && m->out_index != NULL)
+    err = read_sparse_out(s, m, v->W_out, (size_t)v->n_out * v->n_res);
+  if (err == 0 && m->state != NULL)
+    err = read_section(s, m->state, v->state, sizeof(aeon_state_t));
+  return err;
+}
+
+static void header_to_certificate(const file_header_t *h,
+                                  aeon_certificate_t *cert) {
+  cert->birth_time = (time_t)h->birth_time;
+  cert->birth_hash = h->birth_hash;
+  cert->reservoir_seed = h->seed;
+  cert->reservoir_size = h->config.reservoir_size;
+  cert->version = h->lib_version;
+}
+
+/** Abre un archivo como origen de lectura */
+static int open_src(model_src_t *s, const char *filename) {
+  s->mem = NULL;
+  s->f = fopen(filename, "rb");
+  if (s->f == NULL)
+    return -2;
+  if (fseek(s->f, 0, SEEK_END) != 0) {
+    fclose(s->f);
+    return -3;
+  }
+  long size = ftell(s->f);
+  if (size < 0) {
+    fclose(s->f);
+    return -3;
+  }
+  s->size = (size_t)size;
+  return 0;
+}
+
+/* ============================================================
+ * NÚCLEO ESTÁTICO
+ * ============================================================ */
+
+/** Vista sobre las arrays del núcleo estático (const en guardado) */
+static aeon_view_t static_file_view(const aeon_core_t *core) {
+  aeon_view_t v;
+  v.n_res = AEON_RESERVOIR_SIZE;
+  v.n_in = AEON_INPUT_SIZE;
+  v.n_out = AEON_OUTPUT_SIZE;
+  v.sparsity = AEON_SPARSITY_FACTOR;
+  v.state = (aeon_state_t *)core->state;
+  v.scratch = NULL;
+  v.W_in = (aeon_weight_t *)core->W_in;
+  v.W_reservoir = (aeon_weight_t *)core->W_reservoir;
+  v.W_out = (aeon_weight_t *)core->W_out;
+  v.col_indices = (uint16_t *)core->col_indices;
+  v.row_ptr = (uint32_t *)core->row_ptr;
+  v.procedural = false;
+  v.seed = core->certificate.reservoir_seed;
+  v.spectral_radius = core->spectral_radius;
+  v.leak = aeon_k_leak(core->leak_rate);
+  v.gain = aeon_k_fraction(1.0f);
+  return v;
+}
+
+int aeon_save(const aeon_core_t *core, const char *filename) {
+  return aeon_save_sections(core, filename, AEON_SECTION_ALL);
+}
+
+int aeon_save_sections(const aeon_core_t *core, const char *filename,
+                       uint32_t sections) {
+  if (core == NULL)
+    return -1;
+  aeon_view_t v = static_file_view(core);
+  return write_model(filename, &core->certificate, &v, core->sparse_count,
+                     core->samples_processed, core->learning_sessions,
+                     core->is_trained, core->leak_rate, sections);
+}
+
+int aeon_load(aeon_core_t *core, const char *filename) {
+  if (core == NULL || filename == NULL)
+    return -1;
+
+  model_src_t s;
+  int err = open_src(&s, filename);
+  if (err != 0)
+    return err;
+
+  file_header_t h;
+  file_section_t table[FILE_MAX_SECTIONS];
+  model_sections_t m;
+  err = parse_model(&s, &h, table);
+  if (err == 0)
+    err = locate_sections(&h, table, &m);
+
+  /* Debe caber en la forma de compilación (y tener pesos guardables) */
+  if (err == 0 &&
+      ((h.flags & FILE_FLAG_PROCEDURAL) ||
+       h.config.reservoir_size != AEON_RESERVOIR_SIZE ||
+       h.config.input_size != AEON_INPUT_SIZE ||
+       h.config.output_size != AEON_OUTPUT_SIZE ||
+       h.sparse_count > AEON_SPARSE_CAPACITY ||
+       (m.w_res == NULL && h.config.sparsity_factor != AEON_SPARSITY_FACTOR)))
+    err = -5;
+
+  /* Se lee en un núcleo temporal: si el archivo falla a medias, core
+   * sigue como estaba */
+  aeon_core_t *tmp = NULL;
+  if (err == 0) {
+    tmp = malloc(sizeof(aeon_core_t));
+    if (tmp == NULL)
+      err = -3;
+  }
+  if (err == 0) {
+    uint32_t seen[AEON_GENERATE_WORK_WORDS(AEON_RESERVOIR_SIZE)];
+    aeon_state_t scratch[AEON_RESERVOIR_SIZE];
+    memset(tmp, 0, sizeof(aeon_core_t));
+    tmp->spectral_radius = h.config.spectral_radius;
+    tmp->leak_rate = h.config.leak_rate;
+    aeon_view_t v = static_file_view(tmp);
+    v.scratch = scratch;
+    err = load_view(&s, &h, &m, &v, seen);
+  }
+  fclose(s.f);
+
+  if (err != 0) {
+    free(tmp);
+    return err;
+  }
+
+  header_to_certificate(&h, &tmp->certificate);
+  tmp->sparse_count = h.sparse_count;
+  tmp->samples_processed = h.samples_processed;
+  tmp->learning_sessions = h.learning_sessions;
+  tmp->is_trained = (h.flags & FILE_FLAG_TRAINED) != 0;
+  if (m.out_index != NULL)
+    aeon_prune(tmp, 0.0f); /* Umbral 0: solo compacta */
+  memcpy(core, tmp, sizeof(aeon_core_t));
+  free(tmp);
+  return 0;
+}
+
+/* ============================================================
+ * NÚCLEO EN TIEMPO DE EJECUCIÓN
+ * ============================================================ */
+
+static aeon_view_t dyn_file_view(const aeon_dyn_core_t *core) {
+  aeon_view_t v;
+  v.n_res = core->config.reservoir_size;
+  v.n_in = core->config.input_size;
+  v.n_out = core->config.output_size;
+  v.sparsity = core->config.sparsity_factor;
+  v.state = core->state;
+  v.scratch = core->scratch;
+  v.W_in = core->W_in;
+  v.W_reservoir = core->W_reservoir;
+  v.W_out = core->W_out;
+  v.col_indices = core->col_indices;
+  v.row_ptr = core->row_ptr;
+  v.procedural = core->procedural;
+  v.seed = core->certificate.reservoir_seed;
+  v.spectral_radius = core->config.spectral_radius;
+  v.leak = aeon_k_leak(core->config.leak_rate);
+  v.gain = core->reservoir_gain;
+  return v;
+}
+
+static void header_to_dyn(const file_header_t *h, aeon_dyn_core_t *core) {
+  header_to_certificate(h, &core->certificate);
+  core->sparse_count = h->sparse_count;
+  core->samples_processed = h->samples_processed;
+  core->learning_sessions = h->learning_sessions;
+  core->is_trained = (h->flags & FILE_FLAG_TRAINED) != 0;
+}
+
+int aeon_core_save(const aeon_dyn_core_t *core, const char *filename,
+                   uint32_t sections) {
+  if (core == NULL)
+    return -1;
+  aeon_view_t v = dyn_file_view(core);
+  return write_model(filename, &core->certificate, &v, core->sparse_count,
+                     core->samples_processed, core->learning_sessions,
+                     core->is_trained, core->config.leak_rate, sections);
+}
+
+aeon_dyn_core_t *aeon_core_load(const char *filename,
+                                const aeon_allocator_t *allocator, int *error) {
+  int err_local;
+  int *err = error != NULL ? error : &err_local;
+  if (filename == NULL) {
+    *err = -1;
+    return NULL;
+  }
+
+  model_src_t s;
+  *err = open_src(&s, filename);
+  if (*err != 0)
+    return NULL;
+
+  file_header_t h;
+  file_section_t table[FILE_MAX_SECTIONS];
+  model_sections_t m;
+  aeon_dyn_core_t *core = NULL;
+  uint32_t *seen = NULL;
+
+  *err = parse_model(&s, &h, table);
+  if (*err == 0)
+    *err = locate_sections(&h, table, &m);
+
+  bool procedural = (h.flags & FILE_FLAG_PROCEDURAL) != 0;
+  uint32_t nnz_expected =
+      procedural ? (uint32_t)h.config.reservoir_size *
+                       aeon_k_proc_fan_in(h.config.reservoir_size,
+                                          h.config.sparsity_factor)
+                 : (uint32_t)h.config.reservoir_size *
+                       h.config.reservoir_size / h.config.sparsity_factor;
+  if (*err == 0 && (procedural ? h.sparse_count != nnz_expected
+                               : h.sparse_count > nnz_expected))
+    *err = -4;
+  if (*err == 0 && procedural)
+    m.w_in = m.w_res = m.col = m.row = NULL; /* No hay dónde ponerlos */
+
+  if (*err == 0) {
+    core = procedural ? aeon_core_create_procedural(&h.config, allocator)
+                      : aeon_core_create(&h.config, allocator);
+    if (core == NULL)
+      *err = -3;
+  }
+  if (*err == 0 && !procedural && (m.w_in == NULL || m.w_res == NULL)) {
+    size_t bytes =
+        AEON_GENERATE_WORK_WORDS(h.config.reservoir_size) * sizeof(uint32_t);
+    seen = core->allocator.alloc(bytes, AEON_CACHE_LINE, core->allocator.ctx);
+    if (seen == NULL)
+      *err = -3;
+  }
+  if (*err == 0) {
+    aeon_view_t v = dyn_file_view(core);
+    v.seed = h.seed;
+    if (procedural) /* Antes de leer el estado: usa state y scratch */
+      core->reservoir_gain = v.gain = aeon_k_proc_gain(&v);
+    *err = load_view(&s, &h, &m, &v, seen);
+  }
+  fclose(s.f);
+
+  if (seen != NULL && core->allocator.free != NULL)
+    core->allocator.free(seen, core->allocator.ctx);
+  if (*err != 0) {
+    aeon_core_destroy(core);
+    return NULL;
+  }
+
+  header_to_dyn(&h, core);
+  return core;
+}
+
+/* ============================================================
+ * PROYECCIÓN EN MEMORIA (SIN COPIA)
+ * ============================================================ */
+
+void aeon_k_unmap(const void *mapping, size_t size) {
+#if AEON_HAVE_MMAP
+  if (mapping != NULL)
+    munmap((void *)mapping, size);
+#else
+  (void)mapping;
+  (void)size;
+#endif
+}
+
+aeon_dyn_core_t *aeon_core_map(const char *filename,
+                               const aeon_allocator_t *allocator, int *error) {
+#if AEON_HAVE_MMAP
+  int err_local;
+  int *err = error != NULL ? error : &err_local;
+  if (filename == NULL) {
+    *err = -1;
+    return NULL;
+  }
+  if (!host_is_le()) /* Los arrays en disco son little-endian */
+    return aeon_core_load(filename, allocator, error);
+
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    *err = -2;
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < FILE_HEADER_SIZE) {
+    close(fd);
+    *err = -4;
+    return NULL;
+  }
+  size_t size = (size_t)st.st_size;
+  void *mem = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED) {
+    *err = -3;
+    return NULL;
+  }
+
+  model_src_t s = {NULL, mem, size};
+  file_header_t h;
+  file_section_t table[FILE_MAX_SECTIONS];
+  model_sections_t m;
+  *err = parse_model(&s, &h, table);
+  if (*err == 0)
+    *err = locate_sections(&h, table, &m);
+
+  /* Sin pesos completos no hay nada que usar en sitio: regenerar */
+  if (*err == 0 && (m.w_in == NULL || m.w_res == NULL || m.w_out == NULL)) {
+    munmap(mem, size);
+    return aeon_core_load(filename, allocator, error);
+  }
+
+  /* Sin cabecera o tabla válidas `m` no está inicializado: salir ya */
+  if (*err != 0) {
+    munmap(mem, size);
+    return NULL;
+  }
+
+  const uint8_t *base = mem;
+  const uint32_t *row_ptr = (const uint32_t *)(const void *)(base + m.row->offset);
+  const uint16_t *col = (const uint16_t *)(const void *)(base + m.col->offset);
+  if (!csr_valid(row_ptr, col, h.config.reservoir_size, h.sparse_count)) {
+    munmap(mem, size);
+    *err = -7;
+    return NULL;
+  }
+
+  /* Arena solo con lo mutable: cabecera, estado y scratch */
+  if (allocator == NULL)
+    allocator = aeon_k_default_allocator();
+  size_t n = h.config.reservoir_size;
+  size_t header = aeon_k_align(sizeof(aeon_dyn_core_t));
+  size_t block = aeon_k_align(n * sizeof(aeon_state_t));
+  size_t total = header + 2 * block;
+  uint8_t *arena = allocator->alloc != NULL
+                       ? allocator->alloc(total, AEON_CACHE_LINE, allocator->ctx)
+                       : NULL;
+  if (arena == NULL) {
+    munmap(mem, size);
+    *err = -3;
+    return NULL;
+  }
+  memset(arena, 0, total);
+
+  aeon_dyn_core_t *core = (aeon_dyn_core_t *)(void *)arena;
+  core->config = h.config;
+  core->state = (aeon_state_t *)(void *)(arena + header);
+  core->scratch = (aeon_state_t *)(void *)(arena + header + block);
+  core->W_in = (aeon_weight_t *)(void *)(base + m.w_in->offset);
+  core->W_reservoir = (aeon_weight_t *)(void *)(base + m.w_res->offset);
+  core->W_out = (aeon_weight_t *)(void *)(base + m.w_out->offset);
+  core->col_indices = (uint16_t *)(void *)(base + m.col->offset);
+  core->row_ptr = (uint32_t *)(void *)(base + m.row->offset);
+  core->reservoir_gain = aeon_k_fraction(1.0f);
+  core->allocator = *allocator;
+  core->arena_size = total;
+  core->mapping = mem;
+  core->mapping_size = size;
+  header_to_dyn(&h, core);
+
+  if (m.state != NULL)
+    memcpy(core->state, base + m.state->offset, m.state->size);
+
+  *err = 0;
+  return core;
+#else
+  return aeon_core_load(filename, allocator, error);
+#endif
+}
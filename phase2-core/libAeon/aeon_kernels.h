@@ -0,0 +1,838 @@
+/**
+ * @file aeon_kernels.h
+ * @brief Proyecto Eón - Kernels internos compartidos (uso interno)
+ *
+ * Bucles calientes parametrizados por dimensiones. El núcleo estático
+ * (aeon_core_t) los invoca con las constantes de compilación, de modo
+ * que el compilador los especializa; el núcleo dimensionado en tiempo
+ * de ejecución (aeon_dyn_core_t) los invoca con su configuración.
+ *
+ * Este header no forma parte de la API pública.
+ */
+
+#ifndef AEON_KERNELS_H
+#define AEON_KERNELS_H
+
+#include "libAeon.h"
+#include <math.h>
+
+/* restrict de C99 (también disponible al compilar como C++) */
+#ifdef __cplusplus
+#define AEON_RESTRICT __restrict
+#else
+#define AEON_RESTRICT restrict
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Vista de un núcleo: punteros a sus arrays y dimensiones */
+typedef struct {
+  uint16_t n_res;              /**< Neuronas del reservoir */
+  uint16_t n_in;               /**< Entradas */
+  uint16_t n_out;              /**< Salidas */
+  uint16_t sparsity;           /**< Factor de escasez */
+  aeon_state_t *state;         /**< Estado (n_res) */
+  aeon_state_t *scratch;       /**< Buffer temporal (n_res) */
+  aeon_weight_t *W_in;         /**< n_res * n_in */
+  aeon_weight_t *W_reservoir;  /**< Pesos CSR */
+  aeon_weight_t *W_out;        /**< n_out * n_res */
+  uint16_t *col_indices;       /**< Columnas CSR */
+  uint32_t *row_ptr;           /**< Punteros de fila CSR (n_res + 1) */
+  bool procedural;             /**< Pesos regenerados desde seed */
+  uint32_t seed;               /**< Semilla efectiva (modo procedural) */
+  float spectral_radius;       /**< Radio objetivo al generar (0 = crudo) */
+  aeon_state_t leak;           /**< Fuga en escala de estado (aeon_k_leak) */
+  aeon_state_t gain;           /**< Escala de los pesos procedurales */
+} aeon_view_t;
+
+/** Fracción en escala de estado (Q8.8 o float) */
+static inline aeon_state_t aeon_k_fraction(float x) {
+#if AEON_USE_FIXED_POINT
+  return (aeon_state_t)lrintf(x * AEON_SCALE);
+#else
+  return x;
+#endif
+}
+
+/** Fuga en escala de estado: 0 o >= 1 es sin fuga, mínimo 1/256 */
+static inline aeon_state_t aeon_k_leak(float rate) {
+  if (!(rate > 0.0f) || rate >= 1.0f)
+    return aeon_k_fraction(1.0f);
+  aeon_state_t leak = aeon_k_fraction(rate);
+  return leak > 0 ? leak : 1;
+}
+
+/* ============================================================
+ * KERNELS DEL CAMINO CALIENTE (inline)
+ *
+ * Convención de punto fijo: los productos Q8.8 x Q8.8 se acumulan
+ * exactos en 32 bits y se desplazan una sola vez por suma, igual que
+ * madd/SMLAD/vmlal en los backends SIMD (aeon_simd.c).
+ * ============================================================ */
+
+#if AEON_USE_FIXED_POINT
+/** Tabla de kernels Q8.8 de un backend SIMD */
+typedef struct {
+  const char *name;
+  /** Σ w[k] * x[k] sin desplazar (x en rango int16) */
+  int32_t (*dot)(const int16_t *w, const int32_t *x, uint32_t n);
+  /** acc[i] = Σ_j W_in[i * n_in + j] * input[j] sin desplazar */
+  void (*input_mac)(const int16_t *W_in, const int32_t *input,
+                    uint16_t n_res, uint16_t n_in, int32_t *acc);
+  /** out[i] = tanh(in[i]); in y out pueden coincidir */
+  void (*tanh)(const int32_t *in, int32_t *out, uint32_t n);
+} aeon_simd_ops_t;
+
+#else
+/** Tabla de kernels float de un backend (pesos f32, f16 o bf16) */
+typedef struct {
+  const char *name;
+  /** acc[i] = Σ_j W_in[i * n_in + j] * input[j] */
+  void (*input_mac)(const aeon_weight_t *W_in, const float *input,
+                    uint16_t n_res, uint16_t n_in, float *acc);
+  /** acc[i] += Σ w[k] * x[col[k]] sobre la fila i del CSR */
+  void (*csr_mac)(const uint32_t *row_ptr, const uint16_t *col,
+                  const aeon_weight_t *w, const float *x, uint16_t n_rows,
+                  float *acc);
+} aeon_simd_ops_t;
+#endif
+
+/** Backend activo (definido en aeon_simd.c) */
+const aeon_simd_ops_t *aeon_k_ops(void);
+
+/** Peso como operando de aeon_state_t: Q8.8 crudo o float ensanchado */
+static inline aeon_state_t aeon_k_weight(aeon_weight_t w) {
+#if AEON_USE_FIXED_POINT
+  return (aeon_state_t)w;
+#else
+  return aeon_weight_to_float(w);
+#endif
+}
+
+/* Constantes de la tanh Q8.8: |x3|, |x5| <= AEON_SCALE, por lo que
+ * (a * M) >> 16 reproduce exactamente a / 3 y a / 15. */
+#define AEON_TANH_DIV3_MAGIC 21846
+#define AEON_TANH_DIV15_MAGIC 4370
+
+/* Tabla de tanh en Q1.15: entrada k = tanh(k / 64), k = 0..256 */
+#define AEON_TANH_LUT_SIZE 256
+#define AEON_TANH_LUT_STEPS 64 /**< Entradas por unidad */
+
+#if AEON_TANH_RUNTIME
+/** Activación activa, AEON_TANH_* (aeon_tanh.c) */
+extern uint8_t aeon_k_tanh_mode;
+#define AEON_K_TANH_MODE aeon_k_tanh_mode
+#else
+#define AEON_K_TANH_MODE AEON_TANH_MODE
+#endif
+
+#if AEON_TANH_RUNTIME || AEON_TANH_MODE == AEON_TANH_LUT
+extern const uint16_t aeon_k_tanh_table[AEON_TANH_LUT_SIZE + 1];
+#endif
+
+/** tanhf redondeada a aeon_state_t (aeon_tanh.c, fuera de línea) */
+aeon_state_t aeon_k_tanh_exact(aeon_state_t x);
+
+/** Polinomio de grado 5 saturado (activación "poly") */
+static inline aeon_state_t aeon_k_tanh_poly(aeon_state_t x) {
+#if AEON_USE_FIXED_POINT
+  /* Saturación simple para punto fijo */
+  if (x > AEON_SCALE)
+    return AEON_SCALE;
+  if (x < -AEON_SCALE)
+    return -AEON_SCALE;
+  /* Aproximación mejorada: tanh(x) ≈ x - x³/3 + x⁵/15 para |x| < 1 */
+  aeon_state_t x2 = (x * x) >> AEON_SCALE_BITS;
+  aeon_state_t x3 = (x2 * x) >> AEON_SCALE_BITS;
+  aeon_state_t x5 = (x3 * x2) >> AEON_SCALE_BITS;
+  /* Divisiones truncadas hacia cero, sobre |v| y restaurando el signo */
+  aeon_state_t d3 = ((x3 < 0 ? -x3 : x3) * AEON_TANH_DIV3_MAGIC) >> 16;
+  aeon_state_t d15 = ((x5 < 0 ? -x5 : x5) * AEON_TANH_DIV15_MAGIC) >> 16;
+  return x - (x3 < 0 ? -d3 : d3) + (x5 < 0 ? -d15 : d15);
+#else
+  /* Aproximación polinomial mejorada de tanh */
+  if (x > 2.0f)
+    return 1.0f;
+  if (x < -2.0f)
+    return -1.0f;
+  float x2 = x * x;
+  return x * (1.0f - x2 / 3.0f + x2 * x2 / 15.0f);
+#endif
+}
+
+#if AEON_TANH_RUNTIME || AEON_TANH_MODE == AEON_TANH_LUT
+/** Tabla con interpolación lineal (activación "lut") */
+static inline aeon_state_t aeon_k_tanh_lut(aeon_state_t x) {
+  const uint16_t *t = aeon_k_tanh_table;
+#if AEON_USE_FIXED_POINT
+  /* Q8.8: 4 pasos de entrada por entrada de la tabla */
+  uint32_t a = (uint32_t)(x < 0 ? -x : x);
+  aeon_state_t y;
+  if (a >= AEON_TANH_LUT_SIZE * 4) {
+    y = AEON_SCALE;
+  } else {
+    uint32_t i = a >> 2, f = a & 3;
+    uint32_t q15 = t[i] * (4 - f) + t[i + 1] * f; /* Q1.15 * 4 */
+    y = (aeon_state_t)((q15 + (1u << 8)) >> 9);
+  }
+  return x < 0 ? -y : y;
+#else
+  float a = x < 0 ? -x : x;
+  float y;
+  if (a >= (float)AEON_TANH_LUT_SIZE / AEON_TANH_LUT_STEPS) {
+    y = 1.0f;
+  } else {
+    float p = a * AEON_TANH_LUT_STEPS;
+    int i = (int)p;
+    float f = p - (float)i;
+    y = ((float)t[i] + ((float)t[i + 1] - (float)t[i]) * f) / 32768.0f;
+  }
+  return x < 0 ? -y : y;
+#endif
+}
+#endif
+
+/** tanh activa (ver aeon_tanh_select) */
+static inline aeon_state_t aeon_k_tanh(aeon_state_t x) {
+#if AEON_TANH_RUNTIME || AEON_TANH_MODE == AEON_TANH_LUT
+  if (AEON_K_TANH_MODE == AEON_TANH_LUT)
+    return aeon_k_tanh_lut(x);
+#endif
+#if AEON_TANH_RUNTIME || AEON_TANH_MODE == AEON_TANH_EXACT
+  if (AEON_K_TANH_MODE == AEON_TANH_EXACT)
+    return aeon_k_tanh_exact(x);
+#endif
+  return aeon_k_tanh_poly(x);
+}
+
+/* ------------------------------------------------------------
+ * Instrumentación (AEON_ENABLE_STATS, aeon_stats.c). Sin ella, las
+ * macros no generan código.
+ * ------------------------------------------------------------ */
+
+#if AEON_ENABLE_STATS
+/** Acumulador Q8.8 ya desplazado a menos de 2x del límite de int32 */
+#define AEON_STATS_NEAR_MISS ((INT32_MAX / 2) >> AEON_SCALE_BITS)
+
+/** Ticks del reloj de aeon_stats_hooks */
+uint64_t aeon_k_stats_clock(void);
+/** Cierra una etapa abierta en start: casos pendientes y duración */
+void aeon_k_stats_stage(int stage, uint64_t start);
+/** Saturaciones en state y casi desbordes en pre (ambos pueden ser NULL) */
+void aeon_k_stats_scan(const aeon_state_t *pre, const aeon_state_t *state,
+                       uint32_t n);
+/** Suma n casos de un evento numérico a la etapa en curso */
+void aeon_k_stats_count(int event, uint32_t n);
+
+#define AEON_STATS_BEGIN(t) uint64_t t = aeon_k_stats_clock()
+#define AEON_STATS_END(stage, t) aeon_k_stats_stage(stage, t)
+#define AEON_STATS_SCAN(pre, state, n) aeon_k_stats_scan(pre, state, n)
+#define AEON_STATS_COUNT(event, n) aeon_k_stats_count(event, n)
+#else
+#define AEON_STATS_BEGIN(t) ((void)0)
+#define AEON_STATS_END(stage, t) ((void)0)
+#define AEON_STATS_SCAN(pre, state, n) ((void)0)
+#define AEON_STATS_COUNT(event, n) ((void)0)
+#endif
+
+/**
+ * @brief No-linealidad del paso: state = tanh(pre) o, con fuga,
+ *        state += leak * (tanh(pre) - state)
+ *
+ * Sin fuga es el camino de siempre, bit a bit. Con fuga pre se
+ * sobrescribe con la activación.
+ */
+static inline void aeon_k_activate(aeon_state_t *pre, aeon_state_t *state,
+                                   uint32_t n, aeon_state_t leak) {
+  if (leak >= aeon_k_fraction(1.0f)) {
+#if AEON_USE_FIXED_POINT
+    aeon_k_ops()->tanh(pre, state, n);
+#else
+    /* Loop unrolling: 4 operaciones por iteración para mejor ILP */
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      state[i]     = aeon_k_tanh(pre[i]);
+      state[i + 1] = aeon_k_tanh(pre[i + 1]);
+      state[i + 2] = aeon_k_tanh(pre[i + 2]);
+      state[i + 3] = aeon_k_tanh(pre[i + 3]);
+    }
+    /* Residuo para tamaños no múltiplos de 4 */
+    for (; i < n; i++) {
+      state[i] = aeon_k_tanh(pre[i]);
+    }
+#endif
+    AEON_STATS_SCAN(pre, state, n);
+    return;
+  }
+
+  AEON_STATS_SCAN(pre, NULL, n);
+#if AEON_USE_FIXED_POINT
+  aeon_k_ops()->tanh(pre, pre, n);
+  for (uint32_t i = 0; i < n; i++) {
+    state[i] += (leak * (pre[i] - state[i])) >> AEON_SCALE_BITS;
+  }
+#else
+  for (uint32_t i = 0; i < n; i++) {
+    state[i] += leak * (aeon_k_tanh(pre[i]) - state[i]);
+  }
+#endif
+  AEON_STATS_SCAN(NULL, state, n);
+}
+
+/**
+ * @brief Paso del reservoir: state = tanh(W_in * input + W_res * state)
+ *
+ * @param scratch Buffer temporal de n_res elementos
+ * @param leak Fuga en escala de estado (aeon_k_leak)
+ */
+static inline void aeon_k_step(uint16_t n_res, uint16_t n_in,
+                               const aeon_weight_t *W_in,
+                               const uint32_t *row_ptr,
+                               const uint16_t *col_indices,
+                               const aeon_weight_t *W_reservoir,
+                               aeon_state_t *state, const aeon_state_t *input,
+                               aeon_state_t *scratch, aeon_state_t leak) {
+#if AEON_USE_FIXED_POINT
+  const aeon_simd_ops_t *ops = aeon_k_ops();
+
+  /* W_in * input (denso, SIMD) */
+  ops->input_mac(W_in, input, n_res, n_in, scratch);
+
+  /* Por cada fila: + W_reservoir * state (CSR).
+   * La suma se acumula en registro y se escribe una sola vez. */
+  for (int i = 0; i < n_res; i++) {
+    aeon_state_t sum = scratch[i];
+    uint32_t row_end = row_ptr[i + 1];
+    for (uint32_t k = row_ptr[i]; k < row_end; k++) {
+      sum += (aeon_state_t)W_reservoir[k] * state[col_indices[k]];
+    }
+    scratch[i] = sum >> AEON_SCALE_BITS;
+  }
+#else
+  const aeon_simd_ops_t *ops = aeon_k_ops();
+
+  /* W_in * input y, por cada fila, + W_reservoir * state (CSR), con
+   * FMA y los pesos ensanchados en registro si el backend lo permite */
+  ops->input_mac(W_in, input, n_res, n_in, scratch);
+  ops->csr_mac(row_ptr, col_indices, W_reservoir, state, n_res, scratch);
+#endif
+
+  /* Aplicar no-linealidad y actualizar estado (SIMD en punto fijo) */
+  aeon_k_activate(scratch, state, n_res, leak);
+}
+
+/** Lectura lineal: output = W_out * state */
+static inline void aeon_k_readout(uint16_t n_res, uint16_t n_out,
+                                  const aeon_weight_t *W_out,
+                                  const aeon_state_t *state,
+                                  aeon_state_t *output) {
+#if AEON_USE_FIXED_POINT
+  const aeon_simd_ops_t *ops = aeon_k_ops();
+  for (int i = 0; i < n_out; i++) {
+    output[i] = ops->dot(&W_out[i * n_res], state, n_res) >> AEON_SCALE_BITS;
+  }
+#else
+  for (int i = 0; i < n_out; i++) {
+    aeon_state_t sum = 0;
+    for (int j = 0; j < n_res; j++) {
+      sum += aeon_weight_to_float(W_out[i * n_res + j]) * state[j];
+    }
+    output[i] = sum;
+  }
+#endif
+}
+
+/**
+ * Lectura sobre los pesos no nulos: los de la salida o ocupan
+ * [ptr[o], ptr[o + 1]) en index/weight. Mismo orden de suma que
+ * aeon_k_readout sin los términos nulos, así que el resultado coincide.
+ */
+static inline void aeon_k_readout_sparse(uint16_t n_out, const uint16_t *ptr,
+                                         const uint16_t *index,
+                                         const aeon_weight_t *weight,
+                                         const aeon_state_t *state,
+                                         aeon_state_t *output) {
+  for (int o = 0; o < n_out; o++) {
+    uint32_t k = ptr[o], end = ptr[o + 1];
+#if AEON_USE_FIXED_POINT
+    /* Suma entera: cuatro acumuladores dan el mismo resultado */
+    aeon_state_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (; k + 4 <= end; k += 4) {
+      s0 += (aeon_state_t)weight[k] * state[index[k]];
+      s1 += (aeon_state_t)weight[k + 1] * state[index[k + 1]];
+      s2 += (aeon_state_t)weight[k + 2] * state[index[k + 2]];
+      s3 += (aeon_state_t)weight[k + 3] * state[index[k + 3]];
+    }
+    for (; k < end; k++) {
+      s0 += (aeon_state_t)weight[k] * state[index[k]];
+    }
+    output[o] = (s0 + s1 + s2 + s3) >> AEON_SCALE_BITS;
+#else
+    aeon_state_t sum = 0;
+    for (; k < end; k++) {
+      sum += aeon_weight_to_float(weight[k]) * state[index[k]];
+    }
+    output[o] = sum;
+#endif
+  }
+}
+
+/* ============================================================
+ * RESERVOIR PROCEDURAL
+ *
+ * Cada peso es una función pura de (semilla, índice de conexión):
+ * no se guarda nada más que la semilla y el paso los regenera. Al no
+ * haber estado secuencial, cada conexión se calcula por separado y el
+ * bucle no tiene dependencias entre iteraciones.
+ *
+ * Fila i: aeon_k_proc_fan_in() conexiones; la t-ésima usa el contador
+ * i * fan_in + t. Columnas repetidas dentro de una fila suman.
+ * ============================================================ */
+
+/** Flujos de contador independientes dentro de una semilla */
+#define AEON_PROC_STREAM_IN 1u
+#define AEON_PROC_STREAM_RES 2u
+
+/** Hash de contador (finalizador lowbias32) */
+static inline uint32_t aeon_k_hash(uint32_t key, uint32_t counter) {
+  uint32_t x = key ^ (counter * 0x9E3779B9u);
+  x ^= x >> 16;
+  x *= 0x7FEB352Du;
+  x ^= x >> 15;
+  x *= 0x846CA68Bu;
+  x ^= x >> 16;
+  return x;
+}
+
+/** Conexiones por fila (n / escasez, al menos una) */
+static inline uint32_t aeon_k_proc_fan_in(uint16_t n_res, uint16_t sparsity) {
+  uint32_t k = n_res / sparsity;
+  return k > 0 ? k : 1;
+}
+
+/** Peso a partir de los 16 bits bajos del hash (mismo rango que birth) */
+static inline aeon_state_t aeon_k_proc_weight(uint32_t h) {
+#if AEON_USE_FIXED_POINT
+  return (int32_t)(h & 0xFF) - 128;
+#else
+  return (float)(h & 0xFFFF) * (1.0f / 32768.0f) - 1.0f;
+#endif
+}
+
+/**
+ * Peso escalado por la ganancia de la normalización espectral (escala
+ * de estado). Con ganancia 1 es aeon_k_proc_weight exacto.
+ */
+static inline aeon_state_t aeon_k_proc_scaled(uint32_t h, aeon_state_t gain) {
+#if AEON_USE_FIXED_POINT
+  return (aeon_k_proc_weight(h) * gain) >> AEON_SCALE_BITS;
+#else
+  return aeon_k_proc_weight(h) * gain;
+#endif
+}
+
+/** Columna a partir de los 16 bits altos, sin división */
+static inline uint32_t aeon_k_proc_col(uint32_t h, uint16_t n_res) {
+  return ((h >> 16) * n_res) >> 16;
+}
+
+/**
+ * aeon_k_step con los pesos regenerados desde la semilla; los del
+ * reservoir se multiplican por gain
+ */
+static inline void aeon_k_step_procedural(uint16_t n_res, uint16_t n_in,
+                                          uint16_t sparsity, uint32_t seed,
+                                          aeon_state_t *state,
+                                          const aeon_state_t *input,
+                                          aeon_state_t *scratch,
+                                          aeon_state_t gain,
+                                          aeon_state_t leak) {
+  const uint32_t key_in = aeon_k_hash(seed, AEON_PROC_STREAM_IN);
+  const uint32_t key_res = aeon_k_hash(seed, AEON_PROC_STREAM_RES);
+  const uint32_t fan_in = aeon_k_proc_fan_in(n_res, sparsity);
+
+  for (uint32_t i = 0; i < n_res; i++) {
+    aeon_state_t sum = 0;
+    for (uint32_t j = 0; j < n_in; j++) {
+      uint32_t h = aeon_k_hash(key_in, i * n_in + j);
+      sum += aeon_k_proc_weight(h) * input[j];
+    }
+    for (uint32_t t = 0, c = i * fan_in; t < fan_in; t++, c++) {
+      uint32_t h = aeon_k_hash(key_res, c);
+      sum += aeon_k_proc_scaled(h, gain) * state[aeon_k_proc_col(h, n_res)];
+    }
+#if AEON_USE_FIXED_POINT
+    scratch[i] = sum >> AEON_SCALE_BITS;
+#else
+    scratch[i] = sum;
+#endif
+  }
+
+  aeon_k_activate(scratch, state, n_res, leak);
+}
+
+/** Paso de una vista, materializada o procedural */
+static inline void aeon_k_view_step(const aeon_view_t *v,
+                                    const aeon_state_t *input) {
+  if (v->procedural) {
+    aeon_k_step_procedural(v->n_res, v->n_in, v->sparsity, v->seed, v->state,
+                           input, v->scratch, v->gain, v->leak);
+  } else {
+    aeon_k_step(v->n_res, v->n_in, v->W_in, v->row_ptr, v->col_indices,
+                v->W_reservoir, v->state, input, v->scratch, v->leak);
+  }
+}
+
+/**
+ * @brief Predicción en lazo cerrado (n_in == n_out)
+ *
+ * out[t] = W_out * state y la salida es la entrada del paso siguiente,
+ * sin pasar por memoria más que la trayectoria. Avanza v->state, que
+ * suele ser una copia; el último paso no se da porque su estado no se
+ * lee. Con ptr != NULL usa la lectura escasa.
+ *
+ * @param out horizon * n_out salidas
+ */
+static inline void aeon_k_forecast(const aeon_view_t *v, const uint16_t *ptr,
+                                   const uint16_t *index,
+                                   const aeon_weight_t *weight,
+                                   uint32_t horizon, aeon_state_t *out) {
+  for (uint32_t t = 0; t < horizon; t++) {
+    aeon_state_t *y = out + (size_t)t * v->n_out;
+    if (ptr != NULL) {
+      aeon_k_readout_sparse(v->n_out, ptr, index, weight, v->state, y);
+    } else {
+      aeon_k_readout(v->n_res, v->n_out, v->W_out, v->state, y);
+    }
+    if (t + 1 < horizon)
+      aeon_k_view_step(v, y);
+  }
+}
+
+/**
+ * @brief Paso del reservoir para un bloque SoA de streams
+ *
+ * Layout: state[i * stride + s], inputs[j * n_streams + s].
+ * Cada peso escaso se lee una vez por bloque y el bucle interno
+ * recorre streams contiguos (vectorizable).
+ *
+ * @param scratch Buffer temporal de n_res * stride elementos
+ * @param leak Fuga en escala de estado (aeon_k_leak)
+ */
+static inline void aeon_k_step_batch(uint16_t n_res, uint16_t n_in,
+                                     const aeon_weight_t *W_in,
+                                     const uint32_t *row_ptr,
+                                     const uint16_t *col_indices,
+                                     const aeon_weight_t *W_reservoir,
+                                     aeon_state_t *state,
+                                     const aeon_state_t *inputs,
+                                     aeon_state_t *scratch,
+                                     uint16_t n_streams, uint32_t stride,
+                                     aeon_state_t leak) {
+  for (int i = 0; i < n_res; i++) {
+    aeon_state_t *AEON_RESTRICT acc = scratch + (size_t)i * stride;
+
+    for (int s = 0; s < n_streams; s++)
+      acc[s] = 0;
+
+    for (int j = 0; j < n_in; j++) {
+      aeon_state_t w = aeon_k_weight(W_in[i * n_in + j]);
+      const aeon_state_t *AEON_RESTRICT x = inputs + (size_t)j * n_streams;
+      for (int s = 0; s < n_streams; s++)
+        acc[s] += w * x[s];
+    }
+
+    uint32_t row_end = row_ptr[i + 1];
+    for (uint32_t k = row_ptr[i]; k < row_end; k++) {
+      aeon_state_t w = aeon_k_weight(W_reservoir[k]);
+      const aeon_state_t *AEON_RESTRICT src =
+          state + (size_t)col_indices[k] * stride;
+      for (int s = 0; s < n_streams; s++)
+        acc[s] += w * src[s];
+    }
+  }
+
+  /* No-linealidad sobre todo el bloque */
+  for (int i = 0; i < n_res; i++) {
+    aeon_state_t *AEON_RESTRICT acc = scratch + (size_t)i * stride;
+#if AEON_USE_FIXED_POINT
+    for (int s = 0; s < n_streams; s++)
+      acc[s] >>= AEON_SCALE_BITS;
+#endif
+    aeon_k_activate(acc, state + (size_t)i * stride, n_streams, leak);
+  }
+}
+
+/**
+ * @brief aeon_k_step_batch con pesos procedurales
+ *
+ * Cada peso se regenera una vez por bloque, no una vez por stream.
+ */
+static inline void aeon_k_step_batch_procedural(
+    uint16_t n_res, uint16_t n_in, uint16_t sparsity, uint32_t seed,
+    aeon_state_t *state, const aeon_state_t *inputs, aeon_state_t *scratch,
+    uint16_t n_streams, uint32_t stride, aeon_state_t gain,
+    aeon_state_t leak) {
+  const uint32_t key_in = aeon_k_hash(seed, AEON_PROC_STREAM_IN);
+  const uint32_t key_res = aeon_k_hash(seed, AEON_PROC_STREAM_RES);
+  const uint32_t fan_in = aeon_k_proc_fan_in(n_res, sparsity);
+
+  for (uint32_t i = 0; i < n_res; i++) {
+    aeon_state_t *AEON_RESTRICT acc = scratch + (size_t)i * stride;
+
+    for (int s = 0; s < n_streams; s++)
+      acc[s] = 0;
+
+    for (uint32_t j = 0; j < n_in; j++) {
+      aeon_state_t w = aeon_k_proc_weight(aeon_k_hash(key_in, i * n_in + j));
+      const aeon_state_t *AEON_RESTRICT x = inputs + (size_t)j * n_streams;
+      for (int s = 0; s < n_streams; s++)
+        acc[s] += w * x[s];
+    }
+
+    for (uint32_t t = 0, c = i * fan_in; t < fan_in; t++, c++) {
+      uint32_t h = aeon_k_hash(key_res, c);
+      aeon_state_t w = aeon_k_proc_scaled(h, gain);
+      const aeon_state_t *AEON_RESTRICT src =
+          state + (size_t)aeon_k_proc_col(h, n_res) * stride;
+      for (int s = 0; s < n_streams; s++)
+        acc[s] += w * src[s];
+    }
+  }
+
+  for (uint32_t i = 0; i < n_res; i++) {
+    aeon_state_t *AEON_RESTRICT acc = scratch + (size_t)i * stride;
+#if AEON_USE_FIXED_POINT
+    for (int s = 0; s < n_streams; s++)
+      acc[s] >>= AEON_SCALE_BITS;
+#endif
+    aeon_k_activate(acc, state + (size_t)i * stride, n_streams, leak);
+  }
+}
+
+/** Lectura lineal SoA: outputs[o * n_streams + s] */
+static inline void aeon_k_readout_batch(uint16_t n_res, uint16_t n_out,
+                                        const aeon_weight_t *W_out,
+                                        const aeon_state_t *state,
+                                        aeon_state_t *outputs,
+                                        uint16_t n_streams, uint32_t stride) {
+  for (int o = 0; o < n_out; o++) {
+    aeon_state_t *AEON_RESTRICT out = outputs + (size_t)o * n_streams;
+    for (int s = 0; s < n_streams; s++)
+      out[s] = 0;
+
+    for (int j = 0; j < n_res; j++) {
+      aeon_state_t w = aeon_k_weight(W_out[o * n_res + j]);
+      const aeon_state_t *AEON_RESTRICT src = state + (size_t)j * stride;
+      for (int s = 0; s < n_streams; s++)
+        out[s] += w * src[s];
+    }
+#if AEON_USE_FIXED_POINT
+    for (int s = 0; s < n_streams; s++)
+      out[s] >>= AEON_SCALE_BITS;
+#endif
+  }
+}
+
+/* ============================================================
+ * RUTINAS COMPARTIDAS (definidas en libAeon.c salvo indicación)
+ * ============================================================ */
+
+/** Redondea un tamaño a múltiplo de AEON_CACHE_LINE */
+static inline size_t aeon_k_align(size_t n) {
+  return (n + AEON_CACHE_LINE - 1) & ~(size_t)(AEON_CACHE_LINE - 1);
+}
+
+/** Asignador malloc alineado (definido en aeon_core.c) */
+const aeon_allocator_t *aeon_k_default_allocator(void);
+
+/** Libera una proyección de aeon_core_map (definido en aeon_io.c) */
+void aeon_k_unmap(const void *mapping, size_t size);
+
+/** CRC-32 (IEEE 802.3) de los archivos de modelo (definido en aeon_io.c) */
+uint32_t aeon_k_crc32(uint32_t crc, const void *data, size_t len);
+
+/**
+ * @brief Rellena el certificado de nacimiento
+ *
+ * @return Semilla efectiva (seed, o el timestamp si seed == 0)
+ */
+uint32_t aeon_k_certify(aeon_certificate_t *cert, uint32_t seed,
+                        uint16_t n_res);
+
+/** Palabras de 32 bits del bitset de conexiones de aeon_k_generate */
+#define AEON_GENERATE_WORK_WORDS(n_res)                                        \
+  (((uint32_t)(n_res) * (n_res) + 31) / 32)
+
+/**
+ * @brief Genera W_in y el reservoir CSR a partir de la semilla
+ *
+ * Coste O(nnz + n²/32). Con v->spectral_radius > 0 reescala después el
+ * reservoir a ese radio (O(96 nnz)), usando state y scratch como
+ * vectores de trabajo: los deja a cero. W_out no se toca.
+ *
+ * @param seen Bitset de AEON_GENERATE_WORK_WORDS(n_res) palabras
+ * @return Número de conexiones escasas generadas
+ */
+uint32_t aeon_k_generate(const aeon_view_t *v, uint32_t seed, uint32_t *seen);
+
+/**
+ * @brief Radio espectral del reservoir de la vista (procedural con
+ *        v->gain) por iteración de potencia
+ *
+ * Usa state y scratch como vectores de trabajo y los deja a cero.
+ */
+float aeon_k_spectral_radius(const aeon_view_t *v);
+
+/**
+ * @brief Ganancia que lleva el reservoir procedural a v->spectral_radius
+ *
+ * Escala de estado; 1 si el radio objetivo es 0. Usa state y scratch
+ * como aeon_k_spectral_radius.
+ */
+aeon_state_t aeon_k_proc_gain(const aeon_view_t *v);
+
+/**
+ * Lambda de Tikhonov por muestra del entrenamiento Ridge: la diagonal
+ * recibe AEON_RIDGE_LAMBDA * muestras, así la regularización guarda la
+ * misma proporción con S^T*S sea cual sea la longitud de la serie y
+ * queda por encima del redondeo de la acumulación.
+ */
+#define AEON_RIDGE_LAMBDA 1e-4f
+
+/** Reintentos del entrenamiento cuando la factorización hunde un pivote */
+#define AEON_RIDGE_RETRIES 3
+/** Factor que multiplica la ridge en cada reintento */
+#define AEON_RIDGE_GROWTH 100.0f
+
+/** Muestras por bloque al acumular S^T*S */
+#define AEON_TRAIN_BLOCK 64
+
+/** Floats de una matriz simétrica n x n en triangular empaquetada */
+#define AEON_TRI_SIZE(n) ((uint32_t)(n) * ((n) + 1) / 2)
+/** Inicio de la fila i en triangular empaquetada (inferior) */
+#define AEON_TRI_ROW(i) ((uint32_t)(i) * ((i) + 1) / 2)
+
+/**
+ * @brief Acumula k muestras de una vez (actualización de rango k, como
+ *        SYRK): S^T*S += B^T B, S^T*Y += B^T Y_B y diag(Y^T*Y)
+ *
+ * B son k estados de n floats seguidos e Y_B sus k objetivos. Las filas
+ * de S^T*S van de dos en dos y las muestras de cuatro en cuatro: cada
+ * carga de B sirve a dos filas. La suma del bloque se forma aparte y se
+ * añade una vez, así que el redondeo crece con k más el número de
+ * bloques y no con el de muestras.
+ *
+ * @param acc Temporal de 2 n floats
+ * @param comp Compensación de la suma de Kahan de cada acumulador, con
+ *        la forma de S^T*S | S^T*Y | Y^T*Y seguidos (NULL = sin
+ *        compensar): el redondeo deja de crecer con el número de
+ *        bloques, para acumular sin límite de muestras
+ */
+void aeon_k_accumulate_block(float *AEON_RESTRICT StS,
+                             float *AEON_RESTRICT StY,
+                             float *AEON_RESTRICT YtY,
+                             const float *AEON_RESTRICT B,
+                             const float *AEON_RESTRICT Y, uint32_t k,
+                             uint16_t n, uint16_t n_out,
+                             float *AEON_RESTRICT acc, float *comp);
+
+/** Inicializa S^T*S = lambda*I (empaquetada), S^T*Y = 0 y Y^T*Y = 0 */
+void aeon_k_ridge_init(float *StS, float *StY, float *YtY, uint16_t n,
+                       uint16_t n_out, float lambda);
+
+/**
+ * @brief Resuelve (S^T*S) W = S^T*Y por Cholesky y escribe W_out
+ *
+ * Factoriza StS in-place (queda L) y sustituye por cada salida.
+ * Los pesos se limitan a [-2, 2] antes de cuantizar.
+ *
+ * @param z Vector temporal de n floats
+ * @return 0 si éxito; -1 si un pivote se hunde bajo el redondeo (~4 n
+ *         eps de su diagonal) o no es finito: StS queda a medio
+ *         factorizar, W_out intacto, y hay que repetir con más ridge
+ */
+int aeon_k_ridge_solve(float *StS, float *StY, float *z, uint16_t n,
+                       uint16_t n_out, aeon_weight_t *W_out);
+
+/**
+ * @brief Suma de errores cuadráticos en forma cerrada
+ *
+ * Con L el factor que dejó aeon_k_ridge_solve (L L^T = S^T*S + ridge*I)
+ * y w los pesos ya cuantizados de W_out, por cada salida:
+ *   |Sw - y|² = Y^T*Y - 2 w^T S^T*Y + |L^T w|² - ridge |w|²
+ * Sustituye a volver a pasar la serie por el reservoir. La identidad
+ * vale para cualquier w (también recortado a ±2), pero solo con un
+ * factor que aeon_k_ridge_solve aceptó: nunca se usa uno con pivotes
+ * hundidos, que los llamadores reintentan con más ridge.
+ *
+ * @param z Vector temporal de n floats
+ * @return Suma de errores cuadráticos de todas las salidas (>= 0), o
+ *         -1 si la diagonal de L no es positiva (factor rechazado)
+ */
+float aeon_k_ridge_error(const float *L, const float *StY, const float *YtY,
+                         float ridge, uint16_t n, uint16_t n_out,
+                         const aeon_weight_t *W_out, float *z);
+
+/** Floats de trabajo que necesita aeon_k_train: S^T*S | S^T*Y | Y^T*Y,
+ *  un bloque de AEON_TRAIN_BLOCK estados y objetivos y 2 n de temporal */
+#define AEON_TRAIN_WORK_SIZE(n_res, n_out)                                     \
+  (AEON_TRI_SIZE(n_res) + (uint32_t)(n_res) * (n_out) + (n_out) +              \
+   (uint32_t)AEON_TRAIN_BLOCK * ((n_res) + (n_out)) + 2 * (uint32_t)(n_res))
+
+/** AEON_TRAIN_WORK_SIZE para formas de tiempo de ejecución */
+uint32_t aeon_k_train_work_size(uint16_t n_res, uint16_t n_out);
+
+/**
+ * @brief Entrenamiento Ridge de W_out sobre una vista
+ *
+ * Una sola pasada por la serie, acumulando por bloques de
+ * AEON_TRAIN_BLOCK muestras con ridge AEON_RIDGE_LAMBDA * muestras: el
+ * MSE sale de los acumuladores. Si la factorización hunde un pivote,
+ * vuelve a pasar la serie con la ridge AEON_RIDGE_GROWTH veces mayor,
+ * hasta AEON_RIDGE_RETRIES veces.
+ *
+ * @param work Buffer de aeon_k_train_work_size() floats
+ * @return MSE de entrenamiento, -2 si no hay muestras tras el washout o
+ *         -5 si S^T*S no se factoriza ni tras los reintentos (datos no
+ *         finitos; W_out queda intacto)
+ */
+float aeon_k_train(const aeon_view_t *v, const aeon_state_t *inputs,
+                   const aeon_state_t *targets, uint32_t n_samples,
+                   uint32_t washout, float *work);
+
+/** Floats de trabajo que necesita aeon_k_train_parallel */
+size_t aeon_k_train_parallel_work_size(uint16_t n_res, uint16_t n_out,
+                                       uint16_t n_partials);
+
+/**
+ * @brief aeon_k_train con la acumulación repartida en n_partials
+ *        S^T*S parciales
+ *
+ * Por rondas: una tarea avanza el reservoir y llena n_partials bloques
+ * de AEON_TRAIN_BLOCK estados mientras otras n_partials acumulan los
+ * bloques de la ronda anterior (doble buffer), el j-ésimo siempre en
+ * la parcial j con aeon_k_accumulate_block. Al final las parciales se
+ * suman en orden, también por tareas. El resultado depende de
+ * n_partials pero no del ejecutor ni del reparto entre hilos; con una
+ * sola parcial coincide bit a bit con aeon_k_train. La ridge y los
+ * reintentos son los de aeon_k_train.
+ *
+ * @param executor Ejecutor de las tareas (NULL = en orden)
+ * @param work Buffer de aeon_k_train_parallel_work_size() floats,
+ *        alineado a AEON_CACHE_LINE
+ * @return MSE de entrenamiento, -2 si los argumentos son inválidos o -5
+ *         si S^T*S no se factoriza ni tras los reintentos
+ */
+float aeon_k_train_parallel(const aeon_view_t *v, const aeon_state_t *inputs,
+                            const aeon_state_t *targets, uint32_t n_samples,
+                            uint32_t washout, const aeon_executor_t *executor,
+                            uint16_t n_partials, float *work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AEON_KERNELS_H */
@@ -0,0 +1,531 @@
+/**
+ * @file aeon_search.c
+ * @brief Proyecto Eón - Búsqueda paralela de semillas e hiperparámetros
+ *
+ * Reparte las combinaciones (semilla, escasez) entre todos los núcleos
+ * de la máquina con un pool de robo de trabajo: cada worker recorre su
+ * propio rango de tareas y, cuando se le acaba, roba la mitad del rango
+ * más largo de otro worker. Cada worker tiene sus propios núcleos y su
+ * propio entrenador, así que no se comparte nada mutable salvo los
+ * rangos.
+ *
+ * Los acumuladores del entrenador no dependen de lambda: cada
+ * (semilla, escasez) pasa una sola vez por el reservoir y se resuelve
+ * una vez por cada lambda del barrido.
+ *
+ * Uso:
+ *   aeon_search [-s A:B] [-p 2,4,8] [-l 0.001,0.01] [-r N] [-k K]
+ *               [-j hilos] [-w washout] [-n muestras] [-t umbral]
+ *               [-d datos.csv]
+ *
+ * datos.csv: una columna (se predice el siguiente valor) o dos
+ * columnas "entrada,objetivo", valores en [-1, 1].
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "libAeon.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/** Máximo de valores por lista de barrido (-p, -l) */
+#define MAX_SWEEP 16
+/** Máximo de resultados que se informan */
+#define MAX_TOP 256
+
+/* ============================================================
+ * CONFIGURACIÓN Y RESULTADOS
+ * ============================================================ */
+
+typedef struct {
+  uint32_t seed_first;
+  uint32_t seed_last;
+  uint16_t sparsity[MAX_SWEEP];
+  int n_sparsity;
+  float lambda[MAX_SWEEP];
+  int n_lambda;
+  uint16_t reservoir_size;
+  int top_k;
+  int n_threads;
+  uint32_t washout;
+  float threshold;
+
+  aeon_state_t *inputs;
+  aeon_state_t *targets;
+  uint32_t n_samples;
+} search_config_t;
+
+typedef struct {
+  uint32_t seed;
+  uint16_t sparsity;
+  float lambda;
+  float mse;
+  double train_ms; /**< Nacimiento + acumulación + resolución */
+} search_result_t;
+
+/** Rango de tareas [head, tail) de un worker */
+typedef struct {
+  pthread_mutex_t lock;
+  uint32_t head;
+  uint32_t tail;
+} task_range_t;
+
+typedef struct {
+  int id;
+  const search_config_t *cfg;
+  task_range_t *ranges; /**< Rangos de todos los workers */
+
+  /* Propio de cada worker */
+  aeon_dyn_core_t *cores[MAX_SWEEP]; /**< Uno por valor de escasez */
+  aeon_trainer_t *trainer;
+  search_result_t top[MAX_TOP];
+  int n_top;
+  uint32_t tasks_done;
+  uint32_t steals;
+  uint32_t below_threshold;
+} worker_t;
+
+static double now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+/** Orden total: MSE y, a igualdad, semilla/escasez/lambda (determinista) */
+static int result_less(const search_result_t *a, const search_result_t *b) {
+  if (a->mse != b->mse)
+    return a->mse < b->mse;
+  if (a->seed != b->seed)
+    return a->seed < b->seed;
+  if (a->sparsity != b->sparsity)
+    return a->sparsity < b->sparsity;
+  return a->lambda < b->lambda;
+}
+
+/** Inserta en una lista ordenada de como mucho k elementos */
+static void top_insert(search_result_t *top, int *n, int k,
+                       const search_result_t *r) {
+  if (*n == k && !result_less(r, &top[k - 1]))
+    return;
+  int i = (*n < k) ? (*n)++ : k - 1;
+  while (i > 0 && result_less(r, &top[i - 1])) {
+    top[i] = top[i - 1];
+    i--;
+  }
+  top[i] = *r;
+}
+
+/* ============================================================
+ * POOL CON ROBO DE TRABAJO
+ * ============================================================ */
+
+/** Toma la siguiente tarea propia; devuelve 0 si no queda ninguna */
+static int take_own(task_range_t *r, uint32_t *task) {
+  int ok = 0;
+  pthread_mutex_lock(&r->lock);
+  if (r->head < r->tail) {
+    *task = r->head++;
+    ok = 1;
+  }
+  pthread_mutex_unlock(&r->lock);
+  return ok;
+}
+
+/** Roba la mitad superior del rango más largo; 0 si no queda trabajo */
+static int steal(worker_t *w) {
+  const int n = w->cfg->n_threads;
+  task_range_t *own = &w->ranges[w->id];
+
+  for (;;) {
+    /* Elegir la víctima con más trabajo pendiente (puede cambiar antes
+     * de robar; entonces se vuelve a buscar) */
+    int victim = -1;
+    uint32_t best = 0;
+    for (int k = 1; k < n; k++) {
+      int v = (w->id + k) % n;
+      pthread_mutex_lock(&w->ranges[v].lock);
+      uint32_t left = w->ranges[v].tail - w->ranges[v].head;
+      pthread_mutex_unlock(&w->ranges[v].lock);
+      if (left > best) {
+        best = left;
+        victim = v;
+      }
+    }
+    if (victim < 0)
+      return 0;
+
+    task_range_t *r = &w->ranges[victim];
+    uint32_t lo = 0, hi = 0;
+    pthread_mutex_lock(&r->lock);
+    if (r->head < r->tail) {
+      uint32_t mid = r->head + (r->tail - r->head) / 2;
+      lo = mid;
+      hi = r->tail;
+      r->tail = mid;
+    }
+    pthread_mutex_unlock(&r->lock);
+
+    if (hi > lo) {
+      pthread_mutex_lock(&own->lock);
+      own->head = lo;
+      own->tail = hi;
+      pthread_mutex_unlock(&own->lock);
+      w->steals++;
+      return 1;
+    }
+    /* La víctima se vació mientras tanto: volver a buscar */
+  }
+}
+
+/* ============================================================
+ * EVALUACIÓN
+ * ============================================================ */
+
+static void run_task(worker_t *w, uint32_t task) {
+  const search_config_t *cfg = w->cfg;
+  uint32_t seed = cfg->seed_first + task / (uint32_t)cfg->n_sparsity;
+  int sp = (int)(task % (uint32_t)cfg->n_sparsity);
+  aeon_dyn_core_t *core = w->cores[sp];
+  aeon_trainer_t *trainer = w->trainer;
+
+  double t0 = now_ms();
+  aeon_core_birth(core, seed);
+  aeon_trainer_begin(trainer, 1.0f, cfg->washout);
+  for (uint32_t t = 0; t < cfg->n_samples; t++) {
+    aeon_core_trainer_push(trainer, core, &cfg->inputs[t], &cfg->targets[t]);
+  }
+
+  for (int l = 0; l < cfg->n_lambda; l++) {
+    trainer->lambda = cfg->lambda[l];
+    int solved = aeon_core_trainer_finalize(trainer, core);
+
+    search_result_t r;
+    r.seed = seed;
+    r.sparsity = cfg->sparsity[sp];
+    r.lambda = cfg->lambda[l];
+    r.mse = solved < 0 || isnan(trainer->mse) ? INFINITY : trainer->mse;
+    r.train_ms = now_ms() - t0;
+
+    if (r.mse < cfg->threshold)
+      w->below_threshold++;
+    top_insert(w->top, &w->n_top, cfg->top_k, &r);
+  }
+  w->tasks_done++;
+}
+
+static void *worker_main(void *arg) {
+  worker_t *w = arg;
+  uint32_t task;
+
+  for (;;) {
+    while (take_own(&w->ranges[w->id], &task)) {
+      run_task(w, task);
+    }
+    if (!steal(w))
+      break;
+  }
+  return NULL;
+}
+
+/* ============================================================
+ * DATOS
+ * ============================================================ */
+
+static aeon_state_t to_state(float v) {
+#if AEON_USE_FIXED_POINT
+  return (aeon_state_t)(v * AEON_SCALE);
+#else
+  return v;
+#endif
+}
+
+/** Serie por defecto: seno, objetivo = siguiente valor (como find_seed) */
+static int make_sine(search_config_t *cfg, uint32_t n) {
+  if (n < 2)
+    return -1;
+  cfg->inputs = malloc(n * sizeof(aeon_state_t));
+  cfg->targets = malloc(n * sizeof(aeon_state_t));
+  if (!cfg->inputs || !cfg->targets)
+    return -1;
+  for (uint32_t i = 0; i < n; i++) {
+    cfg->inputs[i] = to_state(sinf((float)i * 0.1f));
+  }
+  for (uint32_t i = 0; i + 1 < n; i++) {
+    cfg->targets[i] = cfg->inputs[i + 1];
+  }
+  cfg->targets[n - 1] = cfg->inputs[0];
+  cfg->n_samples = n;
+  return 0;
+}
+
+static int load_csv(search_config_t *cfg, const char *path) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL)
+    return -1;
+
+  uint32_t cap = 1024, n = 0;
+  int two_columns = -1;
+  char line[256];
+  cfg->inputs = malloc(cap * sizeof(aeon_state_t));
+  cfg->targets = malloc(cap * sizeof(aeon_state_t));
+
+  while (cfg->inputs && cfg->targets && fgets(line, sizeof(line), f)) {
+    float x, y;
+    int got = sscanf(line, "%f,%f", &x, &y);
+    if (got < 1)
+      continue; /* Cabecera o línea vacía */
+    if (two_columns < 0)
+      two_columns = (got == 2);
+
+    if (n == cap) {
+      cap *= 2;
+      cfg->inputs = realloc(cfg->inputs, cap * sizeof(aeon_state_t));
+      cfg->targets = realloc(cfg->targets, cap * sizeof(aeon_state_t));
+      if (!cfg->inputs || !cfg->targets)
+        break;
+    }
+    cfg->inputs[n] = to_state(x);
+    cfg->targets[n] = two_columns ? to_state(y) : 0;
+    n++;
+  }
+  fclose(f);
+
+  if (!cfg->inputs || !cfg->targets || n < 2)
+    return -1;
+
+  /* Una columna: objetivo = siguiente valor */
+  if (!two_columns) {
+    for (uint32_t i = 0; i + 1 < n; i++) {
+      cfg->targets[i] = cfg->inputs[i + 1];
+    }
+    n--;
+  }
+  cfg->n_samples = n;
+  return 0;
+}
+
+/* ============================================================
+ * LÍNEA DE COMANDOS
+ * ============================================================ */
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [options]\n"
+          "  -s A:B      seed range (default 1:1000)\n"
+          "  -p LIST     sparsity factors, e.g. 2,4,8 (default %d)\n"
+          "  -l LIST     per-sample ridge lambdas, e.g. 1e-4,1e-3 "
+          "(default 1e-4)\n"
+          "  -r N        reservoir size (default %d)\n"
+          "  -k K        report the best K results (default 10)\n"
+          "  -j N        worker threads (default: online CPUs)\n"
+          "  -w N        washout samples (default 50)\n"
+          "  -n N        synthetic sine samples (default 300)\n"
+          "  -t MSE      count results below this MSE (default 0.02)\n"
+          "  -d FILE     CSV data: 'x' or 'x,target' per line\n",
+          prog, AEON_SPARSITY_FACTOR, AEON_RESERVOIR_SIZE);
+}
+
+static int parse_u16_list(const char *s, uint16_t *out) {
+  int n = 0;
+  char *end;
+  while (*s && n < MAX_SWEEP) {
+    long v = strtol(s, &end, 10);
+    if (end == s || v <= 0 || v > 65535)
+      return -1;
+    out[n++] = (uint16_t)v;
+    s = (*end == ',') ? end + 1 : end;
+  }
+  return n;
+}
+
+static int parse_float_list(const char *s, float *out) {
+  int n = 0;
+  char *end;
+  while (*s && n < MAX_SWEEP) {
+    float v = strtof(s, &end);
+    if (end == s || !(v > 0.0f))
+      return -1;
+    out[n++] = v;
+    s = (*end == ',') ? end + 1 : end;
+  }
+  return n;
+}
+
+int main(int argc, char *argv[]) {
+  search_config_t cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.seed_first = 1;
+  cfg.seed_last = 1000;
+  cfg.sparsity[0] = AEON_SPARSITY_FACTOR;
+  cfg.n_sparsity = 1;
+  cfg.lambda[0] = 1e-4f;
+  cfg.n_lambda = 1;
+  cfg.reservoir_size = AEON_RESERVOIR_SIZE;
+  cfg.top_k = 10;
+  cfg.n_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+  cfg.washout = 50;
+  cfg.threshold = 0.02f;
+
+  uint32_t n_sine = 300;
+  const char *data_path = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "s:p:l:r:k:j:w:n:t:d:h")) != -1) {
+    switch (opt) {
+    case 's':
+      if (sscanf(optarg, "%u:%u", &cfg.seed_first, &cfg.seed_last) != 2 ||
+          cfg.seed_first == 0 || cfg.seed_last < cfg.seed_first) {
+        fprintf(stderr, "Invalid seed range (seed 0 is the clock)\n");
+        return 1;
+      }
+      break;
+    case 'p':
+      cfg.n_sparsity = parse_u16_list(optarg, cfg.sparsity);
+      break;
+    case 'l':
+      cfg.n_lambda = parse_float_list(optarg, cfg.lambda);
+      break;
+    case 'r':
+      cfg.reservoir_size = (uint16_t)atoi(optarg);
+      break;
+    case 'k':
+      cfg.top_k = atoi(optarg);
+      break;
+    case 'j':
+      cfg.n_threads = atoi(optarg);
+      break;
+    case 'w':
+      cfg.washout = (uint32_t)atoi(optarg);
+      break;
+    case 'n':
+      n_sine = (uint32_t)atoi(optarg);
+      break;
+    case 't':
+      cfg.threshold = (float)atof(optarg);
+      break;
+    case 'd':
+      data_path = optarg;
+      break;
+    default:
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (cfg.n_sparsity <= 0 || cfg.n_lambda <= 0 || cfg.reservoir_size == 0) {
+    fprintf(stderr, "Invalid sparsity, lambda or reservoir size\n");
+    return 1;
+  }
+  if (cfg.top_k < 1)
+    cfg.top_k = 1;
+  if (cfg.top_k > MAX_TOP)
+    cfg.top_k = MAX_TOP;
+  if (cfg.n_threads < 1)
+    cfg.n_threads = 1;
+
+  int data_ok = data_path ? load_csv(&cfg, data_path) : make_sine(&cfg, n_sine);
+  if (data_ok != 0 || cfg.n_samples <= cfg.washout) {
+    fprintf(stderr, "Could not prepare training data (need > %u samples)\n",
+            cfg.washout);
+    return 1;
+  }
+
+  uint32_t n_seeds = cfg.seed_last - cfg.seed_first + 1;
+  uint32_t n_tasks = n_seeds * (uint32_t)cfg.n_sparsity;
+  if ((uint32_t)cfg.n_threads > n_tasks)
+    cfg.n_threads = (int)n_tasks;
+
+  /* Resolver el backend antes de lanzar hilos */
+  printf("Searching %u seeds x %d sparsity x %d lambda "
+         "(%u neurons, %u samples) on %d threads, %s kernels...\n",
+         n_seeds, cfg.n_sparsity, cfg.n_lambda, cfg.reservoir_size,
+         cfg.n_samples, cfg.n_threads, aeon_simd_backend());
+
+  /* Workers: rangos contiguos iniciales, núcleos y entrenador propios */
+  task_range_t *ranges = calloc((size_t)cfg.n_threads, sizeof(task_range_t));
+  worker_t *workers = calloc((size_t)cfg.n_threads, sizeof(worker_t));
+  pthread_t *threads = calloc((size_t)cfg.n_threads, sizeof(pthread_t));
+  if (!ranges || !workers || !threads) {
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+  }
+
+  for (int i = 0; i < cfg.n_threads; i++) {
+    pthread_mutex_init(&ranges[i].lock, NULL);
+    ranges[i].head = (uint32_t)((uint64_t)n_tasks * i / cfg.n_threads);
+    ranges[i].tail = (uint32_t)((uint64_t)n_tasks * (i + 1) / cfg.n_threads);
+
+    worker_t *w = &workers[i];
+    w->id = i;
+    w->cfg = &cfg;
+    w->ranges = ranges;
+    for (int p = 0; p < cfg.n_sparsity; p++) {
+      aeon_config_t c = {cfg.reservoir_size,  AEON_INPUT_SIZE,
+                         AEON_OUTPUT_SIZE,    cfg.sparsity[p],
+                         AEON_SPECTRAL_RADIUS, AEON_LEAK_RATE};
+      w->cores[p] = aeon_core_create(&c, NULL);
+      if (w->cores[p] == NULL) {
+        fprintf(stderr, "Could not create reservoir\n");
+        return 1;
+      }
+    }
+    w->trainer =
+        aeon_trainer_create(cfg.reservoir_size, AEON_OUTPUT_SIZE, NULL);
+    if (w->trainer == NULL) {
+      fprintf(stderr, "Could not create trainer\n");
+      return 1;
+    }
+  }
+
+  double t0 = now_ms();
+  for (int i = 0; i < cfg.n_threads; i++) {
+    pthread_create(&threads[i], NULL, worker_main, &workers[i]);
+  }
+  for (int i = 0; i < cfg.n_threads; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  double wall_ms = now_ms() - t0;
+
+  /* Fusionar los top-K de cada worker */
+  search_result_t top[MAX_TOP];
+  int n_top = 0;
+  uint32_t below = 0, steals = 0;
+  for (int i = 0; i < cfg.n_threads; i++) {
+    for (int j = 0; j < workers[i].n_top; j++) {
+      top_insert(top, &n_top, cfg.top_k, &workers[i].top[j]);
+    }
+    below += workers[i].below_threshold;
+    steals += workers[i].steals;
+  }
+
+  printf("\n  %-4s %-10s %-8s %-9s %-10s %s\n", "#", "seed", "sparsity",
+         "lambda", "mse", "train_ms");
+  for (int i = 0; i < n_top; i++) {
+    printf("  %-4d %-10u %-8u %-9g %-10.6f %.3f\n", i + 1, top[i].seed,
+           top[i].sparsity, top[i].lambda, top[i].mse, top[i].train_ms);
+  }
+
+  printf("\n  %u tasks in %.1f ms (%.1f tasks/s, %u steals)\n", n_tasks,
+         wall_ms, wall_ms > 0.0 ? n_tasks / (wall_ms / 1e3) : 0.0, steals);
+  printf("  %u results with MSE < %g\n", below, cfg.threshold);
+
+  for (int i = 0; i < cfg.n_threads; i++) {
+    for (int p = 0; p < cfg.n_sparsity; p++) {
+      aeon_core_destroy(workers[i].cores[p]);
+    }
+    aeon_trainer_destroy(workers[i].trainer);
+    pthread_mutex_destroy(&ranges[i].lock);
+  }
+  free(threads);
+  free(workers);
+  free(ranges);
+  free(cfg.inputs);
+  free(cfg.targets);
+
+  return n_top > 0 && top[0].mse < cfg.threshold ? 0 : 1;
+}
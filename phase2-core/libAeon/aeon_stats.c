@@ -0,0 +1,136 @@
+/**
+ * @file aeon_stats.c
+ * @brief Proyecto Eón - Contadores y trazas del camino caliente
+ *
+ * Los kernels suman los casos numéricos a contadores pendientes de la
+ * etapa en curso; al cerrarla (aeon_k_stats_stage) se pasan a los
+ * totales y se emiten las trazas. Sin AEON_ENABLE_STATS solo quedan
+ * las llamadas públicas, que no hacen nada.
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <time.h>
+#define AEON_HAVE_MONOTONIC 1
+#else
+#define AEON_HAVE_MONOTONIC 0
+#endif
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <math.h>
+#include <string.h>
+
+static const char *const event_names[] = {
+    "update", "predict", "train", "tanh_saturation", "pivot_clamp",
+    "near_miss"};
+
+const char *aeon_event_name(int event) {
+  if (event < 0 || event > AEON_EVENT_NEAR_MISS)
+    return NULL;
+  return event_names[event];
+}
+
+#if AEON_ENABLE_STATS
+
+static aeon_stats_t stats;
+static aeon_hooks_t hooks;
+
+/** Casos de la etapa en curso, por evento numérico */
+static uint64_t pending[3];
+#define PENDING(event) pending[(event) - AEON_EVENT_TANH_SATURATION]
+
+uint64_t aeon_k_stats_clock(void) {
+  if (hooks.clock != NULL)
+    return hooks.clock(hooks.ctx);
+#if AEON_HAVE_MONOTONIC
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#else
+  return 0; /* Sin reloj: solo se cuentan llamadas */
+#endif
+}
+
+void aeon_k_stats_count(int event, uint32_t n) {
+  PENDING(event) += n;
+}
+
+void aeon_k_stats_scan(const aeon_state_t *pre, const aeon_state_t *state,
+                       uint32_t n) {
+  uint32_t saturated = 0, near = 0;
+  for (uint32_t i = 0; i < n; i++) {
+#if AEON_USE_FIXED_POINT
+    if (pre != NULL)
+      near += pre[i] >= AEON_STATS_NEAR_MISS || pre[i] <= -AEON_STATS_NEAR_MISS;
+    if (state != NULL)
+      saturated += state[i] >= AEON_SCALE || state[i] <= -AEON_SCALE;
+#else
+    if (pre != NULL)
+      near += !isfinite(pre[i]);
+    if (state != NULL)
+      saturated += fabsf(state[i]) >= 1.0f;
+#endif
+  }
+  PENDING(AEON_EVENT_TANH_SATURATION) += saturated;
+  PENDING(AEON_EVENT_NEAR_MISS) += near;
+}
+
+void aeon_k_stats_stage(int stage, uint64_t start) {
+  uint64_t elapsed = aeon_k_stats_clock() - start;
+
+  stats.calls[stage]++;
+  stats.time_total[stage] += elapsed;
+  if (elapsed > stats.time_max[stage])
+    stats.time_max[stage] = elapsed;
+
+  stats.tanh_saturations += PENDING(AEON_EVENT_TANH_SATURATION);
+  stats.pivot_clamps += PENDING(AEON_EVENT_PIVOT_CLAMP);
+  stats.overflow_near_misses += PENDING(AEON_EVENT_NEAR_MISS);
+
+  if (hooks.trace != NULL) {
+    for (int e = AEON_EVENT_TANH_SATURATION; e <= AEON_EVENT_NEAR_MISS; e++) {
+      if (PENDING(e) != 0)
+        hooks.trace(e, PENDING(e), hooks.ctx);
+    }
+    hooks.trace(stage, elapsed, hooks.ctx);
+  }
+  memset(pending, 0, sizeof(pending));
+}
+
+int aeon_stats_get(aeon_stats_t *out) {
+  if (out == NULL)
+    return -1;
+  *out = stats;
+  return 0;
+}
+
+void aeon_stats_reset(void) {
+  memset(&stats, 0, sizeof(stats));
+  memset(pending, 0, sizeof(pending));
+}
+
+void aeon_stats_hooks(const aeon_hooks_t *h) {
+  if (h == NULL) {
+    memset(&hooks, 0, sizeof(hooks));
+    return;
+  }
+  hooks = *h;
+}
+
+#else
+
+int aeon_stats_get(aeon_stats_t *out) {
+  if (out == NULL)
+    return -1;
+  memset(out, 0, sizeof(*out));
+  return -2;
+}
+
+void aeon_stats_reset(void) {}
+
+void aeon_stats_hooks(const aeon_hooks_t *h) { (void)h; }
+
+#endif
@@ -0,0 +1,431 @@
+/**
+ * @file aeon_stream.c
+ * @brief Proyecto Eón - Ingesta de tramas binarias y CSV
+ *
+ * El formato binario (ver libAeon.h) son bloques de int16 alineados a
+ * 2 bytes tras una cabecera de 8: proyectado en memoria en un host
+ * little-endian, cada bloque se entrega tal cual, sin copiar ni
+ * convertir. Tuberías y hosts big-endian leen y decodifican por
+ * bloques de chunk_frames. El CSV se convierte a int16 con los bits
+ * fraccionarios que pida quien abre el lector, redondeando.
+ */
+
+#if defined(__unix__) || defined(__APPLE__)
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AEON_HAVE_MMAP 1
+#else
+#define AEON_HAVE_MMAP 0
+#endif
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STREAM_MAGIC "EONS"
+#define BLOCK_HEADER_SIZE 4
+#define DEFAULT_CHUNK_FRAMES 256
+#define MAX_FRAC_BITS 15
+/** Tope de tramas por entrega sin copia (cabe en el int32 de retorno) */
+#define MAX_MAPPED_FRAMES 0x40000000u
+
+static bool host_is_le(void) {
+  const uint16_t probe = 1;
+  return *(const uint8_t *)&probe == 1;
+}
+
+static uint16_t rd16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+/** n valores int16 little-endian de src a dst (pueden coincidir) */
+static void decode16(int16_t *dst, const uint8_t *src, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    dst[i] = (int16_t)rd16(&src[2 * i]);
+}
+
+/* ============================================================
+ * CSV
+ * ============================================================ */
+
+static bool is_separator(char c) {
+  return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r';
+}
+
+/** Siguiente línea del origen en s->line, sin el salto; false al final */
+static bool next_line(aeon_stream_t *s) {
+  size_t len = 0;
+
+  if (s->data != NULL) {
+    if (s->pos >= s->size)
+      return false;
+    while (s->pos < s->size && s->data[s->pos] != '\n') {
+      if (len < AEON_STREAM_LINE - 1)
+        s->line[len++] = (char)s->data[s->pos];
+      s->pos++;
+    }
+    s->pos++; /* Salto de línea */
+    s->line[len] = '\0';
+    return true;
+  }
+
+  /* Primero los bytes que se leyeron para detectar el formato */
+  while (s->peek_pos < s->peek_len) {
+    char c = (char)s->peek[s->peek_pos++];
+    if (c == '\n') {
+      s->line[len] = '\0';
+      return true;
+    }
+    s->line[len++] = c;
+  }
+  s->line[len] = '\0';
+
+  FILE *f = s->file;
+  if (fgets(s->line + len, (int)(AEON_STREAM_LINE - len), f) == NULL)
+    return len > 0; /* Última línea sin salto */
+  len += strlen(s->line + len);
+  if (len > 0 && s->line[len - 1] == '\n') {
+    s->line[len - 1] = '\0';
+  } else if (len == AEON_STREAM_LINE - 1) {
+    int c; /* Línea truncada: descartar el resto */
+    while ((c = getc(f)) != EOF && c != '\n') {
+    }
+  }
+  return true;
+}
+
+/**
+ * @return Campos numéricos de la línea (hasta max), 0 si no es una
+ *         línea de datos, -1 si algún campo no es un número finito
+ */
+static int parse_line(const char *p, float *values, int max) {
+  while (is_separator(*p))
+    p++;
+  if (!((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.'))
+    return 0;
+
+  int n = 0;
+  while (*p != '\0' && n < max) {
+    char *end;
+    float v = strtof(p, &end);
+    if (end == p || !isfinite(v))
+      return -1;
+    values[n++] = v;
+    p = end;
+    while (is_separator(*p))
+      p++;
+  }
+  return n;
+}
+
+static int16_t to_int16(float v, uint8_t frac_bits) {
+  long r = lrintf(v * (float)(1u << frac_bits));
+  if (r > INT16_MAX)
+    return INT16_MAX;
+  if (r < INT16_MIN)
+    return INT16_MIN;
+  return (int16_t)r;
+}
+
+/** Siguiente trama CSV en dst; false al final */
+static bool csv_frame(aeon_stream_t *s, int16_t *dst) {
+  float values[AEON_STREAM_MAX_CHANNELS];
+
+  for (;;) {
+    if (!s->line_ready && !next_line(s))
+      return false;
+    s->line_ready = false;
+
+    int n = parse_line(s->line, values, AEON_STREAM_MAX_CHANNELS);
+    if (n < (int)s->channels || n <= 0) {
+      s->skipped++;
+      continue;
+    }
+    for (uint16_t c = 0; c < s->channels; c++)
+      dst[c] = to_int16(values[c], s->frac_bits);
+    return true;
+  }
+}
+
+/* ============================================================
+ * APERTURA
+ * ============================================================ */
+
+static aeon_stream_t *stream_alloc(const aeon_allocator_t *allocator) {
+  if (allocator == NULL)
+    allocator = aeon_k_default_allocator();
+  if (allocator->alloc == NULL)
+    return NULL;
+  aeon_stream_t *s =
+      allocator->alloc(sizeof(aeon_stream_t), AEON_CACHE_LINE, allocator->ctx);
+  if (s == NULL)
+    return NULL;
+  memset(s, 0, sizeof(*s));
+  s->allocator = *allocator;
+  return s;
+}
+
+/** Detecta el formato, lee la cabecera y reserva el bloque decodificado */
+static int stream_begin(aeon_stream_t *s, uint8_t csv_frac_bits,
+                        uint32_t chunk_frames) {
+  const uint8_t *head;
+  size_t have;
+  if (s->data != NULL) {
+    head = s->data;
+    have = s->size;
+  } else {
+    s->peek_len = (uint8_t)fread(s->peek, 1, AEON_STREAM_HEADER_SIZE,
+                                 (FILE *)s->file);
+    if (ferror((FILE *)s->file))
+      return -3;
+    head = s->peek;
+    have = s->peek_len;
+  }
+
+  if (have >= 4 && memcmp(head, STREAM_MAGIC, 4) == 0) {
+    if (have < AEON_STREAM_HEADER_SIZE || head[4] != AEON_STREAM_VERSION)
+      return -4;
+    s->binary = true;
+    s->frac_bits = head[5];
+    s->channels = rd16(&head[6]);
+    if (s->data != NULL)
+      s->pos = AEON_STREAM_HEADER_SIZE;
+    else
+      s->peek_pos = s->peek_len;
+    s->mapped = s->data != NULL && host_is_le();
+  } else {
+    /* CSV: la primera línea de datos fija los canales */
+    s->frac_bits = csv_frac_bits;
+    float values[AEON_STREAM_MAX_CHANNELS];
+    while (s->channels == 0 && next_line(s)) {
+      int n = parse_line(s->line, values, AEON_STREAM_MAX_CHANNELS);
+      if (n > 0) {
+        s->channels = (uint16_t)n;
+        s->line_ready = true;
+      } else {
+        s->skipped++;
+      }
+    }
+    if (s->file != NULL && ferror((FILE *)s->file))
+      return -3;
+  }
+  if (s->channels == 0 || s->frac_bits > MAX_FRAC_BITS)
+    return -4;
+
+  s->chunk_frames = chunk_frames != 0 ? chunk_frames : DEFAULT_CHUNK_FRAMES;
+  s->chunk = s->allocator.alloc((size_t)s->chunk_frames * s->channels *
+                                    sizeof(int16_t),
+                                AEON_CACHE_LINE, s->allocator.ctx);
+  return s->chunk != NULL ? 0 : -3;
+}
+
+aeon_stream_t *aeon_stream_open_memory(const void *data, size_t size,
+                                       uint8_t csv_frac_bits,
+                                       uint32_t chunk_frames,
+                                       const aeon_allocator_t *allocator,
+                                       int *error) {
+  int err_local;
+  int *err = error != NULL ? error : &err_local;
+  if (data == NULL) {
+    *err = -1;
+    return NULL;
+  }
+  aeon_stream_t *s = stream_alloc(allocator);
+  if (s == NULL) {
+    *err = -3;
+    return NULL;
+  }
+  s->data = data;
+  s->size = size;
+  *err = stream_begin(s, csv_frac_bits, chunk_frames);
+  if (*err != 0) {
+    aeon_stream_close(s);
+    return NULL;
+  }
+  return s;
+}
+
+aeon_stream_t *aeon_stream_open(const char *path, uint8_t csv_frac_bits,
+                                uint32_t chunk_frames,
+                                const aeon_allocator_t *allocator, int *error) {
+  int err_local;
+  int *err = error != NULL ? error : &err_local;
+  bool use_stdin = path == NULL || strcmp(path, "-") == 0;
+  FILE *f = use_stdin ? stdin : fopen(path, "rb");
+  if (f == NULL) {
+    *err = -2;
+    return NULL;
+  }
+
+#if AEON_HAVE_MMAP
+  /* Archivo regular sin leer todavía: proyectarlo y servir sin copia */
+  int fd = fileno(f);
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+      lseek(fd, 0, SEEK_CUR) == 0) {
+    size_t size = (size_t)st.st_size;
+    void *mem = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mem != MAP_FAILED) {
+      posix_madvise(mem, size, POSIX_MADV_SEQUENTIAL);
+      aeon_stream_t *s = aeon_stream_open_memory(mem, size, csv_frac_bits,
+                                                 chunk_frames, allocator, err);
+      if (s == NULL)
+        munmap(mem, size);
+      else
+        s->owns_map = true;
+      if (!use_stdin)
+        fclose(f);
+      return s;
+    }
+  }
+#endif
+
+  aeon_stream_t *s = stream_alloc(allocator);
+  if (s == NULL) {
+    if (!use_stdin)
+      fclose(f);
+    *err = -3;
+    return NULL;
+  }
+  s->file = f;
+  s->owns_file = !use_stdin;
+  *err = stream_begin(s, csv_frac_bits, chunk_frames);
+  if (*err != 0) {
+    aeon_stream_close(s);
+    return NULL;
+  }
+  return s;
+}
+
+void aeon_stream_close(aeon_stream_t *stream) {
+  if (stream == NULL)
+    return;
+  if (stream->owns_map)
+    aeon_k_unmap(stream->data, stream->size);
+  if (stream->owns_file)
+    fclose((FILE *)stream->file);
+  aeon_allocator_t allocator = stream->allocator;
+  if (allocator.free != NULL) {
+    if (stream->chunk != NULL)
+      allocator.free(stream->chunk, allocator.ctx);
+    allocator.free(stream, allocator.ctx);
+  }
+}
+
+/* ============================================================
+ * LECTURA
+ * ============================================================ */
+
+/** Cabecera del siguiente bloque no vacío; 0 si hay, 1 al final */
+static int next_block(aeon_stream_t *s) {
+  uint8_t hdr[BLOCK_HEADER_SIZE];
+  size_t frame_bytes = (size_t)s->channels * sizeof(int16_t);
+
+  while (s->block_left == 0) {
+    if (s->data != NULL) {
+      if (s->pos == s->size)
+        return 1;
+      if (s->size - s->pos < BLOCK_HEADER_SIZE)
+        return -4;
+      memcpy(hdr, s->data + s->pos, BLOCK_HEADER_SIZE);
+      s->pos += BLOCK_HEADER_SIZE;
+      uint32_t n = rd32(hdr);
+      if ((uint64_t)n * frame_bytes > s->size - s->pos)
+        return -4;
+      s->block_left = n;
+    } else {
+      size_t got = fread(hdr, 1, BLOCK_HEADER_SIZE, (FILE *)s->file);
+      if (got == 0)
+        return ferror((FILE *)s->file) ? -3 : 1;
+      if (got < BLOCK_HEADER_SIZE)
+        return -4;
+      s->block_left = rd32(hdr);
+    }
+  }
+  return 0;
+}
+
+static int32_t binary_next(aeon_stream_t *s, const int16_t **frames) {
+  int r = next_block(s);
+  if (r != 0)
+    return r > 0 ? 0 : r;
+
+  const size_t channels = s->channels;
+  uint32_t take;
+  if (s->data != NULL) {
+    const uint8_t *p = s->data + s->pos;
+    if (s->mapped && ((uintptr_t)p & 1) == 0) {
+      /* Sin copia: el bloque entero desde la proyección */
+      take = s->block_left < MAX_MAPPED_FRAMES ? s->block_left
+                                                : MAX_MAPPED_FRAMES;
+      *frames = (const int16_t *)(const void *)p;
+    } else {
+      take = s->block_left < s->chunk_frames ? s->block_left : s->chunk_frames;
+      decode16(s->chunk, p, (size_t)take * channels);
+      *frames = s->chunk;
+    }
+    s->pos += (size_t)take * channels * sizeof(int16_t);
+  } else {
+    take = s->block_left < s->chunk_frames ? s->block_left : s->chunk_frames;
+    size_t got = fread(s->chunk, channels * sizeof(int16_t), take,
+                       (FILE *)s->file);
+    if (got < take)
+      return ferror((FILE *)s->file) ? -3 : -4;
+    if (!host_is_le())
+      decode16(s->chunk, (const uint8_t *)s->chunk, (size_t)take * channels);
+    *frames = s->chunk;
+  }
+  s->block_left -= take;
+  return (int32_t)take;
+}
+
+int32_t aeon_stream_next(aeon_stream_t *stream, const int16_t **frames) {
+  if (stream == NULL || frames == NULL)
+    return -1;
+
+  int32_t n;
+  if (stream->binary) {
+    n = binary_next(stream, frames);
+  } else {
+    n = 0;
+    while ((uint32_t)n < stream->chunk_frames &&
+           csv_frame(stream, &stream->chunk[(size_t)n * stream->channels]))
+      n++;
+    if (stream->file != NULL && ferror((FILE *)stream->file))
+      return -3;
+    *frames = stream->chunk;
+  }
+  if (n > 0)
+    stream->frames += (uint64_t)n;
+  return n;
+}
+
+void aeon_stream_state(const aeon_stream_t *stream, const int16_t *frame,
+                       uint16_t first, uint16_t count, aeon_state_t *out) {
+  const int16_t *v = &frame[first];
+#if AEON_USE_FIXED_POINT
+  int shift = (int)stream->frac_bits - AEON_SCALE_BITS;
+  for (uint16_t i = 0; i < count; i++) {
+    if (shift >= 0)
+      out[i] = (aeon_state_t)v[i] >> shift;
+    else
+      out[i] = (aeon_state_t)v[i] * (1 << -shift);
+  }
+#else
+  const float scale = 1.0f / (float)(1u << stream->frac_bits);
+  for (uint16_t i = 0; i < count; i++)
+    out[i] = (float)v[i] * scale;
+#endif
+}
@@ -0,0 +1,305 @@
+/**
+ * @file aeon_trainer.c
+ * @brief Proyecto Eón - Entrenamiento Ridge incremental
+ *
+ * Las muestras se acumulan en S^T*S y S^T*Y según llegan; nunca se
+ * guarda la serie, solo un bloque de AEON_TRAIN_BLOCK muestras que se
+ * suma de una vez con suma compensada, así que el redondeo no crece
+ * con la longitud de la sesión. El olvido exponencial no reescala las
+ * matrices en cada paso: cada muestra nueva se acumula con peso f^-t
+ * (su fila del bloque, con sqrt(f^-t)) y la escala común se deshace al
+ * resolver (y, de vez en cuando, para no desbordar el float).
+ */
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <math.h>
+#include <string.h>
+
+/** Peso a partir del cual se renormalizan los acumuladores */
+#define TRAINER_RENORM 1e6f
+
+/* ============================================================
+ * CICLO DE VIDA
+ * ============================================================ */
+
+aeon_trainer_t *aeon_trainer_create(uint16_t reservoir_size,
+                                    uint16_t output_size,
+                                    const aeon_allocator_t *allocator) {
+  if (reservoir_size == 0 || output_size == 0)
+    return NULL;
+  if (allocator == NULL)
+    allocator = aeon_k_default_allocator();
+  if (allocator->alloc == NULL)
+    return NULL;
+
+  size_t n = reservoir_size;
+  size_t header = aeon_k_align(sizeof(aeon_trainer_t));
+  size_t tri = aeon_k_align(AEON_TRI_SIZE(n) * sizeof(float));
+  size_t sty = aeon_k_align(n * output_size * sizeof(float));
+  size_t yty = aeon_k_align(output_size * sizeof(float));
+  size_t comp = aeon_k_align((AEON_TRI_SIZE(n) + n * output_size +
+                              output_size) * sizeof(float));
+  size_t block = aeon_k_align((size_t)AEON_TRAIN_BLOCK *
+                              (n + output_size) * sizeof(float));
+  size_t work = aeon_k_align(2 * n * sizeof(float));
+  size_t total = header + 2 * tri + sty + yty + comp + block + work;
+
+  uint8_t *arena = allocator->alloc(total, AEON_CACHE_LINE, allocator->ctx);
+  if (arena == NULL)
+    return NULL;
+  memset(arena, 0, total);
+
+  aeon_trainer_t *trainer = (aeon_trainer_t *)(void *)arena;
+  trainer->reservoir_size = reservoir_size;
+  trainer->output_size = output_size;
+  trainer->lambda = AEON_RIDGE_LAMBDA;
+  trainer->StS = (float *)(void *)(arena + header);
+  trainer->StY = (float *)(void *)(arena + header + tri);
+  trainer->YtY = (float *)(void *)(arena + header + tri + sty);
+  trainer->factor = (float *)(void *)(arena + header + tri + sty + yty);
+  trainer->comp = (float *)(void *)(arena + header + 2 * tri + sty + yty);
+  trainer->block =
+      (float *)(void *)(arena + header + 2 * tri + sty + yty + comp);
+  trainer->work =
+      (float *)(void *)(arena + header + 2 * tri + sty + yty + comp + block);
+  trainer->allocator = *allocator;
+
+  aeon_trainer_begin(trainer, 1.0f, 0);
+  return trainer;
+}
+
+void aeon_trainer_destroy(aeon_trainer_t *trainer) {
+  if (trainer == NULL)
+    return;
+  aeon_allocator_t allocator = trainer->allocator;
+  if (allocator.free != NULL)
+    allocator.free(trainer, allocator.ctx);
+}
+
+/** Floats de S^T*S | S^T*Y | Y^T*Y (y de su compensación) */
+static size_t accumulator_size(const aeon_trainer_t *t) {
+  return AEON_TRI_SIZE(t->reservoir_size) +
+         (size_t)t->reservoir_size * t->output_size + t->output_size;
+}
+
+int aeon_trainer_begin(aeon_trainer_t *trainer, float forgetting,
+                       uint32_t washout) {
+  if (trainer == NULL)
+    return -1;
+  if (!(forgetting > 0.0f && forgetting <= 1.0f))
+    return -2;
+
+  /* La regularización se suma al resolver, para que el olvido no la
+   * haga desaparecer en sesiones largas */
+  aeon_k_ridge_init(trainer->StS, trainer->StY, trainer->YtY,
+                    trainer->reservoir_size, trainer->output_size, 0.0f);
+  memset(trainer->comp, 0, accumulator_size(trainer) * sizeof(float));
+
+  trainer->forgetting = forgetting;
+  trainer->washout = washout;
+  trainer->n_accumulated = 0;
+  trainer->mse = 0.0f;
+  trainer->weight = 1.0f;
+  trainer->weight_sum = 0.0;
+  trainer->pending = 0;
+  return 0;
+}
+
+/* ============================================================
+ * ACUMULACIÓN
+ * ============================================================ */
+
+/** Suma el bloque pendiente a los acumuladores */
+static void flush(aeon_trainer_t *t) {
+  if (t->pending == 0)
+    return;
+  aeon_k_accumulate_block(t->StS, t->StY, t->YtY, t->block,
+                          t->block + (size_t)AEON_TRAIN_BLOCK *
+                                         t->reservoir_size,
+                          t->pending, t->reservoir_size, t->output_size,
+                          t->work, t->comp);
+  t->pending = 0;
+}
+
+/** Divide los acumuladores por el peso actual y lo devuelve a 1 */
+static void renormalize(aeon_trainer_t *t) {
+  float inv = 1.0f / t->weight;
+  uint32_t tri = AEON_TRI_SIZE(t->reservoir_size);
+  uint32_t sty = (uint32_t)t->reservoir_size * t->output_size;
+
+  /* Las filas pendientes llevan la escala vieja */
+  flush(t);
+  for (uint32_t i = 0; i < tri; i++) {
+    t->StS[i] *= inv;
+  }
+  for (uint32_t i = 0; i < sty; i++) {
+    t->StY[i] *= inv;
+  }
+  for (int o = 0; o < t->output_size; o++) {
+    t->YtY[o] *= inv;
+  }
+  for (size_t i = 0; i < accumulator_size(t); i++) {
+    t->comp[i] *= inv;
+  }
+  t->weight_sum *= inv;
+  t->weight = 1.0f;
+}
+
+int aeon_trainer_accumulate(aeon_trainer_t *trainer, const aeon_state_t *state,
+                            const aeon_state_t *target) {
+  if (trainer == NULL || state == NULL || target == NULL)
+    return -1;
+
+  if (trainer->washout > 0) {
+    trainer->washout--;
+    return 0;
+  }
+
+  /* Cada muestra pesa 1/f más que la anterior: equivale a multiplicar
+   * lo acumulado por f, sin recorrer las matrices en cada paso */
+  if (trainer->n_accumulated > 0 && trainer->forgetting < 1.0f) {
+    trainer->weight /= trainer->forgetting;
+    if (trainer->weight > TRAINER_RENORM)
+      renormalize(trainer);
+  }
+
+  /* Fila del bloque escalada por sqrt(peso): B^T B suma peso * s s^T */
+  const int n = trainer->reservoir_size;
+  const int n_out = trainer->output_size;
+  const float scale = sqrtf(trainer->weight);
+  float *state_f = trainer->block + (size_t)trainer->pending * n;
+  float *target_f = trainer->block + (size_t)AEON_TRAIN_BLOCK * n +
+                    (size_t)trainer->pending * n_out;
+
+  for (int i = 0; i < n; i++) {
+#if AEON_USE_FIXED_POINT
+    state_f[i] = scale * ((float)state[i] / AEON_SCALE);
+#else
+    state_f[i] = scale * state[i];
+#endif
+  }
+  for (int o = 0; o < n_out; o++) {
+#if AEON_USE_FIXED_POINT
+    target_f[o] = scale * ((float)target[o] / AEON_SCALE);
+#else
+    target_f[o] = scale * target[o];
+#endif
+  }
+
+  trainer->weight_sum += trainer->weight;
+  trainer->n_accumulated++;
+  if (++trainer->pending == AEON_TRAIN_BLOCK)
+    flush(trainer);
+  return 1;
+}
+
+int aeon_trainer_push(aeon_trainer_t *trainer, aeon_core_t *core,
+                      const aeon_state_t *input, const aeon_state_t *target) {
+  if (trainer == NULL || core == NULL || input == NULL || target == NULL)
+    return -1;
+  if (trainer->reservoir_size != AEON_RESERVOIR_SIZE ||
+      trainer->output_size != AEON_OUTPUT_SIZE)
+    return -2;
+
+  aeon_update(core, input);
+  return aeon_trainer_accumulate(trainer, core->state, target);
+}
+
+int aeon_core_trainer_push(aeon_trainer_t *trainer, aeon_dyn_core_t *core,
+                           const aeon_state_t *input,
+                           const aeon_state_t *target) {
+  if (trainer == NULL || core == NULL || input == NULL || target == NULL)
+    return -1;
+  if (trainer->reservoir_size != core->config.reservoir_size ||
+      trainer->output_size != core->config.output_size)
+    return -2;
+
+  aeon_core_update(core, input);
+  return aeon_trainer_accumulate(trainer, core->state, target);
+}
+
+/* ============================================================
+ * RESOLUCIÓN
+ * ============================================================ */
+
+/**
+ * Factoriza una copia de S^T*S + ridge*I, escribe W_out y el MSE.
+ * Devuelve los reintentos con más ridge, o -5 si ninguno factoriza
+ */
+static int solve(aeon_trainer_t *t, aeon_weight_t *W_out) {
+  const uint16_t n = t->reservoir_size;
+  float *z = t->work;
+
+  /* Sumar el bloque a medias no cambia lo acumulado */
+  flush(t);
+
+  /* lambda es por muestra y los acumuladores están escalados por
+   * weight, igual que weight_sum: la regularización guarda la misma
+   * proporción con S^T*S con o sin olvido */
+  float ridge = t->lambda * (float)t->weight_sum;
+  int attempt = 0;
+  for (;; attempt++) {
+    memcpy(t->factor, t->StS, AEON_TRI_SIZE(n) * sizeof(float));
+    for (int i = 0; i < n; i++) {
+      t->factor[AEON_TRI_ROW(i) + i] += ridge;
+    }
+    if (aeon_k_ridge_solve(t->factor, t->StY, z, n, t->output_size,
+                           W_out) == 0)
+      break;
+    if (attempt == AEON_RIDGE_RETRIES)
+      return -5;
+    ridge *= AEON_RIDGE_GROWTH;
+  }
+
+  /* La escala común se cancela entre el error y la suma de pesos */
+  float sse = aeon_k_ridge_error(t->factor, t->StY, t->YtY, ridge, n,
+                                 t->output_size, W_out, z);
+  if (sse < 0.0f)
+    return -5;
+  t->mse = sse / ((float)t->weight_sum * t->output_size);
+  return attempt;
+}
+
+int aeon_trainer_finalize(aeon_trainer_t *trainer, aeon_core_t *core) {
+  if (trainer == NULL || core == NULL)
+    return -1;
+  if (trainer->reservoir_size != AEON_RESERVOIR_SIZE ||
+      trainer->output_size != AEON_OUTPUT_SIZE)
+    return -2;
+  if (trainer->n_accumulated == 0)
+    return -3;
+
+  AEON_STATS_BEGIN(t0);
+  int retries = solve(trainer, core->W_out);
+
+  if (retries >= 0) {
+    core->readout_sparse = false;
+    core->is_trained = true;
+    core->learning_sessions++;
+  }
+  AEON_STATS_END(AEON_EVENT_TRAIN, t0);
+  return retries;
+}
+
+int aeon_core_trainer_finalize(aeon_trainer_t *trainer, aeon_dyn_core_t *core) {
+  if (trainer == NULL || core == NULL)
+    return -1;
+  if (trainer->reservoir_size != core->config.reservoir_size ||
+      trainer->output_size != core->config.output_size)
+    return -2;
+  if (trainer->n_accumulated == 0)
+    return -3;
+  if (core->mapping != NULL)
+    return -4;
+
+  AEON_STATS_BEGIN(t0);
+  int retries = solve(trainer, core->W_out);
+
+  if (retries >= 0) {
+    core->is_trained = true;
+    core->learning_sessions++;
+  }
+  AEON_STATS_END(AEON_EVENT_TRAIN, t0);
+  return retries;
+}
@@ -6,6 +6,20 @@
  * que incluyen cambios bruscos (picos climáticos), guardando
  * pesos periódicamente para simular "vida" de un sensor.
  *
+ * El aprendizaje es incremental: cada muestra se empuja al
+ * entrenador en cuanto llega y W_out se resuelve al final de cada
+ * epoch sin olvidar las anteriores (salvo el factor de olvido).
+ * El MSE de cada epoch es prequential: se mide prediciendo con el
+ * W_out de la epoch anterior antes de aprender de la muestra.
+ *
+ * Con un umbral delta > 0 el reservoir avanza en modo delta
+ * (aeon_delta_update): solo se propagan los cambios que lo superan.
+ *
+ * Los guardados periódicos van a un log de checkpoints (solo se añade
+ * lo que cambió: estado, W_out, contadores). Si al arrancar ya existe
+ * el log, el núcleo se restaura de su último checkpoint consistente y
+ * sigue aprendiendo.
+ *
  * Plan de Alimentación Inmediata - Fase 1
  *
  * (c) 2024 SenseLab - Build with Sense
@@ -111,6 +125,8 @@ int main(int argc, char *argv[]) {
   int n_epochs = 10;
   int save_interval = 2;
   int samples_per_epoch = 500;
+  float forgetting = 0.999f;
+  float delta_threshold = 0.0f;
 
   if (argc > 1)
     n_epochs = atoi(argv[1]);
@@ -118,6 +134,10 @@ int main(int argc, char *argv[]) {
     save_interval = atoi(argv[2]);
   if (argc > 3)
     samples_per_epoch = atoi(argv[3]);
+  if (argc > 4)
+    forgetting = (float)atof(argv[4]);
+  if (argc > 5)
+    delta_threshold = (float)atof(argv[5]);
 
   signal(SIGINT, signal_handler);
 
@@ -126,18 +146,34 @@ int main(int argc, char *argv[]) {
   printf("\n  Configuración:\n");
   printf("    • Epochs: %d\n", n_epochs);
   printf("    • Muestras/epoch: %d\n", samples_per_epoch);
-  printf("    • Guardar cada: %d epochs\n", save_interval);
+  printf("    • Checkpoint cada: %d epochs\n", save_interval);
+  printf("    • Factor de olvido: %.4f\n", forgetting);
+  if (delta_threshold > 0.0f)
+    printf("    • Umbral delta: %.4f\n", delta_threshold);
   printf("    • Ctrl+C para detener\n");
 
-  /* Crear núcleo */
+  /* Crear núcleo, o retomarlo del log de checkpoints */
   aeon_core_t core;
   uint32_t seed = (uint32_t)time(NULL);
-
-  printf("\n[1] Momento Cero (Nacimiento)...\n");
-  int result = aeon_birth(&core, seed);
-  if (result != 0) {
-    printf("Error en nacimiento: %d\n", result);
-    return 1;
+  const char *log_file = "aeon_checkpoint.log";
+
+  int restored = aeon_checkpoint_restore(&core, log_file);
+  if (restored >= 0) {
+    seed = core.certificate.reservoir_seed;
+    printf("\n[1] Reanudando desde %s (%d checkpoints)...\n", log_file,
+           restored);
+  } else {
+    if (restored != -2) {
+      printf("\n[!] %s no es válido para este núcleo (%d), se reinicia\n",
+             log_file, restored);
+      remove(log_file);
+    }
+    printf("\n[1] Momento Cero (Nacimiento)...\n");
+    int result = aeon_birth(&core, seed);
+    if (result != 0) {
+      printf("Error en nacimiento: %d\n", result);
+      return 1;
+    }
   }
 
   char hash_str[33];
@@ -150,11 +186,36 @@ int main(int argc, char *argv[]) {
   aeon_state_t *inputs = malloc(samples_per_epoch * sizeof(aeon_state_t));
   aeon_state_t *targets = malloc(samples_per_epoch * sizeof(aeon_state_t));
 
-  if (!inputs || !targets) {
+  aeon_trainer_t *trainer =
+      aeon_trainer_create(AEON_RESERVOIR_SIZE, AEON_OUTPUT_SIZE, NULL);
+
+  aeon_delta_t *delta = NULL;
+  if (delta_threshold > 0.0f) {
+    delta = aeon_delta_create(AEON_RESERVOIR_SIZE, AEON_INPUT_SIZE, NULL);
+#if AEON_USE_FIXED_POINT
+    aeon_delta_begin(delta, (aeon_state_t)(delta_threshold * AEON_SCALE));
+#else
+    aeon_delta_begin(delta, delta_threshold);
+#endif
+  }
+
+  if (!inputs || !targets || !trainer || (delta_threshold > 0.0f && !delta)) {
     printf("Error: sin memoria\n");
     return 1;
   }
 
+  int ckpt_err;
+  aeon_checkpoint_t *ckpt =
+      aeon_checkpoint_open(log_file, &core, NULL, &ckpt_err);
+  if (ckpt == NULL) {
+    printf("Error: no se puede abrir %s (%d)\n", log_file, ckpt_err);
+    return 1;
+  }
+  if (aeon_trainer_begin(trainer, forgetting, 50) != 0) {
+    printf("Error: factor de olvido fuera de (0, 1]\n");
+    return 1;
+  }
+
   /* === BUCLE DE APRENDIZAJE CONTINUO === */
   print_header("APRENDIZAJE CONTINUO (Serie Climática)");
 
@@ -172,22 +233,47 @@ int main(int argc, char *argv[]) {
     }
     targets[samples_per_epoch - 1] = inputs[0];
 
-    /* Entrenar */
-    float mse = aeon_train(&core, inputs, targets, samples_per_epoch, 50);
+    /* Aprender muestra a muestra, midiendo antes de aprender */
+    float mse = 0.0f;
+    for (int i = 0; i < samples_per_epoch; i++) {
+      if (delta != NULL) {
+        aeon_delta_update(delta, &core, &inputs[i]);
+        aeon_trainer_accumulate(trainer, core.state, &targets[i]);
+      } else {
+        aeon_trainer_push(trainer, &core, &inputs[i], &targets[i]);
+      }
+
+      aeon_state_t pred;
+      aeon_predict(&core, &pred);
+#if AEON_USE_FIXED_POINT
+      float diff = (float)(pred - targets[i]) / AEON_SCALE;
+#else
+      float diff = pred - targets[i];
+#endif
+      mse += diff * diff;
+    }
+    mse /= (float)samples_per_epoch;
     total_mse += mse;
 
+    /* Resolver W_out con todo lo acumulado */
+    aeon_trainer_finalize(trainer, &core);
+
     if (mse < best_mse) {
       best_mse = mse;
     }
 
     print_progress_bar(epoch, n_epochs, mse);
 
-    /* Guardar periódicamente */
+    /* Checkpoint periódico: se copia lo cambiado y se escribe aparte */
     if (epoch % save_interval == 0) {
-      char filename[64];
-      snprintf(filename, sizeof(filename), "aeon_epoch_%03d.bin", epoch);
-      aeon_save(&core, filename);
-      printf(" → Guardado: %s", filename);
+      int changed = aeon_checkpoint_save(ckpt, &core);
+      if (changed < 0)
+        printf(" → Error de checkpoint: %d", changed);
+      else
+        printf(" → Checkpoint:%s%s%s",
+               changed & AEON_CHECKPOINT_STATE ? " estado" : "",
+               changed & AEON_CHECKPOINT_W_OUT ? " W_out" : "",
+               changed & AEON_CHECKPOINT_COUNTERS ? " contadores" : "");
     }
 
     printf("\n");
@@ -211,8 +297,24 @@ int main(int argc, char *argv[]) {
   printf("  • MSE promedio: %.6f\n", avg_mse);
   printf("  • Mejor MSE: %.6f\n", best_mse);
   printf("  • Edad: %u segundos\n", aeon_age_seconds(&core));
+  if (delta != NULL) {
+    printf("  • MACs evitadas (delta): %.1f%% (%llu de %llu)\n",
+           delta->ops_total
+               ? 100.0 * (double)delta->ops_skipped / (double)delta->ops_total
+               : 0.0,
+           (unsigned long long)delta->ops_skipped,
+           (unsigned long long)delta->ops_total);
+  }
   printf("\n");
 
+  /* Último checkpoint y log en disco */
+  aeon_checkpoint_save(ckpt, &core);
+  if (aeon_checkpoint_flush(ckpt) == 0) {
+    printf("  ✓ Log de checkpoints: %s (%u registros añadidos, %llu bytes)\n",
+           log_file, ckpt->records, (unsigned long long)ckpt->bytes);
+  }
+  aeon_checkpoint_close(ckpt);
+
   /* Guardar estado final */
   const char *final_file = "aeon_final.bin";
   if (aeon_save(&core, final_file) == 0) {
@@ -220,6 +322,8 @@ int main(int argc, char *argv[]) {
   }
 
   /* Limpiar */
+  aeon_trainer_destroy(trainer);
+  aeon_delta_destroy(delta);
   free(inputs);
   free(targets);
 
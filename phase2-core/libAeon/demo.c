@@ -52,7 +52,7 @@ int main(void) {
          (long)core.certificate.birth_time);
   printf("    ✓ Hash: %s\n", hash_str);
   printf("    ✓ Reservoir: %d neuronas\n", core.certificate.reservoir_size);
-  printf("    ✓ Conexiones escasas: %d\n", core.sparse_count);
+  printf("    ✓ Conexiones escasas: %u\n", (unsigned)core.sparse_count);
   printf("    ✓ Memoria: %u bytes\n", aeon_memory_usage(&core));
 
   /* === GENERAR DATOS === */
@@ -139,6 +139,8 @@ int main(void) {
   printf("    ✓ Umbral: %.2f\n", threshold);
   printf("    ✓ Conexiones podadas: %d / %d\n", pruned,
          AEON_OUTPUT_SIZE * AEON_RESERVOIR_SIZE);
+  printf("    ✓ Lectura: %s\n",
+         core.readout_sparse ? "escasa (solo supervivientes)" : "densa");
 
   /* Verificar impacto en precisión */
   aeon_reset(&core);
@@ -169,7 +171,7 @@ int main(void) {
   printf("  • Tamaño del núcleo: %u bytes (%.2f KB)\n",
          aeon_memory_usage(&core), (float)aeon_memory_usage(&core) / 1024.0f);
   printf("  • Reservoir: %d neuronas\n", AEON_RESERVOIR_SIZE);
-  printf("  • Conexiones: %d (escasas)\n", core.sparse_count);
+  printf("  • Conexiones: %u (escasas)\n", (unsigned)core.sparse_count);
   printf("  • Punto fijo: %s\n",
          AEON_USE_FIXED_POINT ? "Sí (Q8.8)" : "No (float)");
   printf("  • Edad: %u segundos\n", aeon_age_seconds(&core));
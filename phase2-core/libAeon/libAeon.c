@@ -6,9 +6,12 @@
  */
 
 #include "libAeon.h"
+#include "aeon_kernels.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <float.h>
+#include <limits.h>
 #include <math.h>  /* Para fabsf() */
 
 /* ============================================================
@@ -37,28 +40,7 @@ uint32_t aeon_random(uint32_t *state) {
  * Mejora: Error reducido de ~5% a ~1% con x - x³/3 + x⁵/15
  * Para punto fijo: tanh(x) ≈ x para |x| < 1, ±1 para |x| > 1
  */
-aeon_state_t aeon_tanh_approx(aeon_state_t x) {
-#if AEON_USE_FIXED_POINT
-  /* Saturación simple para punto fijo */
-  if (x > AEON_SCALE)
-    return AEON_SCALE;
-  if (x < -AEON_SCALE)
-    return -AEON_SCALE;
-  /* Aproximación mejorada: tanh(x) ≈ x - x³/3 + x⁵/15 para |x| < 1 */
-  aeon_state_t x2 = (x * x) >> AEON_SCALE_BITS;
-  aeon_state_t x3 = (x2 * x) >> AEON_SCALE_BITS;
-  aeon_state_t x5 = (x3 * x2) >> AEON_SCALE_BITS;
-  return x - (x3 / 3) + (x5 / 15);
-#else
-  /* Aproximación polinomial mejorada de tanh */
-  if (x > 2.0f)
-    return 1.0f;
-  if (x < -2.0f)
-    return -1.0f;
-  float x2 = x * x;
-  return x * (1.0f - x2 / 3.0f + x2 * x2 / 15.0f);
-#endif
-}
+aeon_state_t aeon_tanh_approx(aeon_state_t x) { return aeon_k_tanh(x); }
 
 /**
  * @brief Genera hash simple basado en datos
@@ -83,85 +65,315 @@ static void generate_hash(aeon_hash_t *hash, uint32_t seed, time_t timestamp) {
  * MOMENTO CERO - NACIMIENTO
  * ============================================================ */
 
-int aeon_birth(aeon_core_t *core, uint32_t seed) {
-  if (core == NULL)
-    return -1;
-
-  /* Limpiar toda la estructura */
-  memset(core, 0, sizeof(aeon_core_t));
-
+uint32_t aeon_k_certify(aeon_certificate_t *cert, uint32_t seed,
+                        uint16_t n_res) {
   /* === MOMENTO CERO === */
-  core->certificate.birth_time = time(NULL);
+  cert->birth_time = time(NULL);
 
   /* Generar semilla si no se proporcionó */
   if (seed == 0) {
-    seed = (uint32_t)core->certificate.birth_time;
+    seed = (uint32_t)cert->birth_time;
   }
-  core->certificate.reservoir_seed = seed;
+  cert->reservoir_seed = seed;
 
   /* Generar hash de nacimiento */
-  generate_hash(&core->certificate.birth_hash, seed,
-                core->certificate.birth_time);
+  generate_hash(&cert->birth_hash, seed, cert->birth_time);
 
   /* Metadatos */
-  core->certificate.reservoir_size = AEON_RESERVOIR_SIZE;
-  core->certificate.version = AEON_VERSION;
+  cert->reservoir_size = n_res;
+  cert->version = AEON_VERSION;
+
+  return seed;
+}
+
+/**
+ * Índice del bit menos significativo a 1 (x != 0)
+ *
+ * Con int de 16 bits (AVR) __builtin_ctz perdería la mitad alta:
+ * ahí uint32_t es unsigned long.
+ */
+static inline int lowest_bit(uint32_t x) {
+#if defined(__GNUC__) && UINT_MAX >= UINT32_MAX
+  return __builtin_ctz(x);
+#elif defined(__GNUC__)
+  return __builtin_ctzl(x);
+#else
+  int b = 0;
+  while (!(x & 1u)) {
+    x >>= 1;
+    b++;
+  }
+  return b;
+#endif
+}
+
+/* ============================================================
+ * RADIO ESPECTRAL
+ *
+ * Iteración de potencia con norma-máximo: x se renormaliza en cada
+ * paso y el radio es la media geométrica del crecimiento de |x|max
+ * tras un calentamiento (con autovalores complejos la norma oscila de
+ * un paso a otro, pero no en media). En punto fijo x vale POWER_ONE
+ * en su máximo y el producto se acumula en 64 bits.
+ * ============================================================ */
+
+#define POWER_ITERATIONS 96
+#define POWER_BURN_IN 32
+
+#if AEON_USE_FIXED_POINT
+#define POWER_ONE (1 << 14)
+typedef int64_t power_acc_t;
+#else
+#define POWER_ONE 1.0f
+typedef float power_acc_t;
+#endif
 
+/** y = W_reservoir * x, en la escala de x */
+static void reservoir_product(const aeon_view_t *v, const aeon_state_t *x,
+                              aeon_state_t *y) {
+  const uint16_t n = v->n_res;
+  const uint32_t key_res = aeon_k_hash(v->seed, AEON_PROC_STREAM_RES);
+  const uint32_t fan_in = aeon_k_proc_fan_in(n, v->sparsity);
+
+  for (uint32_t i = 0; i < n; i++) {
+    power_acc_t sum = 0;
+    if (v->procedural) {
+      for (uint32_t t = 0, c = i * fan_in; t < fan_in; t++, c++) {
+        uint32_t h = aeon_k_hash(key_res, c);
+        sum += (power_acc_t)aeon_k_proc_scaled(h, v->gain) *
+               x[aeon_k_proc_col(h, n)];
+      }
+    } else {
+      for (uint32_t k = v->row_ptr[i]; k < v->row_ptr[i + 1]; k++) {
+        sum += (power_acc_t)aeon_k_weight(v->W_reservoir[k]) *
+               x[v->col_indices[k]];
+      }
+    }
+#if AEON_USE_FIXED_POINT
+    y[i] = (aeon_state_t)(sum >> AEON_SCALE_BITS);
+#else
+    y[i] = sum;
+#endif
+  }
+}
+
+float aeon_k_spectral_radius(const aeon_view_t *v) {
+  const uint16_t n = v->n_res;
+  aeon_state_t *x = v->state;
+  aeon_state_t *y = v->scratch;
+  float log_growth = 0.0f;
+  float radius = 0.0f;
+
+  for (uint32_t i = 0; i < n; i++)
+    x[i] = POWER_ONE;
+
+  int it = 0;
+  for (; it < POWER_ITERATIONS; it++) {
+    reservoir_product(v, x, y);
+    aeon_state_t peak = 0;
+    for (uint32_t i = 0; i < n; i++) {
+      aeon_state_t a = y[i] < 0 ? -y[i] : y[i];
+      if (a > peak)
+        peak = a;
+    }
+    if (peak == 0)
+      break; /* Nilpotente (o sin conexiones): radio 0 */
+    if (it >= POWER_BURN_IN)
+      log_growth += logf((float)peak / (float)POWER_ONE);
+    for (uint32_t i = 0; i < n; i++) {
+#if AEON_USE_FIXED_POINT
+      x[i] = (aeon_state_t)(((int64_t)y[i] * POWER_ONE) / peak);
+#else
+      x[i] = y[i] / peak;
+#endif
+    }
+  }
+  if (it == POWER_ITERATIONS)
+    radius = expf(log_growth / (float)(POWER_ITERATIONS - POWER_BURN_IN));
+
+  memset(x, 0, n * sizeof(aeon_state_t));
+  memset(y, 0, n * sizeof(aeon_state_t));
+  return radius;
+}
+
+aeon_state_t aeon_k_proc_gain(const aeon_view_t *v) {
+  const aeon_state_t one = aeon_k_fraction(1.0f);
+  if (!(v->spectral_radius > 0.0f))
+    return one;
+
+  aeon_view_t unit = *v;
+  unit.gain = one;
+  float radius = aeon_k_spectral_radius(&unit);
+  if (radius <= 0.0f)
+    return one;
+  aeon_state_t gain = aeon_k_fraction(v->spectral_radius / radius);
+  return gain > 0 ? gain : 1;
+}
+
+/** Reescala W_reservoir (ya generado) al radio v->spectral_radius */
+static void normalize_reservoir(const aeon_view_t *v, uint32_t nnz) {
+  float radius = aeon_k_spectral_radius(v);
+  if (radius <= 0.0f)
+    return;
+  float f = v->spectral_radius / radius;
+  for (uint32_t k = 0; k < nnz; k++) {
+#if AEON_USE_FIXED_POINT
+    long w = lrintf((float)v->W_reservoir[k] * f);
+    if (w > INT16_MAX)
+      w = INT16_MAX;
+    if (w < INT16_MIN)
+      w = INT16_MIN;
+    v->W_reservoir[k] = (aeon_weight_t)w;
+#else
+    v->W_reservoir[k] =
+        aeon_weight_from_float(aeon_weight_to_float(v->W_reservoir[k]) * f);
+#endif
+  }
+}
+
+uint32_t aeon_k_generate(const aeon_view_t *v, uint32_t seed,
+                         uint32_t *seen) {
   /* === INICIALIZAR RESERVOIR ("LA NADA") === */
   uint32_t rng_state = seed;
+  uint16_t n = v->n_res;
 
   /* W_in: Pesos de entrada aleatorios */
-  for (int i = 0; i < AEON_RESERVOIR_SIZE * AEON_INPUT_SIZE; i++) {
+  for (uint32_t i = 0; i < (uint32_t)n * v->n_in; i++) {
     uint32_t r = aeon_random(&rng_state);
 #if AEON_USE_FIXED_POINT
     /* Rango [-128, 127] mapeado a [-1, 1) en punto fijo */
-    core->W_in[i] = (aeon_weight_t)((r % 256) - 128);
+    v->W_in[i] = (aeon_weight_t)((r % 256) - 128);
 #else
-    core->W_in[i] = ((float)(r % 1000) / 500.0f) - 1.0f;
+    v->W_in[i] = aeon_weight_from_float(((float)(r % 1000) / 500.0f) - 1.0f);
 #endif
   }
 
-  /* W_reservoir: Conexiones escasas */
-  core->sparse_count = 0;
-  int total_connections = AEON_RESERVOIR_SIZE * AEON_RESERVOIR_SIZE;
-  int target_connections = total_connections / AEON_SPARSITY_FACTOR;
-
-  for (int i = 0;
-       i < target_connections &&
-       core->sparse_count <
-           (AEON_RESERVOIR_SIZE * AEON_RESERVOIR_SIZE / AEON_SPARSITY_FACTOR);
-       i++) {
+  /*
+   * W_reservoir: Conexiones escasas en CSR, en O(nnz).
+   *
+   * La secuencia de sorteos es la de siempre (candidato; si no está
+   * repetido, su peso), así que cada semilla sigue dando el mismo
+   * reservoir. Se recorre dos veces:
+   *   1. Un bitset de n*n bits marca qué candidatos sobreviven.
+   *   2. El bitset, leído en orden, da row_ptr y col_indices.
+   *   3. Se repite la secuencia y cada peso va a su posición CSR
+   *      (el bit se borra al colocarlo: los repetidos ya no lo ven).
+   */
+  uint32_t total_connections = (uint32_t)n * n;
+  uint32_t target_connections = total_connections / v->sparsity;
+  uint32_t words = AEON_GENERATE_WORK_WORDS(n);
+  const uint32_t rng_reservoir = rng_state;
+
+  memset(seen, 0, words * sizeof(uint32_t));
+  for (uint32_t i = 0; i < target_connections; i++) {
+    uint32_t idx = aeon_random(&rng_state) % total_connections;
+    uint32_t bit = (uint32_t)1 << (idx & 31);
+    if (seen[idx >> 5] & bit)
+      continue;
+    seen[idx >> 5] |= bit;
+    aeon_random(&rng_state); /* Peso, se sortea en la segunda pasada */
+  }
 
-    uint32_t r = aeon_random(&rng_state);
-    uint16_t idx = r % total_connections;
-
-    /* Evitar duplicados (simple) */
-    bool exists = false;
-    for (int j = 0; j < core->sparse_count; j++) {
-      if (core->sparse_indices[j] == idx) {
-        exists = true;
-        break;
+  uint32_t sparse_count = 0;
+  uint32_t row = 0;
+  v->row_ptr[0] = 0;
+  for (uint32_t w = 0; w < words; w++) {
+    uint32_t bits = seen[w];
+    while (bits) {
+      uint32_t idx = (w << 5) + (uint32_t)lowest_bit(bits);
+      bits &= bits - 1;
+      while (row < idx / n) {
+        v->row_ptr[++row] = sparse_count;
       }
+      v->col_indices[sparse_count++] = (uint16_t)(idx % n);
+    }
+  }
+  while (row < n) {
+    v->row_ptr[++row] = sparse_count;
+  }
+
+  rng_state = rng_reservoir;
+  for (uint32_t i = 0; i < target_connections; i++) {
+    uint32_t idx = aeon_random(&rng_state) % total_connections;
+    uint32_t bit = (uint32_t)1 << (idx & 31);
+    if (!(seen[idx >> 5] & bit))
+      continue;
+    seen[idx >> 5] &= ~bit;
+
+    /* Búsqueda binaria de la columna dentro de su fila */
+    uint32_t r_row = idx / n;
+    uint16_t col = (uint16_t)(idx % n);
+    uint32_t lo = v->row_ptr[r_row];
+    uint32_t hi = v->row_ptr[r_row + 1];
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (v->col_indices[mid] < col)
+        lo = mid + 1;
+      else
+        hi = mid;
     }
 
-    if (!exists) {
-      core->sparse_indices[core->sparse_count] = idx;
-      r = aeon_random(&rng_state);
+    uint32_t r = aeon_random(&rng_state);
 #if AEON_USE_FIXED_POINT
-      core->W_reservoir[core->sparse_count] = (aeon_weight_t)((r % 256) - 128);
+    v->W_reservoir[lo] = (aeon_weight_t)((r % 256) - 128);
 #else
-      core->W_reservoir[core->sparse_count] =
-          ((float)(r % 1000) / 500.0f) - 1.0f;
+    v->W_reservoir[lo] =
+        aeon_weight_from_float(((float)(r % 1000) / 500.0f) - 1.0f);
 #endif
-      core->sparse_count++;
-    }
   }
 
-  /* W_out: Inicializar a cero (se entrena después) */
-  memset(core->W_out, 0, sizeof(core->W_out));
+  if (v->spectral_radius > 0.0f)
+    normalize_reservoir(v, sparse_count);
+  return sparse_count;
+}
+
+/** Vista sobre las arrays del núcleo estático */
+static aeon_view_t static_view(aeon_core_t *core, aeon_state_t *scratch) {
+  aeon_view_t v;
+  v.n_res = AEON_RESERVOIR_SIZE;
+  v.n_in = AEON_INPUT_SIZE;
+  v.n_out = AEON_OUTPUT_SIZE;
+  v.sparsity = AEON_SPARSITY_FACTOR;
+  v.state = core->state;
+  v.scratch = scratch;
+  v.W_in = core->W_in;
+  v.W_reservoir = core->W_reservoir;
+  v.W_out = core->W_out;
+  v.col_indices = core->col_indices;
+  v.row_ptr = core->row_ptr;
+  v.procedural = false;
+  v.seed = core->certificate.reservoir_seed;
+  v.spectral_radius = core->spectral_radius;
+  v.leak = aeon_k_leak(core->leak_rate);
+  v.gain = aeon_k_fraction(1.0f);
+  return v;
+}
+
+int aeon_birth(aeon_core_t *core, uint32_t seed) {
+  return aeon_birth_spectral(core, seed, AEON_SPECTRAL_RADIUS);
+}
+
+int aeon_birth_spectral(aeon_core_t *core, uint32_t seed,
+                        float spectral_radius) {
+  if (core == NULL)
+    return -1;
+  if (!(spectral_radius >= 0.0f))
+    return -2;
+
+  /* Limpiar toda la estructura (W_out y estado quedan a cero) */
+  memset(core, 0, sizeof(aeon_core_t));
+  core->spectral_radius = spectral_radius;
+  core->leak_rate = AEON_LEAK_RATE;
+
+  seed = aeon_k_certify(&core->certificate, seed, AEON_RESERVOIR_SIZE);
+
+  /* Bitset de conexiones (n*n bits) solo durante el nacimiento; el
+   * estado y scratch sirven de vectores a la iteración de potencia */
+  uint32_t seen[AEON_GENERATE_WORK_WORDS(AEON_RESERVOIR_SIZE)];
+  aeon_state_t scratch[AEON_RESERVOIR_SIZE];
+  aeon_view_t v = static_view(core, scratch);
+  core->sparse_count = aeon_k_generate(&v, seed, seen);
 
-  /* Estado inicial */
-  memset(core->state, 0, sizeof(core->state));
   core->samples_processed = 0;
   core->learning_sessions = 0;
   core->is_trained = false;
@@ -169,159 +381,386 @@ int aeon_birth(aeon_core_t *core, uint32_t seed) {
   return 0;
 }
 
+float aeon_spectral_radius(const aeon_core_t *core) {
+  if (core == NULL)
+    return -1.0f;
+  aeon_state_t x[AEON_RESERVOIR_SIZE];
+  aeon_state_t y[AEON_RESERVOIR_SIZE];
+  aeon_view_t v = static_view((aeon_core_t *)core, y);
+  v.state = x;
+  return aeon_k_spectral_radius(&v);
+}
+
 /* ============================================================
- * PERSISTENCIA
+ * PROCESAMIENTO
  * ============================================================ */
 
-int aeon_save(const aeon_core_t *core, const char *filename) {
-  if (core == NULL || filename == NULL)
-    return -1;
+void aeon_update(aeon_core_t *core, const aeon_state_t *input) {
+  if (core == NULL || input == NULL)
+    return;
 
-  FILE *f = fopen(filename, "wb");
-  if (f == NULL)
-    return -2;
+  AEON_STATS_BEGIN(t0);
+  aeon_state_t new_state[AEON_RESERVOIR_SIZE];
+  aeon_k_step(AEON_RESERVOIR_SIZE, AEON_INPUT_SIZE, core->W_in, core->row_ptr,
+              core->col_indices, core->W_reservoir, core->state, input,
+              new_state, aeon_k_leak(core->leak_rate));
 
-  /* Escribir estructura completa */
-  size_t written = fwrite(core, sizeof(aeon_core_t), 1, f);
-  fclose(f);
+  core->samples_processed++;
+  AEON_STATS_END(AEON_EVENT_UPDATE, t0);
+}
 
-  return (written == 1) ? 0 : -3;
+void aeon_predict(const aeon_core_t *core, aeon_state_t *output) {
+  if (core == NULL || output == NULL)
+    return;
+
+  /* output = W_out * state */
+  AEON_STATS_BEGIN(t0);
+  if (core->readout_sparse) {
+    aeon_k_readout_sparse(AEON_OUTPUT_SIZE, core->readout_ptr,
+                          core->readout_index, core->readout_weight,
+                          core->state, output);
+  } else {
+    aeon_k_readout(AEON_RESERVOIR_SIZE, AEON_OUTPUT_SIZE, core->W_out,
+                   core->state, output);
+  }
+  AEON_STATS_SCAN(output, NULL, AEON_OUTPUT_SIZE);
+  AEON_STATS_END(AEON_EVENT_PREDICT, t0);
 }
 
-int aeon_load(aeon_core_t *core, const char *filename) {
-  if (core == NULL || filename == NULL)
+int aeon_generate(const aeon_core_t *core, uint32_t horizon,
+                  aeon_state_t *out) {
+  if (core == NULL || out == NULL)
     return -1;
-
-  FILE *f = fopen(filename, "rb");
-  if (f == NULL)
+  if (AEON_INPUT_SIZE != AEON_OUTPUT_SIZE)
     return -2;
 
-  /* Verificar tamaño del archivo antes de leer */
-  fseek(f, 0, SEEK_END);
-  long file_size = ftell(f);
-  fseek(f, 0, SEEK_SET);
-  
-  if (file_size != (long)sizeof(aeon_core_t)) {
-    fclose(f);
-    return -4;  /* Error: tamaño de archivo inválido */
+  AEON_STATS_BEGIN(t0);
+  aeon_state_t state[AEON_RESERVOIR_SIZE];
+  aeon_state_t scratch[AEON_RESERVOIR_SIZE];
+  memcpy(state, core->state, sizeof(state));
+
+  /* La vista solo se lee: el estado que avanza es la copia */
+  aeon_view_t v = static_view((aeon_core_t *)core, scratch);
+  v.state = state;
+  if (core->readout_sparse) {
+    aeon_k_forecast(&v, core->readout_ptr, core->readout_index,
+                    core->readout_weight, horizon, out);
+  } else {
+    aeon_k_forecast(&v, NULL, NULL, NULL, horizon, out);
   }
+  AEON_STATS_SCAN(out, NULL, horizon * AEON_OUTPUT_SIZE);
+  AEON_STATS_END(AEON_EVENT_PREDICT, t0);
+  return 0;
+}
 
-  /* Leer estructura completa */
-  size_t bytes_read = fread(core, sizeof(aeon_core_t), 1, f);
-  fclose(f);
+void aeon_reset(aeon_core_t *core) {
+  if (core == NULL)
+    return;
+  memset(core->state, 0, sizeof(core->state));
+}
+
+/* ============================================================
+ * ENTRENAMIENTO
+ * ============================================================ */
 
-  if (bytes_read != 1) {
-    return -3;  /* Error de lectura */
+/* ------------------------------------------------------------
+ * Regresión Ridge con S^T*S en almacenamiento triangular empaquetado:
+ * el elemento (i, j) con j <= i vive en P[i * (i + 1) / 2 + j].
+ * ------------------------------------------------------------ */
+
+void aeon_k_ridge_init(float *StS, float *StY, float *YtY, uint16_t n,
+                       uint16_t n_out, float lambda) {
+  for (int i = 0; i < n; i++) {
+    float *row = &StS[AEON_TRI_ROW(i)];
+    for (int j = 0; j < i; j++) {
+      row[j] = 0.0f;
+    }
+    row[i] = lambda;
+    for (int o = 0; o < n_out; o++) {
+      StY[i * n_out + o] = 0.0f;
+    }
   }
+  for (int o = 0; o < n_out; o++) {
+    YtY[o] = 0.0f;
+  }
+}
 
-  /* Validar datos cargados */
-  if (core->certificate.reservoir_size != AEON_RESERVOIR_SIZE) {
-    return -5;  /* Error: configuración incompatible */
+/** dst += x, con suma compensada (Kahan) si hay comp */
+static inline void add_compensated(float *dst, float *comp, float x) {
+  if (comp == NULL) {
+    *dst += x;
+    return;
   }
-  
-  /* Validar versión (versión mayor debe coincidir) */
-  uint16_t loaded_major = core->certificate.version >> 8;
-  if (loaded_major != AEON_VERSION_MAJOR) {
-    return -6;  /* Error: versión incompatible */
+  float y = x - *comp;
+  float t = *dst + y;
+  *comp = (t - *dst) - y;
+  *dst = t;
+}
+
+void aeon_k_accumulate_block(float *AEON_RESTRICT StS,
+                             float *AEON_RESTRICT StY,
+                             float *AEON_RESTRICT YtY,
+                             const float *AEON_RESTRICT B,
+                             const float *AEON_RESTRICT Y, uint32_t k,
+                             uint16_t n, uint16_t n_out,
+                             float *AEON_RESTRICT acc, float *comp) {
+  const uint32_t k4 = k & ~3u;
+  float *comp_StY = comp != NULL ? comp + AEON_TRI_SIZE(n) : NULL;
+  float *comp_YtY = comp != NULL ? comp_StY + (size_t)n * n_out : NULL;
+  float *AEON_RESTRICT acc1 = acc + n;
+
+  /* Filas de dos en dos y muestras de cuatro en cuatro, en acc */
+  for (int i = 0; i < n; i += 2) {
+    const bool pair = i + 1 < n;
+    const int len = pair ? i + 2 : i + 1;
+    for (int j = 0; j < len; j++) {
+      acc[j] = 0.0f;
+      acc1[j] = 0.0f;
+    }
+
+    uint32_t t = 0;
+    for (; t < k4; t += 4) {
+      const float *b0 = &B[(size_t)t * n];
+      const float *b1 = b0 + n;
+      const float *b2 = b1 + n;
+      const float *b3 = b2 + n;
+      const float a0 = b0[i], a1 = b1[i], a2 = b2[i], a3 = b3[i];
+      const float c0 = pair ? b0[i + 1] : 0.0f, c1 = pair ? b1[i + 1] : 0.0f;
+      const float c2 = pair ? b2[i + 1] : 0.0f, c3 = pair ? b3[i + 1] : 0.0f;
+      for (int j = 0; j < len; j++) {
+        float x0 = b0[j], x1 = b1[j], x2 = b2[j], x3 = b3[j];
+        acc[j] += a0 * x0 + a1 * x1 + a2 * x2 + a3 * x3;
+        acc1[j] += c0 * x0 + c1 * x1 + c2 * x2 + c3 * x3;
+      }
+    }
+    for (; t < k; t++) {
+      const float *b = &B[(size_t)t * n];
+      const float a = b[i], c = pair ? b[i + 1] : 0.0f;
+      for (int j = 0; j < len; j++) {
+        acc[j] += a * b[j];
+        acc1[j] += c * b[j];
+      }
+    }
+
+    uint32_t r = AEON_TRI_ROW(i);
+    for (int j = 0; j <= i; j++) {
+      add_compensated(&StS[r + j], comp != NULL ? &comp[r + j] : NULL,
+                      acc[j]);
+    }
+    if (pair) {
+      r = AEON_TRI_ROW(i + 1);
+      for (int j = 0; j <= i + 1; j++) {
+        add_compensated(&StS[r + j], comp != NULL ? &comp[r + j] : NULL,
+                        acc1[j]);
+      }
+    }
   }
 
-  return 0;
+  for (int i = 0; i < n; i++) {
+    for (int o = 0; o < n_out; o++) {
+      float sum = 0.0f;
+      for (uint32_t t = 0; t < k; t++) {
+        sum += B[(size_t)t * n + i] * Y[(size_t)t * n_out + o];
+      }
+      size_t x = (size_t)i * n_out + o;
+      add_compensated(&StY[x], comp_StY != NULL ? &comp_StY[x] : NULL, sum);
+    }
+  }
+  for (int o = 0; o < n_out; o++) {
+    float sum = 0.0f;
+    for (uint32_t t = 0; t < k; t++) {
+      float y = Y[(size_t)t * n_out + o];
+      sum += y * y;
+    }
+    add_compensated(&YtY[o], comp_YtY != NULL ? &comp_YtY[o] : NULL, sum);
+  }
 }
 
-/* ============================================================
- * PROCESAMIENTO
- * ============================================================ */
 
-void aeon_update(aeon_core_t *core, const aeon_state_t *input) {
-  if (core == NULL || input == NULL)
-    return;
 
-  aeon_state_t new_state[AEON_RESERVOIR_SIZE];
+int aeon_k_ridge_solve(float *StS, float *StY, float *z, uint16_t n,
+                       uint16_t n_out, aeon_weight_t *W_out) {
+  /*
+   * Factorización de Cholesky in-place: S^T*S = L * L^T.
+   * S^T*S + lambda*I es simétrica definida positiva, así que no hace
+   * falta pivoteo y el coste es ~n³/6 flops frente a ~n³ de invertir
+   * con Gauss-Jordan. Cada fila de L se calcula con productos de
+   * filas contiguas ya factorizadas.
+   */
+  for (int i = 0; i < n; i++) {
+    float *Li = &StS[AEON_TRI_ROW(i)];
+    for (int j = 0; j <= i; j++) {
+      const float *Lj = &StS[AEON_TRI_ROW(j)];
+      float sum = Li[j];
+      for (int k = 0; k < j; k++) {
+        sum -= Li[k] * Lj[k];
+      }
+      if (j == i) {
+        /* Pivote hundido bajo el redondeo del producto (~n eps): la
+         * ridge no basta para la precisión de S^T*S y cualquier peso
+         * saldría del ruido. También atrapa NaN */
+        if (!(sum > Li[i] * (4.0f * (float)n * FLT_EPSILON))) {
+          AEON_STATS_COUNT(AEON_EVENT_PIVOT_CLAMP, 1);
+          return -1;
+        }
+        Li[i] = sqrtf(sum);
+      } else {
+        Li[j] = sum / Lj[j];
+      }
+    }
+  }
+
+  /* Por cada salida: L z = S^T*y (adelante), L^T w = z (atrás) */
+  for (int o = 0; o < n_out; o++) {
+    for (int i = 0; i < n; i++) {
+      const float *Li = &StS[AEON_TRI_ROW(i)];
+      float sum = StY[i * n_out + o];
+      for (int k = 0; k < i; k++) {
+        sum -= Li[k] * z[k];
+      }
+      z[i] = sum / Li[i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+      float sum = z[i];
+      for (int k = i + 1; k < n; k++) {
+        sum -= StS[AEON_TRI_ROW(k) + i] * z[k];
+      }
+      z[i] = sum / StS[AEON_TRI_ROW(i) + i];
+    }
+
+    for (int i = 0; i < n; i++) {
+      float w = z[i];
+
+      /* Limitar magnitud del peso para estabilidad */
+      if (w > 2.0f)
+        w = 2.0f;
+      if (w < -2.0f)
+        w = -2.0f;
 
-  /* Contribución de entrada: W_in * input */
-  for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
-    aeon_state_t sum = 0;
-    for (int j = 0; j < AEON_INPUT_SIZE; j++) {
-      int idx = i * AEON_INPUT_SIZE + j;
 #if AEON_USE_FIXED_POINT
-      sum += ((aeon_state_t)core->W_in[idx] * input[j]) >> AEON_SCALE_BITS;
+      W_out[o * n + i] = (aeon_weight_t)(w * AEON_SCALE);
 #else
-      sum += core->W_in[idx] * input[j];
+      W_out[o * n + i] = aeon_weight_from_float(w);
 #endif
     }
-    new_state[i] = sum;
   }
 
-  /* Contribución del reservoir (escaso): W_reservoir * state */
-  for (int k = 0; k < core->sparse_count; k++) {
-    uint16_t idx = core->sparse_indices[k];
-    int i = idx / AEON_RESERVOIR_SIZE; /* Fila */
-    int j = idx % AEON_RESERVOIR_SIZE; /* Columna */
+  return 0;
+}
+
+float aeon_k_ridge_error(const float *L, const float *StY, const float *YtY,
+                         float ridge, uint16_t n, uint16_t n_out,
+                         const aeon_weight_t *W_out, float *z) {
+  float sse = 0.0f;
+
+  /* Un factor rechazado (pivote hundido o NaN) no cumple L L^T =
+   * S^T*S + ridge*I y la identidad daría un error sin sentido */
+  for (int i = 0; i < n; i++) {
+    if (!(L[AEON_TRI_ROW(i) + i] > 0.0f))
+      return -1.0f;
+  }
 
+  for (int o = 0; o < n_out; o++) {
+    const aeon_weight_t *w = &W_out[o * n];
+    float wSy = 0.0f;
+    float ww = 0.0f;
+
+    /* z = L^T w, recorriendo L por filas contiguas */
+    for (int i = 0; i < n; i++) {
+      z[i] = 0.0f;
+    }
+    for (int i = 0; i < n; i++) {
+      const float *Li = &L[AEON_TRI_ROW(i)];
 #if AEON_USE_FIXED_POINT
-    new_state[i] += ((aeon_state_t)core->W_reservoir[k] * core->state[j]) >>
-                    AEON_SCALE_BITS;
+      float wi = (float)w[i] / AEON_SCALE;
 #else
-    new_state[i] += core->W_reservoir[k] * core->state[j];
+      float wi = aeon_weight_to_float(w[i]);
 #endif
-  }
+      for (int j = 0; j <= i; j++) {
+        z[j] += Li[j] * wi;
+      }
+      wSy += wi * StY[i * n_out + o];
+      ww += wi * wi;
+    }
 
-  /* Aplicar no-linealidad y actualizar estado
-   * Loop unrolling: 4 operaciones por iteración para mejor ILP */
-  int i = 0;
-  for (; i < AEON_RESERVOIR_SIZE - 3; i += 4) {
-    core->state[i]     = aeon_tanh_approx(new_state[i]);
-    core->state[i + 1] = aeon_tanh_approx(new_state[i + 1]);
-    core->state[i + 2] = aeon_tanh_approx(new_state[i + 2]);
-    core->state[i + 3] = aeon_tanh_approx(new_state[i + 3]);
-  }
-  /* Residuo para tamaños no múltiplos de 4 */
-  for (; i < AEON_RESERVOIR_SIZE; i++) {
-    core->state[i] = aeon_tanh_approx(new_state[i]);
+    float wSSw = -ridge * ww;
+    for (int i = 0; i < n; i++) {
+      wSSw += z[i] * z[i];
+    }
+
+    sse += YtY[o] - 2.0f * wSy + wSSw;
   }
 
-  core->samples_processed++;
+  /* La cancelación puede dejar un residuo negativo minúsculo */
+  return sse > 0.0f ? sse : 0.0f;
 }
 
-void aeon_predict(const aeon_core_t *core, aeon_state_t *output) {
-  if (core == NULL || output == NULL)
-    return;
+uint32_t aeon_k_train_work_size(uint16_t n_res, uint16_t n_out) {
+  /* S^T*S empaquetada + StY + Y^T*Y + bloque + temporal del bloque */
+  return AEON_TRAIN_WORK_SIZE(n_res, n_out);
+}
 
-  /* output = W_out * state */
-  for (int i = 0; i < AEON_OUTPUT_SIZE; i++) {
-    aeon_state_t sum = 0;
-    for (int j = 0; j < AEON_RESERVOIR_SIZE; j++) {
-      int idx = i * AEON_RESERVOIR_SIZE + j;
+/** Estado actual y objetivo t en float, como filas de un bloque */
+static void load_sample(const aeon_view_t *v, const aeon_state_t *targets,
+                        uint32_t t, float *state_f, float *target_f) {
+  for (int i = 0; i < v->n_res; i++) {
 #if AEON_USE_FIXED_POINT
-      sum +=
-          ((aeon_state_t)core->W_out[idx] * core->state[j]) >> AEON_SCALE_BITS;
+    state_f[i] = (float)v->state[i] / AEON_SCALE;
 #else
-      sum += core->W_out[idx] * core->state[j];
+    state_f[i] = v->state[i];
+#endif
+  }
+  for (int o = 0; o < v->n_out; o++) {
+#if AEON_USE_FIXED_POINT
+    target_f[o] = (float)targets[(size_t)t * v->n_out + o] / AEON_SCALE;
+#else
+    target_f[o] = targets[(size_t)t * v->n_out + o];
 #endif
-    }
-    output[i] = sum;
   }
 }
 
-void aeon_reset(aeon_core_t *core) {
-  if (core == NULL)
-    return;
-  memset(core->state, 0, sizeof(core->state));
+/** Pasa la serie desde el estado cero y acumula sobre ridge*I */
+static void accumulate_series(const aeon_view_t *v,
+                              const aeon_state_t *inputs,
+                              const aeon_state_t *targets,
+                              uint32_t n_samples, uint32_t washout,
+                              float ridge, float *work) {
+  const int n = v->n_res;
+  const int n_out = v->n_out;
+  float *StS = work;
+  float *StY = StS + AEON_TRI_SIZE(n);
+  float *YtY = StY + n * n_out;
+  float *B = YtY + n_out;
+  float *Y = B + (size_t)AEON_TRAIN_BLOCK * n;
+  float *acc = Y + (size_t)AEON_TRAIN_BLOCK * n_out;
+  uint32_t k = 0;
+
+  memset(v->state, 0, (size_t)n * sizeof(aeon_state_t));
+  aeon_k_ridge_init(StS, StY, YtY, v->n_res, v->n_out, ridge);
+
+  for (uint32_t t = 0; t < n_samples; t++) {
+    aeon_k_view_step(v, &inputs[(size_t)t * v->n_in]);
+    if (t < washout)
+      continue;
+
+    load_sample(v, targets, t, &B[(size_t)k * n], &Y[(size_t)k * n_out]);
+    if (++k == AEON_TRAIN_BLOCK || t + 1 == n_samples) {
+      aeon_k_accumulate_block(StS, StY, YtY, B, Y, k, v->n_res, v->n_out,
+                              acc, NULL);
+      k = 0;
+    }
+  }
 }
 
-/* ============================================================
- * ENTRENAMIENTO
- * ============================================================ */
-
-float aeon_train(aeon_core_t *core, const aeon_state_t *inputs,
-                 const aeon_state_t *targets, uint16_t n_samples,
-                 uint16_t washout) {
-  if (core == NULL || inputs == NULL || targets == NULL)
-    return -1.0f;
+float aeon_k_train(const aeon_view_t *v, const aeon_state_t *inputs,
+                   const aeon_state_t *targets, uint32_t n_samples,
+                   uint32_t washout, float *work) {
   if (n_samples <= washout)
     return -2.0f;
 
-  uint16_t train_samples = n_samples - washout;
+  const int n = v->n_res;
+  const int n_out = v->n_out;
+  uint32_t train_samples = n_samples - washout;
 
   /*
    * ENTRENAMIENTO OPTIMIZADO PARA PUNTO FIJO
@@ -331,182 +770,308 @@ float aeon_train(aeon_core_t *core, const aeon_state_t *inputs,
    * entrenamiento y convertimos al final.
    */
 
-  /* Reset y recolectar estados en formato float para precisión */
-  aeon_reset(core);
+  /* Acumuladores para regresión (S^T * S), (S^T * Y) y diag(Y^T * Y),
+   * seguidos del bloque de estados, en work */
+  float *StS = work;
+  float *StY = StS + AEON_TRI_SIZE(n);
+  float *YtY = StY + n * n_out;
+  float *z = YtY + n_out;
+
+  /* Regularización de Tikhonov (Ridge) proporcional a las muestras: la
+   * misma fracción de S^T*S sea cual sea la longitud de la serie */
+  float ridge = AEON_RIDGE_LAMBDA * (float)train_samples;
+  for (int attempt = 0;; attempt++) {
+    accumulate_series(v, inputs, targets, n_samples, washout, ridge, work);
+
+    /* Resolver (S^T*S) W_out = S^T*Y por Cholesky (el bloque como
+     * vector temporal de la sustitución) */
+    if (aeon_k_ridge_solve(StS, StY, z, v->n_res, v->n_out, v->W_out) == 0)
+      break;
+    if (attempt == AEON_RIDGE_RETRIES)
+      return -5.0f;
+    ridge *= AEON_RIDGE_GROWTH;
+  }
 
-  /* Acumuladores para regresión (S^T * S) y (S^T * Y) */
-  float StS[AEON_RESERVOIR_SIZE][AEON_RESERVOIR_SIZE];
-  float StY[AEON_RESERVOIR_SIZE][AEON_OUTPUT_SIZE];
+  /* MSE en forma cerrada con el factor L y los pesos cuantizados, sin
+   * segunda pasada por el reservoir */
+  float sse = aeon_k_ridge_error(StS, StY, YtY, ridge, v->n_res, v->n_out,
+                                 v->W_out, z);
+  if (sse < 0.0f)
+    return -5.0f;
 
-  /* Inicializar acumuladores con Regularización de Tikhonov (Ridge)
-   * Lambda = 0.001 evita sobreajuste y mejora estabilidad numérica
-   * en la inversión de matriz. Valor optimizado para ESN pequeños. */
-  const float ridge_lambda = 0.001f;
-  for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
-    for (int j = 0; j < AEON_RESERVOIR_SIZE; j++) {
-      StS[i][j] = (i == j) ? ridge_lambda : 0.0f;
-    }
-    for (int o = 0; o < AEON_OUTPUT_SIZE; o++) {
-      StY[i][o] = 0.0f;
-    }
-  }
+  return sse / (float)(train_samples * n_out);
+}
 
-  /* Pasar datos y acumular */
-  for (uint16_t t = 0; t < n_samples; t++) {
-    aeon_update(core, &inputs[t * AEON_INPUT_SIZE]);
+/* ------------------------------------------------------------
+ * Entrenamiento paralelo: S^T*S parciales por bloques de muestras.
+ * Cada parcial es S^T*S | S^T*Y | Y^T*Y seguidos y el temporal de su
+ * bloque, con la cabeza en su propia línea de caché; cada buffer,
+ * n_partials bloques de AEON_TRAIN_BLOCK estados y, detrás, sus
+ * objetivos.
+ * ------------------------------------------------------------ */
+
+#define CACHE_FLOATS (AEON_CACHE_LINE / sizeof(float))
+
+typedef struct {
+  const aeon_view_t *v;
+  const aeon_state_t *inputs;
+  const aeon_state_t *targets;
+  uint32_t n_samples;
+  uint32_t washout;
+  uint32_t next;      /**< Siguiente muestra por pasar por el reservoir */
+  uint16_t n_partials;
+  size_t stride;      /**< Floats por parcial */
+  size_t block;       /**< Floats por bloque */
+  float *partials;
+  float *buffers[2];
+  uint32_t filled[2]; /**< Muestras en cada buffer */
+  int current;        /**< Buffer que se acumula en esta ronda */
+  size_t chunk;       /**< Floats por tarea de la reducción */
+} train_pipeline_t;
+
+static size_t round_up_floats(size_t n) {
+  return (n + CACHE_FLOATS - 1) / CACHE_FLOATS * CACHE_FLOATS;
+}
 
-    if (t >= washout) {
-      /* Extraer estado actual como float */
-      float state_f[AEON_RESERVOIR_SIZE];
-      for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
-#if AEON_USE_FIXED_POINT
-        state_f[i] = (float)core->state[i] / AEON_SCALE;
-#else
-        state_f[i] = core->state[i];
-#endif
-      }
+/** Floats de S^T*S | S^T*Y | Y^T*Y */
+static size_t accumulator_size(uint16_t n_res, uint16_t n_out) {
+  return AEON_TRI_SIZE(n_res) + (size_t)n_res * n_out + n_out;
+}
 
-      /* Target actual */
-      float target_f[AEON_OUTPUT_SIZE];
-      for (int o = 0; o < AEON_OUTPUT_SIZE; o++) {
-#if AEON_USE_FIXED_POINT
-        target_f[o] = (float)targets[t * AEON_OUTPUT_SIZE + o] / AEON_SCALE;
-#else
-        target_f[o] = targets[t * AEON_OUTPUT_SIZE + o];
-#endif
-      }
+static size_t partial_stride(uint16_t n_res, uint16_t n_out) {
+  return round_up_floats(accumulator_size(n_res, n_out)) +
+         round_up_floats(2 * (size_t)n_res);
+}
 
-      /* Acumular S^T * S (matriz de covarianza) */
-      for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
-        for (int j = i; j < AEON_RESERVOIR_SIZE; j++) {
-          float prod = state_f[i] * state_f[j];
-          StS[i][j] += prod;
-          if (i != j)
-            StS[j][i] += prod; /* Simetría */
-        }
+size_t aeon_k_train_parallel_work_size(uint16_t n_res, uint16_t n_out,
+                                       uint16_t n_partials) {
+  size_t partial = partial_stride(n_res, n_out);
+  size_t block = (size_t)AEON_TRAIN_BLOCK * (n_res + n_out);
+  return n_partials * (partial + 2 * block);
+}
 
-        /* Acumular S^T * Y */
-        for (int o = 0; o < AEON_OUTPUT_SIZE; o++) {
-          StY[i][o] += state_f[i] * target_f[o];
-        }
-      }
-    }
+/** Avanza el reservoir hasta llenar el buffer b o agotar la serie */
+static void pipeline_produce(train_pipeline_t *p, int b) {
+  const aeon_view_t *v = p->v;
+  const int n = v->n_res;
+  const int n_out = v->n_out;
+  const uint32_t capacity = (uint32_t)p->n_partials * AEON_TRAIN_BLOCK;
+  uint32_t m = 0;
+
+  for (; m < capacity && p->next < p->n_samples; p->next++) {
+    uint32_t t = p->next;
+    aeon_k_view_step(v, &p->inputs[(size_t)t * v->n_in]);
+    if (t < p->washout)
+      continue;
+
+    float *block = p->buffers[b] + (m / AEON_TRAIN_BLOCK) * p->block;
+    uint32_t r = m % AEON_TRAIN_BLOCK;
+    load_sample(v, p->targets, t, block + (size_t)r * n,
+                block + (size_t)AEON_TRAIN_BLOCK * n + (size_t)r * n_out);
+    m++;
   }
+  p->filled[b] = m;
+}
 
-  /*
-   * Resolver W_out = (S^T*S)^(-1) * S^T*Y usando eliminación Gaussiana
-   * simplificada (Gauss-Jordan para sistemas pequeños)
-   */
+/** Tarea 0: llenar el otro buffer; tarea 1 + j: acumular el bloque j */
+static void pipeline_task(void *arg, uint32_t index) {
+  train_pipeline_t *p = arg;
+  if (index == 0) {
+    pipeline_produce(p, p->current ^ 1);
+    return;
+  }
 
-  /* Invertir StS usando Gauss-Jordan (in-place con matriz identidad) */
-  float inv[AEON_RESERVOIR_SIZE][AEON_RESERVOIR_SIZE];
+  uint32_t j = index - 1;
+  uint32_t first = j * AEON_TRAIN_BLOCK;
+  if (first >= p->filled[p->current])
+    return;
+  uint32_t k = p->filled[p->current] - first;
+  if (k > AEON_TRAIN_BLOCK)
+    k = AEON_TRAIN_BLOCK;
+
+  const uint16_t n = p->v->n_res;
+  const uint16_t n_out = p->v->n_out;
+  const float *block = p->buffers[p->current] + j * p->block;
+  float *StS = p->partials + j * p->stride;
+  float *StY = StS + AEON_TRI_SIZE(n);
+  float *acc = StS + round_up_floats(accumulator_size(n, n_out));
+  aeon_k_accumulate_block(StS, StY, StY + (size_t)n * n_out, block,
+                          block + (size_t)AEON_TRAIN_BLOCK * n, k, n, n_out,
+                          acc, NULL);
+}
 
-  /* Inicializar inversa como identidad */
-  for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
-    for (int j = 0; j < AEON_RESERVOIR_SIZE; j++) {
-      inv[i][j] = (i == j) ? 1.0f : 0.0f;
+/** Suma las parciales 1..n-1 sobre la 0 en un tramo, siempre en orden */
+static void reduce_task(void *arg, uint32_t index) {
+  train_pipeline_t *p = arg;
+  size_t size = accumulator_size(p->v->n_res, p->v->n_out);
+  size_t begin = index * p->chunk;
+  size_t end = begin + p->chunk < size ? begin + p->chunk : size;
+
+  for (uint16_t q = 1; q < p->n_partials; q++) {
+    const float *src = p->partials + q * p->stride;
+    for (size_t x = begin; x < end; x++) {
+      p->partials[x] += src[x];
     }
   }
+}
 
-  /* Gauss-Jordan */
-  for (int col = 0; col < AEON_RESERVOIR_SIZE; col++) {
-    /* Buscar pivote máximo */
-    int max_row = col;
-    float max_val = StS[col][col] > 0 ? StS[col][col] : -StS[col][col];
-
-    for (int row = col + 1; row < AEON_RESERVOIR_SIZE; row++) {
-      float val = StS[row][col] > 0 ? StS[row][col] : -StS[row][col];
-      if (val > max_val) {
-        max_val = val;
-        max_row = row;
-      }
-    }
+/** Lote de tareas con el ejecutor, o en orden si no hay */
+static void run_tasks(const aeon_executor_t *executor, aeon_task_fn task,
+                      void *arg, uint32_t n) {
+  /* Los contadores de AEON_ENABLE_STATS son globales: en orden */
+  if (executor != NULL && executor->run != NULL && !AEON_ENABLE_STATS) {
+    executor->run(executor->ctx, task, arg, n);
+    return;
+  }
+  for (uint32_t i = 0; i < n; i++)
+    task(arg, i);
+}
 
-    /* Intercambiar filas si es necesario */
-    if (max_row != col) {
-      for (int k = 0; k < AEON_RESERVOIR_SIZE; k++) {
-        float tmp = StS[col][k];
-        StS[col][k] = StS[max_row][k];
-        StS[max_row][k] = tmp;
-        tmp = inv[col][k];
-        inv[col][k] = inv[max_row][k];
-        inv[max_row][k] = tmp;
-      }
-    }
+/** Una pasada del pipeline con ridge*I en la parcial 0; deja la suma
+ *  de las parciales en la 0 */
+static void pipeline_run(train_pipeline_t *p, const aeon_executor_t *executor,
+                         float ridge) {
+  const uint16_t n = p->v->n_res;
+  const uint16_t n_out = p->v->n_out;
+
+  /* La regularización va solo en la parcial 0, como en aeon_k_train */
+  for (uint16_t q = 0; q < p->n_partials; q++) {
+    float *StS = p->partials + q * p->stride;
+    float *StY = StS + AEON_TRI_SIZE(n);
+    aeon_k_ridge_init(StS, StY, StY + (size_t)n * n_out, n, n_out,
+                      q == 0 ? ridge : 0.0f);
+  }
+  memset(p->v->state, 0, (size_t)n * sizeof(aeon_state_t));
+  p->next = 0;
+  p->current = 0;
+
+  pipeline_produce(p, 0);
+  while (p->filled[p->current] > 0) {
+    run_tasks(executor, pipeline_task, p, 1u + p->n_partials);
+    p->current ^= 1;
+  }
 
-    /* Normalizar fila pivote */
-    float pivot = StS[col][col];
-    if (fabsf(pivot) < 1e-10f) {
-      pivot = (pivot >= 0.0f) ? 1e-10f : -1e-10f; /* Evitar división por cero preservando signo */
-    }
+  if (p->n_partials > 1) {
+    size_t size = accumulator_size(n, n_out);
+    p->chunk = round_up_floats((size + p->n_partials - 1) / p->n_partials);
+    run_tasks(executor, reduce_task, p,
+              (uint32_t)((size + p->chunk - 1) / p->chunk));
+  }
+}
 
-    for (int k = 0; k < AEON_RESERVOIR_SIZE; k++) {
-      StS[col][k] /= pivot;
-      inv[col][k] /= pivot;
-    }
+float aeon_k_train_parallel(const aeon_view_t *v, const aeon_state_t *inputs,
+                            const aeon_state_t *targets, uint32_t n_samples,
+                            uint32_t washout, const aeon_executor_t *executor,
+                            uint16_t n_partials, float *work) {
+  if (n_samples <= washout || n_partials == 0)
+    return -2.0f;
 
-    /* Eliminar en otras filas */
-    for (int row = 0; row < AEON_RESERVOIR_SIZE; row++) {
-      if (row != col) {
-        float factor = StS[row][col];
-        for (int k = 0; k < AEON_RESERVOIR_SIZE; k++) {
-          StS[row][k] -= factor * StS[col][k];
-          inv[row][k] -= factor * inv[col][k];
-        }
-      }
-    }
+  const uint16_t n = v->n_res;
+  const uint16_t n_out = v->n_out;
+  train_pipeline_t p;
+  p.v = v;
+  p.inputs = inputs;
+  p.targets = targets;
+  p.n_samples = n_samples;
+  p.washout = washout;
+  p.n_partials = n_partials;
+  p.stride = partial_stride(n, n_out);
+  p.block = (size_t)AEON_TRAIN_BLOCK * (n + n_out);
+  p.partials = work;
+  p.buffers[0] = work + n_partials * p.stride;
+  p.buffers[1] = p.buffers[0] + n_partials * p.block;
+
+  float *StS = p.partials;
+  float *StY = StS + AEON_TRI_SIZE(n);
+  float *z = p.buffers[0];
+  float ridge = AEON_RIDGE_LAMBDA * (float)(n_samples - washout);
+  for (int attempt = 0;; attempt++) {
+    pipeline_run(&p, executor, ridge);
+    if (aeon_k_ridge_solve(StS, StY, z, n, n_out, v->W_out) == 0)
+      break;
+    if (attempt == AEON_RIDGE_RETRIES)
+      return -5.0f;
+    ridge *= AEON_RIDGE_GROWTH;
   }
 
-  /* Calcular W_out = inv(StS) * StY */
-  for (int o = 0; o < AEON_OUTPUT_SIZE; o++) {
-    for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
-      float sum = 0.0f;
-      for (int k = 0; k < AEON_RESERVOIR_SIZE; k++) {
-        sum += inv[i][k] * StY[k][o];
-      }
+  float sse = aeon_k_ridge_error(StS, StY, StY + (size_t)n * n_out, ridge, n,
+                                 n_out, v->W_out, z);
+  if (sse < 0.0f)
+    return -5.0f;
+  return sse / (float)((n_samples - washout) * n_out);
+}
 
-      /* Limitar magnitud del peso para estabilidad */
-      if (sum > 2.0f)
-        sum = 2.0f;
-      if (sum < -2.0f)
-        sum = -2.0f;
+size_t aeon_train_work_size(void) {
+  return AEON_TRAIN_WORK_SIZE(AEON_RESERVOIR_SIZE, AEON_OUTPUT_SIZE) *
+         sizeof(float);
+}
 
-#if AEON_USE_FIXED_POINT
-      core->W_out[o * AEON_RESERVOIR_SIZE + i] =
-          (aeon_weight_t)(sum * AEON_SCALE);
-#else
-      core->W_out[o * AEON_RESERVOIR_SIZE + i] = sum;
-#endif
-    }
+float aeon_train_work(aeon_core_t *core, const aeon_state_t *inputs,
+                      const aeon_state_t *targets, uint32_t n_samples,
+                      uint32_t washout, float *work) {
+  if (core == NULL || inputs == NULL || targets == NULL || work == NULL)
+    return -1.0f;
+  if (n_samples <= washout)
+    return -2.0f;
+
+  AEON_STATS_BEGIN(t0);
+  aeon_state_t scratch[AEON_RESERVOIR_SIZE];
+  aeon_view_t v = static_view(core, scratch);
+
+  float mse = aeon_k_train(&v, inputs, targets, n_samples, washout, work);
+
+  /* Si S^T*S no se factoriza, W_out sigue como estaba */
+  if (mse >= 0.0f) {
+    core->readout_sparse = false;
+    core->is_trained = true;
+    core->learning_sessions++;
+    core->samples_processed += n_samples;
   }
+  AEON_STATS_END(AEON_EVENT_TRAIN, t0);
 
-  core->is_trained = true;
-  core->learning_sessions++;
+  return mse;
+}
 
-  /* Calcular MSE */
-  float mse = 0.0f;
-  aeon_reset(core);
+float aeon_train(aeon_core_t *core, const aeon_state_t *inputs,
+                 const aeon_state_t *targets, uint32_t n_samples,
+                 uint32_t washout) {
+  if (core == NULL || inputs == NULL || targets == NULL)
+    return -1.0f;
+  if (n_samples <= washout)
+    return -2.0f;
 
-  for (uint16_t t = washout; t < n_samples; t++) {
-    aeon_update(core, &inputs[t * AEON_INPUT_SIZE]);
+  /* O(N²): del montón, no de la pila */
+  float *work = malloc(aeon_train_work_size());
+  if (work == NULL)
+    return -3.0f;
 
-    aeon_state_t pred[AEON_OUTPUT_SIZE];
-    aeon_predict(core, pred);
+  float mse =
+      aeon_train_work(core, inputs, targets, n_samples, washout, work);
 
-    for (int o = 0; o < AEON_OUTPUT_SIZE; o++) {
-#if AEON_USE_FIXED_POINT
-      float p = (float)pred[o] / AEON_SCALE;
-      float y = (float)targets[t * AEON_OUTPUT_SIZE + o] / AEON_SCALE;
-#else
-      float p = pred[o];
-      float y = targets[t * AEON_OUTPUT_SIZE + o];
-#endif
-      float diff = p - y;
-      mse += diff * diff;
+  free(work);
+  return mse;
+}
+
+/** Copia los pesos no nulos de W_out a la lectura escasa, si caben */
+static void compact_readout(aeon_core_t *core) {
+  core->readout_sparse = false;
+
+  uint32_t k = 0;
+  core->readout_ptr[0] = 0;
+  for (int o = 0; o < AEON_OUTPUT_SIZE; o++) {
+    const aeon_weight_t *w = &core->W_out[o * AEON_RESERVOIR_SIZE];
+    for (int j = 0; j < AEON_RESERVOIR_SIZE; j++) {
+      if (aeon_k_weight(w[j]) == 0)
+        continue;
+      if (k == AEON_READOUT_CAPACITY)
+        return; /* No cabe: lectura densa */
+      core->readout_index[k] = (uint16_t)j;
+      core->readout_weight[k] = w[j];
+      k++;
     }
+    core->readout_ptr[o + 1] = (uint16_t)k;
   }
-
-  return mse / (float)(train_samples * AEON_OUTPUT_SIZE);
+  core->readout_sparse = true;
 }
 
 int aeon_prune(aeon_core_t *core, float threshold) {
@@ -529,13 +1094,14 @@ int aeon_prune(aeon_core_t *core, float threshold) {
       pruned_count++;
     }
 #else
-    if (fabs(w) < threshold) {
-      core->W_out[i] = 0.0f;
+    if (fabsf(aeon_weight_to_float(w)) < threshold) {
+      core->W_out[i] = aeon_weight_from_float(0.0f);
       pruned_count++;
     }
 #endif
   }
 
+  compact_readout(core);
   return pruned_count;
 }
 
@@ -26,6 +26,7 @@ int main() {
     aeon_state_t output;
 
     printf("Benchmarking Eon Motor (%d cycles)...\n", N_CYCLES);
+    printf("Kernel backend: %s\n", aeon_simd_backend());
 
     clock_t start = clock();
 
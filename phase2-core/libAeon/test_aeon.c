@@ -10,11 +10,16 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define ANSI_COLOR_RED "\x1b[31m"
 #define ANSI_COLOR_GREEN "\x1b[32m"
 #define ANSI_COLOR_RESET "\x1b[0m"
 
+// 16-bit float weight storage: relative tolerances scale with 1 ULP
+#define W16_STORAGE                                                            \
+  (!AEON_USE_FIXED_POINT && AEON_FLOAT_WEIGHTS != AEON_WEIGHTS_F32)
+
 void test_passed(const char *test_name) {
   printf(ANSI_COLOR_GREEN "✓ PASS: %s" ANSI_COLOR_RESET "\n", test_name);
 }
@@ -36,6 +41,162 @@ void generate_data(aeon_state_t *data, int n_samples) {
   }
 }
 
+// MSE of the trained readout over the series, stepping from rest
+static float replay_mse(aeon_core_t *core, const aeon_state_t *inputs,
+                        const aeon_state_t *targets, uint32_t n_samples,
+                        uint32_t washout) {
+  double sum = 0.0;
+  aeon_reset(core);
+  for (uint32_t t = 0; t < n_samples; t++) {
+    aeon_state_t pred;
+    aeon_update(core, &inputs[t]);
+    if (t < washout)
+      continue;
+    aeon_predict(core, &pred);
+    float d = (float)(pred - targets[t]);
+#if AEON_USE_FIXED_POINT
+    d /= AEON_SCALE;
+#endif
+    sum += d * d;
+  }
+  return (float)(sum / (n_samples - washout));
+}
+
+static float to_float(aeon_state_t x) {
+#if AEON_USE_FIXED_POINT
+  return (float)x / AEON_SCALE;
+#else
+  return x;
+#endif
+}
+
+static aeon_state_t from_float(float x) {
+#if AEON_USE_FIXED_POINT
+  return (aeon_state_t)(x * AEON_SCALE);
+#else
+  return x;
+#endif
+}
+
+// The solver aeon_train used to have: dense S^T*S accumulated sample by
+// sample in float with lambda = 0.001, inverted by Gauss-Jordan
+static void legacy_train(aeon_core_t *core, const aeon_state_t *inputs,
+                         const aeon_state_t *targets, uint32_t n_samples,
+                         uint32_t washout) {
+  enum { N = AEON_RESERVOIR_SIZE, N_OUT = AEON_OUTPUT_SIZE };
+  float *StS = malloc(N * N * sizeof(float));
+  float *inv = malloc(N * N * sizeof(float));
+  float *StY = calloc(N * N_OUT, sizeof(float));
+  float s[N];
+
+  for (int i = 0; i < N * N; i++) {
+    StS[i] = i % (N + 1) == 0 ? 0.001f : 0.0f;
+    inv[i] = i % (N + 1) == 0 ? 1.0f : 0.0f;
+  }
+  aeon_reset(core);
+  for (uint32_t t = 0; t < n_samples; t++) {
+    aeon_update(core, &inputs[t * AEON_INPUT_SIZE]);
+    if (t < washout)
+      continue;
+    for (int i = 0; i < N; i++)
+      s[i] = to_float(core->state[i]);
+    for (int i = 0; i < N; i++) {
+      for (int j = i; j < N; j++) {
+        float prod = s[i] * s[j];
+        StS[i * N + j] += prod;
+        if (i != j)
+          StS[j * N + i] += prod;
+      }
+      for (int o = 0; o < N_OUT; o++)
+        StY[i * N_OUT + o] += s[i] * to_float(targets[t * N_OUT + o]);
+    }
+  }
+
+  for (int col = 0; col < N; col++) {
+    int max_row = col;
+    for (int row = col + 1; row < N; row++) {
+      if (fabsf(StS[row * N + col]) > fabsf(StS[max_row * N + col]))
+        max_row = row;
+    }
+    for (int k = 0; k < N; k++) {
+      float tmp = StS[col * N + k];
+      StS[col * N + k] = StS[max_row * N + k];
+      StS[max_row * N + k] = tmp;
+      tmp = inv[col * N + k];
+      inv[col * N + k] = inv[max_row * N + k];
+      inv[max_row * N + k] = tmp;
+    }
+    float pivot = StS[col * N + col];
+    if (fabsf(pivot) < 1e-10f)
+      pivot = pivot >= 0.0f ? 1e-10f : -1e-10f;
+    for (int k = 0; k < N; k++) {
+      StS[col * N + k] /= pivot;
+      inv[col * N + k] /= pivot;
+    }
+    for (int row = 0; row < N; row++) {
+      if (row == col)
+        continue;
+      float factor = StS[row * N + col];
+      for (int k = 0; k < N; k++) {
+        StS[row * N + k] -= factor * StS[col * N + k];
+        inv[row * N + k] -= factor * inv[col * N + k];
+      }
+    }
+  }
+
+  for (int o = 0; o < N_OUT; o++) {
+    for (int i = 0; i < N; i++) {
+      float w = 0.0f;
+      for (int k = 0; k < N; k++)
+        w += inv[i * N + k] * StY[k * N_OUT + o];
+      w = w > 2.0f ? 2.0f : w < -2.0f ? -2.0f : w;
+#if AEON_USE_FIXED_POINT
+      core->W_out[o * N + i] = (aeon_weight_t)(w * AEON_SCALE);
+#else
+      core->W_out[o * N + i] = aeon_weight_from_float(w);
+#endif
+    }
+  }
+  core->readout_sparse = false;
+  free(StS);
+  free(inv);
+  free(StY);
+}
+
+#if AEON_USE_FIXED_POINT && AEON_TANH_MODE == AEON_TANH_POLY
+// The "poly" activation as it was written with divisions
+static aeon_state_t tanh_poly_reference(aeon_state_t x) {
+  if (x > AEON_SCALE)
+    return AEON_SCALE;
+  if (x < -AEON_SCALE)
+    return -AEON_SCALE;
+  aeon_state_t x2 = (x * x) >> AEON_SCALE_BITS;
+  aeon_state_t x3 = (x2 * x) >> AEON_SCALE_BITS;
+  aeon_state_t x5 = (x3 * x2) >> AEON_SCALE_BITS;
+  return x - x3 / 3 + x5 / 15;
+}
+#endif
+
+#if AEON_ENABLE_STATS
+typedef struct {
+  uint64_t events[AEON_EVENT_NEAR_MISS + 1];
+  uint64_t ticks;
+} trace_log_t;
+
+static void trace_collect(int event, uint64_t value, void *ctx) {
+  trace_log_t *log = ctx;
+  log->events[event]++;
+  if (event <= AEON_EVENT_TRAIN)
+    log->ticks += value;
+}
+
+static uint64_t fake_ticks;
+static uint64_t fake_clock(void *ctx) {
+  (void)ctx;
+  return fake_ticks += 10;
+}
+#endif
+
 int main(void) {
   printf("=== Aeon Core Regression Tests ===\n");
   printf("Config: Size=%d, Sparsity=%d, FixedPoint=%d\n", AEON_RESERVOIR_SIZE,
@@ -53,9 +214,13 @@ int main(void) {
   test_passed("Initialization");
 
   // TEST 2: Memory Usage
+  // Expecting < 2KB at 32 neurons, but <5KB safe margin; W_out and the
+  // CSR grow with N² beyond that
   uint32_t size = aeon_memory_usage(&core);
-  if (size == 0 ||
-      size > 5000) { // Expecting < 2KB usually, but <5KB safe margin
+  uint32_t size_limit = 5000;
+  if (AEON_RESERVOIR_SIZE > 32)
+    size_limit += 2u * (AEON_RESERVOIR_SIZE * AEON_RESERVOIR_SIZE - 32 * 32);
+  if (size == 0 || size > size_limit) {
     char msg[64];
     sprintf(msg, "Memory usage suspicious: %u bytes", size);
     test_failed("Memory Usage", msg);
@@ -102,6 +267,1405 @@ int main(void) {
   }
   test_passed("Structural Pruning");
 
+  // TEST 5: Runtime-sized core matches the static core
+  aeon_config_t config = AEON_CONFIG_DEFAULT;
+  aeon_dyn_core_t *dyn = aeon_core_create(&config, NULL);
+  if (dyn == NULL) {
+    test_failed("Runtime Core", "aeon_core_create failed");
+  }
+  if (((uintptr_t)dyn->W_in % AEON_CACHE_LINE) != 0 ||
+      ((uintptr_t)dyn->W_reservoir % AEON_CACHE_LINE) != 0) {
+    test_failed("Runtime Core", "Arena arrays not cache-line aligned");
+  }
+  aeon_birth(&core, 3);
+  aeon_core_birth(dyn, 3);
+  float mse_static = aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+  float mse_dyn = aeon_core_train(dyn, inputs, targets, N_SAMPLES, 50);
+  if (mse_static != mse_dyn || dyn->sparse_count != core.sparse_count) {
+    char msg[96];
+    sprintf(msg, "Static/runtime mismatch (%f vs %f)", mse_static, mse_dyn);
+    test_failed("Runtime Core", msg);
+  }
+  aeon_core_destroy(dyn);
+  test_passed("Runtime Core");
+
+  // TEST 6: Differently shaped cores in one process
+  aeon_config_t wide = {64, 4, 2, 4, AEON_SPECTRAL_RADIUS,
+                        AEON_LEAK_RATE};
+  aeon_dyn_core_t *wide_core = aeon_core_create(&wide, NULL);
+  if (wide_core == NULL || aeon_core_birth(wide_core, 7) != 0) {
+    test_failed("Runtime Shapes", "Failed to create 64x4x2 core");
+  }
+  aeon_state_t wide_in[N_SAMPLES * 4];
+  aeon_state_t wide_tgt[N_SAMPLES * 2];
+  for (int t = 0; t < N_SAMPLES; t++) {
+    for (int j = 0; j < 4; j++)
+      wide_in[t * 4 + j] = inputs[(t + j) % N_SAMPLES];
+    wide_tgt[t * 2] = targets[t];
+    wide_tgt[t * 2 + 1] = inputs[t];
+  }
+  float mse_wide = aeon_core_train(wide_core, wide_in, wide_tgt, N_SAMPLES, 50);
+  printf("Runtime 64x4x2 MSE: %f (%u bytes)\n", mse_wide,
+         aeon_core_memory_usage(wide_core));
+  if (mse_wide < 0.0f || mse_wide > 0.05f) {
+    test_failed("Runtime Shapes", "Unexpected MSE for 64x4x2 core");
+  }
+  aeon_core_destroy(wide_core);
+  test_passed("Runtime Shapes");
+
+  // TEST 6b: Large reservoir trains through the Cholesky solver
+  const int N_LARGE = 2000;
+  aeon_state_t *large_in = malloc(N_LARGE * sizeof(aeon_state_t));
+  aeon_state_t *large_tgt = malloc(N_LARGE * sizeof(aeon_state_t));
+  generate_data(large_in, N_LARGE);
+  for (int t = 0; t < N_LARGE - 1; t++)
+    large_tgt[t] = large_in[t + 1];
+  large_tgt[N_LARGE - 1] = large_in[0];
+
+  aeon_config_t large = {256, 1, 1, 8, AEON_SPECTRAL_RADIUS,
+                         AEON_LEAK_RATE};
+  aeon_dyn_core_t *large_core = aeon_core_create(&large, NULL);
+  if (large_core == NULL || aeon_core_birth(large_core, 11) != 0) {
+    test_failed("Large Reservoir", "Failed to create 256-neuron core");
+  }
+  float mse_large =
+      aeon_core_train(large_core, large_in, large_tgt, N_LARGE, 100);
+  printf("Runtime 256-neuron MSE: %f\n", mse_large);
+  // Unscaled 256-neuron reservoirs are noisy; this only catches solver failure
+  if (mse_large < 0.0f || mse_large > 0.05f || isnan(mse_large)) {
+    test_failed("Large Reservoir", "Unexpected MSE for 256-neuron core");
+  }
+  aeon_core_destroy(large_core);
+  free(large_in);
+  free(large_tgt);
+  test_passed("Large Reservoir");
+
+  // TEST 7: Batched streams match independent cores
+  // FMA float backends round once per term; equality is on scalar
+  if (!AEON_USE_FIXED_POINT)
+    aeon_simd_select("scalar");
+  const int N_STREAMS = 5;
+  aeon_batch_t *batch = aeon_batch_create(AEON_RESERVOIR_SIZE, N_STREAMS, NULL);
+  if (batch == NULL) {
+    test_failed("Batch Inference", "aeon_batch_create failed");
+  }
+  aeon_core_t streams[5];
+  for (int s = 0; s < N_STREAMS; s++) {
+    streams[s] = core;
+    aeon_reset(&streams[s]);
+  }
+  for (int t = 0; t < 100; t++) {
+    aeon_state_t batch_in[5];
+    aeon_state_t batch_out[5];
+    for (int s = 0; s < N_STREAMS; s++)
+      batch_in[s] = inputs[(t + s * 17) % N_SAMPLES];
+    aeon_update_batch(&core, batch, batch_in);
+    aeon_predict_batch(&core, batch, batch_out);
+    for (int s = 0; s < N_STREAMS; s++) {
+      aeon_state_t single_out;
+      aeon_update(&streams[s], &batch_in[s]);
+      aeon_predict(&streams[s], &single_out);
+      if (single_out != batch_out[s]) {
+        test_failed("Batch Inference", "Batched output differs from single");
+      }
+    }
+  }
+  aeon_batch_destroy(batch);
+  aeon_simd_select(NULL);
+  test_passed("Batch Inference");
+
+  // TEST 8: Every SIMD backend matches the scalar reference bit for bit
+  const char *backends[] = {"scalar", "sse4.1", "avx2", "neon", "dsp"};
+  aeon_simd_select("scalar");
+  aeon_birth(&core, 3);
+  float mse_ref = aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+  aeon_weight_t w_ref[AEON_RESERVOIR_SIZE];
+  memcpy(w_ref, core.W_out, sizeof(w_ref));
+  for (int b = 1; b < 5; b++) {
+    if (aeon_simd_select(backends[b]) != 0)
+      continue;
+    aeon_birth(&core, 3);
+    float mse_b = aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+    if (mse_b != mse_ref || memcmp(w_ref, core.W_out, sizeof(w_ref)) != 0) {
+      char msg[64];
+      sprintf(msg, "Backend %s differs from scalar", backends[b]);
+      test_failed("SIMD Backends", msg);
+    }
+    printf("Backend %s: MSE %f (bit-exact)\n", backends[b], mse_b);
+  }
+  aeon_simd_select(NULL);
+  test_passed("SIMD Backends");
+
+  // TEST 9: Streaming trainer reproduces the batch solution
+  // The reference comes from the scalar backend (see TEST 7)
+  if (!AEON_USE_FIXED_POINT)
+    aeon_simd_select("scalar");
+  aeon_trainer_t *trainer =
+      aeon_trainer_create(AEON_RESERVOIR_SIZE, AEON_OUTPUT_SIZE, NULL);
+  if (trainer == NULL || aeon_trainer_begin(trainer, 0.0f, 0) != -2) {
+    test_failed("Streaming Trainer", "Create/begin validation failed");
+  }
+  aeon_birth(&core, 3);
+  aeon_trainer_begin(trainer, 1.0f, 50);
+  for (int t = 0; t < N_SAMPLES; t++)
+    aeon_trainer_push(trainer, &core, &inputs[t], &targets[t]);
+  if (trainer->n_accumulated != N_SAMPLES - 50 ||
+      aeon_trainer_finalize(trainer, &core) < 0) {
+    test_failed("Streaming Trainer", "Finalize failed");
+  }
+  for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
+    // Same blocks as aeon_train; only the order of the ridge term and
+    // the compensated sum differ: allow one LSB. The reservoir is nearly
+    // linear on a sine, so in float the rounding is amplified by the
+    // conditioning of S^T*S
+    float ref = aeon_weight_to_float(w_ref[i]);
+    float lsb = AEON_USE_FIXED_POINT ? 1.0f / AEON_SCALE : 1e-3f;
+    if (W16_STORAGE)
+      lsb += fabsf(ref) / 128.0f;
+    if (fabsf(aeon_weight_to_float(core.W_out[i]) - ref) > lsb) {
+      test_failed("Streaming Trainer", "W_out differs from aeon_train");
+    }
+  }
+  aeon_simd_select(NULL);
+
+  // Forgetting over a long stream forces renormalisation; the solution
+  // must stay finite and still track the signal
+  aeon_birth(&core, 3);
+  aeon_trainer_begin(trainer, 0.99f, 50);
+  for (int t = 0; t < 20 * N_SAMPLES; t++)
+    aeon_trainer_push(trainer, &core, &inputs[t % N_SAMPLES],
+                      &targets[t % N_SAMPLES]);
+  aeon_trainer_finalize(trainer, &core);
+  float err = 0.0f;
+  for (int t = 0; t < N_SAMPLES; t++) {
+    aeon_state_t pred;
+    aeon_update(&core, &inputs[t]);
+    aeon_predict(&core, &pred);
+    float d = (float)(pred - targets[t]);
+#if AEON_USE_FIXED_POINT
+    d /= AEON_SCALE;
+#endif
+    err += d * d;
+  }
+  err /= N_SAMPLES;
+  printf("Streaming (f=0.99) MSE: %f\n", err);
+  if (isnan(err) || err > 0.05f) {
+    test_failed("Streaming Trainer", "Forgetting trainer diverged");
+  }
+  aeon_trainer_destroy(trainer);
+  test_passed("Streaming Trainer");
+
+  // TEST 10: Closed-form training MSE matches replaying the series
+  aeon_birth(&core, 3);
+  float mse_closed = aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+  float mse_replay = replay_mse(&core, inputs, targets, N_SAMPLES, 50);
+  printf("Closed-form MSE: %f (replay %f)\n", mse_closed, mse_replay);
+  // The replay truncates each Q8.8 prediction; allow a few percent
+  if (fabsf(mse_closed - mse_replay) > 0.05f * mse_replay + 1e-5f) {
+    test_failed("Closed-form MSE", "Closed-form MSE differs from replay");
+  }
+  test_passed("Closed-form MSE");
+
+  // TEST 11: Birth writes a well-formed CSR and is reproducible
+  aeon_config_t odd = {200, 1, 1, 3, AEON_SPECTRAL_RADIUS,
+                       AEON_LEAK_RATE};
+  aeon_dyn_core_t *csr = aeon_core_create(&odd, NULL);
+  if (csr == NULL || aeon_core_birth(csr, 99) != 0) {
+    test_failed("Birth CSR", "Failed to create 200-neuron core");
+  }
+  if (csr->row_ptr[0] != 0 || csr->row_ptr[200] != csr->sparse_count) {
+    test_failed("Birth CSR", "row_ptr does not span sparse_count");
+  }
+  for (int i = 0; i < 200; i++) {
+    for (uint32_t k = csr->row_ptr[i] + 1; k < csr->row_ptr[i + 1]; k++) {
+      if (csr->col_indices[k] <= csr->col_indices[k - 1]) {
+        test_failed("Birth CSR", "Row columns not strictly ascending");
+      }
+    }
+  }
+  uint32_t nnz = csr->sparse_count;
+  aeon_weight_t *w_first = malloc(nnz * sizeof(aeon_weight_t));
+  memcpy(w_first, csr->W_reservoir, nnz * sizeof(aeon_weight_t));
+  aeon_core_birth(csr, 99);
+  if (csr->sparse_count != nnz ||
+      memcmp(w_first, csr->W_reservoir, nnz * sizeof(aeon_weight_t)) != 0) {
+    test_failed("Birth CSR", "Same seed gave a different reservoir");
+  }
+  free(w_first);
+  aeon_core_destroy(csr);
+  test_passed("Birth CSR");
+
+  // TEST 12: Model files round-trip, regenerate from the seed and map
+  const char *model_path = "test_model.aeon";
+  static aeon_core_t loaded;
+  if (aeon_save_sections(&core, model_path, AEON_SECTION_W_OUT) != 0 ||
+      aeon_load(&loaded, model_path) != 0) {
+    test_failed("Model File", "Seed-only save/load failed");
+  }
+  if (loaded.sparse_count != core.sparse_count ||
+      memcmp(loaded.W_in, core.W_in, sizeof(core.W_in)) != 0 ||
+      memcmp(loaded.W_reservoir, core.W_reservoir, sizeof(core.W_reservoir)) !=
+          0 ||
+      memcmp(loaded.col_indices, core.col_indices, sizeof(core.col_indices)) !=
+          0 ||
+      memcmp(loaded.W_out, core.W_out, sizeof(core.W_out)) != 0 ||
+      !loaded.is_trained) {
+    test_failed("Model File", "Seed-only file did not rebuild the model");
+  }
+
+  aeon_dyn_core_t *saved = aeon_core_create(&wide, NULL);
+  aeon_core_birth(saved, 11);
+  aeon_core_train(saved, wide_in, wide_tgt, N_SAMPLES, 50);
+  int io_err = aeon_core_save(saved, model_path, AEON_SECTION_ALL);
+  aeon_dyn_core_t *mapped = aeon_core_map(model_path, NULL, &io_err);
+  if (io_err != 0 || mapped == NULL) {
+    test_failed("Model File", "aeon_core_map failed");
+  }
+  if (aeon_core_birth(mapped, 1) != -4) {
+    test_failed("Model File", "Mapped core accepted a rebirth");
+  }
+  for (int t = 0; t < 100; t++) {
+    aeon_state_t out_a[2], out_b[2];
+    aeon_core_update(saved, &wide_in[t * 4]);
+    aeon_core_update(mapped, &wide_in[t * 4]);
+    aeon_core_predict(saved, out_a);
+    aeon_core_predict(mapped, out_b);
+    if (memcmp(out_a, out_b, sizeof(out_a)) != 0) {
+      test_failed("Model File", "Mapped core predicts differently");
+    }
+  }
+  printf("Mapped 64x4x2 model: %u bytes of arena (copy: %u)\n",
+         aeon_core_memory_usage(mapped), aeon_core_memory_usage(saved));
+  aeon_core_destroy(mapped);
+
+  // Garbage and truncated files must be rejected, not dereferenced
+  const char *bad_path = "test_model_bad.aeon";
+  FILE *model_file = fopen(model_path, "rb");
+  fseek(model_file, 0, SEEK_END);
+  long model_size = ftell(model_file);
+  unsigned char *model_bytes = malloc((size_t)model_size);
+  fseek(model_file, 0, SEEK_SET);
+  if (fread(model_bytes, 1, (size_t)model_size, model_file) !=
+      (size_t)model_size) {
+    test_failed("Model File", "Could not read back the model");
+  }
+  fclose(model_file);
+  unsigned char garbage[200];
+  for (int i = 0; i < 200; i++)
+    garbage[i] = (unsigned char)(i * 37 + 11);
+  const struct {
+    const unsigned char *bytes;
+    size_t size;
+  } bad_files[] = {{garbage, sizeof(garbage)},
+                   {model_bytes, (size_t)model_size / 2},
+                   {model_bytes, 80}};
+  for (int i = 0; i < 3; i++) {
+    FILE *bad = fopen(bad_path, "wb");
+    fwrite(bad_files[i].bytes, 1, bad_files[i].size, bad);
+    fclose(bad);
+    io_err = 0;
+    if (aeon_core_map(bad_path, NULL, &io_err) != NULL || io_err == 0) {
+      test_failed("Model File", "Mapped a garbage or truncated file");
+    }
+  }
+  free(model_bytes);
+  remove(bad_path);
+
+  // A flipped byte must be caught by the section CRC
+  model_file = fopen(model_path, "r+b");
+  fseek(model_file, -1, SEEK_END);
+  int last = fgetc(model_file);
+  fseek(model_file, -1, SEEK_END);
+  fputc(last ^ 0x01, model_file);
+  fclose(model_file);
+  if (aeon_core_load(model_path, NULL, &io_err) != NULL || io_err != -7) {
+    test_failed("Model File", "Corrupted file was not rejected");
+  }
+
+  // A CSR row out of order or with a repeated column is rejected even
+  // with good CRCs, and a failed aeon_load leaves the model it had
+  static aeon_core_t snapshot, tampered;
+  memcpy(&snapshot, &loaded, sizeof(loaded));
+  for (int mode = 0; mode < 2; mode++) {
+    memcpy(&tampered, &core, sizeof(core));
+    uint32_t row = 0;
+    while (tampered.row_ptr[row + 1] - tampered.row_ptr[row] < 2)
+      row++;
+    uint16_t *cols = &tampered.col_indices[tampered.row_ptr[row]];
+    uint16_t first = cols[0];
+    cols[0] = cols[1];
+    cols[1] = mode == 0 ? first : cols[0];
+    if (aeon_save(&tampered, model_path) != 0 ||
+        aeon_load(&loaded, model_path) != -7) {
+      test_failed("Model File", "Unsorted CSR columns were accepted");
+    }
+    if (memcmp(&loaded, &snapshot, sizeof(loaded)) != 0) {
+      test_failed("Model File", "Failed load modified the core");
+    }
+  }
+  aeon_core_destroy(saved);
+  remove(model_path);
+  test_passed("Model File");
+
+  // TEST 13: Procedural reservoir keeps only the seed
+  aeon_dyn_core_t *proc = aeon_core_create_procedural(&wide, NULL);
+  if (proc == NULL || aeon_core_birth(proc, 21) != 0 || proc->W_in != NULL ||
+      proc->W_reservoir != NULL) {
+    test_failed("Procedural Reservoir", "Failed to create procedural core");
+  }
+  float mse_proc = aeon_core_train(proc, wide_in, wide_tgt, N_SAMPLES, 50);
+  printf("Procedural 64x4x2 MSE: %f (%u bytes, materialized %u)\n", mse_proc,
+         aeon_core_memory_usage(proc), (unsigned)aeon_core_arena_size(&wide));
+  if (mse_proc < 0.0f || mse_proc > 0.05f) {
+    test_failed("Procedural Reservoir", "Unexpected MSE");
+  }
+
+  if (aeon_core_save(proc, model_path, AEON_SECTION_ALL) != 0) {
+    test_failed("Procedural Reservoir", "aeon_core_save failed");
+  }
+  aeon_dyn_core_t *proc_loaded = aeon_core_load(model_path, NULL, &io_err);
+  remove(model_path);
+  if (proc_loaded == NULL || !proc_loaded->procedural) {
+    test_failed("Procedural Reservoir", "aeon_core_load failed");
+  }
+
+  if (!AEON_USE_FIXED_POINT)
+    aeon_simd_select("scalar"); // Exact batch equality (see TEST 7)
+  aeon_batch_t *proc_batch = aeon_batch_create(64, 2, NULL);
+  aeon_core_reset(proc);
+  aeon_core_reset(proc_loaded);
+  for (int t = 0; t < 100; t++) {
+    aeon_state_t out_a[2], out_b[2], out_batch[4];
+    aeon_state_t soa_in[8];
+    for (int j = 0; j < 4; j++) {
+      soa_in[j * 2] = wide_in[t * 4 + j];
+      soa_in[j * 2 + 1] = wide_in[t * 4 + j];
+    }
+    aeon_core_update(proc, &wide_in[t * 4]);
+    aeon_core_update(proc_loaded, &wide_in[t * 4]);
+    aeon_core_update_batch(proc, proc_batch, soa_in);
+    aeon_core_predict(proc, out_a);
+    aeon_core_predict(proc_loaded, out_b);
+    aeon_core_predict_batch(proc, proc_batch, out_batch);
+    if (memcmp(out_a, out_b, sizeof(out_a)) != 0) {
+      test_failed("Procedural Reservoir", "Reloaded core predicts differently");
+    }
+    if (out_batch[0] != out_a[0] || out_batch[2] != out_a[1]) {
+      test_failed("Procedural Reservoir", "Batched output differs from single");
+    }
+  }
+  aeon_batch_destroy(proc_batch);
+  aeon_simd_select(NULL);
+  aeon_core_destroy(proc_loaded);
+  aeon_core_destroy(proc);
+  test_passed("Procedural Reservoir");
+
+  // TEST 14: Delta mode matches aeon_update and skips work on slow input
+  aeon_delta_t *delta =
+      aeon_delta_create(AEON_RESERVOIR_SIZE, AEON_INPUT_SIZE, NULL);
+  if (delta == NULL || aeon_delta_begin(delta, -1) != -2) {
+    test_failed("Delta Update", "Create/begin validation failed");
+  }
+  static aeon_core_t dense_core;
+  aeon_birth(&core, 3);
+  aeon_birth(&dense_core, 3);
+  aeon_delta_begin(delta, 0);
+  for (int t = 0; t < N_SAMPLES; t++) {
+    aeon_update(&dense_core, &inputs[t]);
+    aeon_delta_update(delta, &core, &inputs[t]);
+#if AEON_USE_FIXED_POINT
+    if (memcmp(core.state, dense_core.state, sizeof(core.state)) != 0) {
+      test_failed("Delta Update", "Threshold 0 differs from aeon_update");
+    }
+#else
+    for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
+      if (fabsf(core.state[i] - dense_core.state[i]) > 1e-4f) {
+        test_failed("Delta Update", "Threshold 0 differs from aeon_update");
+      }
+    }
+#endif
+  }
+
+  // A slow signal (1/10 of the training rate) with a small threshold.
+  // The dense core is trained on it and both share W_out: the skipped
+  // updates are judged by the prediction they leave, not by the worst
+  // neuron, whose drift grows with the fan-in and the reservoir size
+  aeon_state_t slow[N_SAMPLES];
+  for (int t = 0; t < N_SAMPLES; t++) {
+    float v = sinf((float)t * 0.01f);
+#if AEON_USE_FIXED_POINT
+    slow[t] = (aeon_state_t)(v * AEON_SCALE);
+#else
+    slow[t] = v;
+#endif
+  }
+  float thr = 0.02f;
+  aeon_birth(&dense_core, 3);
+  aeon_train(&dense_core, slow, &slow[1], N_SAMPLES - 1, 50);
+  aeon_birth(&core, 3);
+  memcpy(core.W_out, dense_core.W_out, sizeof(core.W_out));
+  core.is_trained = dense_core.is_trained;
+  aeon_reset(&dense_core);
+#if AEON_USE_FIXED_POINT
+  aeon_delta_begin(delta, (aeon_state_t)(thr * AEON_SCALE));
+#else
+  aeon_delta_begin(delta, thr);
+#endif
+  float delta_err = 0.0f, dense_mse = 0.0f, delta_mse = 0.0f;
+  for (int t = 0; t < N_SAMPLES - 1; t++) {
+    aeon_state_t pred_dense, pred_delta;
+    aeon_update(&dense_core, &slow[t]);
+    aeon_delta_update(delta, &core, &slow[t]);
+    for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
+      float d = (float)(core.state[i] - dense_core.state[i]);
+#if AEON_USE_FIXED_POINT
+      d /= AEON_SCALE;
+#endif
+      if (fabsf(d) > delta_err)
+        delta_err = fabsf(d);
+    }
+    if (t < 50)
+      continue;
+    aeon_predict(&dense_core, &pred_dense);
+    aeon_predict(&core, &pred_delta);
+    float e_dense = (float)(pred_dense - slow[t + 1]);
+    float e_delta = (float)(pred_delta - slow[t + 1]);
+#if AEON_USE_FIXED_POINT
+    e_dense /= AEON_SCALE;
+    e_delta /= AEON_SCALE;
+#endif
+    dense_mse += e_dense * e_dense;
+    delta_mse += e_delta * e_delta;
+  }
+  dense_mse /= (N_SAMPLES - 51);
+  delta_mse /= (N_SAMPLES - 51);
+  printf("Delta (thr %.2f): %.1f%% MACs skipped, max state error %f, "
+         "MSE %f (dense %f)\n",
+         thr, 100.0 * (double)delta->ops_skipped / (double)delta->ops_total,
+         delta_err, delta_mse, dense_mse);
+  if (delta->ops_skipped == 0) {
+    test_failed("Delta Update", "Thresholded delta mode skipped nothing");
+  }
+  // Each skipped input moves a prediction by about the threshold
+  if (delta_mse > dense_mse + thr * thr) {
+    test_failed("Delta Update", "Thresholded delta mode drifted");
+  }
+  aeon_delta_destroy(delta);
+
+  aeon_dyn_core_t *proc_delta = aeon_core_create_procedural(&wide, NULL);
+  aeon_core_birth(proc_delta, 21);
+  delta = aeon_delta_create(64, 4, NULL);
+  if (aeon_core_delta_update(delta, proc_delta, wide_in) != -5) {
+    test_failed("Delta Update", "Procedural core was not rejected");
+  }
+  aeon_delta_destroy(delta);
+  aeon_core_destroy(proc_delta);
+  test_passed("Delta Update");
+
+  // TEST 15: Pruned readouts predict sparsely and save smaller
+  aeon_birth(&core, 3);
+  aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+  float prune_thr = 0.0f;
+  const int n_readout = AEON_OUTPUT_SIZE * AEON_RESERVOIR_SIZE;
+  int live = n_readout;
+  while (live > n_readout / 4) {
+    prune_thr += 0.02f;
+    live = n_readout - aeon_prune(&core, prune_thr);
+  }
+  if (!core.readout_sparse || core.readout_ptr[AEON_OUTPUT_SIZE] != live) {
+    test_failed("Sparse Readout", "aeon_prune did not compact W_out");
+  }
+  dense_core = core;
+  dense_core.readout_sparse = false;
+  for (int t = 0; t < N_SAMPLES; t++) {
+    aeon_state_t out_sparse[AEON_OUTPUT_SIZE], out_dense[AEON_OUTPUT_SIZE];
+    aeon_update(&core, &inputs[t]);
+    aeon_update(&dense_core, &inputs[t]);
+    aeon_predict(&core, out_sparse);
+    aeon_predict(&dense_core, out_dense);
+    if (memcmp(out_sparse, out_dense, sizeof(out_dense)) != 0) {
+      test_failed("Sparse Readout", "Sparse prediction differs from dense");
+    }
+  }
+
+  long file_size[2];
+  const uint32_t out_sections[2] = {AEON_SECTION_W_OUT,
+                                    AEON_SECTION_W_OUT_SPARSE};
+  for (int f = 0; f < 2; f++) {
+    aeon_save_sections(&core, model_path, out_sections[f]);
+    model_file = fopen(model_path, "rb");
+    fseek(model_file, 0, SEEK_END);
+    file_size[f] = ftell(model_file);
+    fclose(model_file);
+  }
+  if (aeon_load(&loaded, model_path) != 0 || !loaded.readout_sparse ||
+      memcmp(loaded.W_out, core.W_out, sizeof(core.W_out)) != 0) {
+    test_failed("Sparse Readout", "Sparse W_out did not round-trip");
+  }
+  aeon_dyn_core_t *sparse_dyn = aeon_core_map(model_path, NULL, &io_err);
+  if (sparse_dyn == NULL ||
+      memcmp(sparse_dyn->W_out, core.W_out, sizeof(core.W_out)) != 0) {
+    test_failed("Sparse Readout", "Runtime core did not expand sparse W_out");
+  }
+  aeon_core_destroy(sparse_dyn);
+  remove(model_path);
+  printf("Pruned to %d/%d weights: %ld bytes sparse, %ld dense\n", live,
+         n_readout, file_size[1], file_size[0]);
+  if (file_size[1] >= file_size[0]) {
+    test_failed("Sparse Readout", "Sparse file is not smaller");
+  }
+
+  aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+  if (core.readout_sparse) {
+    test_failed("Sparse Readout", "Retraining kept the stale sparse readout");
+  }
+  test_passed("Sparse Readout");
+
+  // TEST 16: Selectable tanh activations
+  const char *tanh_modes[3] = {"poly", "lut", "exact"};
+  if (strcmp(aeon_tanh_backend(), tanh_modes[AEON_TANH_MODE]) != 0) {
+    test_failed("Tanh Backends", "Active activation is not AEON_TANH_MODE");
+  }
+#if AEON_USE_FIXED_POINT && AEON_TANH_MODE == AEON_TANH_POLY
+  for (aeon_state_t x = -8 * AEON_SCALE; x <= 8 * AEON_SCALE; x++) {
+    if (aeon_tanh_approx(x) != tanh_poly_reference(x)) {
+      test_failed("Tanh Backends", "Division-free poly changed its results");
+    }
+  }
+#endif
+#if AEON_USE_FIXED_POINT
+  const float tanh_bound[3] = {0.25f, 0.003f, 0.002f};
+#else
+  // Float poly overshoots up to 1.47 just before it saturates at |x| = 2
+  const float tanh_bound[3] = {0.55f, 0.001f, 0.000001f};
+#endif
+  for (int m = 0; m < 3; m++) {
+    aeon_tanh_report_t rep;
+    if (aeon_tanh_report(tanh_modes[m], &rep) != 0) {
+      // Without AEON_TANH_RUNTIME only the built-in table is compiled
+      if (AEON_TANH_RUNTIME || m != AEON_TANH_LUT) {
+        test_failed("Tanh Backends", "aeon_tanh_report failed");
+      }
+      continue;
+    }
+    printf("Tanh %-5s: max error %.6f at x = %.4f, mean %.6f\n",
+           tanh_modes[m], rep.max_error, rep.worst_x, rep.mean_error);
+    if (rep.max_error > tanh_bound[m]) {
+      test_failed("Tanh Backends", "Activation error above its bound");
+    }
+  }
+  if (aeon_tanh_select("bogus") != -1 ||
+      strcmp(aeon_tanh_backend(), tanh_modes[AEON_TANH_MODE]) != 0) {
+    test_failed("Tanh Backends", "Unknown activation was accepted");
+  }
+
+  if (aeon_tanh_select("lut") == 0) {
+    aeon_birth(&core, 42);
+    float mse_lut = aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+    aeon_tanh_select(NULL);
+    printf("Training MSE with lut: %f\n", mse_lut);
+    if (mse_lut < 0.0f || mse_lut > 0.02f || isnan(mse_lut)) {
+      test_failed("Tanh Backends", "Training with lut failed");
+    }
+  }
+  test_passed("Tanh Backends");
+
+  // TEST 17: Opt-in hot-path stats and trace hooks
+  aeon_stats_t st;
+#if AEON_ENABLE_STATS
+  trace_log_t trace_log;
+  memset(&trace_log, 0, sizeof(trace_log));
+  aeon_hooks_t hooks = {fake_clock, trace_collect, &trace_log};
+  aeon_stats_hooks(&hooks);
+  aeon_stats_reset();
+
+  aeon_birth(&core, 42);
+  aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+  aeon_state_t loud = inputs[0] * 100 + 1000;
+  for (int t = 0; t < 20; t++) {
+    aeon_state_t out;
+    aeon_update(&core, t < 10 ? &inputs[t] : &loud);
+    aeon_predict(&core, &out);
+  }
+  aeon_stats_get(&st);
+  aeon_stats_hooks(NULL);
+  printf("Stats: %llu updates, %llu saturations, %llu pivot clamps, "
+         "%llu near misses\n",
+         (unsigned long long)st.calls[AEON_EVENT_UPDATE],
+         (unsigned long long)st.tanh_saturations,
+         (unsigned long long)st.pivot_clamps,
+         (unsigned long long)st.overflow_near_misses);
+  if (st.calls[AEON_EVENT_UPDATE] != 20 || st.calls[AEON_EVENT_PREDICT] != 20 ||
+      st.calls[AEON_EVENT_TRAIN] != 1) {
+    test_failed("Stats", "Stage calls were not counted");
+  }
+  if (st.time_total[AEON_EVENT_UPDATE] != 20 * 10 ||
+      st.time_max[AEON_EVENT_TRAIN] != 10) {
+    test_failed("Stats", "Stage times do not follow the hook clock");
+  }
+  if (st.tanh_saturations == 0 ||
+      trace_log.events[AEON_EVENT_TANH_SATURATION] == 0) {
+    test_failed("Stats", "A saturating input was not counted");
+  }
+  if (trace_log.events[AEON_EVENT_UPDATE] != 20 || trace_log.ticks != 41 * 10) {
+    test_failed("Stats", "Trace hook missed stage events");
+  }
+  aeon_stats_reset();
+  aeon_stats_get(&st);
+  if (st.calls[AEON_EVENT_UPDATE] != 0) {
+    test_failed("Stats", "aeon_stats_reset kept counters");
+  }
+#else
+  if (aeon_stats_get(&st) != -2 || st.calls[AEON_EVENT_UPDATE] != 0) {
+    test_failed("Stats", "Stats reported without AEON_ENABLE_STATS");
+  }
+#endif
+  if (strcmp(aeon_event_name(AEON_EVENT_PIVOT_CLAMP), "pivot_clamp") != 0 ||
+      aeon_event_name(99) != NULL) {
+    test_failed("Stats", "Unexpected event names");
+  }
+  test_passed("Stats");
+
+  // TEST 18: Closed-loop generation matches predict + update and is const
+  aeon_birth(&core, 42);
+  aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+  for (int t = 0; t < 100; t++) {
+    aeon_update(&core, &inputs[t]);
+  }
+  enum { HORIZON = 60 };
+  aeon_state_t forecast[HORIZON * AEON_OUTPUT_SIZE];
+  aeon_state_t replay[HORIZON * AEON_OUTPUT_SIZE];
+  for (int pass = 0; pass < 2; pass++) {
+    // Second pass: same checks through the sparse readout
+    if (pass == 1 && aeon_prune(&core, 0.3f) == 0) {
+      test_failed("Closed-Loop Generation", "Nothing was pruned");
+    }
+    dense_core = core;
+    if (aeon_generate(&core, HORIZON, forecast) != 0) {
+      test_failed("Closed-Loop Generation", "aeon_generate failed");
+    }
+    if (memcmp(&dense_core, &core, sizeof(core)) != 0) {
+      test_failed("Closed-Loop Generation", "aeon_generate changed the core");
+    }
+    for (int t = 0; t < HORIZON; t++) {
+      aeon_predict(&dense_core, &replay[t * AEON_OUTPUT_SIZE]);
+      aeon_update(&dense_core, &replay[t * AEON_OUTPUT_SIZE]);
+    }
+    if (memcmp(forecast, replay, sizeof(forecast)) != 0) {
+      test_failed("Closed-Loop Generation", "Trajectory differs from the loop");
+    }
+  }
+
+  aeon_config_t pair = {48, 2, 2, 4, AEON_SPECTRAL_RADIUS,
+                        AEON_LEAK_RATE};
+  aeon_dyn_core_t *pair_core = aeon_core_create(&pair, NULL);
+  aeon_core_birth(pair_core, 5);
+  aeon_state_t pair_in[N_SAMPLES * 2], pair_tgt[N_SAMPLES * 2];
+  for (int t = 0; t < N_SAMPLES; t++) {
+    for (int j = 0; j < 2; j++) {
+      pair_in[t * 2 + j] = inputs[(t + 3 * j) % N_SAMPLES];
+      pair_tgt[t * 2 + j] = targets[(t + 3 * j) % N_SAMPLES];
+    }
+  }
+  aeon_core_train(pair_core, pair_in, pair_tgt, N_SAMPLES, 50);
+  aeon_state_t pair_out[HORIZON * 2], pair_replay[HORIZON * 2];
+  if (aeon_core_generate(pair_core, HORIZON, pair_out) != 0) {
+    test_failed("Closed-Loop Generation", "aeon_core_generate failed");
+  }
+  for (int t = 0; t < HORIZON; t++) {
+    aeon_core_predict(pair_core, &pair_replay[t * 2]);
+    aeon_core_update(pair_core, &pair_replay[t * 2]);
+  }
+  if (memcmp(pair_out, pair_replay, sizeof(pair_out)) != 0) {
+    test_failed("Closed-Loop Generation", "Multi-output trajectory differs");
+  }
+  aeon_core_destroy(pair_core);
+
+  aeon_dyn_core_t *ragged = aeon_core_create(&wide, NULL);
+  if (aeon_core_generate(ragged, HORIZON, pair_out) != -2) {
+    test_failed("Closed-Loop Generation", "Input/output mismatch accepted");
+  }
+  aeon_core_destroy(ragged);
+  test_passed("Closed-Loop Generation");
+
+  // TEST 19: Routed ensemble skips rejected experts and matches by hand
+  uint32_t ens_seeds[3] = {42, 7, 99};
+  uint8_t ens_domains[3] = {AEON_DOMAIN_TIMESERIES, AEON_DOMAIN_TIMESERIES,
+                            AEON_DOMAIN_AUDIO};
+  aeon_ensemble_t *ens = aeon_ensemble_create(3, ens_seeds, ens_domains, NULL);
+  aeon_ensemble_t *ens_par =
+      aeon_ensemble_create(3, ens_seeds, ens_domains, NULL);
+  aeon_executor_t *pool = aeon_executor_create(3);
+  ens_par->executor = pool; // NULL without AEON_USE_THREADS: sequential
+  if (aeon_ensemble_cost(ens, 0, AEON_DOMAIN_TIMESERIES) != AEON_ROUTE_ACCEPT ||
+      aeon_ensemble_cost(ens, 2, AEON_DOMAIN_TIMESERIES) != AEON_ROUTE_REJECT) {
+    test_failed("Ensemble", "Unexpected routing decisions");
+  }
+
+  aeon_core_t audio_core = ens->experts[2].core;
+  float ens_mse = aeon_ensemble_train(ens, AEON_DOMAIN_TIMESERIES, inputs,
+                                      targets, N_SAMPLES, 50);
+  float par_mse = aeon_ensemble_train(ens_par, AEON_DOMAIN_TIMESERIES, inputs,
+                                      targets, N_SAMPLES, 50);
+  printf("Ensemble MSE: %.6f (%d experts, executor %s)\n", ens_mse,
+         ens->n_active, pool != NULL ? "threads" : "none");
+  if (ens_mse < 0.0f || ens_mse != par_mse || ens->n_active != 2 ||
+      ens->experts[0].processed[AEON_DOMAIN_TIMESERIES] != 2) {
+    test_failed("Ensemble", "Training did not reach the routed experts");
+  }
+
+  aeon_core_t ref_a = ens->experts[0].core;
+  aeon_core_t ref_b = ens->experts[1].core;
+  uint8_t aff_a = ens->experts[0].affinity[AEON_DOMAIN_TIMESERIES];
+  uint8_t aff_b = ens->experts[1].affinity[AEON_DOMAIN_TIMESERIES];
+  for (int t = 0; t < 100; t++) {
+    aeon_state_t mixed[AEON_OUTPUT_SIZE], par_mixed[AEON_OUTPUT_SIZE];
+    aeon_state_t out_a[AEON_OUTPUT_SIZE], out_b[AEON_OUTPUT_SIZE];
+    if (aeon_ensemble_step(ens, AEON_DOMAIN_TIMESERIES, &inputs[t], mixed) !=
+            2 ||
+        aeon_ensemble_step(ens_par, AEON_DOMAIN_TIMESERIES, &inputs[t],
+                           par_mixed) != 2) {
+      test_failed("Ensemble", "aeon_ensemble_step failed");
+    }
+    aeon_update(&ref_a, &inputs[t]);
+    aeon_predict(&ref_a, out_a);
+    aeon_update(&ref_b, &inputs[t]);
+    aeon_predict(&ref_b, out_b);
+    for (int o = 0; o < AEON_OUTPUT_SIZE; o++) {
+#if AEON_USE_FIXED_POINT
+      int64_t sum = (int64_t)aff_a * out_a[o] + (int64_t)aff_b * out_b[o];
+      aeon_state_t expect = (aeon_state_t)(sum / (aff_a + aff_b));
+#else
+      aeon_state_t expect = (aff_a * out_a[o] + aff_b * out_b[o]) /
+                            (float)(aff_a + aff_b);
+#endif
+      if (mixed[o] != expect || par_mixed[o] != mixed[o]) {
+        test_failed("Ensemble", "Mixed output differs from the weighted mean");
+      }
+    }
+  }
+  if (memcmp(&audio_core, &ens->experts[2].core, sizeof(audio_core)) != 0) {
+    test_failed("Ensemble", "A rejected expert was evaluated");
+  }
+  aeon_state_t none[AEON_OUTPUT_SIZE];
+  if (aeon_ensemble_step(ens, AEON_DOMAIN_LIGHT, inputs, none) != -3 ||
+      aeon_ensemble_step(ens, AEON_DOMAIN_COUNT, inputs, none) != -2) {
+    test_failed("Ensemble", "Unroutable domains accepted");
+  }
+  aeon_executor_destroy(pool);
+  aeon_ensemble_destroy(ens_par);
+  aeon_ensemble_destroy(ens);
+  test_passed("Ensemble");
+
+  // TEST 20: Framed binary ingestion is served in place; CSV falls back
+  // Two Q8.8 channels: a 3-frame block, an empty block, a 2-frame block
+  static const int16_t stream_values[10] = {256, -128, 64, 512, -1,
+                                            0,   300,  -300, 7, 25};
+  uint8_t stream_buf[AEON_STREAM_HEADER_SIZE + 3 * 4 + sizeof(stream_values)];
+  memcpy(stream_buf, "EONS", 4);
+  stream_buf[4] = AEON_STREAM_VERSION;
+  stream_buf[5] = 8; // Q8.8
+  stream_buf[6] = 2; // Channels, little-endian
+  stream_buf[7] = 0;
+  size_t sb = AEON_STREAM_HEADER_SIZE;
+  const uint32_t block_frames[3] = {3, 0, 2};
+  for (int b = 0, v = 0; b < 3; b++) {
+    for (int k = 0; k < 4; k++) {
+      stream_buf[sb++] = (uint8_t)(block_frames[b] >> (8 * k));
+    }
+    for (uint32_t i = 0; i < block_frames[b] * 2; i++, v++) {
+      stream_buf[sb++] = (uint8_t)(stream_values[v] & 0xFF);
+      stream_buf[sb++] = (uint8_t)((uint16_t)stream_values[v] >> 8);
+    }
+  }
+
+  const char *stream_path = "test_stream.eons";
+  FILE *stream_file = fopen(stream_path, "wb");
+  if (stream_file == NULL || fwrite(stream_buf, 1, sb, stream_file) != sb) {
+    test_failed("Stream Ingestion", "Could not write the stream file");
+  }
+  fclose(stream_file);
+
+  for (int pass = 0; pass < 2; pass++) {
+    int stream_err;
+    aeon_stream_t *rd =
+        pass == 0 ? aeon_stream_open_memory(stream_buf, sb, 8, 0, NULL,
+                                            &stream_err)
+                  : aeon_stream_open(stream_path, 8, 0, NULL, &stream_err);
+    if (rd == NULL || !rd->binary || rd->channels != 2) {
+      test_failed("Stream Ingestion", "Binary stream not recognized");
+    }
+    const int16_t *frames;
+    int16_t got_values[10];
+    int32_t n, total = 0;
+    while ((n = aeon_stream_next(rd, &frames)) > 0) {
+      memcpy(&got_values[total * 2], frames, (size_t)n * 2 * sizeof(int16_t));
+      if (pass == 0 && rd->mapped && total == 0 &&
+          (const void *)frames != stream_buf + AEON_STREAM_HEADER_SIZE + 4) {
+        test_failed("Stream Ingestion", "Mapped block was copied");
+      }
+      total += n;
+    }
+    if (n != 0 || total != 5 ||
+        memcmp(got_values, stream_values, sizeof(stream_values)) != 0) {
+      test_failed("Stream Ingestion", "Binary frames differ");
+    }
+    aeon_stream_close(rd);
+  }
+  remove(stream_path);
+
+  int trunc_err;
+  aeon_stream_t *trunc =
+      aeon_stream_open_memory(stream_buf, sb - 1, 8, 0, NULL, &trunc_err);
+  const int16_t *trunc_frames;
+  if (trunc == NULL || aeon_stream_next(trunc, &trunc_frames) != 3 ||
+      aeon_stream_next(trunc, &trunc_frames) != -4) {
+    test_failed("Stream Ingestion", "Truncated block accepted");
+  }
+  aeon_stream_close(trunc);
+
+  // CSV fallback: header and comment lines skipped, values rounded
+  const char csv[] = "b1,target\n0.5,1\n# noise\n-0.25; 2\n0.3 0\n";
+  aeon_stream_t *rd_csv =
+      aeon_stream_open_memory(csv, sizeof(csv) - 1, 8, 2, NULL, NULL);
+  const int16_t *csv_frames;
+  if (rd_csv == NULL || rd_csv->binary || rd_csv->channels != 2 ||
+      aeon_stream_next(rd_csv, &csv_frames) != 2 || csv_frames[0] != 128 ||
+      csv_frames[1] != 256 || csv_frames[2] != -64 || csv_frames[3] != 512) {
+    test_failed("Stream Ingestion", "CSV frames differ");
+  }
+  aeon_state_t csv_state[2];
+  if (aeon_stream_next(rd_csv, &csv_frames) != 1 ||
+      aeon_stream_next(rd_csv, &csv_frames) != 0 || rd_csv->skipped != 2) {
+    test_failed("Stream Ingestion", "CSV framing is off");
+  }
+  aeon_stream_state(rd_csv, csv_frames, 0, 2, csv_state);
+#if AEON_USE_FIXED_POINT
+  if (csv_state[0] != 77 || csv_state[1] != 0) {
+#else
+  if (fabsf(csv_state[0] - 77.0f / 256.0f) > 1e-6f || csv_state[1] != 0.0f) {
+#endif
+    test_failed("Stream Ingestion", "aeon_stream_state changed the scale");
+  }
+  aeon_stream_close(rd_csv);
+  test_passed("Stream Ingestion");
+
+  // TEST 21: Goertzel front-end: band selectivity, level and chunking
+  aeon_frontend_config_t fe_config = AEON_FRONTEND_CONFIG_DEFAULT;
+  aeon_frontend_t fe, fe_chunked;
+  if (aeon_frontend_begin(&fe, &fe_config) != 0 || sizeof(fe) > 2048) {
+    test_failed("Audio Front-End", "Default front-end rejected or too big");
+  }
+  aeon_frontend_config_t fe_bad = fe_config;
+  fe_bad.hop_len = fe_bad.frame_len + 1;
+  if (aeon_frontend_begin(&fe_chunked, &fe_bad) != -2) {
+    test_failed("Audio Front-End", "Hop longer than the frame accepted");
+  }
+  // Bins a few Hz from DC would wrap the 32-bit Goertzel state
+  const aeon_frontend_config_t fe_low = {8000, 4, 512, 160, 1, 20, 90};
+  if (aeon_frontend_begin(&fe_chunked, &fe_low) != -2) {
+    test_failed("Audio Front-End", "Overflowing low band accepted");
+  }
+
+  enum { PCM_LEN = 1000 };
+  int16_t pcm[PCM_LEN];
+  aeon_state_t bands[(PCM_LEN / 160 + 1) * 4], bands_chunked[4 * 8];
+  const float amplitudes[2] = {32767.0f, 327.67f}; // 0 dB and -40 dB
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < PCM_LEN; i++) {
+      pcm[i] = (int16_t)lrintf(amplitudes[pass] *
+                               sinf(2.0f * 3.14159265f * 1800.0f * i / 8000));
+    }
+    aeon_frontend_begin(&fe, &fe_config);
+    aeon_frontend_begin(&fe_chunked, &fe_config);
+    int n_frames = aeon_frontend_push(&fe, pcm, PCM_LEN, bands);
+    int n_chunked = 0;
+    for (int i = 0; i < PCM_LEN; i++) {
+      n_chunked += aeon_frontend_push(&fe_chunked, &pcm[i], 1,
+                                      &bands_chunked[n_chunked * 4]);
+    }
+    // First frame once 256 samples are in, then one every 160
+    if (n_frames != 5 || n_chunked != 5 ||
+        memcmp(bands, bands_chunked, 5 * 4 * sizeof(aeon_state_t)) != 0) {
+      test_failed("Audio Front-End", "Frames depend on how PCM is chunked");
+    }
+    // Last frame; AEON_SCALE is 1.0f in float builds
+    const aeon_state_t *last = &bands[4 * 4];
+    float level = (float)last[2] / AEON_SCALE;
+    printf("Front-end 1800 Hz at %s: [%.2f %.2f %.2f %.2f]\n",
+           pass == 0 ? "0 dB" : "-40 dB", (float)last[0] / AEON_SCALE,
+           (float)last[1] / AEON_SCALE, level, (float)last[3] / AEON_SCALE);
+    float expect = pass == 0 ? 1.0f : 1.0f - 40.0f / 90.0f;
+    if (fabsf(level - expect) > 0.05f) {
+      test_failed("Audio Front-End", "Band level off the log scale");
+    }
+    for (int b = 0; b < 4; b++) {
+      if (b != 2 && last[b] >= last[2] / 2) {
+        test_failed("Audio Front-End", "Tone leaks into other bands");
+      }
+    }
+  }
+  memset(pcm, 0, sizeof(pcm));
+  aeon_frontend_begin(&fe, &fe_config);
+  aeon_frontend_push(&fe, pcm, PCM_LEN, bands);
+  for (int b = 0; b < 4; b++) {
+    if (bands[b] != 0) {
+      test_failed("Audio Front-End", "Silence has energy");
+    }
+  }
+  test_passed("Audio Front-End");
+
+  // TEST 22: Checkpoint log appends only what changed and restores
+  const char *ckpt_path = "test_checkpoint.log";
+  remove(ckpt_path);
+  aeon_core_t sensor, back_core;
+  aeon_birth(&sensor, 77);
+  aeon_train(&sensor, inputs, targets, N_SAMPLES, 50);
+  aeon_prune(&sensor, 0.05f);
+
+  int ckpt_err;
+  aeon_checkpoint_t *ckpt =
+      aeon_checkpoint_open(ckpt_path, &sensor, NULL, &ckpt_err);
+  if (ckpt == NULL || ckpt_err != 0) {
+    test_failed("Checkpoint Log", "aeon_checkpoint_open failed");
+  }
+  if (aeon_checkpoint_save(ckpt, &sensor) != AEON_CHECKPOINT_ALL) {
+    test_failed("Checkpoint Log", "First checkpoint is not complete");
+  }
+  for (int i = 0; i < 10; i++)
+    aeon_update(&sensor, &inputs[i]);
+  if (aeon_checkpoint_save(ckpt, &sensor) !=
+          (AEON_CHECKPOINT_STATE | AEON_CHECKPOINT_COUNTERS) ||
+      aeon_checkpoint_save(ckpt, &sensor) != 0) {
+    test_failed("Checkpoint Log", "Unchanged sections were written");
+  }
+  if (aeon_checkpoint_flush(ckpt) != 0) {
+    test_failed("Checkpoint Log", "aeon_checkpoint_flush failed");
+  }
+  uint64_t full_bytes =
+      16 + 16 + sizeof(sensor.state) + sizeof(sensor.W_out) + 4;
+  uint64_t delta_bytes = 16 + 16 + sizeof(sensor.state) + 4;
+  printf("Checkpoint records: %u + %u bytes (aeon_save rewrites %u)%s\n",
+         (unsigned)full_bytes, (unsigned)delta_bytes,
+         aeon_memory_usage(&sensor), ckpt->threaded ? ", threaded" : "");
+  if (ckpt->records + ckpt->coalesced != 2 ||
+      ckpt->bytes != 56 + ckpt->records * delta_bytes + sizeof(sensor.W_out)) {
+    test_failed("Checkpoint Log", "Unexpected log size");
+  }
+  if (aeon_checkpoint_close(ckpt) != 0) {
+    test_failed("Checkpoint Log", "aeon_checkpoint_close failed");
+  }
+  aeon_core_t saved_live = sensor;
+
+  // Appending resumes after the last record; other cores are refused
+  ckpt = aeon_checkpoint_open(ckpt_path, &sensor, NULL, &ckpt_err);
+  uint32_t resumed = ckpt != NULL ? ckpt->sequence : 0;
+  aeon_update(&sensor, &inputs[10]);
+  if (ckpt == NULL ||
+      aeon_checkpoint_save(ckpt, &sensor) != AEON_CHECKPOINT_ALL ||
+      aeon_checkpoint_close(ckpt) != 0 || resumed == 0) {
+    test_failed("Checkpoint Log", "Could not resume the log");
+  }
+  aeon_birth(&back_core, 78);
+  if (aeon_checkpoint_open(ckpt_path, &back_core, NULL, &ckpt_err) != NULL ||
+      ckpt_err != -5) {
+    test_failed("Checkpoint Log", "Log of another core was accepted");
+  }
+
+  int applied = aeon_checkpoint_restore(&back_core, ckpt_path);
+  aeon_state_t y_live, y_back;
+  aeon_predict(&sensor, &y_live);
+  aeon_predict(&back_core, &y_back);
+  if (applied != (int)resumed + 1 ||
+      memcmp(back_core.state, sensor.state, sizeof(sensor.state)) != 0 ||
+      memcmp(back_core.W_out, sensor.W_out, sizeof(sensor.W_out)) != 0 ||
+      memcmp(back_core.W_in, sensor.W_in, sizeof(sensor.W_in)) != 0 ||
+      memcmp(&back_core.certificate.birth_hash, &sensor.certificate.birth_hash,
+             sizeof(aeon_hash_t)) != 0 ||
+      back_core.samples_processed != sensor.samples_processed ||
+      back_core.readout_sparse != sensor.readout_sparse || y_back != y_live) {
+    test_failed("Checkpoint Log", "Restored core differs");
+  }
+
+  // A torn last record is skipped: the previous snapshot wins
+  FILE *ckpt_file = fopen(ckpt_path, "r+b");
+  fseek(ckpt_file, -3, SEEK_END);
+  fputc(0x5A, ckpt_file);
+  fclose(ckpt_file);
+  applied = aeon_checkpoint_restore(&back_core, ckpt_path);
+  if (applied != (int)resumed ||
+      memcmp(back_core.state, saved_live.state, sizeof(sensor.state)) != 0 ||
+      back_core.samples_processed != saved_live.samples_processed) {
+    test_failed("Checkpoint Log", "Corrupted record was applied");
+  }
+  remove(ckpt_path);
+  test_passed("Checkpoint Log");
+
+  // TEST 23: Half-width weights round to nearest even; FMA backends
+  // track the scalar float path
+  const struct {
+    float x;
+    uint16_t f16, bf16;
+  } half_cases[] = {
+      {1.0f, 0x3C00, 0x3F80},
+      {-2.0f, 0xC000, 0xC000},
+      {1.0f + 1.0f / 2048, 0x3C00, 0x3F80}, // Tie (f16): stays even
+      {1.0f + 3.0f / 2048, 0x3C02, 0x3F80}, // Tie (f16): rounds up
+      {1.0f + 3.0f / 256, 0x3C0C, 0x3F82},  // Tie (bf16): rounds up
+      {65504.0f, 0x7BFF, 0x4780},           // Largest f16
+      {65520.0f, 0x7C00, 0x4780},           // f16 overflows to inf
+      {5.9604645e-08f, 0x0001, 0x3380},     // Smallest f16 subnormal
+      {2.0e-08f, 0x0000, 0x32AC},           // f16 underflows to zero
+  };
+  for (size_t c = 0; c < sizeof(half_cases) / sizeof(half_cases[0]); c++) {
+    if (aeon_f16_from_float(half_cases[c].x) != half_cases[c].f16 ||
+        aeon_bf16_from_float(half_cases[c].x) != half_cases[c].bf16) {
+      char msg[64];
+      sprintf(msg, "Wrong rounding of %g", (double)half_cases[c].x);
+      test_failed("Half Weights", msg);
+    }
+  }
+  for (uint32_t h = 0; h < 0x10000; h++) {
+    bool nan16 = (h & 0x7C00) == 0x7C00 && (h & 0x03FF) != 0;
+    bool nan_bf = (h & 0x7F80) == 0x7F80 && (h & 0x007F) != 0;
+    if ((!nan16 && aeon_f16_from_float(aeon_f16_to_float(h)) != h) ||
+        (!nan_bf && aeon_bf16_from_float(aeon_bf16_to_float(h)) != h)) {
+      test_failed("Half Weights", "16-bit value does not round-trip");
+    }
+  }
+  if (!isnan(aeon_f16_to_float(aeon_f16_from_float(NAN))) ||
+      !isnan(aeon_bf16_to_float(aeon_bf16_from_float(NAN)))) {
+    test_failed("Half Weights", "NaN became a number");
+  }
+
+#if !AEON_USE_FIXED_POINT
+  const char *fma_backends[] = {"avx2-fma", "neon-fma"};
+  aeon_simd_select("scalar");
+  aeon_birth(&core, 3);
+  mse_ref = aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+  aeon_state_t y_ref[N_SAMPLES];
+  aeon_reset(&core);
+  for (int t = 0; t < N_SAMPLES; t++) {
+    aeon_update(&core, &inputs[t]);
+    aeon_predict(&core, &y_ref[t]);
+  }
+  for (int b = 0; b < 2; b++) {
+    if (aeon_simd_select(fma_backends[b]) != 0)
+      continue;
+    aeon_birth(&core, 3);
+    float mse_b = aeon_train(&core, inputs, targets, N_SAMPLES, 50);
+    float drift = 0.0f;
+    aeon_reset(&core);
+    for (int t = 0; t < N_SAMPLES; t++) {
+      aeon_state_t y;
+      aeon_update(&core, &inputs[t]);
+      aeon_predict(&core, &y);
+      drift = fmaxf(drift, fabsf(y - y_ref[t]));
+    }
+    printf("Backend %s: MSE %f (scalar %f), max drift %.2e\n",
+           fma_backends[b], mse_b, mse_ref, drift);
+    if (fabsf(mse_b - mse_ref) > 1e-3f || drift > 1e-2f) {
+      char msg[64];
+      sprintf(msg, "Backend %s drifts from scalar", fma_backends[b]);
+      test_failed("Half Weights", msg);
+    }
+  }
+  aeon_simd_select(NULL);
+#endif
+  printf("Float weights: %u bytes each\n", (unsigned)sizeof(aeon_weight_t));
+  test_passed("Half Weights");
+
+  // TEST 24: Birth keeps the raw weights unless a spectral radius is
+  // asked for; leak blends the step
+  aeon_birth_spectral(&core, 3, 0.9f);
+  const float radius_ref = aeon_spectral_radius(&core);
+  aeon_birth_spectral(&back_core, 3, 0.0f);
+  float radius_raw = aeon_spectral_radius(&back_core);
+  // aeon_birth takes AEON_SPECTRAL_RADIUS: raw weights unless the build
+  // asks for a radius (the suite does above 32 neurons)
+  aeon_birth(&loaded, 3);
+  bool birth_default =
+      loaded.spectral_radius == AEON_SPECTRAL_RADIUS &&
+      (AEON_SPECTRAL_RADIUS != 0.0f ||
+       memcmp(loaded.W_reservoir, back_core.W_reservoir,
+              sizeof(loaded.W_reservoir)) == 0);
+  if (!birth_default || aeon_birth_spectral(&loaded, 3, -1.0f) != -2 ||
+      fabsf(radius_ref - 0.9f) > 0.02f * 0.9f ||
+      fabsf(radius_raw - radius_ref) < 0.05f) {
+    test_failed("Spectral Radius", "Static birth radius is not the asked one");
+  }
+  aeon_config_t tuned = {256, 1, 1, 8, 0.5f, 0.25f};
+  aeon_dyn_core_t *tuned_cores[2] = {aeon_core_create(&tuned, NULL),
+                                     aeon_core_create_procedural(&tuned, NULL)};
+  for (int c = 0; c < 2; c++) {
+    float r = -1.0f;
+    if (tuned_cores[c] != NULL && aeon_core_birth(tuned_cores[c], 5) == 0)
+      r = aeon_core_spectral_radius(tuned_cores[c]);
+    printf("Spectral radius %s: %.4f for 0.5 (raw birth at 32: %.4f)\n",
+           c ? "procedural" : "CSR", r, radius_raw);
+    if (fabsf(r - 0.5f) > 0.01f) {
+      test_failed("Spectral Radius", "Runtime birth missed the target");
+    }
+  }
+
+  // From rest, one leaky step is the leak times the full step
+  back_core = core;
+  back_core.leak_rate = 0.25f;
+  aeon_update(&core, &inputs[1]);
+  aeon_update(&back_core, &inputs[1]);
+  for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
+#if AEON_USE_FIXED_POINT
+    bool blended = back_core.state[i] == (core.state[i] * 64) >> 8;
+#else
+    bool blended = fabsf(back_core.state[i] - 0.25f * core.state[i]) < 1e-6f;
+#endif
+    if (!blended) {
+      test_failed("Spectral Radius", "Leaky step does not blend");
+    }
+  }
+
+  // Non-default dynamics write a version 3 header; the defaults of
+  // earlier files (raw weights, no leak) still write version 1
+  for (int c = 0; c < 2; c++) {
+    aeon_dyn_core_t *tc = tuned_cores[c];
+    aeon_dyn_core_t *tl = NULL;
+    uint8_t version[2] = {0, 0};
+    if (aeon_core_save(tc, model_path, AEON_SECTION_W_OUT) == 0 &&
+        (model_file = fopen(model_path, "rb")) != NULL) {
+      fseek(model_file, 4, SEEK_SET);
+      if (fread(version, 1, 2, model_file) != 2)
+        version[0] = 0;
+      fclose(model_file);
+      tl = aeon_core_load(model_path, NULL, &io_err);
+    }
+    if (tl == NULL || version[0] != 3 ||
+        tl->config.spectral_radius != tuned.spectral_radius ||
+        tl->config.leak_rate != tuned.leak_rate) {
+      test_failed("Spectral Radius", "Dynamics were not saved");
+    }
+    for (int t = 0; tl != NULL && t < 50; t++) {
+      aeon_state_t ya, yb;
+      aeon_core_update(tc, &inputs[t]);
+      aeon_core_update(tl, &inputs[t]);
+      aeon_core_predict(tc, &ya);
+      aeon_core_predict(tl, &yb);
+      if (memcmp(tc->state, tl->state, 256 * sizeof(aeon_state_t)) != 0 ||
+          ya != yb) {
+        test_failed("Spectral Radius", "Loaded core steps differently");
+      }
+    }
+    aeon_core_destroy(tl);
+    aeon_core_destroy(tc);
+  }
+  aeon_birth_spectral(&back_core, 3, 0.0f);
+  uint8_t legacy_version = 0;
+  if (aeon_save(&back_core, model_path) == 0 &&
+      (model_file = fopen(model_path, "rb")) != NULL) {
+    fseek(model_file, 4, SEEK_SET);
+    legacy_version = (uint8_t)fgetc(model_file);
+    fclose(model_file);
+  }
+  if (legacy_version != 1 || aeon_load(&loaded, model_path) != 0 ||
+      loaded.spectral_radius != 0.0f || loaded.leak_rate != 1.0f ||
+      memcmp(loaded.W_reservoir, back_core.W_reservoir,
+             sizeof(loaded.W_reservoir)) != 0) {
+    test_failed("Spectral Radius", "Legacy dynamics changed the file");
+  }
+  remove(model_path);
+
+  // The checkpoint log regenerates at the logged radius and keeps the leak
+  aeon_birth_spectral(&sensor, 77, 0.7f);
+  sensor.leak_rate = 0.5f;
+  ckpt = aeon_checkpoint_open(ckpt_path, &sensor, NULL, &ckpt_err);
+  if (ckpt == NULL || aeon_checkpoint_save(ckpt, &sensor) < 0 ||
+      aeon_checkpoint_close(ckpt) != 0 ||
+      aeon_checkpoint_restore(&back_core, ckpt_path) != 1 ||
+      back_core.spectral_radius != 0.7f || back_core.leak_rate != 0.5f ||
+      memcmp(back_core.W_reservoir, sensor.W_reservoir,
+             sizeof(sensor.W_reservoir)) != 0) {
+    test_failed("Spectral Radius", "Checkpoint lost the dynamics");
+  }
+  remove(ckpt_path);
+  test_passed("Spectral Radius");
+
+  // TEST 25: Parallel accumulation: same solution as the serial
+  // training, and the same bits whatever runs the tasks
+  aeon_dyn_core_t *par = aeon_core_create(&large, NULL);
+  aeon_core_birth(par, 11);
+  size_t w_bytes = 256 * sizeof(aeon_weight_t);
+  aeon_weight_t *w_serial = malloc(w_bytes);
+  float mse_serial = aeon_core_train(par, inputs, targets, N_SAMPLES, 50);
+  memcpy(w_serial, par->W_out, w_bytes);
+  if (aeon_core_train_parallel(par, inputs, targets, N_SAMPLES, 50, NULL,
+                               0) != -2.0f) {
+    test_failed("Parallel Training", "Zero partials were accepted");
+  }
+  float mse_one =
+      aeon_core_train_parallel(par, inputs, targets, N_SAMPLES, 50, NULL, 1);
+  if (mse_one != mse_serial || memcmp(par->W_out, w_serial, w_bytes) != 0) {
+    test_failed("Parallel Training", "One partial differs from the serial");
+  }
+
+  // 250 samples in three partials of 64: the second round is partial
+  aeon_executor_t *train_pool = aeon_executor_create(3);
+  aeon_weight_t *w_in_order = malloc(w_bytes);
+  float mse_in_order =
+      aeon_core_train_parallel(par, inputs, targets, N_SAMPLES, 50, NULL, 3);
+  memcpy(w_in_order, par->W_out, w_bytes);
+  float mse_pool = aeon_core_train_parallel(par, inputs, targets, N_SAMPLES,
+                                            50, train_pool, 3);
+  printf("Parallel training MSE: %f (serial %f, one partial %f%s)\n",
+         mse_pool, mse_serial, mse_one,
+         train_pool != NULL ? ", thread pool" : "");
+  if (mse_pool != mse_in_order ||
+      memcmp(par->W_out, w_in_order, w_bytes) != 0) {
+    test_failed("Parallel Training", "Result depends on the executor");
+  }
+  if (fabsf(mse_pool - mse_serial) > 0.1f * mse_serial + 1e-4f) {
+    test_failed("Parallel Training", "Partials changed the solution");
+  }
+  aeon_executor_destroy(train_pool);
+  free(w_serial);
+  free(w_in_order);
+  aeon_core_destroy(par);
+  test_passed("Parallel Training");
+
+  // TEST 26: Long series: the blocked accumulation with a per-sample
+  // ridge is at least as accurate as the old float accumulation with
+  // Gauss-Jordan, and its closed-form MSE still matches the replay
+  enum { N_LONG = 60000 };
+  aeon_state_t *long_in = malloc(N_LONG * sizeof(aeon_state_t));
+  aeon_state_t *long_tgt = malloc(N_LONG * sizeof(aeon_state_t));
+  generate_data(long_in, N_LONG);
+  for (int i = 0; i < N_LONG; i++)
+    long_tgt[i] = long_in[(i + 1) % N_LONG];
+  const uint32_t long_lengths[] = {6000, N_LONG};
+  for (int k = 0; k < 2; k++) {
+    uint32_t len = long_lengths[k];
+    aeon_birth(&core, 3);
+    legacy_train(&core, long_in, long_tgt, len, 50);
+    float mse_old = replay_mse(&core, long_in, long_tgt, len, 50);
+    aeon_birth(&core, 3);
+    float mse_new = aeon_train(&core, long_in, long_tgt, len, 50);
+    float mse_new_replay = replay_mse(&core, long_in, long_tgt, len, 50);
+    printf("Long series (%u samples): MSE %f (replay %f, old solver %f)\n",
+           (unsigned)len, mse_new, mse_new_replay, mse_old);
+    if (mse_new < 0.0f || mse_new_replay > 1.05f * mse_old + 1e-4f) {
+      test_failed("Long Series", "Worse than the old solver");
+    }
+    if (fabsf(mse_new - mse_new_replay) > 0.05f * mse_new_replay + 1e-4f) {
+      test_failed("Long Series", "Closed-form MSE differs from replay");
+    }
+  }
+  free(long_in);
+  free(long_tgt);
+  test_passed("Long Series");
+
+  // TEST 27: A streaming session of 10^5 samples without forgetting
+  // lands within one LSB of the batch training of the same series (in
+  // Q8.8 that LSB alone moves the MSE by tens of percent)
+  enum { N_STREAM = 100000 };
+  aeon_state_t *stream_in = malloc(N_STREAM * sizeof(aeon_state_t));
+  aeon_state_t *stream_tgt = malloc(N_STREAM * sizeof(aeon_state_t));
+  generate_data(stream_in, N_STREAM);
+  for (int i = 0; i < N_STREAM; i++)
+    stream_tgt[i] = stream_in[(i + 1) % N_STREAM];
+  aeon_trainer_t *session =
+      aeon_trainer_create(AEON_RESERVOIR_SIZE, AEON_OUTPUT_SIZE, NULL);
+  aeon_birth(&core, 3);
+  aeon_trainer_begin(session, 1.0f, 50);
+  for (int t = 0; t < N_STREAM; t++)
+    aeon_trainer_push(session, &core, &stream_in[t], &stream_tgt[t]);
+  int session_solved = aeon_trainer_finalize(session, &core);
+  float mse_session = replay_mse(&core, stream_in, stream_tgt, N_STREAM, 50);
+  memcpy(w_ref, core.W_out, sizeof(w_ref));
+  aeon_birth(&core, 3);
+  float mse_batch = aeon_train(&core, stream_in, stream_tgt, N_STREAM, 50);
+  printf("Streaming %d samples: MSE %f (replay %f, batch %f)\n", N_STREAM,
+         session->mse, mse_session, mse_batch);
+  if (session_solved < 0 || mse_batch < 0.0f ||
+      mse_session > 1.5f * mse_batch + 1e-4f) {
+    test_failed("Long Streaming", "Long session drifted from the batch fit");
+  }
+  for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
+    // Same blocks as aeon_train, as in TEST 9; conditioning of S^T*S
+    // in float
+    float ref = aeon_weight_to_float(core.W_out[i]);
+    float lsb = AEON_USE_FIXED_POINT ? 1.0f / AEON_SCALE : 1e-2f;
+    if (W16_STORAGE)
+      lsb += fabsf(ref) / 128.0f;
+    if (fabsf(aeon_weight_to_float(w_ref[i]) - ref) > lsb) {
+      test_failed("Long Streaming", "W_out differs from aeon_train");
+    }
+  }
+  if (fabsf(session->mse - mse_session) > 0.05f * mse_session + 1e-5f) {
+    test_failed("Long Streaming", "Closed-form MSE differs from replay");
+  }
+  aeon_trainer_destroy(session);
+  free(stream_in);
+  free(stream_tgt);
+  test_passed("Long Streaming");
+
+  // TEST 28: Ill-conditioned fit: two groups of identical neurons sink
+  // the pivots under a tiny ridge; the retried fit's closed-form MSE
+  // still matches the replay, and a fit that never factors leaves
+  // W_out alone
+  enum { N_RANK2 = 2000 };
+  aeon_state_t *rank2 = malloc(N_RANK2 * AEON_RESERVOIR_SIZE *
+                               sizeof(aeon_state_t));
+  aeon_state_t *rank2_tgt = malloc(N_RANK2 * sizeof(aeon_state_t));
+  for (int t = 0; t < N_RANK2; t++) {
+    for (int i = 0; i < AEON_RESERVOIR_SIZE; i++) {
+      float s = sinf((float)(t - 3 * (i & 1)) * 0.1f);
+      rank2[t * AEON_RESERVOIR_SIZE + i] = from_float(s);
+    }
+    float y = sinf((float)(t + 1) * 0.1f) + 0.1f * sinf((float)t * 1.7f);
+    rank2_tgt[t] = from_float(y);
+  }
+  aeon_trainer_t *ill =
+      aeon_trainer_create(AEON_RESERVOIR_SIZE, AEON_OUTPUT_SIZE, NULL);
+  ill->lambda = 1e-9f;
+  for (int t = 0; t < N_RANK2; t++)
+    aeon_trainer_accumulate(ill, &rank2[t * AEON_RESERVOIR_SIZE],
+                            &rank2_tgt[t]);
+  aeon_birth(&core, 3);
+  int ill_retries = aeon_trainer_finalize(ill, &core);
+  double ill_sum = 0.0;
+  for (int t = 0; t < N_RANK2; t++) {
+    float pred = 0.0f;
+    for (int i = 0; i < AEON_RESERVOIR_SIZE; i++)
+      pred += aeon_weight_to_float(core.W_out[i]) *
+              to_float(rank2[t * AEON_RESERVOIR_SIZE + i]);
+    float d = pred - to_float(rank2_tgt[t]);
+    ill_sum += (double)d * d;
+  }
+  float ill_replay = (float)(ill_sum / N_RANK2);
+  printf("Ill-conditioned fit: %d retries, MSE %f (replay %f)\n",
+         ill_retries, ill->mse, ill_replay);
+  if (ill_retries < 1) {
+    test_failed("Ill-conditioned Fit", "Sunk pivots were not retried");
+  }
+  if (fabsf(ill->mse - ill_replay) > 0.05f * ill_replay + 1e-5f) {
+    test_failed("Ill-conditioned Fit", "Closed-form MSE differs from replay");
+  }
+
+  // Without any ridge no retry can factor
+  memcpy(w_ref, core.W_out, sizeof(w_ref));
+  aeon_trainer_begin(ill, 1.0f, 0);
+  ill->lambda = 0.0f;
+  for (int t = 0; t < N_RANK2; t++)
+    aeon_trainer_accumulate(ill, &rank2[t * AEON_RESERVOIR_SIZE],
+                            &rank2_tgt[t]);
+  core.is_trained = false;
+  if (aeon_trainer_finalize(ill, &core) != -5 || core.is_trained ||
+      memcmp(w_ref, core.W_out, sizeof(w_ref)) != 0) {
+    test_failed("Ill-conditioned Fit", "Unfactored fit touched the core");
+  }
+  aeon_trainer_destroy(ill);
+  free(rank2);
+  free(rank2_tgt);
+  test_passed("Ill-conditioned Fit");
+
   printf("\nAll tests passed successfully.\n");
   return 0;
 }
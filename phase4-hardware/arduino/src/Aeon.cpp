@@ -0,0 +1,176 @@
+/**
+ * Aeon.cpp - Implementación de librería Arduino
+ *
+ * Los bucles son los kernels de libAeon (aeon_kernels.h); src/libAeon
+ * lleva una copia del núcleo que Arduino compila con la librería.
+ *
+ * (c) 2024 SenseLab - Build with Sense
+ */
+
+#include "Aeon.h"
+
+// Factor de escala para punto fijo Q8.8
+#define SCALE AEON_SCALE
+
+Aeon::Aeon(uint8_t reservoirSize) {
+  _size = min(reservoirSize, AEON_MAX_RESERVOIR);
+  _trained = false;
+  _sparse_count = 0;
+  _seed = 0;
+  _gain = aeon_k_fraction(1.0f);
+  _leak = aeon_k_leak(AEON_LEAK_RATE);
+}
+
+aeon_view_t Aeon::_view() {
+  aeon_view_t v;
+  v.n_res = _size;
+  v.n_in = 1;
+  v.n_out = 1;
+  v.sparsity = AEON_SPARSITY;
+  v.state = _state;
+  v.scratch = _scratch;
+  v.W_out = _W_out;
+#ifdef AEON_PROCEDURAL
+  v.W_in = NULL;
+  v.W_reservoir = NULL;
+  v.col_indices = NULL;
+  v.row_ptr = NULL;
+  v.procedural = true;
+#else
+  v.W_in = _W_in;
+  v.W_reservoir = _W_reservoir;
+  v.col_indices = _col_indices;
+  v.row_ptr = _row_ptr;
+  v.procedural = false;
+#endif
+  v.seed = _seed;
+  v.spectral_radius = AEON_SPECTRAL_RADIUS;
+  v.leak = _leak;
+  v.gain = _gain;
+  return v;
+}
+
+void Aeon::begin(uint32_t seed) {
+  // Xorshift no admite semilla 0
+  _seed = (seed == 0) ? (millis() | 1UL) : seed;
+
+  // Limpiar estado
+  reset();
+  for (uint8_t i = 0; i < _size; i++) {
+    _W_out[i] = 0; // Se entrena después
+  }
+
+#ifdef AEON_PROCEDURAL
+  // Solo se guardan la semilla y la ganancia que normaliza el radio:
+  // update() regenera los pesos
+  _sparse_count =
+      (uint16_t)(_size * aeon_k_proc_fan_in(_size, AEON_SPARSITY));
+  aeon_view_t v = _view();
+  _gain = aeon_k_proc_gain(&v);
+#else
+  // Mismo W_in y CSR (normalizado) que aeon_birth(core, seed) en el
+  // servidor
+  uint32_t seen[AEON_GENERATE_WORK_WORDS(AEON_MAX_RESERVOIR)];
+  aeon_view_t v = _view();
+  _sparse_count = (uint16_t)aeon_k_generate(&v, _seed, seen);
+#endif
+
+  _trained = false;
+}
+
+float Aeon::_toFloat(int16_t fixed) { return (float)fixed / SCALE; }
+
+int16_t Aeon::_toFixed(float f) { return (int16_t)(f * SCALE); }
+
+void Aeon::setLeakRate(float rate) { _leak = aeon_k_leak(rate); }
+
+void Aeon::update(float input) {
+  aeon_state_t input_fixed = _toFixed(input);
+  aeon_view_t v = _view();
+  aeon_k_view_step(&v, &input_fixed);
+}
+
+float Aeon::predict() {
+  aeon_state_t out;
+  aeon_k_readout(_size, 1, _W_out, _state, &out);
+  return (float)out / SCALE;
+}
+
+float Aeon::train(float *inputs, float *targets, uint16_t n_samples,
+                  uint8_t washout) {
+  if (n_samples <= washout)
+    return -1.0f;
+
+  // Mismo cálculo que aeon_k_train con las series en Q8.8, por bloques
+  // de AEON_TRAIN_ROWS muestras: S^T*S | S^T*Y | Y^T*Y | bloque | 2 n
+  uint32_t tri = AEON_TRI_SIZE(_size);
+  float *work = (float *)malloc(
+      (tri + _size + 1 + AEON_TRAIN_ROWS * (_size + 1) + 2 * _size) *
+      sizeof(float));
+  if (work == NULL)
+    return -1.0f;
+  float *StS = work;
+  float *StY = StS + tri;
+  float *YtY = StY + _size;
+  float *B = YtY + 1;
+  float *Y = B + AEON_TRAIN_ROWS * _size;
+  float *acc = Y + AEON_TRAIN_ROWS;
+
+  aeon_view_t v = _view();
+  uint16_t train_samples = n_samples - washout;
+  float ridge = AEON_RIDGE_LAMBDA * train_samples;
+  for (int attempt = 0;; attempt++) {
+    reset();
+    aeon_k_ridge_init(StS, StY, YtY, _size, 1, ridge);
+
+    uint8_t k = 0;
+    for (uint16_t t = 0; t < n_samples; t++) {
+      update(inputs[t]);
+      if (t < washout)
+        continue;
+
+      for (uint8_t i = 0; i < _size; i++) {
+        B[k * _size + i] = (float)_state[i] / SCALE;
+      }
+      Y[k] = (float)_toFixed(targets[t]) / SCALE;
+      if (++k == AEON_TRAIN_ROWS || t + 1 == n_samples) {
+        aeon_k_accumulate_block(StS, StY, YtY, B, Y, k, _size, 1, acc, NULL);
+        k = 0;
+      }
+    }
+
+    if (aeon_k_ridge_solve(StS, StY, B, _size, 1, v.W_out) == 0)
+      break;
+    if (attempt == AEON_RIDGE_RETRIES) {
+      free(work);
+      return -1.0f;
+    }
+    ridge *= AEON_RIDGE_GROWTH;
+  }
+
+  float sse = aeon_k_ridge_error(StS, StY, YtY, ridge, _size, 1, v.W_out, B);
+  free(work);
+  if (sse < 0.0f)
+    return -1.0f;
+
+  _trained = true;
+  return sse / train_samples;
+}
+
+void Aeon::reset() {
+  for (uint8_t i = 0; i < _size; i++) {
+    _state[i] = 0;
+  }
+}
+
+uint16_t Aeon::memoryUsage() {
+  // Bytes de los arrays en uso (el objeto reserva AEON_MAX_RESERVOIR)
+  uint16_t bytes = _size * 2 * sizeof(aeon_state_t) + // state, scratch
+                   _size * sizeof(aeon_weight_t);      // W_out
+#ifndef AEON_PROCEDURAL
+  bytes += _size * sizeof(aeon_weight_t) +                       // W_in
+           _sparse_count * (sizeof(aeon_weight_t) + sizeof(uint16_t)) + // CSR
+           (_size + 1) * sizeof(uint32_t);                        // row_ptr
+#endif
+  return bytes;
+}
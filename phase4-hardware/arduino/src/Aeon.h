@@ -0,0 +1,157 @@
+/**
+ * Aeon.h - Librería Arduino para Proyecto Eón
+ *
+ * Echo State Network ultraligero para microcontroladores.
+ * Diseñado para Arduino Nano (2KB RAM) y superiores.
+ *
+ * Uso:
+ *   #include <Aeon.h>
+ *   Aeon esn(16);  // 16 neuronas
+ *   esn.train(inputs, targets, 100);
+ *   float pred = esn.predict(input);
+ *
+ * Memoria: ~500 bytes para 16 neuronas
+ *
+ * Es una envoltura de los kernels de libAeon (phase2-core): mismo
+ * generador, reservoir CSR, tanh y Ridge que el servidor, así que un
+ * modelo con la misma semilla y W_out da los mismos estados bit a bit.
+ *
+ * (c) 2024 SenseLab - Build with Sense
+ * https://github.com/SenseLab-dev
+ */
+
+#ifndef AEON_H
+#define AEON_H
+
+#include <Arduino.h>
+
+#include "libAeon/aeon_kernels.h"
+
+// Configuración por defecto
+//
+// AEON_PROCEDURAL: no guarda W_in ni las conexiones escasas; update()
+// las regenera desde la semilla con un hash de contador. Solo ocupan
+// RAM el estado y W_out (10 bytes por neurona en vez de ~16 + N),
+// a cambio de un hash por conexión en cada paso. Equivale a
+// aeon_core_create_procedural() con la misma semilla.
+#ifndef AEON_MAX_RESERVOIR
+#ifdef AEON_PROCEDURAL
+#define AEON_MAX_RESERVOIR 64 // Máximo de neuronas (procedural)
+#elif defined(__AVR__)
+#define AEON_MAX_RESERVOIR 16 // Máximo de neuronas (2KB de RAM)
+#else
+#define AEON_MAX_RESERVOIR 32 // Máximo de neuronas
+#endif
+#endif
+
+#ifndef AEON_SPARSITY
+#define AEON_SPARSITY 4 // 1 de cada N conexiones
+#endif
+
+// Muestras por bloque al acumular S^T*S en train(): las de aeon_k_train
+// salvo en AVR, donde 64 estados no caben en 2KB
+#ifndef AEON_TRAIN_ROWS
+#ifdef __AVR__
+#define AEON_TRAIN_ROWS 4
+#else
+#define AEON_TRAIN_ROWS AEON_TRAIN_BLOCK
+#endif
+#endif
+
+class Aeon {
+public:
+  /**
+   * Constructor
+   * @param reservoirSize Número de neuronas (default: 16)
+   */
+  Aeon(uint8_t reservoirSize = 16);
+
+  /**
+   * Inicializa el reservoir con una semilla
+   * @param seed Semilla para RNG (0 = usar millis())
+   */
+  void begin(uint32_t seed = 0);
+
+  /**
+   * Actualiza el estado con una entrada
+   * @param input Valor de entrada [-1, 1]
+   */
+  void update(float input);
+
+  /**
+   * Tasa de fuga de update(): state += rate * (tanh(...) - state)
+   * @param rate Fracción en (0, 1] (1 = sin fuga, en pasos de 1/256)
+   */
+  void setLeakRate(float rate);
+
+  /**
+   * Obtiene predicción basada en estado actual
+   * @return Valor predicho
+   */
+  float predict();
+
+  /**
+   * Entrena con datos
+   * @param inputs Array de entradas
+   * @param targets Array de objetivos
+   * @param n_samples Número de muestras
+   * @param washout Muestras a descartar (default: 20)
+   * @return MSE del entrenamiento, o -1 si falla (sin memoria, sin
+   *         muestras o S^T*S no se factoriza: W_out queda como estaba)
+   */
+  float train(float *inputs, float *targets, uint16_t n_samples,
+              uint8_t washout = 20);
+
+  /**
+   * Resetea el estado del reservoir
+   */
+  void reset();
+
+  /**
+   * Obtiene uso de memoria en bytes
+   */
+  uint16_t memoryUsage();
+
+  /**
+   * Obtiene el estado de entrenamiento
+   */
+  bool isTrained() { return _trained; }
+
+  /**
+   * Semilla del reservoir (la de aeon_birth en el servidor)
+   */
+  uint32_t seed() { return _seed; }
+
+protected:
+  uint8_t _size; // Tamaño del reservoir
+  bool _trained; // Estado de entrenamiento
+  uint32_t _seed;
+  aeon_state_t _gain; // Escala del reservoir procedural
+  aeon_state_t _leak; // Fuga de update() en Q8.8
+
+  // Estado (punto fijo Q8.8 en 32 bits, como aeon_state_t)
+  aeon_state_t _state[AEON_MAX_RESERVOIR];
+  aeon_state_t _scratch[AEON_MAX_RESERVOIR];
+
+  // Pesos Q8.8
+  aeon_weight_t _W_out[AEON_MAX_RESERVOIR];
+
+#ifndef AEON_PROCEDURAL
+  aeon_weight_t _W_in[AEON_MAX_RESERVOIR];
+
+  // Reservoir escaso en CSR (mismo formato que aeon_core_t)
+  aeon_weight_t
+      _W_reservoir[AEON_MAX_RESERVOIR * AEON_MAX_RESERVOIR / AEON_SPARSITY];
+  uint16_t
+      _col_indices[AEON_MAX_RESERVOIR * AEON_MAX_RESERVOIR / AEON_SPARSITY];
+  uint32_t _row_ptr[AEON_MAX_RESERVOIR + 1];
+#endif
+  uint16_t _sparse_count;
+
+  // Funciones internas
+  aeon_view_t _view();
+  float _toFloat(int16_t fixed);
+  int16_t _toFixed(float f);
+};
+
+#endif // AEON_H
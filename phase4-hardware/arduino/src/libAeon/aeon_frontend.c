@@ -0,0 +1,186 @@
+/**
+ * @file aeon_frontend.c
+ * @brief Proyecto Eón - Banco de filtros Goertzel en punto fijo
+ *
+ * Por cada bin, Goertzel recorre la trama con
+ *
+ *   s[i] = x[i] + 2 cos(w) s[i - 1] - s[i - 2]
+ *
+ * y la potencia del bin es s1² + s2² - 2 cos(w) s1 s2. La ventana se
+ * aplica al leer el ring buffer, sin copia de la trama. Con muestras
+ * int16, |s| <= sum|x| / sin(w): begin rechaza los bins en los que esa
+ * cota no cabe en 32 bits (con tramas de 512, centros por debajo de
+ * sample_rate / 1600 o igual de cerca de Nyquist). La potencia se
+ * calcula en 64 bits. El
+ * log2 usa la posición del bit más alto y una corrección cuadrática de
+ * la mantisa (error < 0.01).
+ */
+
+#include "libAeon.h"
+#include <math.h>
+#include <string.h>
+
+#define COEFF_BITS 14
+#define WINDOW_BITS 15
+#define FULL_SCALE 32767.0f
+#define TWO_PI 6.28318530718f
+
+static float hz_to_mel(float f) { return 2595.0f * log10f(1.0f + f / 700.0f); }
+
+static float mel_to_hz(float m) {
+  return 700.0f * (powf(10.0f, m / 2595.0f) - 1.0f);
+}
+
+int aeon_frontend_begin(aeon_frontend_t *fe,
+                        const aeon_frontend_config_t *config) {
+  if (fe == NULL || config == NULL)
+    return -1;
+  const aeon_frontend_config_t *c = config;
+  if (c->n_bands == 0 || c->n_bands > AEON_FRONTEND_MAX_BANDS ||
+      c->frame_len < 8 || c->frame_len > AEON_FRONTEND_MAX_FRAME ||
+      c->hop_len == 0 || c->hop_len > c->frame_len || c->range_db == 0 ||
+      c->f_low == 0 || c->f_low >= c->f_high ||
+      2u * c->f_high >= c->sample_rate)
+    return -2;
+
+  memset(fe, 0, sizeof(*fe));
+  fe->config = *c;
+
+  /* Hann simétrica: solo la primera mitad */
+  const int n = c->frame_len;
+  float window_sum = 0.0f;
+  for (int i = 0; i < n; i++) {
+    float w = 0.5f - 0.5f * cosf(TWO_PI * (float)i / (float)(n - 1));
+    int16_t q = (int16_t)lrintf(w * 32767.0f);
+    if (i < (n + 1) / 2)
+      fe->window[i] = q;
+    window_sum += (float)q / (1 << WINDOW_BITS);
+  }
+
+  /* Un tono de amplitud A en el bin da |X| = A * sum(w) / 2 */
+  float full = FULL_SCALE * window_sum / 2.0f;
+
+  /* Bordes equiespaciados en mel; bins cada dos bins de FFT (el lóbulo
+   * principal de Hann mide cuatro) o más separados si no caben */
+  float spacing = 2.0f * (float)c->sample_rate / (float)c->frame_len;
+  float span = (float)(c->f_high - c->f_low) / AEON_FRONTEND_MAX_BINS;
+  if (spacing < span)
+    spacing = span;
+  float mel_lo = hz_to_mel(c->f_low);
+  float mel_step = (hz_to_mel(c->f_high) - mel_lo) / (float)c->n_bands;
+  int bins = 0;
+  for (int b = 0; b < c->n_bands; b++) {
+    float lo = mel_to_hz(mel_lo + (float)b * mel_step);
+    float hi = mel_to_hz(mel_lo + (float)(b + 1) * mel_step);
+    int m = (int)lrintf((hi - lo) / spacing);
+    if (m < 1)
+      m = 1;
+    if (bins + m > AEON_FRONTEND_MAX_BINS - (c->n_bands - 1 - b))
+      m = AEON_FRONTEND_MAX_BINS - (c->n_bands - 1 - b) - bins;
+    if (m < 1)
+      return -2;
+    for (int j = 0; j < m; j++) {
+      float f = lo + ((float)j + 0.5f) * (hi - lo) / (float)m;
+      float w = TWO_PI * f / (float)c->sample_rate;
+      if (2.0f * full / sinf(w) >= 2147483647.0f)
+        return -2; /* s desbordaría int32 a fondo de escala */
+      fe->coeff[bins++] = (int16_t)lrintf(2.0f * cosf(w) * (1 << COEFF_BITS));
+    }
+    fe->band_end[b] = (uint8_t)bins;
+  }
+
+  fe->log_full = (int32_t)lrintf(2.0f * log2f(full) * 256.0f);
+  fe->log_range = (int32_t)lrintf((float)c->range_db / 3.0103f * 256.0f);
+  return 0;
+}
+
+/** log2(p) en Q8.8, p > 0 */
+static int32_t log2_q8(uint64_t p) {
+  int e = 63;
+#if defined(__GNUC__)
+  e -= __builtin_clzll(p);
+#else
+  while (!(p >> e))
+    e--;
+#endif
+  /* Mantisa f en [0, 1) con 8 bits: log2(1 + f) ~ f + 0.346 f (1 - f) */
+  int32_t f = e >= 8 ? (int32_t)(p >> (e - 8)) & 0xFF
+                     : (int32_t)(p << (8 - e)) & 0xFF;
+  f += (f * (256 - f) * 89) >> 16;
+  return (e << 8) + f;
+}
+
+/** Goertzel de un bin sobre la trama enventanada, desde head */
+static void goertzel(const aeon_frontend_t *fe, int32_t coeff, int32_t *s1,
+                     int32_t *s2) {
+  const int n = fe->config.frame_len;
+  const int half = (n + 1) / 2;
+  int32_t a = 0, b = 0;
+
+  for (int i = 0, r = fe->head; i < n; i++) {
+    int32_t w = fe->window[i < half ? i : n - 1 - i];
+    int32_t x = ((int32_t)fe->ring[r] * w) >> WINDOW_BITS;
+    int32_t s = (int32_t)(x + (((int64_t)coeff * a) >> COEFF_BITS) - b);
+    b = a;
+    a = s;
+    if (++r == n)
+      r = 0;
+  }
+  *s1 = a;
+  *s2 = b;
+}
+
+/** Trama completa del ring buffer a n_bands salidas */
+static void frontend_frame(aeon_frontend_t *fe, aeon_state_t *out) {
+  const int32_t floor = fe->log_full - fe->log_range;
+  for (int b = 0, k = 0; b < fe->config.n_bands; b++) {
+    int64_t p = 0;
+    for (; k < fe->band_end[b]; k++) {
+      int32_t s1, s2;
+      goertzel(fe, fe->coeff[k], &s1, &s2);
+      int64_t cross = ((int64_t)fe->coeff[k] * s1) >> COEFF_BITS;
+      p += (int64_t)s1 * s1 + (int64_t)s2 * s2 - cross * s2;
+    }
+
+    int32_t v = 0;
+    if (p > 0) {
+      int64_t rel = (int64_t)(log2_q8((uint64_t)p) - floor) * 256;
+      v = rel <= 0 ? 0 : (int32_t)(rel / fe->log_range);
+      if (v > 256)
+        v = 256;
+    }
+#if AEON_USE_FIXED_POINT
+    out[b] = v;
+#else
+    out[b] = (float)v / 256.0f;
+#endif
+  }
+  fe->frames++;
+}
+
+int aeon_frontend_push(aeon_frontend_t *fe, const int16_t *pcm, uint32_t n,
+                       aeon_state_t *out) {
+  if (fe == NULL || pcm == NULL || out == NULL)
+    return -1;
+
+  const uint16_t frame_len = fe->config.frame_len;
+  int produced = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    fe->ring[fe->head] = pcm[i];
+    if (++fe->head == frame_len)
+      fe->head = 0;
+    fe->since_hop++;
+
+    /* Primera trama al llenarse; después, una por hop */
+    if (fe->filled < frame_len) {
+      if (++fe->filled < frame_len)
+        continue;
+    } else if (fe->since_hop < fe->config.hop_len) {
+      continue;
+    }
+    frontend_frame(fe, &out[produced * fe->config.n_bands]);
+    fe->since_hop = 0;
+    produced++;
+  }
+  return produced;
+}
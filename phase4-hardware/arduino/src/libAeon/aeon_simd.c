@@ -0,0 +1,633 @@
+/**
+ * @file aeon_simd.c
+ * @brief Proyecto Eón - Kernels SIMD/DSP/FMA del camino caliente
+ *
+ * Backends Q8.8 para los productos densos (W_in, W_out) y la tanh
+ * saturada:
+ *   - scalar : referencia portable
+ *   - sse4.1 : _mm_madd_epi16 / _mm_mullo_epi32      (x86, runtime)
+ *   - avx2   : _mm256_madd_epi16 / _mm256_mullo_epi32 (x86, runtime)
+ *   - neon   : vmlal_s16 / vmlaq_s32                  (ARM, compilación)
+ *   - dsp    : SMLAD de Cortex-M4/M7                  (ARM, compilación)
+ *
+ * Todos los backends Q8.8 son aritmética entera exacta y producen
+ * resultados bit a bit idénticos al escalar.
+ *
+ * En la build float los backends cubren W_in y las filas CSR del
+ * reservoir, y ensanchan en registro los pesos f16/bf16:
+ *   - scalar   : referencia portable
+ *   - avx2-fma : _mm256_fmadd_ps, gather y F16C  (x86, runtime)
+ *   - neon-fma : vfmaq_f32 (vmlaq_f32 sin FMA)   (ARM, compilación)
+ * FMA redondea una vez por producto y las sumas van en otro orden: los
+ * resultados coinciden con el escalar a unos ULP, no bit a bit. W_out
+ * sigue en orden secuencial para que la lectura escasa de aeon_prune
+ * dé el mismo resultado que la densa.
+ */
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <string.h>
+
+#if AEON_USE_SIMD && defined(__GNUC__) &&                                      \
+    (defined(__x86_64__) || defined(__i386__))
+#define AEON_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if AEON_USE_SIMD && defined(__ARM_NEON)
+#define AEON_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if AEON_USE_SIMD && AEON_USE_FIXED_POINT && !defined(__ARM_NEON) &&          \
+    defined(__ARM_FEATURE_DSP)
+#define AEON_SIMD_DSP 1
+#include <arm_acle.h>
+#endif
+
+#if AEON_USE_FIXED_POINT
+
+/* Los backends vectorizan la activación "poly"; con otra activación
+ * la tanh pasa al bucle escalar (una rama por llamada). */
+#define TANH_VECTOR (AEON_K_TANH_MODE == AEON_TANH_POLY)
+
+/* ============================================================
+ * ESCALAR (REFERENCIA)
+ * ============================================================ */
+
+static int32_t dot_scalar(const int16_t *w, const int32_t *x, uint32_t n) {
+  int32_t sum = 0;
+  for (uint32_t k = 0; k < n; k++) {
+    sum += (int32_t)w[k] * x[k];
+  }
+  return sum;
+}
+
+static void input_mac_scalar(const int16_t *W_in, const int32_t *input,
+                             uint16_t n_res, uint16_t n_in, int32_t *acc) {
+  for (int i = 0; i < n_res; i++) {
+    int32_t sum = 0;
+    for (int j = 0; j < n_in; j++) {
+      sum += (int32_t)W_in[i * n_in + j] * input[j];
+    }
+    acc[i] = sum;
+  }
+}
+
+static void tanh_scalar(const int32_t *in, int32_t *out, uint32_t n) {
+  /* Loop unrolling: 4 operaciones por iteración para mejor ILP */
+  uint32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    out[i]     = aeon_k_tanh(in[i]);
+    out[i + 1] = aeon_k_tanh(in[i + 1]);
+    out[i + 2] = aeon_k_tanh(in[i + 2]);
+    out[i + 3] = aeon_k_tanh(in[i + 3]);
+  }
+  /* Residuo para tamaños no múltiplos de 4 */
+  for (; i < n; i++) {
+    out[i] = aeon_k_tanh(in[i]);
+  }
+}
+
+static const aeon_simd_ops_t ops_scalar = {"scalar", dot_scalar,
+                                           input_mac_scalar, tanh_scalar};
+
+/* ============================================================
+ * x86: SSE4.1 / AVX2 (selección en tiempo de ejecución)
+ * ============================================================ */
+
+#ifdef AEON_SIMD_X86
+
+__attribute__((target("sse4.1"))) static int32_t
+dot_sse41(const int16_t *w, const int32_t *x, uint32_t n) {
+  __m128i acc = _mm_setzero_si128();
+  uint32_t k = 0;
+  for (; k + 8 <= n; k += 8) {
+    __m128i wv = _mm_loadu_si128((const __m128i *)(const void *)(w + k));
+    __m128i x0 = _mm_loadu_si128((const __m128i *)(const void *)(x + k));
+    __m128i x1 = _mm_loadu_si128((const __m128i *)(const void *)(x + k + 4));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(wv, _mm_packs_epi32(x0, x1)));
+  }
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4E));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xB1));
+  int32_t sum = _mm_cvtsi128_si32(acc);
+  for (; k < n; k++) {
+    sum += (int32_t)w[k] * x[k];
+  }
+  return sum;
+}
+
+__attribute__((target("sse4.1"))) static void
+input_mac_sse41(const int16_t *W_in, const int32_t *input, uint16_t n_res,
+                uint16_t n_in, int32_t *acc) {
+  if (n_in != 1) {
+    input_mac_scalar(W_in, input, n_res, n_in, acc);
+    return;
+  }
+  __m128i in = _mm_set1_epi32(input[0]);
+  int i = 0;
+  for (; i + 4 <= n_res; i += 4) {
+    __m128i w = _mm_cvtepi16_epi32(
+        _mm_loadl_epi64((const __m128i *)(const void *)(W_in + i)));
+    _mm_storeu_si128((__m128i *)(void *)(acc + i), _mm_mullo_epi32(w, in));
+  }
+  for (; i < n_res; i++) {
+    acc[i] = (int32_t)W_in[i] * input[0];
+  }
+}
+
+__attribute__((target("sse4.1"))) static __m128i tanh_sse41_vec(__m128i x) {
+  const __m128i one = _mm_set1_epi32(AEON_SCALE);
+  const __m128i neg_one = _mm_set1_epi32(-AEON_SCALE);
+  __m128i c = _mm_min_epi32(_mm_max_epi32(x, neg_one), one);
+  __m128i x2 = _mm_srai_epi32(_mm_mullo_epi32(c, c), AEON_SCALE_BITS);
+  __m128i x3 = _mm_srai_epi32(_mm_mullo_epi32(x2, c), AEON_SCALE_BITS);
+  __m128i x5 = _mm_srai_epi32(_mm_mullo_epi32(x3, x2), AEON_SCALE_BITS);
+  /* División truncada hacia cero: sobre |v| y restaurando el signo */
+  const __m128i m3 = _mm_set1_epi32(AEON_TANH_DIV3_MAGIC);
+  const __m128i m15 = _mm_set1_epi32(AEON_TANH_DIV15_MAGIC);
+  __m128i d3 = _mm_srli_epi32(_mm_mullo_epi32(_mm_abs_epi32(x3), m3), 16);
+  __m128i d15 = _mm_srli_epi32(_mm_mullo_epi32(_mm_abs_epi32(x5), m15), 16);
+  d3 = _mm_sign_epi32(d3, x3);
+  d15 = _mm_sign_epi32(d15, x5);
+  __m128i r = _mm_add_epi32(_mm_sub_epi32(c, d3), d15);
+  /* Saturación: fuera de [-1, 1] el escalar devuelve ±1 exacto */
+  r = _mm_blendv_epi8(r, one, _mm_cmpgt_epi32(x, one));
+  r = _mm_blendv_epi8(r, neg_one, _mm_cmplt_epi32(x, neg_one));
+  return r;
+}
+
+__attribute__((target("sse4.1"))) static void
+tanh_sse41(const int32_t *in, int32_t *out, uint32_t n) {
+  if (!TANH_VECTOR) {
+    tanh_scalar(in, out, n);
+    return;
+  }
+  uint32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i x = _mm_loadu_si128((const __m128i *)(const void *)(in + i));
+    _mm_storeu_si128((__m128i *)(void *)(out + i), tanh_sse41_vec(x));
+  }
+  for (; i < n; i++) {
+    out[i] = aeon_k_tanh(in[i]);
+  }
+}
+
+static const aeon_simd_ops_t ops_sse41 = {"sse4.1", dot_sse41,
+                                          input_mac_sse41, tanh_sse41};
+
+__attribute__((target("avx2"))) static int32_t
+dot_avx2(const int16_t *w, const int32_t *x, uint32_t n) {
+  __m256i acc = _mm256_setzero_si256();
+  uint32_t k = 0;
+  for (; k + 16 <= n; k += 16) {
+    __m256i wv = _mm256_loadu_si256((const __m256i *)(const void *)(w + k));
+    __m256i x0 = _mm256_loadu_si256((const __m256i *)(const void *)(x + k));
+    __m256i x1 =
+        _mm256_loadu_si256((const __m256i *)(const void *)(x + k + 8));
+    /* packs opera por carriles de 128 bits: reordenar a x[k..k+15] */
+    __m256i xp = _mm256_permute4x64_epi64(_mm256_packs_epi32(x0, x1), 0xD8);
+    acc = _mm256_add_epi32(acc, _mm256_madd_epi16(wv, xp));
+  }
+  __m128i acc4 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                               _mm256_extracti128_si256(acc, 1));
+  acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, 0x4E));
+  acc4 = _mm_add_epi32(acc4, _mm_shuffle_epi32(acc4, 0xB1));
+  int32_t sum = _mm_cvtsi128_si32(acc4);
+  for (; k < n; k++) {
+    sum += (int32_t)w[k] * x[k];
+  }
+  return sum;
+}
+
+__attribute__((target("avx2"))) static void
+input_mac_avx2(const int16_t *W_in, const int32_t *input, uint16_t n_res,
+               uint16_t n_in, int32_t *acc) {
+  if (n_in != 1) {
+    input_mac_scalar(W_in, input, n_res, n_in, acc);
+    return;
+  }
+  __m256i in = _mm256_set1_epi32(input[0]);
+  int i = 0;
+  for (; i + 8 <= n_res; i += 8) {
+    __m256i w = _mm256_cvtepi16_epi32(
+        _mm_loadu_si128((const __m128i *)(const void *)(W_in + i)));
+    _mm256_storeu_si256((__m256i *)(void *)(acc + i),
+                        _mm256_mullo_epi32(w, in));
+  }
+  for (; i < n_res; i++) {
+    acc[i] = (int32_t)W_in[i] * input[0];
+  }
+}
+
+__attribute__((target("avx2"))) static void
+tanh_avx2(const int32_t *in, int32_t *out, uint32_t n) {
+  if (!TANH_VECTOR) {
+    tanh_scalar(in, out, n);
+    return;
+  }
+  const __m256i one = _mm256_set1_epi32(AEON_SCALE);
+  const __m256i neg_one = _mm256_set1_epi32(-AEON_SCALE);
+  const __m256i m3 = _mm256_set1_epi32(AEON_TANH_DIV3_MAGIC);
+  const __m256i m15 = _mm256_set1_epi32(AEON_TANH_DIV15_MAGIC);
+  uint32_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i x = _mm256_loadu_si256((const __m256i *)(const void *)(in + i));
+    __m256i c = _mm256_min_epi32(_mm256_max_epi32(x, neg_one), one);
+    __m256i x2 = _mm256_srai_epi32(_mm256_mullo_epi32(c, c), AEON_SCALE_BITS);
+    __m256i x3 =
+        _mm256_srai_epi32(_mm256_mullo_epi32(x2, c), AEON_SCALE_BITS);
+    __m256i x5 =
+        _mm256_srai_epi32(_mm256_mullo_epi32(x3, x2), AEON_SCALE_BITS);
+    __m256i d3 =
+        _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_abs_epi32(x3), m3), 16);
+    __m256i d15 =
+        _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_abs_epi32(x5), m15), 16);
+    d3 = _mm256_sign_epi32(d3, x3);
+    d15 = _mm256_sign_epi32(d15, x5);
+    __m256i r = _mm256_add_epi32(_mm256_sub_epi32(c, d3), d15);
+    r = _mm256_blendv_epi8(r, one, _mm256_cmpgt_epi32(x, one));
+    r = _mm256_blendv_epi8(r, neg_one, _mm256_cmpgt_epi32(neg_one, x));
+    _mm256_storeu_si256((__m256i *)(void *)(out + i), r);
+  }
+  for (; i < n; i++) {
+    out[i] = aeon_k_tanh(in[i]);
+  }
+}
+
+static const aeon_simd_ops_t ops_avx2 = {"avx2", dot_avx2, input_mac_avx2,
+                                         tanh_avx2};
+
+#endif /* AEON_SIMD_X86 */
+
+/* ============================================================
+ * ARM NEON (selección en compilación)
+ * ============================================================ */
+
+#ifdef AEON_SIMD_NEON
+
+static int32_t dot_neon(const int16_t *w, const int32_t *x, uint32_t n) {
+  int32x4_t acc = vdupq_n_s32(0);
+  uint32_t k = 0;
+  for (; k + 4 <= n; k += 4) {
+    /* x cabe en int16 (estado Q8.8 acotado por la tanh) */
+    acc = vmlal_s16(acc, vld1_s16(w + k), vmovn_s32(vld1q_s32(x + k)));
+  }
+  int32x2_t half = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+  int32_t sum = vget_lane_s32(vpadd_s32(half, half), 0);
+  for (; k < n; k++) {
+    sum += (int32_t)w[k] * x[k];
+  }
+  return sum;
+}
+
+static void input_mac_neon(const int16_t *W_in, const int32_t *input,
+                           uint16_t n_res, uint16_t n_in, int32_t *acc) {
+  if (n_in != 1) {
+    input_mac_scalar(W_in, input, n_res, n_in, acc);
+    return;
+  }
+  int32x4_t in = vdupq_n_s32(input[0]);
+  int i = 0;
+  for (; i + 4 <= n_res; i += 4) {
+    vst1q_s32(acc + i, vmulq_s32(vmovl_s16(vld1_s16(W_in + i)), in));
+  }
+  for (; i < n_res; i++) {
+    acc[i] = (int32_t)W_in[i] * input[0];
+  }
+}
+
+static void tanh_neon(const int32_t *in, int32_t *out, uint32_t n) {
+  if (!TANH_VECTOR) {
+    tanh_scalar(in, out, n);
+    return;
+  }
+  const int32x4_t one = vdupq_n_s32(AEON_SCALE);
+  const int32x4_t neg_one = vdupq_n_s32(-AEON_SCALE);
+  const int32x4_t m3 = vdupq_n_s32(AEON_TANH_DIV3_MAGIC);
+  const int32x4_t m15 = vdupq_n_s32(AEON_TANH_DIV15_MAGIC);
+  const int32x4_t zero = vdupq_n_s32(0);
+  uint32_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    int32x4_t x = vld1q_s32(in + i);
+    int32x4_t c = vminq_s32(vmaxq_s32(x, neg_one), one);
+    int32x4_t x2 = vshrq_n_s32(vmulq_s32(c, c), AEON_SCALE_BITS);
+    int32x4_t x3 = vshrq_n_s32(vmulq_s32(x2, c), AEON_SCALE_BITS);
+    int32x4_t x5 = vshrq_n_s32(vmulq_s32(x3, x2), AEON_SCALE_BITS);
+    int32x4_t d3 = vshrq_n_s32(vmulq_s32(vabsq_s32(x3), m3), 16);
+    int32x4_t d15 = vshrq_n_s32(vmulq_s32(vabsq_s32(x5), m15), 16);
+    d3 = vbslq_s32(vcltq_s32(x3, zero), vnegq_s32(d3), d3);
+    d15 = vbslq_s32(vcltq_s32(x5, zero), vnegq_s32(d15), d15);
+    int32x4_t r = vaddq_s32(vsubq_s32(c, d3), d15);
+    r = vbslq_s32(vcgtq_s32(x, one), one, r);
+    r = vbslq_s32(vcltq_s32(x, neg_one), neg_one, r);
+    vst1q_s32(out + i, r);
+  }
+  for (; i < n; i++) {
+    out[i] = aeon_k_tanh(in[i]);
+  }
+}
+
+static const aeon_simd_ops_t ops_neon = {"neon", dot_neon, input_mac_neon,
+                                         tanh_neon};
+
+#endif /* AEON_SIMD_NEON */
+
+/* ============================================================
+ * CORTEX-M DSP: SMLAD (selección en compilación)
+ * ============================================================ */
+
+#ifdef AEON_SIMD_DSP
+
+static int32_t dot_dsp(const int16_t *w, const int32_t *x, uint32_t n) {
+  int32_t sum = 0;
+  uint32_t k = 0;
+  for (; k + 2 <= n; k += 2) {
+    int32_t wp;
+    memcpy(&wp, w + k, sizeof(wp)); /* w[k] | w[k+1] << 16 */
+    int32_t xp = (int32_t)(((uint32_t)x[k] & 0xFFFFu) |
+                           ((uint32_t)x[k + 1] << 16));
+    sum = __smlad(wp, xp, sum); /* sum += w0*x0 + w1*x1 */
+  }
+  for (; k < n; k++) {
+    sum += (int32_t)w[k] * x[k];
+  }
+  return sum;
+}
+
+static const aeon_simd_ops_t ops_dsp = {"dsp", dot_dsp, input_mac_scalar,
+                                        tanh_scalar};
+
+#endif /* AEON_SIMD_DSP */
+
+#else /* !AEON_USE_FIXED_POINT */
+
+/* ============================================================
+ * ESCALAR FLOAT (REFERENCIA)
+ * ============================================================ */
+
+static void input_mac_scalar(const aeon_weight_t *W_in, const float *input,
+                             uint16_t n_res, uint16_t n_in, float *acc) {
+  for (int i = 0; i < n_res; i++) {
+    float sum = 0.0f;
+    for (int j = 0; j < n_in; j++) {
+      sum += aeon_weight_to_float(W_in[i * n_in + j]) * input[j];
+    }
+    acc[i] = sum;
+  }
+}
+
+static void csr_mac_scalar(const uint32_t *row_ptr, const uint16_t *col,
+                           const aeon_weight_t *w, const float *x,
+                           uint16_t n_rows, float *acc) {
+  for (int i = 0; i < n_rows; i++) {
+    float sum = acc[i];
+    uint32_t row_end = row_ptr[i + 1];
+    for (uint32_t k = row_ptr[i]; k < row_end; k++) {
+      sum += aeon_weight_to_float(w[k]) * x[col[k]];
+    }
+    acc[i] = sum;
+  }
+}
+
+static const aeon_simd_ops_t ops_scalar = {"scalar", input_mac_scalar,
+                                           csr_mac_scalar};
+
+/* ============================================================
+ * x86: AVX2 + FMA (selección en tiempo de ejecución)
+ * ============================================================ */
+
+#ifdef AEON_SIMD_X86
+
+#if AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F16
+#define FMA_TARGET "avx2,fma,f16c"
+#else
+#define FMA_TARGET "avx2,fma"
+#endif
+
+/** 8 pesos ensanchados a float */
+__attribute__((target(FMA_TARGET))) static inline __m256
+load8_fma(const aeon_weight_t *w) {
+#if AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F16
+  return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(const void *)w));
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_BF16
+  __m256i b = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128((const __m128i *)(const void *)w));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(b, 16));
+#else
+  return _mm256_loadu_ps(w);
+#endif
+}
+
+__attribute__((target(FMA_TARGET))) static inline float hsum_fma(__m256 v) {
+  __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+__attribute__((target(FMA_TARGET))) static void
+input_mac_fma(const aeon_weight_t *W_in, const float *input, uint16_t n_res,
+              uint16_t n_in, float *acc) {
+  if (n_in != 1) {
+    input_mac_scalar(W_in, input, n_res, n_in, acc);
+    return;
+  }
+  __m256 in = _mm256_set1_ps(input[0]);
+  int i = 0;
+  for (; i + 8 <= n_res; i += 8) {
+    _mm256_storeu_ps(acc + i, _mm256_mul_ps(load8_fma(W_in + i), in));
+  }
+  for (; i < n_res; i++) {
+    acc[i] = aeon_weight_to_float(W_in[i]) * input[0];
+  }
+}
+
+__attribute__((target(FMA_TARGET))) static void
+csr_mac_fma(const uint32_t *row_ptr, const uint16_t *col,
+            const aeon_weight_t *w, const float *x, uint16_t n_rows,
+            float *acc) {
+  for (int i = 0; i < n_rows; i++) {
+    uint32_t k = row_ptr[i], row_end = row_ptr[i + 1];
+    float sum = acc[i];
+    if (row_end - k >= 8) {
+      __m256 a = _mm256_setzero_ps();
+      for (; k + 8 <= row_end; k += 8) {
+        __m256i idx = _mm256_cvtepu16_epi32(
+            _mm_loadu_si128((const __m128i *)(const void *)(col + k)));
+        a = _mm256_fmadd_ps(load8_fma(w + k), _mm256_i32gather_ps(x, idx, 4),
+                            a);
+      }
+      sum += hsum_fma(a);
+    }
+    for (; k < row_end; k++) {
+      sum += aeon_weight_to_float(w[k]) * x[col[k]];
+    }
+    acc[i] = sum;
+  }
+}
+
+static const aeon_simd_ops_t ops_fma = {"avx2-fma", input_mac_fma,
+                                        csr_mac_fma};
+
+#endif /* AEON_SIMD_X86 */
+
+/* ============================================================
+ * ARM NEON FLOAT (selección en compilación)
+ * ============================================================ */
+
+#ifdef AEON_SIMD_NEON
+
+#if defined(__ARM_FEATURE_FMA)
+#define NEON_MLA(acc, a, b) vfmaq_f32(acc, a, b)
+#else
+#define NEON_MLA(acc, a, b) vmlaq_f32(acc, a, b)
+#endif
+
+/** 4 pesos ensanchados a float */
+static inline float32x4_t load4_neon(const aeon_weight_t *w) {
+#if AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F16 &&                                  \
+    (defined(__aarch64__) || (defined(__ARM_FP) && (__ARM_FP & 2)))
+  return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(&w->bits)));
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_BF16
+  return vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(&w->bits), 16));
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F16
+  float t[4] = {aeon_weight_to_float(w[0]), aeon_weight_to_float(w[1]),
+                aeon_weight_to_float(w[2]), aeon_weight_to_float(w[3])};
+  return vld1q_f32(t);
+#else
+  return vld1q_f32(w);
+#endif
+}
+
+static inline float hsum_neon(float32x4_t v) {
+#if defined(__aarch64__)
+  return vaddvq_f32(v);
+#else
+  float32x2_t half = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpadd_f32(half, half), 0);
+#endif
+}
+
+static void input_mac_neon(const aeon_weight_t *W_in, const float *input,
+                           uint16_t n_res, uint16_t n_in, float *acc) {
+  if (n_in != 1) {
+    input_mac_scalar(W_in, input, n_res, n_in, acc);
+    return;
+  }
+  int i = 0;
+  for (; i + 4 <= n_res; i += 4) {
+    vst1q_f32(acc + i, vmulq_n_f32(load4_neon(W_in + i), input[0]));
+  }
+  for (; i < n_res; i++) {
+    acc[i] = aeon_weight_to_float(W_in[i]) * input[0];
+  }
+}
+
+static void csr_mac_neon(const uint32_t *row_ptr, const uint16_t *col,
+                         const aeon_weight_t *w, const float *x,
+                         uint16_t n_rows, float *acc) {
+  for (int i = 0; i < n_rows; i++) {
+    uint32_t k = row_ptr[i], row_end = row_ptr[i + 1];
+    float sum = acc[i];
+    if (row_end - k >= 4) {
+      float32x4_t a = vdupq_n_f32(0.0f);
+      for (; k + 4 <= row_end; k += 4) {
+        /* Sin gather: las cuatro columnas se cargan por carril */
+        float32x4_t xv = vdupq_n_f32(x[col[k]]);
+        xv = vsetq_lane_f32(x[col[k + 1]], xv, 1);
+        xv = vsetq_lane_f32(x[col[k + 2]], xv, 2);
+        xv = vsetq_lane_f32(x[col[k + 3]], xv, 3);
+        a = NEON_MLA(a, load4_neon(w + k), xv);
+      }
+      sum += hsum_neon(a);
+    }
+    for (; k < row_end; k++) {
+      sum += aeon_weight_to_float(w[k]) * x[col[k]];
+    }
+    acc[i] = sum;
+  }
+}
+
+static const aeon_simd_ops_t ops_neon = {"neon-fma", input_mac_neon,
+                                         csr_mac_neon};
+
+#endif /* AEON_SIMD_NEON */
+
+#endif /* AEON_USE_FIXED_POINT */
+
+/* ============================================================
+ * DESPACHO
+ * ============================================================ */
+
+/** Backends compilados, del preferido al escalar */
+static const aeon_simd_ops_t *const candidates[] = {
+#if AEON_USE_FIXED_POINT
+#if defined(AEON_SIMD_X86)
+    &ops_avx2, &ops_sse41,
+#endif
+#if defined(AEON_SIMD_DSP)
+    &ops_dsp,
+#endif
+#elif defined(AEON_SIMD_X86)
+    &ops_fma,
+#endif
+#if defined(AEON_SIMD_NEON)
+    &ops_neon,
+#endif
+    &ops_scalar};
+
+#define N_CANDIDATES (sizeof(candidates) / sizeof(candidates[0]))
+
+/** Si la CPU tiene las extensiones del backend */
+static bool supported(const aeon_simd_ops_t *ops) {
+#if defined(AEON_SIMD_X86)
+  __builtin_cpu_init();
+#if AEON_USE_FIXED_POINT
+  if (ops == &ops_avx2)
+    return __builtin_cpu_supports("avx2");
+  if (ops == &ops_sse41)
+    return __builtin_cpu_supports("sse4.1");
+#else
+  /* Todas las CPU con AVX2 y FMA tienen F16C (Haswell, Zen) */
+  if (ops == &ops_fma)
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#endif
+  (void)ops;
+  return true;
+}
+
+static const aeon_simd_ops_t *best_ops(void) {
+  for (size_t i = 0; i < N_CANDIDATES; i++) {
+    if (supported(candidates[i]))
+      return candidates[i];
+  }
+  return &ops_scalar;
+}
+
+/* Resolución perezosa: todas las escrituras concurrentes guardan el
+ * mismo puntero, así que no se necesita sincronización. */
+static const aeon_simd_ops_t *active_ops = NULL;
+
+const aeon_simd_ops_t *aeon_k_ops(void) {
+  if (active_ops == NULL)
+    active_ops = best_ops();
+  return active_ops;
+}
+
+const char *aeon_simd_backend(void) { return aeon_k_ops()->name; }
+
+int aeon_simd_select(const char *name) {
+  if (name == NULL) {
+    active_ops = best_ops();
+    return 0;
+  }
+  for (size_t i = 0; i < N_CANDIDATES; i++) {
+    if (strcmp(name, candidates[i]->name) == 0 && supported(candidates[i])) {
+      active_ops = candidates[i];
+      return 0;
+    }
+  }
+  return -1;
+}
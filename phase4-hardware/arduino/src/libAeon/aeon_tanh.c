@@ -0,0 +1,141 @@
+/**
+ * @file aeon_tanh.c
+ * @brief Proyecto Eón - Activaciones tanh
+ *
+ * Tabla de "lut", "exact" fuera de línea (usa tanhf) y selección e
+ * informe de precisión de las activaciones. Las inline están en
+ * aeon_kernels.h.
+ */
+
+#include "libAeon.h"
+#include "aeon_kernels.h"
+#include <math.h>
+#include <string.h>
+
+#if AEON_TANH_RUNTIME
+uint8_t aeon_k_tanh_mode = AEON_TANH_MODE;
+#endif
+
+#if AEON_TANH_RUNTIME || AEON_TANH_MODE == AEON_TANH_LUT
+/* round(tanh(k / 64) * 32768) */
+const uint16_t aeon_k_tanh_table[AEON_TANH_LUT_SIZE + 1] = {
+    0, 512, 1024, 1535, 2045, 2555, 3063, 3570, 4075, 4578,
+    5079, 5577, 6073, 6566, 7056, 7542, 8025, 8505, 8980, 9452,
+    9919, 10382, 10840, 11294, 11743, 12186, 12625, 13058, 13486, 13909,
+    14326, 14737, 15143, 15542, 15936, 16324, 16706, 17082, 17452, 17816,
+    18173, 18525, 18870, 19209, 19542, 19869, 20189, 20504, 20813, 21115,
+    21411, 21702, 21986, 22265, 22538, 22804, 23066, 23321, 23571, 23815,
+    24054, 24287, 24516, 24738, 24956, 25168, 25376, 25578, 25776, 25969,
+    26157, 26340, 26519, 26694, 26864, 27029, 27191, 27348, 27502, 27651,
+    27797, 27938, 28076, 28211, 28341, 28469, 28592, 28713, 28830, 28944,
+    29055, 29163, 29268, 29370, 29470, 29566, 29660, 29751, 29840, 29926,
+    30010, 30091, 30170, 30247, 30322, 30394, 30465, 30533, 30600, 30664,
+    30727, 30788, 30847, 30904, 30960, 31014, 31067, 31118, 31167, 31215,
+    31262, 31307, 31351, 31394, 31435, 31476, 31515, 31553, 31589, 31625,
+    31659, 31693, 31726, 31757, 31788, 31817, 31846, 31874, 31901, 31928,
+    31953, 31978, 32002, 32025, 32048, 32070, 32091, 32112, 32132, 32151,
+    32170, 32188, 32206, 32223, 32240, 32256, 32271, 32287, 32301, 32316,
+    32329, 32343, 32356, 32368, 32381, 32392, 32404, 32415, 32426, 32436,
+    32447, 32456, 32466, 32475, 32484, 32493, 32501, 32509, 32517, 32525,
+    32532, 32540, 32547, 32553, 32560, 32566, 32573, 32579, 32584, 32590,
+    32596, 32601, 32606, 32611, 32616, 32620, 32625, 32629, 32634, 32638,
+    32642, 32646, 32649, 32653, 32657, 32660, 32663, 32667, 32670, 32673,
+    32676, 32678, 32681, 32684, 32686, 32689, 32691, 32694, 32696, 32698,
+    32700, 32702, 32704, 32706, 32708, 32710, 32712, 32714, 32715, 32717,
+    32718, 32720, 32721, 32723, 32724, 32726, 32727, 32728, 32729, 32731,
+    32732, 32733, 32734, 32735, 32736, 32737, 32738, 32739, 32740, 32741,
+    32741, 32742, 32743, 32744, 32745, 32745, 32746,
+};
+#endif
+
+aeon_state_t aeon_k_tanh_exact(aeon_state_t x) {
+#if AEON_USE_FIXED_POINT
+  return (aeon_state_t)lrintf(tanhf((float)x / AEON_SCALE) * AEON_SCALE);
+#else
+  return tanhf(x);
+#endif
+}
+
+/* ============================================================
+ * SELECCIÓN
+ * ============================================================ */
+
+static const char *const tanh_names[] = {"poly", "lut", "exact"};
+
+/** Índice AEON_TANH_* de un nombre (NULL = AEON_TANH_MODE), o -1 */
+static int tanh_lookup(const char *name) {
+  if (name == NULL)
+    return AEON_TANH_MODE;
+  for (int m = 0; m < 3; m++) {
+    if (strcmp(name, tanh_names[m]) == 0)
+      return m;
+  }
+  return -1;
+}
+
+const char *aeon_tanh_backend(void) { return tanh_names[AEON_K_TANH_MODE]; }
+
+int aeon_tanh_select(const char *name) {
+  int mode = tanh_lookup(name);
+  if (mode < 0)
+    return -1;
+#if AEON_TANH_RUNTIME
+  aeon_k_tanh_mode = (uint8_t)mode;
+  return 0;
+#else
+  return mode == AEON_TANH_MODE ? 0 : -1;
+#endif
+}
+
+/* ============================================================
+ * PRECISIÓN
+ * ============================================================ */
+
+/** Activación `mode` sin pasar por la elegida */
+static aeon_state_t tanh_eval(int mode, aeon_state_t x) {
+#if AEON_TANH_RUNTIME || AEON_TANH_MODE == AEON_TANH_LUT
+  if (mode == AEON_TANH_LUT)
+    return aeon_k_tanh_lut(x);
+#endif
+  if (mode == AEON_TANH_EXACT)
+    return aeon_k_tanh_exact(x);
+  return aeon_k_tanh_poly(x);
+}
+
+int aeon_tanh_report(const char *name, aeon_tanh_report_t *report) {
+  int mode = name == NULL ? AEON_K_TANH_MODE : tanh_lookup(name);
+  if (mode < 0 || report == NULL)
+    return -1;
+#if !AEON_TANH_RUNTIME && AEON_TANH_MODE != AEON_TANH_LUT
+  if (mode == AEON_TANH_LUT)
+    return -1; /* Tabla no compilada */
+#endif
+
+#if AEON_USE_FIXED_POINT
+  const int32_t steps = 8 * AEON_SCALE;
+  const float unit = 1.0f / AEON_SCALE;
+#else
+  const int32_t steps = 8 * 4096;
+  const float unit = 1.0f / 4096;
+#endif
+
+  double sum = 0.0;
+  report->max_error = 0.0f;
+  report->worst_x = 0.0f;
+  for (int32_t k = -steps; k <= steps; k++) {
+    float xf = (float)k * unit;
+#if AEON_USE_FIXED_POINT
+    float y = (float)tanh_eval(mode, (aeon_state_t)k) * unit;
+#else
+    float y = tanh_eval(mode, xf);
+#endif
+    float err = fabsf(y - tanhf(xf));
+    sum += err;
+    if (err > report->max_error) {
+      report->max_error = err;
+      report->worst_x = xf;
+    }
+  }
+  report->mean_error = (float)(sum / (2 * steps + 1));
+  return 0;
+}
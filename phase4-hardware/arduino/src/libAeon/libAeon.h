@@ -0,0 +1,1590 @@
+/**
+ * @file libAeon.h
+ * @brief Proyecto Eón - Núcleo ESN Ultraligero
+ *
+ * Implementación minimalista de Echo State Network en C puro
+ * para hardware embebido con huella de memoria mínima.
+ *
+ * "La Nada es Todo" - El reservoir aleatorio contiene
+ * toda la computación necesaria.
+ *
+ * @author Proyecto Eón
+ * @date 2024
+ */
+
+#ifndef LIBAEON_H
+#define LIBAEON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================
+ * CONFIGURACIÓN - Ajustar según hardware objetivo
+ * ============================================================ */
+
+/** Tamaño del reservoir (neuronas) */
+#ifndef AEON_RESERVOIR_SIZE
+#define AEON_RESERVOIR_SIZE 32
+#endif
+
+/** Número de entradas */
+#ifndef AEON_INPUT_SIZE
+#define AEON_INPUT_SIZE 1
+#endif
+
+/** Número de salidas */
+#ifndef AEON_OUTPUT_SIZE
+#define AEON_OUTPUT_SIZE 1
+#endif
+
+/** Escasez del reservoir (1 de cada N conexiones es no-cero) */
+#ifndef AEON_SPARSITY_FACTOR
+#define AEON_SPARSITY_FACTOR 4
+#endif
+
+/**
+ * Radio espectral objetivo del reservoir. Con un valor > 0, aeon_birth
+ * lo estima por iteración de potencia y reescala los pesos: sin
+ * normalizar, el radio de los pesos uniformes crece con sqrt(n /
+ * escasez) y los reservoirs grandes saturan. Por defecto 0 = pesos
+ * crudos, así que la misma semilla da el mismo reservoir y los mismos
+ * modelos que antes; aeon_birth_spectral o config.spectral_radius lo
+ * piden por núcleo (p. ej. 0.9 con cientos de neuronas).
+ */
+#ifndef AEON_SPECTRAL_RADIUS
+#define AEON_SPECTRAL_RADIUS 0.0f
+#endif
+
+/**
+ * Tasa de fuga de aeon_update: state += a * (tanh(...) - state).
+ * 1 = sin fuga (el estado es la activación); en punto fijo se redondea
+ * a múltiplos de 1/256.
+ */
+#ifndef AEON_LEAK_RATE
+#define AEON_LEAK_RATE 1.0f
+#endif
+
+/** Capacidad máxima de conexiones escasas del reservoir */
+#define AEON_SPARSE_CAPACITY                                                   \
+  (AEON_RESERVOIR_SIZE * AEON_RESERVOIR_SIZE / AEON_SPARSITY_FACTOR)
+
+/**
+ * Pesos de salida que caben en la lectura escasa de aeon_prune. Si
+ * sobreviven más, aeon_predict sigue con el producto denso: con AVX2
+ * el denso empata entre ~10% y ~25% de supervivientes según el tamaño;
+ * en un MCU sin SIMD compensa subirlo hasta la mitad.
+ */
+#ifndef AEON_READOUT_CAPACITY
+#define AEON_READOUT_CAPACITY (AEON_OUTPUT_SIZE * AEON_RESERVOIR_SIZE / 4)
+#endif
+
+/** Usar punto fijo en lugar de float (más eficiente en MCU) */
+#ifndef AEON_USE_FIXED_POINT
+#define AEON_USE_FIXED_POINT 1
+#endif
+
+/* Almacenamiento de pesos del camino float */
+#define AEON_WEIGHTS_F32 0  /**< float de 32 bits */
+#define AEON_WEIGHTS_F16 1  /**< IEEE binary16 (11 bits de mantisa) */
+#define AEON_WEIGHTS_BF16 2 /**< bfloat16: los 16 bits altos de un float */
+
+/**
+ * Pesos del camino float (AEON_USE_FIXED_POINT=0). Con f16 o bf16 se
+ * guardan en 16 bits y se ensanchan a float al leerlos: la aritmética
+ * y el estado siguen en float y W_in, el reservoir y W_out ocupan la
+ * mitad. Sin efecto en punto fijo.
+ */
+#ifndef AEON_FLOAT_WEIGHTS
+#define AEON_FLOAT_WEIGHTS AEON_WEIGHTS_F32
+#endif
+
+/** Kernels SIMD/DSP y FMA (float) en el camino caliente (0 = escalar) */
+#ifndef AEON_USE_SIMD
+#define AEON_USE_SIMD 1
+#endif
+
+/* Activaciones tanh (ver aeon_tanh_select) */
+#define AEON_TANH_POLY 0  /**< Polinomio de grado 5 saturado en ±1 */
+#define AEON_TANH_LUT 1   /**< Tabla de 257 entradas con interpolación */
+#define AEON_TANH_EXACT 2 /**< tanhf redondeada (FPU o float software) */
+
+/** Activación por defecto */
+#ifndef AEON_TANH_MODE
+#define AEON_TANH_MODE AEON_TANH_POLY
+#endif
+
+/**
+ * Cambiar la activación en tiempo de ejecución (una rama por neurona).
+ * Con 0 solo existe AEON_TANH_MODE y la tabla y tanhf no se enlazan.
+ */
+#ifndef AEON_TANH_RUNTIME
+#if defined(__AVR__)
+#define AEON_TANH_RUNTIME 0
+#else
+#define AEON_TANH_RUNTIME 1
+#endif
+#endif
+
+/**
+ * Contadores y trazas del camino caliente (ver aeon_stats_get). Con 0
+ * las llamadas de instrumentación desaparecen del código compilado.
+ */
+#ifndef AEON_ENABLE_STATS
+#define AEON_ENABLE_STATS 0
+#endif
+
+/** Pool de hilos POSIX para aeon_executor_create (CMake lo activa) */
+#ifndef AEON_USE_THREADS
+#define AEON_USE_THREADS 0
+#endif
+
+/* ============================================================
+ * TIPOS DE DATOS
+ * ============================================================ */
+
+#if AEON_USE_FIXED_POINT
+/** Punto fijo Q8.8 para pesos (-128 a 127 con 8 bits decimales) */
+typedef int16_t aeon_weight_t;
+/** Punto fijo Q16.16 para estado/acumuladores */
+typedef int32_t aeon_state_t;
+/** Factor de escala para punto fijo */
+#define AEON_SCALE 256
+#define AEON_SCALE_BITS 8
+#else
+#if AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F32
+typedef float aeon_weight_t;
+#else
+/** Peso de 16 bits (f16 o bf16): leer con aeon_weight_to_float */
+typedef struct {
+  uint16_t bits;
+} aeon_weight_t;
+#endif
+typedef float aeon_state_t;
+#define AEON_SCALE 1.0f
+#endif
+
+/** float a binary16, redondeando al par más cercano */
+static inline uint16_t aeon_f16_from_float(float x) {
+  uint32_t u, sign;
+  memcpy(&u, &x, sizeof(u));
+  sign = (u >> 16) & 0x8000u;
+  u &= 0x7FFFFFFFu;
+  if (u >= 0x47800000u) /* >= 65536: infinito, o NaN silencioso */
+    return (uint16_t)(sign | (u > 0x7F800000u ? 0x7E00u : 0x7C00u));
+  if (u < 0x38800000u) { /* Subnormal o cero: la suma redondea */
+    float f, magic = 0.5f;
+    memcpy(&f, &u, sizeof(f));
+    f += magic;
+    memcpy(&u, &f, sizeof(u));
+    return (uint16_t)(sign | (u - 0x3F000000u));
+  }
+  u += 0xC8000FFFu + ((u >> 13) & 1u); /* Exponente -112 y redondeo */
+  return (uint16_t)(sign | (u >> 13));
+}
+
+/** binary16 a float (exacto) */
+static inline float aeon_f16_to_float(uint16_t h) {
+  uint32_t u = (uint32_t)(h & 0x7FFFu) << 13;
+  uint32_t exp = u & 0x0F800000u;
+  float f;
+  u += 0x38000000u; /* Exponente +112 */
+  if (exp == 0x0F800000u) {
+    u += 0x38000000u; /* Infinito y NaN */
+  } else if (exp == 0) {
+    u += 0x00800000u; /* Subnormal: renormaliza restando 2^-14 */
+    memcpy(&f, &u, sizeof(f));
+    f -= 6.103515625e-05f;
+    memcpy(&u, &f, sizeof(u));
+  }
+  u |= (uint32_t)(h & 0x8000u) << 16;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+/** float a bfloat16, redondeando al par más cercano */
+static inline uint16_t aeon_bf16_from_float(float x) {
+  uint32_t u;
+  memcpy(&u, &x, sizeof(u));
+  if ((u & 0x7FFFFFFFu) > 0x7F800000u)
+    return (uint16_t)((u >> 16) | 0x0040u); /* NaN silencioso */
+  return (uint16_t)((u + 0x7FFFu + ((u >> 16) & 1u)) >> 16);
+}
+
+/** bfloat16 a float (exacto) */
+static inline float aeon_bf16_to_float(uint16_t b) {
+  uint32_t u = (uint32_t)b << 16;
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+/** Valor de un peso (en punto fijo, Q8.8 a float) */
+static inline float aeon_weight_to_float(aeon_weight_t w) {
+#if AEON_USE_FIXED_POINT
+  return (float)w / AEON_SCALE;
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F16
+  return aeon_f16_to_float(w.bits);
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_BF16
+  return aeon_bf16_to_float(w.bits);
+#else
+  return w;
+#endif
+}
+
+/** Peso con el valor x (redondeado al formato de almacenamiento) */
+static inline aeon_weight_t aeon_weight_from_float(float x) {
+#if AEON_USE_FIXED_POINT
+  return (aeon_weight_t)(x * AEON_SCALE);
+#elif AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F32
+  return x;
+#else
+  aeon_weight_t w;
+#if AEON_FLOAT_WEIGHTS == AEON_WEIGHTS_F16
+  w.bits = aeon_f16_from_float(x);
+#else
+  w.bits = aeon_bf16_from_float(x);
+#endif
+  return w;
+#endif
+}
+
+/** Hash de nacimiento (16 bytes) */
+typedef struct {
+  uint8_t bytes[16];
+} aeon_hash_t;
+
+/** Certificado de nacimiento */
+typedef struct {
+  time_t birth_time;       /**< Timestamp UTC del nacimiento */
+  aeon_hash_t birth_hash;  /**< Hash único */
+  uint32_t reservoir_seed; /**< Semilla del reservoir */
+  uint16_t reservoir_size; /**< Tamaño del reservoir */
+  uint16_t version;        /**< Versión de libAeon */
+} aeon_certificate_t;
+
+/** Núcleo principal de Eón */
+typedef struct {
+  /* Certificado de nacimiento (inmutable después de init) */
+  aeon_certificate_t certificate;
+
+  /* Estado del reservoir */
+  aeon_state_t state[AEON_RESERVOIR_SIZE];
+
+  /* Matrices de pesos (compactas) */
+  aeon_weight_t W_in[AEON_RESERVOIR_SIZE * AEON_INPUT_SIZE];
+  aeon_weight_t W_reservoir[AEON_SPARSE_CAPACITY];
+  aeon_weight_t W_out[AEON_OUTPUT_SIZE * AEON_RESERVOIR_SIZE];
+
+  /* Reservoir escaso en formato CSR (Compressed Sparse Row):
+   * las conexiones de la fila i ocupan [row_ptr[i], row_ptr[i + 1])
+   * en W_reservoir/col_indices, con columnas en orden ascendente. */
+  uint16_t col_indices[AEON_SPARSE_CAPACITY];
+  uint32_t row_ptr[AEON_RESERVOIR_SIZE + 1];
+  uint32_t sparse_count;
+
+  /* Dinámica: radio al que se normalizó W_reservoir al nacer (0 = pesos
+   * crudos) y fuga de aeon_update, que puede cambiarse en cualquier
+   * momento (0 o 1 = sin fuga) */
+  float spectral_radius;
+  float leak_rate;
+
+  /* Lectura escasa (aeon_prune): los pesos no nulos de la salida o
+   * ocupan [readout_ptr[o], readout_ptr[o + 1]) en readout_index /
+   * readout_weight. aeon_predict solo la usa si readout_sparse. */
+  uint16_t readout_index[AEON_READOUT_CAPACITY];
+  aeon_weight_t readout_weight[AEON_READOUT_CAPACITY];
+  uint16_t readout_ptr[AEON_OUTPUT_SIZE + 1];
+  bool readout_sparse;
+
+  /* Estadísticas */
+  uint32_t samples_processed;
+  uint32_t learning_sessions;
+  bool is_trained;
+
+} aeon_core_t;
+
+/* ============================================================
+ * FUNCIONES PRINCIPALES
+ * ============================================================ */
+
+/**
+ * @brief Inicializa una nueva instancia de Eón (Momento Cero)
+ *
+ * Esta función marca el nacimiento de la IA. El timestamp y hash
+ * son inmutables después de esta llamada.
+ *
+ * @param core Puntero a la estructura del núcleo
+ * @param seed Semilla opcional (0 = usar timestamp)
+ * @return 0 si éxito, código de error si falla
+ */
+int aeon_birth(aeon_core_t *core, uint32_t seed);
+
+/**
+ * @brief aeon_birth con otro radio espectral objetivo
+ *
+ * @param spectral_radius Radio de W_reservoir (0 = pesos crudos)
+ * @return 0 si éxito, -1 si core es NULL, -2 si el radio es negativo
+ */
+int aeon_birth_spectral(aeon_core_t *core, uint32_t seed,
+                        float spectral_radius);
+
+/**
+ * @brief Radio espectral actual de W_reservoir por iteración de potencia
+ *
+ * Estimación de la norma-máximo (error ~1% con los pesos de birth); no
+ * toca el estado. Es el mismo estimador que normaliza el nacimiento.
+ *
+ * @return Radio estimado, o -1 si core es NULL
+ */
+float aeon_spectral_radius(const aeon_core_t *core);
+
+/* Formato de archivo de modelos (ver aeon_io.c) */
+#define AEON_FILE_FORMAT_VERSION 3 /**< 3 añade radio y fuga; lee 1 a 3 */
+#define AEON_FILE_WEIGHTS_Q8_8 1 /**< Pesos int16 Q8.8 */
+#define AEON_FILE_WEIGHTS_F32 2  /**< Pesos float */
+#define AEON_FILE_WEIGHTS_F16 3  /**< Pesos binary16 */
+#define AEON_FILE_WEIGHTS_BF16 4 /**< Pesos bfloat16 */
+
+/* Secciones opcionales del archivo */
+#define AEON_SECTION_W_IN 0x01      /**< Pesos de entrada */
+#define AEON_SECTION_RESERVOIR 0x02 /**< Reservoir CSR completo */
+#define AEON_SECTION_W_OUT 0x04     /**< Pesos de salida entrenados */
+#define AEON_SECTION_STATE 0x08     /**< Estado actual del reservoir */
+#define AEON_SECTION_ALL 0x0F
+/** W_out como lista (índice, peso) de los no nulos, en vez de denso */
+#define AEON_SECTION_W_OUT_SPARSE 0x10
+
+/**
+ * @brief Cargar instancia desde archivo
+ *
+ * Las secciones W_in/reservoir ausentes se regeneran desde la semilla
+ * de la cabecera; W_out y el estado ausentes quedan a cero. Un W_out
+ * escaso se expande y deja la lectura escasa preparada. El archivo se
+ * valida entero (CRC, CSR ordenado) en un temporal del heap: si falla,
+ * core queda como estaba.
+ *
+ * @param core Puntero a la estructura del núcleo
+ * @param filename Ruta al archivo
+ * @return 0 si éxito, -2 no se abre, -3 error de lectura (o sin
+ *         memoria para el temporal), -4 formato inválido, -5 forma
+ *         incompatible, -6 versión incompatible, -7 datos corruptos
+ *         (CRC o CSR)
+ */
+int aeon_load(aeon_core_t *core, const char *filename);
+
+/**
+ * @brief Guardar instancia completa a archivo
+ *
+ * @param core Puntero a la estructura del núcleo
+ * @param filename Ruta al archivo
+ * @return 0 si éxito, -2 no se abre, -3 error de escritura
+ */
+int aeon_save(const aeon_core_t *core, const char *filename);
+
+/**
+ * @brief Guardar solo algunas secciones
+ *
+ * Con AEON_SECTION_W_OUT basta para distribuir un modelo entrenado:
+ * el resto se reconstruye desde la semilla al cargar. Tras aeon_prune,
+ * AEON_SECTION_W_OUT_SPARSE guarda solo los pesos no nulos: 2 bytes de
+ * índice más el peso por cada uno (gana por debajo de ~50% en Q8.8).
+ *
+ * @param sections Máscara AEON_SECTION_*
+ */
+int aeon_save_sections(const aeon_core_t *core, const char *filename,
+                       uint32_t sections);
+
+/**
+ * @brief Actualiza el estado del reservoir con nueva entrada
+ *
+ * @param core Puntero al núcleo
+ * @param input Vector de entrada
+ */
+void aeon_update(aeon_core_t *core, const aeon_state_t *input);
+
+/**
+ * @brief Genera predicción basada en el estado actual
+ *
+ * @param core Puntero al núcleo
+ * @param output Vector de salida (debe tener AEON_OUTPUT_SIZE elementos)
+ */
+void aeon_predict(const aeon_core_t *core, aeon_state_t *output);
+
+/**
+ * @brief Predicción en lazo cerrado a `horizon` pasos
+ *
+ * Cada predicción se usa como entrada del paso siguiente, en un solo
+ * bucle sobre una copia del estado en pila: out coincide con repetir
+ * aeon_predict + aeon_update, pero el núcleo no cambia.
+ *
+ * @param out horizon * AEON_OUTPUT_SIZE salidas, paso a paso
+ * @return 0 si éxito, -1 si hay punteros nulos, -2 si AEON_INPUT_SIZE
+ *         != AEON_OUTPUT_SIZE
+ */
+int aeon_generate(const aeon_core_t *core, uint32_t horizon,
+                  aeon_state_t *out);
+
+/**
+ * @brief Entrena la capa de salida con datos
+ *
+ * Usa regresión Ridge simplificada. Solo entrena W_out.
+ *
+ * @param core Puntero al núcleo
+ * @param inputs Datos de entrada (n_samples x AEON_INPUT_SIZE)
+ * @param targets Objetivos (n_samples x AEON_OUTPUT_SIZE)
+ * @param n_samples Número de muestras. Las series largas (millones)
+ *        valen también por esta vía: S^T*S se suma por bloques de
+ *        AEON_TRAIN_BLOCK filas (aeon_kernels.h), así que el redondeo
+ *        crece con los bloques y no con las muestras
+ * @param washout Muestras iniciales a descartar
+ * El espacio de trabajo (O(N²), ~N²/2 floats) se pide temporalmente
+ * con malloc; aeon_train_work lo recibe del llamador.
+ *
+ * @return Error cuadrático medio, o negativo si falla (-3 = sin
+ *         memoria, -5 = S^T*S no se factoriza; W_out queda como estaba)
+ */
+float aeon_train(aeon_core_t *core, const aeon_state_t *inputs,
+                 const aeon_state_t *targets, uint32_t n_samples,
+                 uint32_t washout);
+
+/** Bytes del espacio de trabajo de aeon_train_work */
+size_t aeon_train_work_size(void);
+
+/**
+ * @brief aeon_train sobre un espacio de trabajo del llamador
+ *
+ * Permite reservarlo de forma estática (p. ej. en un MCU).
+ *
+ * @param work aeon_train_work_size() bytes alineados a float
+ * @return Como aeon_train (-1 también si work es NULL)
+ */
+float aeon_train_work(aeon_core_t *core, const aeon_state_t *inputs,
+                      const aeon_state_t *targets, uint32_t n_samples,
+                      uint32_t washout, float *work);
+
+/**
+ * @brief Resetea el estado del reservoir a ceros
+ *
+ * @param core Puntero al núcleo
+ */
+void aeon_reset(aeon_core_t *core);
+
+/**
+ * @brief Obtiene el uso de memoria en bytes
+ *
+ * @param core Puntero al núcleo
+ * @return Bytes utilizados
+ */
+uint32_t aeon_memory_usage(const aeon_core_t *core);
+
+/**
+ * @brief Obtiene edad en segundos desde el nacimiento
+ *
+ * @param core Puntero al núcleo
+ * @return Segundos desde nacimiento
+ */
+uint32_t aeon_age_seconds(const aeon_core_t *core);
+
+/**
+ * @brief Convierte hash a string hexadecimal
+ *
+ * @param hash Puntero al hash
+ * @param buffer Buffer de salida (mínimo 33 bytes)
+ * @param buffer_size Tamaño del buffer en bytes
+ */
+void aeon_hash_to_string(const aeon_hash_t *hash, char *buffer, size_t buffer_size);
+
+/**
+ * @brief Poda conexiones débiles de la capa de salida
+ *
+ * Compacta los supervivientes en la lectura escasa del núcleo si caben
+ * en AEON_READOUT_CAPACITY; aeon_predict recorre entonces solo esos
+ * (mismo resultado, bit a bit). Entrenar o cargar vuelve a la lectura
+ * densa; tras modificar W_out a mano, llamar a aeon_prune(core, 0).
+ *
+ * @param core Puntero al núcleo
+ * @param threshold Umbral absoluto (si |w| < threshold, w = 0)
+ * @return Número de conexiones podadas
+ */
+int aeon_prune(aeon_core_t *core, float threshold);
+
+/* ============================================================
+ * NÚCLEO DIMENSIONADO EN TIEMPO DE EJECUCIÓN
+ *
+ * aeon_core_t fija su forma al compilar (camino rápido para MCU).
+ * aeon_dyn_core_t recibe la forma en tiempo de ejecución y reparte
+ * todos sus arrays desde una única arena contigua, alineada a línea
+ * de caché, de modo que un proceso puede alojar modelos de formas
+ * distintas con el mismo binario.
+ * ============================================================ */
+
+/** Alineación de cada array dentro de la arena */
+#define AEON_CACHE_LINE 64
+
+/** Forma de un núcleo dimensionado en tiempo de ejecución */
+typedef struct {
+  uint16_t reservoir_size;  /**< Neuronas del reservoir */
+  uint16_t input_size;      /**< Número de entradas */
+  uint16_t output_size;     /**< Número de salidas */
+  uint16_t sparsity_factor; /**< 1 de cada N conexiones es no-cero */
+  float spectral_radius;    /**< Radio al nacer (0 = pesos crudos) */
+  float leak_rate;          /**< Fuga del paso (0 o 1 = sin fuga) */
+} aeon_config_t;
+
+/** Configuración equivalente a los valores de compilación */
+#define AEON_CONFIG_DEFAULT                                                    \
+  {AEON_RESERVOIR_SIZE,  AEON_INPUT_SIZE,      AEON_OUTPUT_SIZE,               \
+   AEON_SPARSITY_FACTOR, AEON_SPECTRAL_RADIUS, AEON_LEAK_RATE}
+
+/**
+ * Asignador de memoria para la arena.
+ * alloc debe devolver memoria alineada a `alignment` (potencia de 2).
+ */
+typedef struct {
+  void *(*alloc)(size_t size, size_t alignment, void *ctx);
+  void (*free)(void *ptr, void *ctx);
+  void *ctx;
+} aeon_allocator_t;
+
+/** Núcleo con arrays en arena (misma semántica que aeon_core_t) */
+typedef struct {
+  aeon_certificate_t certificate;
+  aeon_config_t config;
+
+  /* Arrays dentro de la arena */
+  aeon_state_t *state;        /**< reservoir_size */
+  aeon_weight_t *W_in;        /**< reservoir_size * input_size (o NULL) */
+  aeon_weight_t *W_reservoir; /**< Pesos CSR (NULL si procedural) */
+  aeon_weight_t *W_out;       /**< output_size * reservoir_size */
+  uint16_t *col_indices;      /**< Columnas CSR (NULL si procedural) */
+  uint32_t *row_ptr;          /**< Punteros de fila CSR (NULL si procedural) */
+  uint32_t sparse_count;
+  bool procedural;            /**< Pesos regenerados desde la semilla */
+
+  /* Estadísticas */
+  uint32_t samples_processed;
+  uint32_t learning_sessions;
+  bool is_trained;
+
+  /* Interno */
+  aeon_state_t *scratch;      /**< Buffer temporal del paso */
+  aeon_state_t reservoir_gain; /**< Escala del reservoir procedural */
+  aeon_allocator_t allocator; /**< Asignador propietario de la arena */
+  size_t arena_size;          /**< Bytes totales de la arena */
+  const void *mapping;        /**< Archivo proyectado (aeon_core_map) */
+  size_t mapping_size;
+} aeon_dyn_core_t;
+
+/**
+ * @brief Bytes de arena necesarios para una configuración
+ *
+ * Permite reservar la arena de forma estática (p. ej. en un MCU) y
+ * servirla con un asignador propio.
+ *
+ * @return Bytes necesarios, o 0 si la configuración es inválida
+ */
+size_t aeon_core_arena_size(const aeon_config_t *config);
+
+/**
+ * @brief Crea un núcleo con la forma indicada
+ *
+ * La estructura y todos sus arrays se reparten de una sola reserva.
+ * El núcleo queda a cero; llamar a aeon_core_birth antes de usarlo.
+ *
+ * @param config Forma del núcleo
+ * @param allocator Asignador (NULL = malloc alineado)
+ * @return Núcleo, o NULL si la configuración es inválida o no hay memoria
+ */
+aeon_dyn_core_t *aeon_core_create(const aeon_config_t *config,
+                                  const aeon_allocator_t *allocator);
+
+/**
+ * @brief Crea un núcleo con reservoir procedural
+ *
+ * W_in y el reservoir no se guardan: cada paso los regenera desde la
+ * semilla del certificado con un hash de contador (la conexión t de la
+ * fila i es función solo de la semilla y de i * fan_in + t). La arena
+ * queda en O(n): estado, scratch y W_out. A cambio, cada paso calcula
+ * un hash por conexión.
+ *
+ * Es un reservoir distinto del materializado: la misma semilla no da
+ * los mismos pesos que aeon_core_create.
+ */
+aeon_dyn_core_t *aeon_core_create_procedural(const aeon_config_t *config,
+                                             const aeon_allocator_t *allocator);
+
+/**
+ * @brief Libera un núcleo creado con aeon_core_create
+ */
+void aeon_core_destroy(aeon_dyn_core_t *core);
+
+/**
+ * @brief Equivalente de aeon_birth (misma semilla y forma = mismos pesos)
+ *
+ * Pide temporalmente al asignador un bitset de n²/8 bytes. Con
+ * config.spectral_radius > 0 normaliza el reservoir como
+ * aeon_birth_spectral; uno procedural guarda en su lugar la ganancia
+ * que el paso aplica a cada peso regenerado.
+ *
+ * @return 0 si éxito, -1 si core es NULL, -3 si no hay memoria,
+ *         -4 si el núcleo está proyectado
+ */
+int aeon_core_birth(aeon_dyn_core_t *core, uint32_t seed);
+
+/** Equivalente de aeon_update (input de config.input_size elementos) */
+void aeon_core_update(aeon_dyn_core_t *core, const aeon_state_t *input);
+
+/**
+ * @brief Equivalente de aeon_spectral_radius (incluye la ganancia
+ *        procedural)
+ *
+ * @return Radio estimado, o negativo si falla (-1 = NULL, -3 = sin
+ *         memoria)
+ */
+float aeon_core_spectral_radius(const aeon_dyn_core_t *core);
+
+/** Equivalente de aeon_predict (output de config.output_size elementos) */
+void aeon_core_predict(const aeon_dyn_core_t *core, aeon_state_t *output);
+
+/**
+ * @brief aeon_generate para núcleos dimensionados en tiempo de ejecución
+ *
+ * Las config.output_size salidas de cada paso son sus entradas. El
+ * estado de trabajo se pide temporalmente al asignador, así que varios
+ * hilos pueden generar a la vez desde el mismo núcleo.
+ *
+ * @return 0 si éxito, -1 si hay punteros nulos, -2 si input_size !=
+ *         output_size, -3 si no hay memoria
+ */
+int aeon_core_generate(const aeon_dyn_core_t *core, uint32_t horizon,
+                       aeon_state_t *out);
+
+/**
+ * @brief Equivalente de aeon_train
+ *
+ * El espacio de trabajo del solver se pide temporalmente al asignador.
+ *
+ * @return MSE, o negativo si falla (-3 = sin memoria, -4 = proyectado,
+ *         -5 = S^T*S no se factoriza)
+ */
+float aeon_core_train(aeon_dyn_core_t *core, const aeon_state_t *inputs,
+                      const aeon_state_t *targets, uint32_t n_samples,
+                      uint32_t washout);
+
+/** Equivalente de aeon_reset */
+void aeon_core_reset(aeon_dyn_core_t *core);
+
+/** Bytes de arena del núcleo */
+uint32_t aeon_core_memory_usage(const aeon_dyn_core_t *core);
+
+/**
+ * @brief Guardar un núcleo en el formato de aeon_save
+ *
+ * @param sections Máscara AEON_SECTION_*
+ * @return Mismos códigos que aeon_save
+ */
+int aeon_core_save(const aeon_dyn_core_t *core, const char *filename,
+                   uint32_t sections);
+
+/**
+ * @brief Cargar un núcleo con la forma que indique el archivo
+ *
+ * @param error Código de error de aeon_load (puede ser NULL)
+ * @return Núcleo, o NULL si falla
+ */
+aeon_dyn_core_t *aeon_core_load(const char *filename,
+                                const aeon_allocator_t *allocator, int *error);
+
+/**
+ * @brief Proyectar un modelo en memoria, sin copiar los pesos
+ *
+ * Los pesos quedan en el archivo proyectado de solo lectura: las
+ * páginas se cargan al usarse y varios procesos comparten las mismas.
+ * La arena solo guarda estado y scratch. No verifica CRC (lo haría
+ * tocar todo el archivo). Si faltan secciones de pesos, o la
+ * plataforma no tiene mmap, equivale a aeon_core_load.
+ *
+ * Un núcleo proyectado admite update/predict/reset; birth, train y
+ * aeon_core_trainer_finalize devuelven -4.
+ */
+aeon_dyn_core_t *aeon_core_map(const char *filename,
+                               const aeon_allocator_t *allocator, int *error);
+
+/* ============================================================
+ * INFERENCIA POR LOTES (MULTI-STREAM)
+ *
+ * Un aeon_batch_t guarda N estados independientes en layout SoA
+ * (estructura de arrays): state[neurona * stride + stream]. Todos los
+ * streams comparten una única copia de W_in / W_reservoir / W_out, de
+ * modo que cada peso se lee una vez por lote y no una vez por stream.
+ *
+ * Entradas y salidas también son SoA y densas:
+ *   inputs[j * n_streams + s], outputs[o * n_streams + s]
+ * ============================================================ */
+
+/** Bloque de estados para streams que comparten pesos */
+typedef struct {
+  uint16_t reservoir_size; /**< Neuronas por stream */
+  uint16_t n_streams;      /**< Streams activos */
+  uint32_t stride;         /**< Elementos entre neuronas (alineado) */
+  aeon_state_t *state;     /**< reservoir_size * stride */
+
+  /* Interno */
+  aeon_state_t *scratch;      /**< Buffer temporal del paso */
+  aeon_allocator_t allocator; /**< Asignador propietario */
+} aeon_batch_t;
+
+/**
+ * @brief Crea un bloque de n_streams estados a cero
+ *
+ * @param reservoir_size Neuronas (debe coincidir con el núcleo usado)
+ * @param n_streams Número de streams
+ * @param allocator Asignador (NULL = malloc alineado)
+ * @return Bloque, o NULL si falla
+ */
+aeon_batch_t *aeon_batch_create(uint16_t reservoir_size, uint16_t n_streams,
+                                const aeon_allocator_t *allocator);
+
+/** Libera un bloque creado con aeon_batch_create */
+void aeon_batch_destroy(aeon_batch_t *batch);
+
+/** Resetea a cero todos los streams */
+void aeon_batch_reset(aeon_batch_t *batch);
+
+/** Resetea a cero un stream */
+void aeon_batch_reset_stream(aeon_batch_t *batch, uint16_t stream);
+
+/**
+ * @brief Avanza todos los streams un paso con los pesos de core
+ *
+ * @param core Núcleo con los pesos compartidos (no se modifica)
+ * @param batch Bloque de estados
+ * @param inputs AEON_INPUT_SIZE * n_streams entradas (SoA)
+ * @return 0 si éxito, -1 si hay punteros nulos, -2 si la forma no coincide
+ */
+int aeon_update_batch(const aeon_core_t *core, aeon_batch_t *batch,
+                      const aeon_state_t *inputs);
+
+/**
+ * @brief Predicción para todos los streams
+ *
+ * @param outputs AEON_OUTPUT_SIZE * n_streams salidas (SoA)
+ * @return 0 si éxito, -1 si hay punteros nulos, -2 si la forma no coincide
+ */
+int aeon_predict_batch(const aeon_core_t *core, const aeon_batch_t *batch,
+                       aeon_state_t *outputs);
+
+/** aeon_update_batch para núcleos dimensionados en tiempo de ejecución */
+int aeon_core_update_batch(const aeon_dyn_core_t *core, aeon_batch_t *batch,
+                           const aeon_state_t *inputs);
+
+/** aeon_predict_batch para núcleos dimensionados en tiempo de ejecución */
+int aeon_core_predict_batch(const aeon_dyn_core_t *core,
+                            const aeon_batch_t *batch, aeon_state_t *outputs);
+
+/* ============================================================
+ * ENTRENAMIENTO INCREMENTAL
+ *
+ * aeon_train necesita todas las muestras en memoria. Un aeon_trainer_t
+ * solo guarda los acumuladores S^T*S (triangular empaquetada) y S^T*Y,
+ * así que la memoria es O(N²) sin importar cuántas muestras lleguen:
+ * las muestras se empujan una a una y W_out se resuelve cuando se
+ * quiera, tantas veces como se quiera, sin perder lo acumulado.
+ *
+ * Con un factor de olvido f < 1 (estilo RLS), la muestra de hace k
+ * pasos pesa f^k, de modo que el modelo sigue a señales que derivan.
+ * ============================================================ */
+
+/** Acumuladores de una regresión Ridge en streaming */
+typedef struct {
+  uint16_t reservoir_size; /**< Neuronas del núcleo entrenado */
+  uint16_t output_size;    /**< Salidas del núcleo entrenado */
+  float lambda;            /**< Regularización de Tikhonov por muestra */
+  float forgetting;        /**< Factor de olvido (1.0 = sin olvido) */
+  uint32_t washout;        /**< Muestras de calentamiento restantes */
+  uint64_t n_accumulated;  /**< Muestras acumuladas desde begin */
+  float mse;               /**< MSE (ponderado) de la última resolución */
+
+  /* Interno */
+  float weight;               /**< Peso de la última muestra (f^-t) */
+  double weight_sum;          /**< Suma de pesos (escalada por weight) */
+  float *StS;                 /**< S^T*S empaquetada (escalada por weight) */
+  float *StY;                 /**< S^T*Y (escalada por weight) */
+  float *YtY;                 /**< diag(Y^T*Y) (escalada por weight) */
+  float *comp;                /**< Compensación de Kahan de los tres */
+  float *block;               /**< Estados y targets aún sin sumar */
+  uint16_t pending;           /**< Muestras en block */
+  float *factor;              /**< Copia factorizada en finalize */
+  float *work;                /**< Temporal del bloque y de la sustitución */
+  aeon_allocator_t allocator; /**< Asignador propietario */
+} aeon_trainer_t;
+
+/**
+ * @brief Crea un entrenador para núcleos de la forma dada
+ *
+ * Queda listo como tras aeon_trainer_begin(t, 1.0f, 0).
+ *
+ * @param reservoir_size Neuronas del núcleo
+ * @param output_size Salidas del núcleo
+ * @param allocator Asignador (NULL = malloc alineado)
+ * @return Entrenador, o NULL si falla
+ */
+aeon_trainer_t *aeon_trainer_create(uint16_t reservoir_size,
+                                    uint16_t output_size,
+                                    const aeon_allocator_t *allocator);
+
+/** Libera un entrenador creado con aeon_trainer_create */
+void aeon_trainer_destroy(aeon_trainer_t *trainer);
+
+/**
+ * @brief Descarta lo acumulado y empieza una nueva sesión
+ *
+ * @param forgetting Factor de olvido en (0, 1]; 1.0 = Ridge clásico
+ * @param washout Muestras iniciales que solo calientan el reservoir
+ * @return 0 si éxito, -1 si trainer es NULL, -2 si forgetting es inválido
+ */
+int aeon_trainer_begin(aeon_trainer_t *trainer, float forgetting,
+                       uint32_t washout);
+
+/**
+ * @brief Acumula un estado ya calculado y su objetivo
+ *
+ * Para reservoirs que se avanzan por otra vía (lotes, hardware).
+ * Mientras quede washout la muestra se descarta.
+ *
+ * @param state reservoir_size elementos
+ * @param target output_size elementos
+ * @return 1 si se acumuló, 0 si era washout, -1 si hay punteros nulos
+ */
+int aeon_trainer_accumulate(aeon_trainer_t *trainer, const aeon_state_t *state,
+                            const aeon_state_t *target);
+
+/**
+ * @brief Avanza el núcleo con input y acumula su estado con target
+ *
+ * @return 1 si se acumuló, 0 si era washout, -1 si hay punteros nulos,
+ *         -2 si la forma no coincide
+ */
+int aeon_trainer_push(aeon_trainer_t *trainer, aeon_core_t *core,
+                      const aeon_state_t *input, const aeon_state_t *target);
+
+/**
+ * @brief Resuelve W_out con lo acumulado hasta ahora
+ *
+ * Los acumuladores no se modifican: se puede seguir empujando
+ * muestras y volver a resolver. trainer->mse queda con el error de
+ * entrenamiento, calculado en forma cerrada desde los acumuladores.
+ *
+ * @return Reintentos con más ridge que hicieron falta (>= 0), -1 si hay
+ *         punteros nulos, -2 si la forma no coincide, -3 si no hay
+ *         muestras, -5 si S^T*S no se factoriza (W_out intacto)
+ */
+int aeon_trainer_finalize(aeon_trainer_t *trainer, aeon_core_t *core);
+
+/** aeon_trainer_push para núcleos dimensionados en tiempo de ejecución */
+int aeon_core_trainer_push(aeon_trainer_t *trainer, aeon_dyn_core_t *core,
+                           const aeon_state_t *input,
+                           const aeon_state_t *target);
+
+/**
+ * aeon_trainer_finalize para núcleos dimensionados en tiempo de
+ * ejecución (-4 si el núcleo está proyectado)
+ */
+int aeon_core_trainer_finalize(aeon_trainer_t *trainer, aeon_dyn_core_t *core);
+
+/* ============================================================
+ * ACTUALIZACIÓN POR EVENTOS (MODO DELTA)
+ *
+ * Las series lentas (temperatura, intervalos RR) apenas cambian entre
+ * muestras. Un aeon_delta_t guarda la preactivación de cada neurona y
+ * solo propaga por W_in y el reservoir CSR las entradas y neuronas que
+ * cambiaron más que el umbral desde la última vez que se propagaron;
+ * las filas sin ninguna columna activa no se recalculan (ni su tanh).
+ * Los cambios por debajo del umbral no se pierden: se acumulan hasta
+ * superarlo. Con umbral 0 en punto fijo el resultado es bit a bit el
+ * de aeon_update.
+ * ============================================================ */
+
+/** Estado del modo delta de un núcleo */
+typedef struct {
+  uint16_t reservoir_size; /**< Neuronas del núcleo */
+  uint16_t input_size;     /**< Entradas del núcleo */
+  aeon_state_t threshold;  /**< |cambio| mínimo que se propaga */
+  uint64_t ops_total;      /**< MACs que habría hecho aeon_update */
+  uint64_t ops_skipped;    /**< MACs evitadas */
+  uint64_t rows_skipped;   /**< Filas no recalculadas */
+  uint32_t active;         /**< Neuronas propagadas en el último paso */
+
+  /* Interno */
+  bool primed;                /**< acc refleja state_ref e input_ref */
+  aeon_state_t *acc;          /**< Preactivaciones (sin desplazar) */
+  aeon_state_t *state_ref;    /**< Último estado propagado */
+  aeon_state_t *change;       /**< Cambio propagado en el paso (0 = no) */
+  aeon_state_t *input_ref;    /**< Última entrada propagada */
+  aeon_state_t *input_change; /**< Cambio de entrada propagado */
+  aeon_allocator_t allocator; /**< Asignador propietario */
+} aeon_delta_t;
+
+/**
+ * @brief Crea el estado delta para núcleos de la forma dada
+ *
+ * Queda listo como tras aeon_delta_begin(d, 0).
+ *
+ * @param allocator Asignador (NULL = malloc alineado)
+ * @return Estado delta, o NULL si falla
+ */
+aeon_delta_t *aeon_delta_create(uint16_t reservoir_size, uint16_t input_size,
+                                const aeon_allocator_t *allocator);
+
+/** Libera un estado creado con aeon_delta_create */
+void aeon_delta_destroy(aeon_delta_t *delta);
+
+/**
+ * @brief Fija el umbral y reinicia contadores
+ *
+ * El siguiente paso es completo. Llamarla también tras modificar el
+ * estado del núcleo por otra vía (aeon_reset, aeon_load, aeon_update).
+ *
+ * @param threshold Umbral en unidades de aeon_state_t (Q8.8 en punto fijo)
+ * @return 0 si éxito, -1 si delta es NULL, -2 si threshold < 0
+ */
+int aeon_delta_begin(aeon_delta_t *delta, aeon_state_t threshold);
+
+/**
+ * @brief aeon_update en modo delta
+ *
+ * @return 0 si éxito, -1 si hay punteros nulos, -2 si la forma no coincide
+ */
+int aeon_delta_update(aeon_delta_t *delta, aeon_core_t *core,
+                      const aeon_state_t *input);
+
+/**
+ * aeon_delta_update para núcleos dimensionados en tiempo de ejecución
+ * (-5 si el núcleo es procedural)
+ */
+int aeon_core_delta_update(aeon_delta_t *delta, aeon_dyn_core_t *core,
+                           const aeon_state_t *input);
+
+/* ============================================================
+ * PARALELISMO
+ *
+ * Las operaciones que se reparten en tareas independientes (expertos
+ * de un ensamble) las ejecutan con un aeon_executor_t. Puede ser el
+ * pool de hilos de la librería o uno propio (una cola de FreeRTOS, un
+ * pool de la aplicación); sin ejecutor las tareas corren en orden en
+ * el hilo que llama.
+ * ============================================================ */
+
+/** Tarea index-ésima de un lote */
+typedef void (*aeon_task_fn)(void *arg, uint32_t index);
+
+/** Ejecutor de lotes de tareas */
+typedef struct {
+  /** Ejecuta task(arg, i) para i en [0, n) y vuelve cuando acaban todas */
+  void (*run)(void *ctx, aeon_task_fn task, void *arg, uint32_t n);
+  void *ctx;
+} aeon_executor_t;
+
+/**
+ * @brief Crea un pool de n_threads hilos persistentes
+ *
+ * El hilo que llama a run también ejecuta tareas, así que n_threads - 1
+ * hilos esperan trabajo.
+ *
+ * @return Ejecutor, o NULL si AEON_USE_THREADS es 0 o algo falla
+ */
+aeon_executor_t *aeon_executor_create(uint16_t n_threads);
+
+/** Detiene los hilos y libera el ejecutor */
+void aeon_executor_destroy(aeon_executor_t *executor);
+
+/**
+ * @brief aeon_core_train con S^T*S acumulada en paralelo
+ *
+ * El reservoir sigue siendo secuencial: una tarea lo avanza y escribe
+ * los estados en bloques de 64 muestras, mientras las demás suman los
+ * bloques ya llenos con una actualización de rango k en n_partials
+ * S^T*S parciales (una por bloque de cada ronda, no por hilo), que se
+ * suman al final. Compensa desde unos cientos de neuronas, cuando la
+ * acumulación O(N²) por muestra domina al paso.
+ *
+ * La acumulación por bloques es la de aeon_core_train, que coincide
+ * bit a bit con n_partials = 1. El resultado depende de n_partials pero
+ * no del ejecutor ni de los hilos.
+ *
+ * @param executor Ejecutor (NULL = en orden en el hilo que llama)
+ * @param n_partials Parciales, p. ej. los hilos del ejecutor; cada una
+ *        ocupa ~2 N² bytes
+ * @return MSE, o negativo si falla (-2 = sin muestras o n_partials 0,
+ *         -3 = sin memoria, -4 = proyectado, -5 = S^T*S no se
+ *         factoriza)
+ */
+float aeon_core_train_parallel(aeon_dyn_core_t *core,
+                               const aeon_state_t *inputs,
+                               const aeon_state_t *targets,
+                               uint32_t n_samples, uint32_t washout,
+                               const aeon_executor_t *executor,
+                               uint16_t n_partials);
+
+/* ============================================================
+ * ENSAMBLE DE RESERVOIRS
+ *
+ * K núcleos con semillas distintas, cada uno con un dominio de datos
+ * nativo y una afinidad por dominio, como la Voluntad Verdadera de
+ * AeonESP32 (mismos dominios, umbrales y reglas de aprendizaje). Cada
+ * paso se enruta por dominio: los expertos que rechazan el dominio no
+ * se actualizan ni se evalúan, y las salidas de los demás se combinan
+ * con su afinidad como peso. La actualización de los expertos elegidos
+ * se reparte con el ejecutor.
+ *
+ * Un experto que rechaza un dominio conserva su estado; vuelve a
+ * avanzar cuando se le enruta otra vez.
+ * ============================================================ */
+
+/** Dominios de datos (mismos valores que DataDomain de AeonESP32) */
+#define AEON_DOMAIN_TEMPERATURE 0
+#define AEON_DOMAIN_HUMIDITY 1
+#define AEON_DOMAIN_AUDIO 2
+#define AEON_DOMAIN_MOTION 3
+#define AEON_DOMAIN_LIGHT 4
+#define AEON_DOMAIN_PRESSURE 5
+#define AEON_DOMAIN_VIBRATION 6
+#define AEON_DOMAIN_VOLTAGE 7
+#define AEON_DOMAIN_TIMESERIES 8
+#define AEON_DOMAIN_GENERIC 9
+#define AEON_DOMAIN_COUNT 10
+
+/* Decisiones de ruta (TaskDecision de AeonESP32) */
+#define AEON_ROUTE_ACCEPT 0 /**< Afinidad >= 200 */
+#define AEON_ROUTE_HIGH 1   /**< Afinidad >= umbral de coste alto */
+#define AEON_ROUTE_LOW 2    /**< Afinidad >= umbral de rechazo */
+#define AEON_ROUTE_REJECT 3 /**< No se actualiza ni se evalúa */
+
+/** Un experto del ensamble */
+typedef struct {
+  aeon_core_t core;
+  uint8_t domain;                      /**< Dominio nativo */
+  uint8_t affinity[AEON_DOMAIN_COUNT]; /**< Afinidad [0, 255] por dominio */
+  uint16_t processed[AEON_DOMAIN_COUNT]; /**< Entrenamientos por dominio */
+  aeon_state_t output[AEON_OUTPUT_SIZE]; /**< Última predicción */
+  float mse;                             /**< Último MSE de entrenamiento */
+} aeon_expert_t;
+
+/** Ensamble de expertos */
+typedef struct {
+  uint16_t n_experts;
+  aeon_expert_t *experts;
+  uint8_t reject_threshold; /**< Afinidad mínima (77, ~30%) */
+  uint8_t high_threshold;   /**< Afinidad de coste alto (128, ~50%) */
+  /** Reparte los expertos de cada paso (NULL = en orden; con
+   *  AEON_ENABLE_STATS siempre en orden, los contadores son globales) */
+  const aeon_executor_t *executor;
+
+  uint16_t n_active; /**< Expertos elegidos en la última ruta */
+  uint16_t *active;  /**< Índices de esos expertos */
+
+  /* Interno */
+  const aeon_state_t *task_input;  /**< Entrada del paso en curso */
+  const aeon_state_t *task_target; /**< Objetivos del entrenamiento */
+  uint32_t task_samples;
+  uint32_t task_washout;
+  aeon_allocator_t allocator; /**< Asignador propietario */
+} aeon_ensemble_t;
+
+/**
+ * @brief Crea un ensamble y da nacimiento a sus expertos
+ *
+ * @param seeds Semilla de cada experto (0 = reloj, como aeon_birth)
+ * @param domains Dominio nativo de cada experto (NULL = todos genéricos)
+ * @param allocator Asignador (NULL = malloc alineado)
+ * @return Ensamble, o NULL si falla
+ */
+aeon_ensemble_t *aeon_ensemble_create(uint16_t n_experts,
+                                      const uint32_t *seeds,
+                                      const uint8_t *domains,
+                                      const aeon_allocator_t *allocator);
+
+/** Libera un ensamble creado con aeon_ensemble_create */
+void aeon_ensemble_destroy(aeon_ensemble_t *ensemble);
+
+/** Decisión de un experto para un dominio (evaluateTaskCost) */
+uint8_t aeon_ensemble_cost(const aeon_ensemble_t *ensemble, uint16_t expert,
+                           uint8_t domain);
+
+/**
+ * @brief Elige los expertos que no rechazan el dominio
+ *
+ * @return Número de expertos elegidos, o -1 si ensemble es NULL, -2 si
+ *         el dominio no existe
+ */
+int aeon_ensemble_route(aeon_ensemble_t *ensemble, uint8_t domain);
+
+/**
+ * @brief Paso del ensamble: ruta, update + predict de cada elegido y
+ *        combinación ponderada por afinidad
+ *
+ * @param output AEON_OUTPUT_SIZE salidas combinadas
+ * @return Expertos evaluados, o -1 si hay punteros nulos, -2 si el
+ *         dominio no existe, -3 si todos lo rechazan
+ */
+int aeon_ensemble_step(aeon_ensemble_t *ensemble, uint8_t domain,
+                       const aeon_state_t *input, aeon_state_t *output);
+
+/**
+ * @brief Entrena los expertos que aceptan el dominio
+ *
+ * Cada experto elegido entrena su W_out con aeon_train (en paralelo
+ * con el ejecutor) y su afinidad por el dominio sube o baja según su
+ * MSE, como recordProcessing de AeonESP32.
+ *
+ * @return MSE medio de los expertos entrenados, o -1 si hay punteros
+ *         nulos, -2 si el dominio no existe, -3 si todos lo rechazan,
+ *         -4 si n_samples <= washout
+ */
+float aeon_ensemble_train(aeon_ensemble_t *ensemble, uint8_t domain,
+                          const aeon_state_t *inputs,
+                          const aeon_state_t *targets, uint32_t n_samples,
+                          uint32_t washout);
+
+/** aeon_reset de todos los expertos */
+void aeon_ensemble_reset(aeon_ensemble_t *ensemble);
+
+/* ============================================================
+ * INGESTA DE SEÑALES
+ *
+ * Lectura por bloques de tramas int16 para reproducir señales
+ * archivadas (audio, ECG) a velocidad de disco. Formato binario,
+ * little-endian:
+ *
+ *   0  "EONS"   4  u8 versión   5  u8 bits fraccionarios
+ *   6  u16 canales
+ *
+ * seguido de bloques [u32 tramas][tramas * canales int16]. Con 8 bits
+ * fraccionarios los valores son Q8.8; con 0, enteros (ms, cuentas de
+ * ADC). Un archivo regular (también stdin redirigido) se proyecta con
+ * mmap y las tramas se entregan sin copiar. Si el origen no empieza
+ * por "EONS" se lee como CSV: una trama por línea, campos separados
+ * por comas, punto y coma o espacios, y las líneas no numéricas
+ * (cabeceras) se descartan.
+ * ============================================================ */
+
+#define AEON_STREAM_VERSION 1
+#define AEON_STREAM_HEADER_SIZE 8
+#define AEON_STREAM_MAX_CHANNELS 64 /**< Campos por línea CSV */
+#define AEON_STREAM_LINE 512        /**< Longitud máxima de línea CSV */
+
+/** Lector de tramas */
+typedef struct {
+  uint16_t channels; /**< Valores por trama */
+  uint8_t frac_bits; /**< Bits fraccionarios (8 = Q8.8) */
+  bool binary;       /**< false = CSV */
+  bool mapped;       /**< Tramas servidas desde memoria, sin copia */
+  uint64_t frames;   /**< Tramas entregadas */
+  uint64_t skipped;  /**< Líneas CSV descartadas */
+
+  /* Interno */
+  void *file; /**< FILE de origen si no hay memoria */
+  bool owns_file;
+  const uint8_t *data; /**< Origen en memoria (o proyección) */
+  size_t size;
+  size_t pos;
+  bool owns_map;
+  uint32_t block_left; /**< Tramas que quedan del bloque binario */
+  int16_t *chunk;      /**< Tramas decodificadas */
+  uint32_t chunk_frames;
+  bool line_ready; /**< line guarda una trama CSV aún sin entregar */
+  uint8_t peek[AEON_STREAM_HEADER_SIZE]; /**< Bytes leídos al detectar */
+  uint8_t peek_len;
+  uint8_t peek_pos;
+  char line[AEON_STREAM_LINE];
+  aeon_allocator_t allocator;
+} aeon_stream_t;
+
+/**
+ * @brief Abre un archivo o tubería de tramas
+ *
+ * @param path Ruta, o "-" / NULL para stdin
+ * @param csv_frac_bits Bits fraccionarios al convertir CSV (8 = Q8.8)
+ * @param chunk_frames Tramas por bloque decodificado (0 = 256)
+ * @param error 0, -2 no se abre, -3 error de lectura o de memoria, -4
+ *        formato inválido (puede ser NULL)
+ * @return Lector, o NULL si falla
+ */
+aeon_stream_t *aeon_stream_open(const char *path, uint8_t csv_frac_bits,
+                                uint32_t chunk_frames,
+                                const aeon_allocator_t *allocator, int *error);
+
+/**
+ * @brief Lector sobre un buffer (archivo proyectado, región de un
+ *        ring buffer compartido...), sin copiarlo
+ *
+ * El buffer debe seguir vivo mientras se use el lector.
+ */
+aeon_stream_t *aeon_stream_open_memory(const void *data, size_t size,
+                                       uint8_t csv_frac_bits,
+                                       uint32_t chunk_frames,
+                                       const aeon_allocator_t *allocator,
+                                       int *error);
+
+/**
+ * @brief Siguiente bloque de tramas
+ *
+ * frames apunta a n * channels valores, trama a trama, válidos hasta
+ * la siguiente llamada. Desde memoria un bloque binario se entrega
+ * entero y sin copia; si no, hasta chunk_frames tramas.
+ *
+ * @return Número de tramas n, 0 al terminar, -1 si hay punteros
+ *         nulos, -3 error de lectura, -4 bloque truncado
+ */
+int32_t aeon_stream_next(aeon_stream_t *stream, const int16_t **frames);
+
+/**
+ * @brief Convierte count canales de una trama, desde first, a la
+ *        escala de aeon_state_t
+ */
+void aeon_stream_state(const aeon_stream_t *stream, const int16_t *frame,
+                       uint16_t first, uint16_t count, aeon_state_t *out);
+
+/** Cierra el origen y libera el lector */
+void aeon_stream_close(aeon_stream_t *stream);
+
+/* ============================================================
+ * FRONT-END DE AUDIO
+ *
+ * Banco de filtros Goertzel en punto fijo que convierte PCM int16 en
+ * energías logarítmicas por banda, directamente en el vector de
+ * entrada del reservoir. Las muestras pasan por un ring buffer de una
+ * trama; cada hop_len muestras se aplica una ventana de Hann a la
+ * trama completa y se evalúan bins Goertzel separados dos bins de FFT
+ * (más si no caben en AEON_FRONTEND_MAX_BINS). Las bandas reparten
+ * [f_low, f_high) en escala mel y suman la potencia de sus bins. Cada
+ * salida es 1 + log2(potencia / fondo de escala) / rango, recortada a
+ * [0, 1]: un tono a fondo de escala dentro de la banda da ~1 y una
+ * energía range_db por debajo, 0.
+ *
+ * Todo el estado vive en aeon_frontend_t (sin memoria dinámica). El
+ * camino por muestra es entero; begin usa float una vez para los
+ * coeficientes y la ventana.
+ * ============================================================ */
+
+#define AEON_FRONTEND_MAX_BANDS 16
+#define AEON_FRONTEND_MAX_FRAME 512 /**< Muestras por trama */
+#define AEON_FRONTEND_MAX_BINS 64   /**< Bins Goertzel en total */
+
+/** Parámetros del front-end */
+typedef struct {
+  uint32_t sample_rate; /**< Hz */
+  uint16_t n_bands;     /**< Salidas por trama */
+  uint16_t frame_len;   /**< Muestras por ventana */
+  uint16_t hop_len;     /**< Muestras entre tramas */
+  uint16_t f_low;       /**< Borde inferior de la primera banda (Hz) */
+  uint16_t f_high;      /**< Borde superior de la última banda (Hz) */
+  uint8_t range_db;     /**< Rango dinámico hasta la salida 0 */
+} aeon_frontend_config_t;
+
+/** 8 kHz, 4 bandas, ventana de 32 ms cada 20 ms (50 tramas/s) */
+#define AEON_FRONTEND_CONFIG_DEFAULT {8000, 4, 256, 160, 300, 3400, 90}
+
+/** Estado del front-end */
+typedef struct {
+  aeon_frontend_config_t config;
+  int16_t coeff[AEON_FRONTEND_MAX_BINS];       /**< 2 cos(w), Q2.14 */
+  uint8_t band_end[AEON_FRONTEND_MAX_BANDS];   /**< Fin de los bins */
+  int16_t window[AEON_FRONTEND_MAX_FRAME / 2]; /**< Media Hann, Q1.15 */
+  int16_t ring[AEON_FRONTEND_MAX_FRAME];       /**< Última trama de PCM */
+  uint16_t head;      /**< Próxima escritura (= muestra más antigua) */
+  uint16_t filled;    /**< Muestras válidas en ring (hasta frame_len) */
+  uint16_t since_hop; /**< Muestras desde la última trama */
+  int32_t log_full;   /**< log2 de la potencia a fondo de escala, Q8.8 */
+  int32_t log_range;  /**< range_db en unidades log2, Q8.8 */
+  uint32_t frames;    /**< Tramas producidas */
+} aeon_frontend_t;
+
+/**
+ * @brief Prepara el front-end y vacía el ring buffer
+ *
+ * @return 0 si éxito, -1 si hay punteros nulos, -2 si la configuración
+ *         no es válida (bandas o trama fuera de rango, hop_len mayor que
+ *         la trama, bordes fuera de (0, sample_rate / 2), más bandas
+ *         que bins o bins tan cerca de 0 o de Nyquist que el estado
+ *         Goertzel desbordaría 32 bits)
+ */
+int aeon_frontend_begin(aeon_frontend_t *fe,
+                        const aeon_frontend_config_t *config);
+
+/**
+ * @brief Procesa n muestras de PCM
+ *
+ * Cada trama terminada escribe n_bands valores en out, una trama tras
+ * otra; con n <= hop_len sale como mucho una, lista para aeon_update.
+ * La primera trama sale al llenarse el ring buffer.
+ *
+ * @param out Espacio para n / hop_len + 1 tramas
+ * @return Tramas escritas, o -1 si hay punteros nulos
+ */
+int aeon_frontend_push(aeon_frontend_t *fe, const int16_t *pcm, uint32_t n,
+                       aeon_state_t *out);
+
+/* ============================================================
+ * CHECKPOINTS
+ *
+ * Log de solo añadir para sensores de vida larga: en vez de reescribir
+ * el modelo entero como aeon_save, cada checkpoint añade un registro
+ * con las secciones que han cambiado desde el anterior (estado, W_out,
+ * contadores). Certificado, W_in y reservoir van una sola vez, como
+ * semilla e identidad en la cabecera, y se regeneran al restaurar.
+ * Little-endian:
+ *
+ *   cabecera  0  "EONC"            4  u16 versión   6  u16 tamaño (56)
+ *             8  u16 neuronas     10  u16 entradas 12  u16 salidas
+ *            14  u16 escasez      16  u8 formato pesos
+ *            18  u16 versión de libAeon            20  u32 semilla
+ *            24  i64 nacimiento   32  hash (16)    48  f32 radio
+ *            52  u32 CRC-32
+ *   registro  0  "CKPT"  4  u32 secuencia  8  u32 secciones
+ *            12  u32 bytes de carga, carga, u32 CRC-32 del registro
+ *
+ * La carga sigue el orden de los bits: contadores (u32 muestras, u32
+ * sesiones, u8 flags, 3 de relleno, f32 fuga), estado y W_out densos.
+ * La versión 2 añade el radio espectral y la fuga; la 1 no se lee. Con
+ * AEON_USE_THREADS, aeon_checkpoint_save copia lo cambiado a un doble
+ * buffer y vuelve; un hilo escribe y hace fsync. Sin hilos se escribe
+ * al guardar.
+ * ============================================================ */
+
+#define AEON_CHECKPOINT_VERSION 2
+
+#define AEON_CHECKPOINT_COUNTERS 0x01 /**< Muestras, sesiones, flags, fuga */
+#define AEON_CHECKPOINT_STATE 0x02    /**< Estado del reservoir */
+#define AEON_CHECKPOINT_W_OUT 0x04    /**< Pesos de salida */
+#define AEON_CHECKPOINT_ALL 0x07
+
+/** Log de checkpoints abierto para añadir */
+typedef struct {
+  /* Escritos por el hilo: leer tras aeon_checkpoint_flush */
+  uint32_t sequence;  /**< Último registro en el log */
+  uint32_t records;   /**< Registros añadidos con este manejador */
+  uint32_t coalesced; /**< Checkpoints fundidos con el siguiente */
+  uint64_t bytes;     /**< Tamaño del log */
+  bool threaded;      /**< Escritura en segundo plano */
+
+  /* Interno */
+  void *file;       /**< FILE del log */
+  void *writer;     /**< Hilo y cerrojo (AEON_USE_THREADS) */
+  void *front;      /**< Instantánea que se está escribiendo */
+  void *back;       /**< Última instantánea pedida */
+  uint32_t pending; /**< Secciones de back sin escribir */
+  bool primed;      /**< back ya refleja el log */
+  int error;        /**< Primer error de escritura (pegajoso) */
+  aeon_allocator_t allocator;
+} aeon_checkpoint_t;
+
+/**
+ * @brief Abre un log para el núcleo
+ *
+ * Si el archivo no existe o está vacío se escribe la cabecera. Si ya
+ * es un log de este núcleo (misma semilla, nacimiento y forma), se
+ * descarta la cola que no supere el CRC y se sigue añadiendo.
+ *
+ * @param error 0, -1 punteros nulos, -2 no se abre, -3 error de E/S,
+ *        -4 no es un log válido, -5 log de otro núcleo, -6 sin memoria
+ *        o sin hilo (puede ser NULL)
+ * @return Log, o NULL si falla
+ */
+aeon_checkpoint_t *aeon_checkpoint_open(const char *filename,
+                                        const aeon_core_t *core,
+                                        const aeon_allocator_t *allocator,
+                                        int *error);
+
+/**
+ * @brief Encola un checkpoint del núcleo
+ *
+ * Compara con el último checkpoint y copia solo las secciones que
+ * difieren. El primero tras abrir las lleva todas. Si el hilo aún
+ * escribe el anterior, ambos salen en un único registro.
+ *
+ * @return Máscara AEON_CHECKPOINT_* de lo cambiado (0 si nada), -1 si
+ *         hay punteros nulos, -3 si falló una escritura anterior
+ */
+int aeon_checkpoint_save(aeon_checkpoint_t *ckpt, const aeon_core_t *core);
+
+/**
+ * @brief Espera a que lo encolado esté en disco
+ * @return 0, -1 si ckpt es NULL, -3 si falló una escritura
+ */
+int aeon_checkpoint_flush(aeon_checkpoint_t *ckpt);
+
+/** Escribe lo pendiente, cierra y libera; devuelve como flush */
+int aeon_checkpoint_close(aeon_checkpoint_t *ckpt);
+
+/**
+ * @brief Reconstruye el núcleo del último checkpoint consistente
+ *
+ * Regenera el reservoir desde la semilla de la cabecera y aplica en
+ * orden los registros hasta el primero incompleto o corrupto: cada
+ * sección queda como en el último registro válido que la lleva.
+ *
+ * @return Registros aplicados (0 = núcleo recién nacido), -1 punteros
+ *         nulos, -2 no se abre, -4 no es un log válido, -5 forma
+ *         distinta de la de compilación, -6 sin memoria
+ */
+int aeon_checkpoint_restore(aeon_core_t *core, const char *filename);
+
+/* ============================================================
+ * KERNELS SIMD
+ *
+ * Con punto fijo, los productos densos (W_in, W_out) y la tanh se
+ * ejecutan con el mejor backend disponible: AVX2 o SSE4.1 en x86
+ * (detección en tiempo de ejecución), NEON o SMLAD de Cortex-M DSP en
+ * ARM (según las banderas de compilación). Todos dan resultados bit a
+ * bit idénticos al backend "scalar".
+ *
+ * En float, W_in y las filas CSR del reservoir usan FMA ("avx2-fma" en
+ * x86, "neon-fma" en ARM) y ensanchan en registro los pesos f16/bf16
+ * de AEON_FLOAT_WEIGHTS. Coinciden con "scalar" a unos ULP; las
+ * igualdades exactas (lote frente a núcleo suelto) son las del escalar.
+ * ============================================================ */
+
+/** Nombre del backend activo ("scalar", "sse4.1", "avx2", "neon", "dsp",
+ *  "avx2-fma", "neon-fma") */
+const char *aeon_simd_backend(void);
+
+/**
+ * @brief Fuerza un backend (para benchmarks y tests)
+ *
+ * @param name Nombre del backend, o NULL para el mejor disponible
+ * @return 0 si éxito, -1 si el backend no está disponible
+ */
+int aeon_simd_select(const char *name);
+
+/* ============================================================
+ * ACTIVACIÓN
+ *
+ * "poly" es la activación histórica: x - x³/3 + x⁵/15, con las
+ * divisiones hechas como producto y desplazamiento (los resultados no
+ * cambian, pero sin división por hardware ya no se llama a la rutina
+ * de división). Satura a ±1 fuera de [-1, 1] en punto fijo y de
+ * [-2, 2] en float, con un salto en el borde. "lut" interpola una tabla
+ * de tanh en [0, 4) con 64 pasos por unidad; "exact" llama a tanhf.
+ *
+ * Cambiar la activación cambia los estados: W_out entrenado con una
+ * debe reentrenarse con otra.
+ * ============================================================ */
+
+/** Nombre de la activación activa ("poly", "lut" o "exact") */
+const char *aeon_tanh_backend(void);
+
+/**
+ * @brief Elige la activación
+ *
+ * @param name Nombre, o NULL para AEON_TANH_MODE
+ * @return 0 si éxito, -1 si no existe o AEON_TANH_RUNTIME es 0 y no es
+ *         la de compilación
+ */
+int aeon_tanh_select(const char *name);
+
+/** Error de una activación frente a tanhf */
+typedef struct {
+  float max_error;  /**< max |f(x) - tanhf(x)| */
+  float mean_error; /**< Media de |f(x) - tanhf(x)| */
+  float worst_x;    /**< x con el error máximo */
+} aeon_tanh_report_t;
+
+/**
+ * @brief Mide una activación en [-8, 8]
+ *
+ * En punto fijo recorre todos los Q8.8 del rango; en float, pasos de
+ * 1/4096. La activación activa no cambia.
+ *
+ * @param name Activación a medir (NULL = la activa)
+ * @return 0 si éxito, -1 si no existe
+ */
+int aeon_tanh_report(const char *name, aeon_tanh_report_t *report);
+
+/* ============================================================
+ * ESTADÍSTICAS Y TRAZAS
+ *
+ * Con AEON_ENABLE_STATS, las llamadas públicas de update, predict y
+ * entrenamiento miden su duración y los kernels cuentan casos numéricos
+ * límite: salidas de la activación en ±1, factorizaciones de Cholesky
+ * rechazadas por un pivote hundido y acumuladores Q8.8 a menos de 2x del
+ * desbordamiento de int32
+ * (en float, valores no finitos). Los contadores son globales y no
+ * atómicos: con varios hilos son aproximados.
+ * ============================================================ */
+
+/* Eventos de traza; los tres primeros son además las etapas medidas */
+#define AEON_EVENT_UPDATE 0          /**< value = ticks de la llamada */
+#define AEON_EVENT_PREDICT 1         /**< value = ticks de la llamada */
+#define AEON_EVENT_TRAIN 2           /**< value = ticks de la llamada */
+#define AEON_EVENT_TANH_SATURATION 3 /**< value = casos en la llamada */
+#define AEON_EVENT_PIVOT_CLAMP 4     /**< value = 1 por Cholesky fallida */
+#define AEON_EVENT_NEAR_MISS 5       /**< value = casos en la llamada */
+#define AEON_STAGE_COUNT 3
+
+/** Contadores acumulados desde aeon_stats_reset */
+typedef struct {
+  uint64_t calls[AEON_STAGE_COUNT];      /**< Llamadas por etapa */
+  uint64_t time_total[AEON_STAGE_COUNT]; /**< Ticks por etapa */
+  uint64_t time_max[AEON_STAGE_COUNT];   /**< Llamada más lenta */
+  uint64_t tanh_saturations;             /**< Activaciones en ±1 */
+  uint64_t pivot_clamps;                 /**< Factorizaciones rechazadas */
+  uint64_t overflow_near_misses;         /**< Acumuladores cerca de int32 */
+} aeon_stats_t;
+
+/** Reloj y receptor de trazas */
+typedef struct {
+  /** Ticks monotónicos (NULL = nanosegundos del sistema si los hay) */
+  uint64_t (*clock)(void *ctx);
+  /**
+   * Se llama al terminar cada etapa, primero con los casos numéricos
+   * que tuvo (solo los distintos de cero) y luego con su duración
+   */
+  void (*trace)(int event, uint64_t value, void *ctx);
+  void *ctx;
+} aeon_hooks_t;
+
+/**
+ * @brief Copia los contadores
+ *
+ * @return 0 si éxito, -1 si stats es NULL, -2 si la librería se compiló
+ *         sin AEON_ENABLE_STATS (stats queda a cero)
+ */
+int aeon_stats_get(aeon_stats_t *stats);
+
+/** Pone a cero los contadores */
+void aeon_stats_reset(void);
+
+/** Instala reloj y trazas (NULL = reloj del sistema y sin trazas) */
+void aeon_stats_hooks(const aeon_hooks_t *hooks);
+
+/** Nombre de un evento ("update", "tanh_saturation"...), o NULL */
+const char *aeon_event_name(int event);
+
+/* ============================================================
+ * FUNCIONES DE UTILIDAD
+ * ============================================================ */
+
+/** Activación tanh activa (ver aeon_tanh_select) */
+aeon_state_t aeon_tanh_approx(aeon_state_t x);
+
+/** Generador de números pseudo-aleatorios (LCG) */
+uint32_t aeon_random(uint32_t *state);
+
+/** Versión de la librería */
+#define AEON_VERSION_MAJOR 1
+#define AEON_VERSION_MINOR 0
+#define AEON_VERSION ((AEON_VERSION_MAJOR << 8) | AEON_VERSION_MINOR)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBAEON_H */
@@ -0,0 +1,32 @@
+#!/bin/sh
+# sync_libaeon.sh - Copia en src/libAeon los fuentes de phase2-core
+#
+# Arduino solo compila lo que hay dentro de la carpeta de la librería,
+# así que EonEmbedded lleva su propia copia del núcleo (generador,
+# Ridge, activaciones, backends SIMD/DSP y front-end Goertzel). Tras
+# tocar libAeon, ejecutar este script y commitear la copia junto al
+# cambio. Con --check solo comprueba que la copia está al día.
+
+set -e
+here=$(cd "$(dirname "$0")" && pwd)
+core="$here/../../phase2-core/libAeon"
+dest="$here/src/libAeon"
+files="libAeon.h aeon_kernels.h libAeon.c aeon_simd.c aeon_tanh.c
+       aeon_stats.c aeon_frontend.c"
+
+if [ "$1" = "--check" ]; then
+  stale=0
+  for f in $files; do
+    if ! cmp -s "$core/$f" "$dest/$f"; then
+      echo "src/libAeon/$f no coincide con phase2-core" >&2
+      stale=1
+    fi
+  done
+  exit $stale
+fi
+
+mkdir -p "$dest"
+for f in $files; do
+  cp "$core/$f" "$dest/$f"
+done
+echo "src/libAeon sincronizado con phase2-core"
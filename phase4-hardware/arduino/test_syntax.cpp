@@ -1,3 +1,3 @@
-#include "Aeon.h"
+#include "src/Aeon.h"
 #include "../esp32/AeonESP32.h"
 int main(){return 0;}
@@ -5,6 +5,9 @@
  * - Enviar predicciones por HTTP
  * - Recibir datos de sensores
  * - Sincronizar con otros nodos (Mente Colectiva)
+ * - Red asíncrona en una tarea FreeRTOS (predicciones en lote, pesos en
+ *   streaming) para que update() nunca espere al WiFi
+ * - Pipeline de doble núcleo: muestreo ADC en uno, reservoir en el otro
  * - Sistema de Voluntad Verdadera (Thelema)
  * - Sistema Medium: Canalización del ruido universal
  *
@@ -26,9 +29,18 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <WiFi.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#if defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+#define AEON_HAS_CONTINUOUS_ADC 1 // analogContinuous*() con DMA
+#else
+#define AEON_HAS_CONTINUOUS_ADC 0
+#endif
 
 // Incluir librería base
-#include "../arduino/Aeon.h"
+#include "../arduino/src/Aeon.h"
 
 // =============================================================================
 // SISTEMA DE VOLUNTAD VERDADERA (THELEMA)
@@ -83,6 +95,110 @@ struct MediumConfig {
   bool useRF;                    // Usar ruido RF adicional (ESP32 WiFi)
 };
 
+// =============================================================================
+// RED ASÍNCRONA
+// =============================================================================
+
+#ifndef AEON_NET_QUEUE
+#define AEON_NET_QUEUE 64 // Predicciones en espera (ring buffer)
+#endif
+
+#ifndef AEON_NET_BATCH
+#define AEON_NET_BATCH 32 // Predicciones por trama binaria
+#endif
+
+#ifndef AEON_NET_STACK
+#define AEON_NET_STACK 4096 // Pila de la tarea de red (bytes)
+#endif
+
+#define AEON_NET_TIMEOUT_MS 2000   // Límite para recibir los pesos
+#define AEON_SYNC_MAGNITUDE 128    // |W_out| al restaurar 1 bit (0.5 en Q8.8)
+#define AEON_PACKET_PREDICTIONS 0x20 // Tipo de trama de predicciones
+
+/**
+ * Cola lock-free de un productor y un consumidor.
+ *
+ * Cada índice lo escribe un solo lado; acquire/release ordena los datos
+ * entre núcleos. Guarda N - 1 elementos.
+ */
+template <typename T, uint16_t N> class AeonSpscQueue {
+public:
+  bool push(const T &item) {
+    uint16_t head = _head;
+    uint16_t next = (uint16_t)((head + 1) % N);
+    if (next == __atomic_load_n(&_tail, __ATOMIC_ACQUIRE))
+      return false; // Llena
+    _items[head] = item;
+    __atomic_store_n(&_head, next, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  bool pop(T &item) {
+    uint16_t tail = _tail;
+    if (tail == __atomic_load_n(&_head, __ATOMIC_ACQUIRE))
+      return false; // Vacía
+    item = _items[tail];
+    __atomic_store_n(&_tail, (uint16_t)((tail + 1) % N), __ATOMIC_RELEASE);
+    return true;
+  }
+
+  uint16_t size() const {
+    uint16_t head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+    uint16_t tail = __atomic_load_n(&_tail, __ATOMIC_ACQUIRE);
+    return (uint16_t)((head + N - tail) % N);
+  }
+
+private:
+  T _items[N];
+  uint16_t _head = 0; // Solo lo escribe push()
+  uint16_t _tail = 0; // Solo lo escribe pop()
+};
+
+/**
+ * Predicción en cola (8 bytes en la trama, little-endian)
+ */
+struct PredictionRecord {
+  uint32_t timestampMs;
+  int16_t input;      // Q8.8
+  int16_t prediction; // Q8.8
+};
+
+// =============================================================================
+// PIPELINE DE DOBLE NÚCLEO
+// =============================================================================
+
+#ifndef AEON_PIPELINE_QUEUE
+#define AEON_PIPELINE_QUEUE 256 // Muestras en vuelo entre núcleos
+#endif
+
+#define AEON_PIPELINE_STACK 4096 // Pila de cada tarea (bytes)
+#define AEON_RF_REFRESH_MS 100   // RSSI en caché: WiFi.RSSI() es lento
+
+/**
+ * Configuración del pipeline de muestreo
+ */
+struct PipelineConfig {
+  uint8_t sensorPin;       // Pin de la señal (entrada del reservoir)
+  uint32_t sampleRateHz;   // Muestras por segundo (ej. 8000 en audio)
+  bool continuousAdc;      // ADC continuo por DMA (Arduino-ESP32 >= 3.0)
+  BaseType_t samplingCore; // Núcleo del muestreo (default: 0)
+  BaseType_t updateCore;   // Núcleo del reservoir (default: 1)
+};
+
+/**
+ * Lectura cruda del ADC (12 bits) que viaja entre los núcleos
+ */
+struct AdcSample {
+  uint16_t sensor;
+  uint16_t entropy; // Promedio de samplesPerReading lecturas
+};
+
+/**
+ * Recibe cada predicción del pipeline, en la tarea del reservoir
+ */
+typedef void (*AeonPipelineCallback)(float input, float prediction,
+                                     void *ctx);
+
 class AeonESP32 : public Aeon {
 public:
   AeonESP32(uint8_t reservoirSize = 16, DataDomain genesisDomain = DOMAIN_GENERIC) 
@@ -153,12 +269,7 @@ public:
     
     // Opcionalmente mezclar con ruido RF del WiFi
     if (_mediumConfig.useRF && WiFi.status() == WL_CONNECTED) {
-      int32_t rssi = WiFi.RSSI();
-      // RSSI típicamente -30 a -90 dBm, normalizar a [0, 1]
-      float rfNoise = ((float)rssi + 90.0) / 60.0;
-      rfNoise = constrain(rfNoise, 0.0, 1.0);
-      // Mezclar: 70% pin físico, 30% RF
-      normalized = normalized * 0.7 + rfNoise * 0.3;
+      normalized = _blendRF(normalized, WiFi.RSSI());
     }
     
     _lastUniverseReading = normalized;
@@ -174,23 +285,98 @@ public:
    * 
    * Nada es artificial aquí. Todo es natural.
    * 
-   * @param input Entrada de datos del sensor
-   * @return Nuevo estado del reservorio
+   * @param input Entrada de datos del sensor (Q8.8)
+   * @return Predicción tras el paso (Q8.8)
    */
   int16_t updateWithUniverseInfluence(int16_t input) {
     // 1. Leer la vibración del universo
     float universe = readUniverseBackground();
     
-    // 2. Convertir a Q8.8 (-128 a 127 rango, centrado en 0)
-    int16_t universeQ8 = (int16_t)((universe - 0.5) * 256.0 * _mediumConfig.influenceWeight);
-    
-    // 3. Mezclar entrada con influencia universal
-    int32_t influencedInput = (int32_t)input + universeQ8;
-    influencedInput = constrain(influencedInput, -32768, 32767);
+    // 2-3. Mezclar entrada con influencia universal
+    int16_t influencedInput = _influence(input, universe);
     
     // 4. Actualizar reservorio con la entrada influenciada
-    return this->update((int16_t)influencedInput);
+    this->update(this->_toFloat(influencedInput));
+    return this->_toFixed(this->predict());
   }
+
+  // =========================================================================
+  // PIPELINE DE DOBLE NÚCLEO
+  // =========================================================================
+
+  /**
+   * Separa el muestreo del reservoir en dos tareas fijadas a núcleos
+   * distintos, unidas por una cola SPSC lock-free.
+   *
+   * La tarea de muestreo lee sensorPin y entropyPin a sampleRateHz: por
+   * DMA si continuousAdc (el ADC promedia samplesPerReading conversiones)
+   * o con analogRead() al ritmo de un esp_timer periódico, bloqueada
+   * entre disparos. La tarea del reservoir aplica la influencia
+   * universal, llama a update()/predict() y entrega cada predicción a
+   * onPrediction. Si el reservoir no da abasto o el muestreo pierde un
+   * disparo, la muestra se descarta.
+   *
+   * @return false si ya está en marcha o no se pudo arrancar, incluido
+   *         un ADC o temporizador que rechace la frecuencia pedida
+   *         (esp_timer admite periodos de 50 us o más)
+   */
+  bool startPipeline(const PipelineConfig &config,
+                     AeonPipelineCallback onPrediction = NULL,
+                     void *ctx = NULL) {
+    if (_pipeRunning || config.sampleRateHz == 0)
+      return false;
+    _pipeConfig = config;
+    _pipeCallback = onPrediction;
+    _pipeCtx = ctx;
+    _pipeRssi = 0;
+    _pipeRunning = true;
+    pinMode(config.sensorPin, INPUT);
+
+    TaskHandle_t update = NULL;
+    if (xTaskCreatePinnedToCore(_pipeUpdateEntry, "aeon_update",
+                                AEON_PIPELINE_STACK, this, 2, &update,
+                                config.updateCore) != pdPASS) {
+      _pipeRunning = false;
+      return false;
+    }
+    _pipeUpdateTask = update;
+
+    // El muestreo prepara su ADC o temporizador y avisa del resultado
+    _pipeSampling = true;
+    _pipeStartState = 0;
+    if (xTaskCreatePinnedToCore(_pipeSampleEntry, "aeon_sample",
+                                AEON_PIPELINE_STACK, this, 3, NULL,
+                                config.samplingCore) != pdPASS) {
+      _pipeSampling = false;
+      stopPipeline();
+      return false;
+    }
+    while (_pipeStartState == 0)
+      vTaskDelay(1);
+    if (_pipeStartState < 0) {
+      stopPipeline();
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * Detiene el pipeline y espera a que ambas tareas terminen
+   */
+  void stopPipeline() {
+    _pipeRunning = false;
+    while (_pipeSampling || _pipeUpdateTask != NULL) {
+      if (_pipeUpdateTask != NULL)
+        xTaskNotifyGive(_pipeUpdateTask);
+      vTaskDelay(1);
+    }
+  }
+
+  /** Muestras procesadas por el reservoir */
+  uint32_t getPipelineSamples() { return _pipeSamples; }
+
+  /** Muestras descartadas con la cola llena o por disparos perdidos */
+  uint32_t getDroppedSamples() { return _pipeDropped; }
   
   /**
    * Obtiene la última lectura del universo.
@@ -411,8 +597,15 @@ public:
 
   /**
    * Enviar predicción a servidor
+   *
+   * Con la red asíncrona en marcha (startNetwork) solo encola la
+   * predicción y serverUrl se ignora: la tarea de red la envía en lote a
+   * la URL de startNetwork. Sin ella hace un POST JSON bloqueante.
    */
   bool sendPrediction(const char *serverUrl, float input, float prediction) {
+    if (_netTask != NULL)
+      return queuePrediction(input, prediction);
+
     if (WiFi.status() != WL_CONNECTED)
       return false;
 
@@ -435,6 +628,100 @@ public:
     return code == 200;
   }
 
+  /**
+   * Arranca la red asíncrona en una tarea FreeRTOS.
+   *
+   * Las predicciones encoladas se envían por POST a serverUrl como una
+   * trama binaria (ver docs/protocol_spec.md de la fase 6) cuando hay
+   * AEON_NET_BATCH o pasa flushMs. Si peerUrl no es NULL, los pesos se
+   * sincronizan cada syncIntervalMs (0 = solo con requestSync()).
+   *
+   * @param core Núcleo de la tarea (0 = el del WiFi, loop() corre en el 1)
+   * @return false si la tarea ya existe o no se pudo crear
+   */
+  bool startNetwork(const char *serverUrl, const char *peerUrl = NULL,
+                    uint32_t syncIntervalMs = 0, uint32_t flushMs = 1000,
+                    BaseType_t core = 0) {
+    if (_netTask != NULL)
+      return false;
+    _netServerUrl = serverUrl ? serverUrl : "";
+    _netPeerUrl = peerUrl ? String(peerUrl) + "/weights/binary" : "";
+    _netSyncIntervalMs = syncIntervalMs;
+    _netFlushMs = flushMs;
+    _netStop = false;
+    _netRunning = true;
+    TaskHandle_t task = NULL;
+    if (xTaskCreatePinnedToCore(_netTaskEntry, "aeon_net", AEON_NET_STACK,
+                                this, 1, &task, core) != pdPASS) {
+      _netRunning = false;
+      return false;
+    }
+    _netTask = task;
+    return true;
+  }
+
+  /**
+   * Predicción con el último W_out sincronizado.
+   *
+   * La tarea de red no toca W_out: deja los pesos recibidos en
+   * _netPending y se copian aquí, en la tarea que predice.
+   */
+  float predict() {
+    _applySyncedWeights();
+    return Aeon::predict();
+  }
+
+  /**
+   * Detiene la tarea de red (las predicciones en cola se conservan).
+   *
+   * La tarea termina sola al despertar: si está en mitad de un envío o
+   * de una descarga, espera a que HTTPClient cierre la conexión.
+   */
+  void stopNetwork() {
+    if (_netTask == NULL)
+      return;
+    TaskHandle_t task = _netTask;
+    _netTask = NULL;
+    _netStop = true;
+    xTaskNotifyGive(task);
+    while (_netRunning)
+      vTaskDelay(1);
+    _netStop = false; // syncWeights() bloqueante vuelve a descargar
+  }
+
+  /**
+   * Encola una predicción sin bloquear.
+   * @return false si la cola está llena (se cuenta como descartada)
+   */
+  bool queuePrediction(float input, float prediction) {
+    PredictionRecord record;
+    record.timestampMs = millis();
+    record.input = _toQ8(input);
+    record.prediction = _toQ8(prediction);
+    if (!_predictions.push(record)) {
+      _droppedPredictions++;
+      return false;
+    }
+    if (_netTask != NULL && _predictions.size() >= AEON_NET_BATCH)
+      xTaskNotifyGive(_netTask);
+    return true;
+  }
+
+  /**
+   * Pide a la tarea de red una sincronización de pesos inmediata
+   */
+  void requestSync() {
+    _netSyncRequested = true;
+    if (_netTask != NULL)
+      xTaskNotifyGive(_netTask);
+  }
+
+  /** Predicciones descartadas por cola llena o envío fallido */
+  uint32_t getDroppedPredictions() { return _droppedPredictions; }
+
+  /** Sincronizaciones de pesos recibidas completas */
+  uint32_t getSyncCount() { return _syncCount; }
+
   /**
    * Obtener pesos comprimidos (para enviar a otros nodos)
    * Protocolo: 1-Bit Weight Exchange
@@ -445,6 +732,7 @@ public:
     if (bufferSize < needed)
       return 0;
 
+    _applySyncedWeights();
     _quantizeWOut(buffer);
     return needed;
   }
@@ -452,65 +740,389 @@ public:
   /**
    * Obtener pesos de otro nodo (para Mente Colectiva)
    * Protocolo: 1-Bit Weight Exchange
+   *
+   * Con la red asíncrona en marcha solo pide la sincronización a la tarea
+   * (que usa el peerUrl de startNetwork) y no espera. Sin ella bloquea
+   * hasta recibir los pesos o AEON_NET_TIMEOUT_MS.
    */
   bool syncWeights(const char *peerUrl) {
-    if (WiFi.status() != WL_CONNECTED)
-      return false;
+    if (_netTask != NULL) {
+      requestSync();
+      return true;
+    }
+    bool ok = _fetchWeights(String(peerUrl) + "/weights/binary");
+    _applySyncedWeights();
+    return ok;
+  }
+
+  /**
+   * Obtener ID único del chip
+   */
+  String getChipId() { return String((uint32_t)ESP.getEfuseMac(), HEX); }
 
+private:
+  // Vector de Voluntad Verdadera (Thelema)
+  TrueWillVector _trueWill;
+  
+  // Configuración del Medium
+  MediumConfig _mediumConfig;
+  float _lastUniverseReading = 0.0;
+
+  // Red asíncrona: todo preasignado, la tarea no reserva memoria
+  AeonSpscQueue<PredictionRecord, AEON_NET_QUEUE> _predictions;
+  uint8_t _netFrame[10 + AEON_NET_BATCH * 8];
+  aeon_weight_t _netWeights[AEON_MAX_RESERVOIR]; // Descarga en curso
+  aeon_weight_t _netPending[AEON_MAX_RESERVOIR]; // Completo, sin aplicar
+  volatile bool _netPendingReady = false;
+  portMUX_TYPE _netMux = portMUX_INITIALIZER_UNLOCKED; // Guarda _netPending
+  TaskHandle_t volatile _netTask = NULL;
+  volatile bool _netStop = false;
+  volatile bool _netRunning = false; // Hasta que la tarea termina
+  String _netServerUrl;
+  String _netPeerUrl;
+  uint32_t _netSyncIntervalMs = 0;
+  uint32_t _netFlushMs = 1000;
+  volatile bool _netSyncRequested = false;
+  volatile uint32_t _droppedPredictions = 0;
+  volatile uint32_t _syncCount = 0;
+
+  // Pipeline de doble núcleo
+  AeonSpscQueue<AdcSample, AEON_PIPELINE_QUEUE> _samples;
+  PipelineConfig _pipeConfig;
+  AeonPipelineCallback _pipeCallback = NULL;
+  void *_pipeCtx = NULL;
+  TaskHandle_t volatile _pipeUpdateTask = NULL;
+  volatile bool _pipeRunning = false;
+  volatile bool _pipeSampling = false;   // Hasta que la tarea termina
+  volatile int8_t _pipeStartState = 0; // 0 preparando, 1 en marcha, -1 fallo
+  volatile int32_t _pipeRssi = 0; // 0 = sin lectura RF
+  volatile uint32_t _pipeSamples = 0;
+  volatile uint32_t _pipeDropped = 0;
+
+  /**
+   * Mezcla 70% pin físico y 30% RF (RSSI típico de -30 a -90 dBm)
+   */
+  static float _blendRF(float normalized, int32_t rssi) {
+    float rfNoise = ((float)rssi + 90.0) / 60.0;
+    rfNoise = constrain(rfNoise, 0.0, 1.0);
+    return normalized * 0.7 + rfNoise * 0.3;
+  }
+
+  /**
+   * Suma la influencia universal (centrada en 0, Q8.8) a la entrada
+   */
+  int16_t _influence(int16_t input, float universe) {
+    int16_t universeQ8 =
+        (int16_t)((universe - 0.5) * 256.0 * _mediumConfig.influenceWeight);
+    int32_t influenced = (int32_t)input + universeQ8;
+    return (int16_t)constrain(influenced, -32768, 32767);
+  }
+
+  static void _pipeSampleEntry(void *self) {
+    static_cast<AeonESP32 *>(self)->_sampleLoop();
+  }
+
+  static void _pipeUpdateEntry(void *self) {
+    static_cast<AeonESP32 *>(self)->_updateLoop();
+  }
+
+  void _pushSample(uint16_t sensor, uint16_t entropy) {
+    AdcSample sample = {sensor, entropy};
+    if (_samples.push(sample))
+      xTaskNotifyGive(_pipeUpdateTask); // Vive hasta que el muestreo acaba
+    else
+      _pipeDropped++;
+  }
+
+  /**
+   * Tarea de muestreo: DMA continuo o analogRead() a ritmo de reloj
+   */
+  void _sampleLoop() {
+#if AEON_HAS_CONTINUOUS_ADC
+    if (_pipeConfig.continuousAdc) {
+      _continuousLoop();
+      return;
+    }
+#endif
+    _timedLoop();
+  }
+
+  /** Despierta a la tarea de muestreo (que va en arg) en cada periodo */
+  static void _pipeTimerEntry(void *task) {
+    xTaskNotifyGive((TaskHandle_t)task);
+  }
+
+  /**
+   * Muestreo con analogRead(): la tarea duerme hasta cada disparo del
+   * esp_timer, así que el núcleo queda libre para IDLE (y su watchdog)
+   * y para la tarea de red entre muestras, a cualquier frecuencia.
+   */
+  void _timedLoop() {
+    esp_timer_create_args_t args = {};
+    args.callback = _pipeTimerEntry;
+    args.arg = xTaskGetCurrentTaskHandle();
+    args.name = "aeon_sample";
+    esp_timer_handle_t timer = NULL;
+    bool ok = esp_timer_create(&args, &timer) == ESP_OK;
+    if (ok && esp_timer_start_periodic(
+                  timer, 1000000ULL / _pipeConfig.sampleRateHz) != ESP_OK) {
+      esp_timer_delete(timer);
+      ok = false;
+    }
+    _pipeStartState = ok ? 1 : -1;
+
+    uint32_t lastRf = 0;
+    while (ok && _pipeRunning) {
+      uint32_t due = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+      if (due == 0)
+        continue; // Sin disparos: solo revisar _pipeRunning
+      if (due > 1)
+        _pipeDropped += due - 1; // Atrasado: no intentar recuperar
+
+      uint32_t sum = 0;
+      for (int i = 0; i < _mediumConfig.samplesPerReading; i++)
+        sum += analogRead(_mediumConfig.entropyPin);
+      uint16_t entropy = (uint16_t)(sum / _mediumConfig.samplesPerReading);
+      _pushSample((uint16_t)analogRead(_pipeConfig.sensorPin), entropy);
+
+      if (millis() - lastRf >= AEON_RF_REFRESH_MS) {
+        _refreshRssi();
+        lastRf = millis();
+      }
+    }
+    if (ok) {
+      esp_timer_stop(timer);
+      esp_timer_delete(timer);
+    }
+    _pipeSampling = false;
+    vTaskDelete(NULL);
+  }
+
+#if AEON_HAS_CONTINUOUS_ADC
+  /**
+   * Muestreo por DMA: el ADC convierte ambos pines samplesPerReading
+   * veces por muestra y analogContinuousRead() bloquea hasta cada trama
+   */
+  void _continuousLoop() {
+    uint8_t pins[2] = {_pipeConfig.sensorPin, _mediumConfig.entropyPin};
+    uint32_t conversions = _mediumConfig.samplesPerReading;
+    bool configured = analogContinuous(
+        pins, 2, conversions, _pipeConfig.sampleRateHz * 2 * conversions,
+        NULL);
+    bool ok = configured && analogContinuousStart();
+    _pipeStartState = ok ? 1 : -1;
+
+    uint32_t lastRf = 0;
+    adc_continuous_data_t *result = NULL;
+    while (ok && _pipeRunning) {
+      if (analogContinuousRead(&result, 100))
+        _pushSample((uint16_t)result[0].avg_read_raw,
+                    (uint16_t)result[1].avg_read_raw);
+      if (millis() - lastRf >= AEON_RF_REFRESH_MS) {
+        _refreshRssi();
+        lastRf = millis();
+      }
+    }
+    if (ok)
+      analogContinuousStop();
+    if (configured)
+      analogContinuousDeinit();
+    _pipeSampling = false;
+    vTaskDelete(NULL);
+  }
+#endif
+
+  void _refreshRssi() {
+    _pipeRssi = (_mediumConfig.useRF && WiFi.status() == WL_CONNECTED)
+                    ? WiFi.RSSI()
+                    : 0;
+  }
+
+  /**
+   * Tarea del reservoir: consume muestras en cuanto llegan
+   */
+  void _updateLoop() {
+    AdcSample sample;
+    while (_pipeRunning) {
+      if (!_samples.pop(sample)) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+        continue;
+      }
+      float universe = sample.entropy / 4095.0;
+      int32_t rssi = _pipeRssi;
+      if (rssi != 0)
+        universe = _blendRF(universe, rssi);
+      _lastUniverseReading = universe;
+
+      float input = sample.sensor / 4095.0;
+      int16_t influenced = _influence(this->_toFixed(input), universe);
+      this->update(this->_toFloat(influenced));
+      float prediction = this->predict();
+      _pipeSamples++;
+      if (_pipeCallback != NULL)
+        _pipeCallback(input, prediction, _pipeCtx);
+    }
+    while (_pipeSampling)
+      vTaskDelay(1); // El muestreo aún puede notificar a esta tarea
+    _pipeUpdateTask = NULL;
+    vTaskDelete(NULL);
+  }
+
+  static int16_t _toQ8(float x) {
+    return (int16_t)constrain(x * 256.0f, -32768.0f, 32767.0f);
+  }
+
+  static void _netTaskEntry(void *self) {
+    static_cast<AeonESP32 *>(self)->_netLoop();
+  }
+
+  /**
+   * Bucle de la tarea de red: despierta con cada lote lleno o
+   * requestSync(), y al menos cada 10 ms para revisar los plazos.
+   */
+  void _netLoop() {
+    uint32_t lastFlush = millis();
+    uint32_t lastSync = lastFlush;
+    while (!_netStop) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+      if (_netStop)
+        break;
+      uint32_t now = millis();
+
+      uint16_t queued = _predictions.size();
+      if (queued >= AEON_NET_BATCH ||
+          (queued > 0 && now - lastFlush >= _netFlushMs)) {
+        _flushPredictions();
+        lastFlush = now;
+      }
+
+      bool due = _netSyncIntervalMs > 0 && now - lastSync >= _netSyncIntervalMs;
+      if ((_netSyncRequested || due) && _netPeerUrl.length() > 0) {
+        _netSyncRequested = false;
+        _fetchWeights(_netPeerUrl);
+        lastSync = now;
+      }
+    }
+    _netRunning = false;
+    vTaskDelete(NULL);
+  }
+
+  /**
+   * Envía hasta AEON_NET_BATCH predicciones en una trama:
+   * "EON", tipo 0x20, chip ID (u32), número (u16) y registros de 8 bytes.
+   */
+  void _flushPredictions() {
+    uint16_t count = 0;
+    PredictionRecord r;
+    while (count < AEON_NET_BATCH && _predictions.pop(r)) {
+      uint8_t *p = &_netFrame[10 + count * 8];
+      memcpy(p, &r.timestampMs, 4); // ESP32 es little-endian
+      memcpy(p + 4, &r.input, 2);
+      memcpy(p + 6, &r.prediction, 2);
+      count++;
+    }
+    if (count == 0)
+      return;
+
+    uint32_t chipId = (uint32_t)ESP.getEfuseMac();
+    _netFrame[0] = 'E';
+    _netFrame[1] = 'O';
+    _netFrame[2] = 'N';
+    _netFrame[3] = AEON_PACKET_PREDICTIONS;
+    memcpy(&_netFrame[4], &chipId, 4);
+    memcpy(&_netFrame[8], &count, 2);
+
+    if (WiFi.status() != WL_CONNECTED) {
+      _droppedPredictions += count;
+      return;
+    }
     HTTPClient http;
-    // Request binary weights directly (assuming endpoint handles this)
-    http.begin(String(peerUrl) + "/weights/binary");
+    http.begin(_netServerUrl);
+    http.addHeader("Content-Type", "application/octet-stream");
+    int code = http.POST(_netFrame, 10 + count * 8);
+    http.end();
+    if (code != 200)
+      _droppedPredictions += count;
+  }
 
-    int code = http.GET();
-    if (code != 200) {
-      http.end();
+  /**
+   * GET de los pesos 1-bit, decodificados a _netWeights según llegan;
+   * solo si llegan todos pasan a _netPending para el próximo predict().
+   */
+  bool _fetchWeights(const String &url) {
+    if (WiFi.status() != WL_CONNECTED)
       return false;
-    }
 
-    // Get payload as bytes
-    // Note: In real ESP32 usage we should stream this if large, but
-    // for small reservoir (e.g. 16 neuronas -> 2 bytes) String is fine or
-    // buffering. However, HTTPClient has getStream().
-    int len = http.getSize();
-    if (len <= 0) {
+    HTTPClient http;
+    http.begin(url);
+    if (http.GET() != 200) {
       http.end();
       return false;
     }
 
-    // Buffer for compressed data
-    uint8_t *buffer = (uint8_t *)malloc(len);
-    if (!buffer) {
+    size_t needed = (this->_size + 7) / 8;
+    int len = http.getSize(); // -1 si es chunked
+    if (len >= 0 && (size_t)len < needed) {
       http.end();
       return false;
     }
 
     WiFiClient *stream = http.getStreamPtr();
-    if (stream->available()) {
-      stream->readBytes(buffer, len);
+    size_t got = 0;
+    uint8_t chunk[16];
+    unsigned long start = millis();
+    while (got < needed && !_netStop &&
+           millis() - start < AEON_NET_TIMEOUT_MS) {
+      int avail = stream->available();
+      if (avail <= 0) {
+        if (!http.connected())
+          break;
+        delay(1); // Cede la CPU mientras llegan más bytes
+        continue;
+      }
+      size_t want = min(sizeof(chunk), needed - got);
+      size_t n = stream->readBytes(chunk, min(want, (size_t)avail));
+      _decodeWeights(chunk, n, got * 8);
+      got += n;
     }
-
-    // Dequantize and update W_out directly
-    // Using a fixed magnitude for 1-bit restoration (e.g. 32 approx 0.5 in
-    // Q?.?)
-    _dequantizeToWOut(buffer, this->_size, 32);
-
-    free(buffer);
     http.end();
+    if (got < needed)
+      return false;
+
+    portENTER_CRITICAL(&_netMux);
+    memcpy(_netPending, _netWeights, this->_size * sizeof(aeon_weight_t));
+    _netPendingReady = true;
+    portEXIT_CRITICAL(&_netMux);
+    _syncCount++;
     return true;
   }
 
   /**
-   * Obtener ID único del chip
+   * Copia a W_out los pesos sincronizados pendientes, si los hay
    */
-  String getChipId() { return String((uint32_t)ESP.getEfuseMac(), HEX); }
+  void _applySyncedWeights() {
+    if (!_netPendingReady)
+      return;
+    portENTER_CRITICAL(&_netMux);
+    memcpy(this->_W_out, _netPending, this->_size * sizeof(aeon_weight_t));
+    _netPendingReady = false;
+    portEXIT_CRITICAL(&_netMux);
+  }
 
-private:
-  // Vector de Voluntad Verdadera (Thelema)
-  TrueWillVector _trueWill;
-  
-  // Configuración del Medium
-  MediumConfig _mediumConfig;
-  float _lastUniverseReading = 0.0;
+  /**
+   * Decodifica bytes de signos a partir del peso `first`
+   */
+  void _decodeWeights(const uint8_t *bytes, size_t n, size_t first) {
+    for (size_t k = 0; k < n; k++) {
+      for (int j = 0; j < 8; j++) {
+        size_t i = first + k * 8 + j;
+        if (i >= this->_size)
+          return;
+        _netWeights[i] = (bytes[k] & (1 << j)) ? AEON_SYNC_MAGNITUDE
+                                               : -AEON_SYNC_MAGNITUDE;
+      }
+    }
+  }
 
   /**
    * Inicializa el sistema de Voluntad Verdadera
@@ -544,25 +1156,6 @@ private:
     pinMode(_mediumConfig.entropyPin, INPUT);
   }
 
-  /**
-   * Descomprime 1-bit weights y actualiza W_out localmente
-   */
-  void _dequantizeToWOut(const uint8_t *input, int count, int8_t magnitude) {
-    if (!input || count > AEON_MAX_RESERVOIR)
-      return;
-
-    for (int i = 0; i < count; i++) {
-      int byte_idx = i / 8;
-      int bit_idx = i % 8;
-
-      if (input[byte_idx] & (1 << bit_idx)) {
-        this->_W_out[i] = magnitude;
-      } else {
-        this->_W_out[i] = -magnitude;
-      }
-    }
-  }
-
   /**
    * Comprime W_out a 1-bit por peso
    */
@@ -0,0 +1,59 @@
+/**
+ * ESP32 Demo: Pipeline de doble núcleo
+ *
+ * El núcleo 0 muestrea un micrófono/acelerómetro analógico a 8 kHz (DMA
+ * con Arduino-ESP32 >= 3.0) y el núcleo 1 actualiza el reservoir con
+ * cada muestra. loop() queda libre y solo informa.
+ *
+ * (c) 2024 SenseLab - Build with Sense
+ */
+
+#include "AeonESP32.h"
+
+const uint8_t SENSOR_PIN = 34;
+const uint32_t SAMPLE_RATE_HZ = 8000;
+
+AeonESP32 esn(16, DOMAIN_AUDIO);
+
+volatile float lastPrediction = 0;
+
+// Corre en la tarea del reservoir (núcleo 1): debe ser breve
+void onPrediction(float input, float prediction, void *ctx) {
+  (void)input;
+  (void)ctx;
+  lastPrediction = prediction;
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+  Serial.println(F("\n=== Proyecto Eón - Pipeline Doble Núcleo ==="));
+
+  esn.begin();
+
+  PipelineConfig config;
+  config.sensorPin = SENSOR_PIN;
+  config.sampleRateHz = SAMPLE_RATE_HZ;
+  config.continuousAdc = true;
+  config.samplingCore = 0;
+  config.updateCore = 1;
+
+  if (!esn.startPipeline(config, onPrediction)) {
+    Serial.println(F("No se pudo arrancar el pipeline"));
+  }
+}
+
+void loop() {
+  static uint32_t lastCount = 0;
+  uint32_t count = esn.getPipelineSamples();
+
+  Serial.print(F("Muestras/s: "));
+  Serial.print(count - lastCount);
+  Serial.print(F("  Descartadas: "));
+  Serial.print(esn.getDroppedSamples());
+  Serial.print(F("  Pred: "));
+  Serial.println(lastPrediction, 3);
+
+  lastCount = count;
+  delay(1000);
+}
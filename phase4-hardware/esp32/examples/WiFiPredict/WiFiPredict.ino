@@ -1,7 +1,8 @@
 /**
  * ESP32 Demo: Predicción con envío WiFi
  *
- * Entrena localmente y envía predicciones a un servidor.
+ * Entrena localmente y envía predicciones a un servidor. La red corre
+ * en su propia tarea: loop() solo encola y nunca espera al WiFi.
  *
  * (c) 2024 SenseLab - Build with Sense
  */
@@ -12,6 +13,7 @@
 const char *WIFI_SSID = "TuRedWiFi";
 const char *WIFI_PASS = "TuPassword";
 const char *SERVER_URL = "http://192.168.1.100:5000/api/predict";
+const char *PEER_URL = "http://192.168.1.100:5000";
 
 // Crear instancia
 AeonESP32 esn(16);
@@ -59,6 +61,9 @@ void setup() {
   Serial.print(F("MSE: "));
   Serial.println(mse, 6);
 
+  // Red asíncrona: lotes de predicciones y pesos del peer cada minuto
+  esn.startNetwork(SERVER_URL, PEER_URL, 60000);
+
   Serial.println(F("\n✓ Listo para predecir"));
 }
 
@@ -78,10 +83,8 @@ void loop() {
   Serial.print(F(" -> Pred: "));
   Serial.println(pred, 3);
 
-  // Enviar a servidor (si hay WiFi)
-  if (WiFi.status() == WL_CONNECTED) {
-    esn.sendPrediction(SERVER_URL, input, pred);
-  }
+  // Encolar para la tarea de red (no bloquea)
+  esn.sendPrediction(SERVER_URL, input, pred);
 
   phase += 0.1;
   delay(500);
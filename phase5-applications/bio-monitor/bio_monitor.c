@@ -6,6 +6,14 @@
  * 1. Learns user's baseline HRV (Heart Rate Variability) in first N beats.
  * 2. Predicts next RR interval.
  * 3. Flags deviations as Anomalies.
+ *
+ * Usage: bio_monitor [delta_ms] [file|-] < rr.txt
+ * With delta_ms > 0 the monitor phase runs in delta mode: RR changes
+ * smaller than delta_ms (and the reservoir changes they cause) are not
+ * propagated, which saves most MACs on a steady heart rate.
+ *
+ * RR intervals (ms) come one per line, or as a 1-channel EONS binary
+ * stream (see aeon_stream_open), e.g. int16 ms with 0 fraction bits.
  */
 
 #include "../../phase2-core/libAeon/libAeon.h"
@@ -17,6 +25,8 @@
 // Anomaly threshold: 20% deviation from prediction
 // (Standard medical bounds for Ectopic beats are roughly >20% pre-maturity)
 #define ANOMALY_THRESHOLD_PCT 0.20f
+// Text RR values keep 1/4 ms (int16 range up to ~8 s)
+#define RR_FRAC_BITS 2
 
 // Helper functions (Basic fixed point conversion)
 // Redefining scale just in case, but using ifndef
@@ -31,12 +41,30 @@ float aeon_fixed_to_float(int16_t i) { return (float)i / AEON_SCALE; }
 static aeon_state_t last_input;
 static aeon_state_t last_prediction;
 
-int main() {
+int main(int argc, char *argv[]) {
+  float delta_ms = argc > 1 ? (float)atof(argv[1]) : 0.0f;
+  aeon_delta_t *delta = NULL;
+  if (delta_ms > 0.0f) {
+    delta = aeon_delta_create(AEON_RESERVOIR_SIZE, AEON_INPUT_SIZE, NULL);
+    if (delta == NULL)
+      return 1;
+    // Same normalization as the input: 500 ms per unit
+    aeon_delta_begin(delta, aeon_float_to_fixed(delta_ms / 500.0f));
+  }
+
+  int err;
+  aeon_stream_t *rr_stream = aeon_stream_open(argc > 2 ? argv[2] : "-",
+                                              RR_FRAC_BITS, 0, NULL, &err);
+  if (rr_stream == NULL) {
+    fprintf(stderr, "Error: no RR intervals to read (%d)\n", err);
+    aeon_delta_destroy(delta);
+    return 1;
+  }
+
   aeon_core_t core;
   // Birth with specific seed for reproducibility on device
   aeon_birth(&core, 777);
 
-  float rr_in;
   int beat_count = 0;
 
   // Buffers for training (small window)
@@ -46,71 +74,93 @@ int main() {
   printf("EON BIO MONITOR STARTED\n");
   printf("Status: CALIBRATING...\n");
 
-  while (scanf("%f", &rr_in) == 1) {
-
-    // Normalize input (roughly to range [-1, 1] relative to 1000ms usually)
-    float norm_in = (rr_in - 1000.0f) / 500.0f;
-    aeon_state_t input_fixed = aeon_float_to_fixed(norm_in);
-
-    // Calibration Phase
-    if (beat_count < CALIBRATION_BEATS) {
-      if (beat_count > 0) {
-        inputs[beat_count - 1] =
-            last_input; // Train to predict CURRENT (input_fixed) from PREV
-                        // (last_input)?
-        // Standard ESN training: Input(t) -> Target(t+1)
-        // Here inputs array is 'state input', targets is 'desired output'
-        // We want W_out * state(t) = target(t+1)
-        // So inputs[] should be... wait. aeon_train takes inputs/targets.
-        // It runs state update on inputs[t]. So state(t) is from inputs[t].
-        // Then it trains W_out * state(t) to match targets[t].
-        // So if we want to predict FUTURE, we want inputs[t] = RR_t, targets[t]
-        // = RR_t+1.
-
-        inputs[beat_count - 1] = last_input;
-        targets[beat_count - 1] = input_fixed;
+  const int16_t *block;
+  int32_t n_beats;
+  while ((n_beats = aeon_stream_next(rr_stream, &block)) > 0) {
+    for (int32_t b = 0; b < n_beats; b++) {
+      float rr_in =
+          ldexpf(block[b * rr_stream->channels], -rr_stream->frac_bits);
+
+      // Normalize input (roughly to range [-1, 1] relative to 1000ms usually)
+      float norm_in = (rr_in - 1000.0f) / 500.0f;
+      aeon_state_t input_fixed = aeon_float_to_fixed(norm_in);
+
+      // Calibration Phase
+      if (beat_count < CALIBRATION_BEATS) {
+        if (beat_count > 0) {
+          inputs[beat_count - 1] =
+              last_input; // Train to predict CURRENT (input_fixed) from PREV
+                          // (last_input)?
+          // Standard ESN training: Input(t) -> Target(t+1)
+          // Here inputs array is 'state input', targets is 'desired output'
+          // We want W_out * state(t) = target(t+1)
+          // So inputs[] should be... wait. aeon_train takes inputs/targets.
+          // It runs state update on inputs[t]. So state(t) is from inputs[t].
+          // Then it trains W_out * state(t) to match targets[t].
+          // So if we want to predict FUTURE, we want inputs[t] = RR_t,
+          // targets[t] = RR_t+1.
+
+          inputs[beat_count - 1] = last_input;
+          targets[beat_count - 1] = input_fixed;
+        }
+        last_input = input_fixed;
+
+        if (beat_count == CALIBRATION_BEATS - 1) {
+          // Train W_out
+          // We have inputs[0..48] and targets[0..48] (49 samples)
+          aeon_train(&core, inputs, targets, CALIBRATION_BEATS - 1, 5);
+          printf("Status: MONITORING ACTIVE\n");
+
+          // Initialize prediction for the very next step
+          // Update state with current input (which is the last one seen)
+          aeon_update(&core, &input_fixed);
+          aeon_state_t pred_out[1];
+          aeon_predict(&core, pred_out);
+          last_prediction = pred_out[0];
+        }
       }
-      last_input = input_fixed;
-
-      if (beat_count == CALIBRATION_BEATS - 1) {
-        // Train W_out
-        // We have inputs[0..48] and targets[0..48] (49 samples)
-        aeon_train(&core, inputs, targets, CALIBRATION_BEATS - 1, 5);
-        printf("Status: MONITORING ACTIVE\n");
-
-        // Initialize prediction for the very next step
-        // Update state with current input (which is the last one seen)
-        aeon_update(&core, &input_fixed);
+      // Monitor Phase
+      else {
+        // 1. Compare prediction made at (t-1) with actual (t) [Current rr_in]
+        float predicted_rr_norm = aeon_fixed_to_float(last_prediction);
+        float predicted_rr = (predicted_rr_norm * 500.0f) + 1000.0f;
+
+        float deviation = fabs(predicted_rr - rr_in) / predicted_rr;
+
+        if (deviation > ANOMALY_THRESHOLD_PCT) {
+          printf("ALERT: Arrhythmia Detected! Beat %d | RR: %.0fms | Pred: "
+                 "%.0fms | Dev: %.1f%%\n",
+                 beat_count, rr_in, predicted_rr, deviation * 100);
+        }
+
+        // 2. Update state with current
+        if (delta != NULL)
+          aeon_delta_update(delta, &core, &input_fixed);
+        else
+          aeon_update(&core, &input_fixed);
+
+        // 3. Predict next
         aeon_state_t pred_out[1];
         aeon_predict(&core, pred_out);
         last_prediction = pred_out[0];
       }
-    }
-    // Monitor Phase
-    else {
-      // 1. Compare prediction made at (t-1) with actual (t) [Current rr_in]
-      float predicted_rr_norm = aeon_fixed_to_float(last_prediction);
-      float predicted_rr = (predicted_rr_norm * 500.0f) + 1000.0f;
-
-      float deviation = fabs(predicted_rr - rr_in) / predicted_rr;
-
-      if (deviation > ANOMALY_THRESHOLD_PCT) {
-        printf("ALERT: Arrhythmia Detected! Beat %d | RR: %.0fms | Pred: "
-               "%.0fms | Dev: %.1f%%\n",
-               beat_count, rr_in, predicted_rr, deviation * 100);
-      }
-
-      // 2. Update state with current
-      aeon_update(&core, &input_fixed);
 
-      // 3. Predict next
-      aeon_state_t pred_out[1];
-      aeon_predict(&core, pred_out);
-      last_prediction = pred_out[0];
+      beat_count++;
     }
-
-    beat_count++;
   }
-
+  if (n_beats < 0)
+    fprintf(stderr, "Error: truncated or unreadable RR stream (%d)\n",
+            n_beats);
+  aeon_stream_close(rr_stream);
+
+  if (delta != NULL) {
+    printf("Delta mode: %.1f%% of MACs skipped (%llu of %llu)\n",
+           delta->ops_total
+               ? 100.0 * (double)delta->ops_skipped / (double)delta->ops_total
+               : 0.0,
+           (unsigned long long)delta->ops_skipped,
+           (unsigned long long)delta->ops_total);
+    aeon_delta_destroy(delta);
+  }
   return 0;
 }
@@ -1,4 +1,5 @@
 import random
+import struct
 import sys
 
 def generate_rr_stream(n_samples=500):
@@ -32,7 +33,15 @@ def generate_rr_stream(n_samples=500):
         elif t > 51 and (t-1) % 100 == 0:
             current_rr = current_rr * 1.4 # Long pause
             
-        print(f"{current_rr:.2f}")
+        yield current_rr
 
 if __name__ == "__main__":
-    generate_rr_stream()
+    if "--binary" in sys.argv[1:]:
+        # EONS stream: int16 RR in 1/4 ms (2 fraction bits), 1 channel
+        rr = [round(v * 4) for v in generate_rr_stream()]
+        out = sys.stdout.buffer
+        out.write(b"EONS" + struct.pack("<BBH", 1, 2, 1))
+        out.write(struct.pack("<I", len(rr)) + struct.pack(f"<{len(rr)}h", *rr))
+    else:
+        for v in generate_rr_stream():
+            print(f"{v:.2f}")
@@ -1,4 +1,6 @@
+import math
 import random
+import struct
 import sys
 
 def generate_audio_stream(n_frames=1000):
@@ -55,13 +57,60 @@ def generate_audio_stream(n_frames=1000):
             labels.append(0)
             t += 1
             
-    # Output CSV-ish format: B1,B2,B3,B4,TARGET
-    print("B1,B2,B3,B4,TARGET")
+    frames = []
     for s, l in zip(stream, labels):
         # Add some gaussian noise to bands
         s_noisy = [max(0.0, min(1.0, v + random.gauss(0, 0.05))) for v in s]
+        frames.append((s_noisy, l))
+    return frames
+
+def write_csv(frames):
+    # Output CSV-ish format: B1,B2,B3,B4,TARGET
+    print("B1,B2,B3,B4,TARGET")
+    for s_noisy, l in frames:
         line = f"{s_noisy[0]:.2f},{s_noisy[1]:.2f},{s_noisy[2]:.2f},{s_noisy[3]:.2f},{l}"
         print(line)
 
+def write_binary(frames):
+    # EONS stream: Q8.8 (8 fraction bits), 5 channels, one block
+    out = sys.stdout.buffer
+    out.write(b"EONS" + struct.pack("<BBH", 1, 8, 5))
+    out.write(struct.pack("<I", len(frames)))
+    for s_noisy, l in frames:
+        out.write(struct.pack("<5h", *[round(v * 256) for v in s_noisy + [l]]))
+
+def band_centers(n_bands=4, f_low=300.0, f_high=3400.0):
+    # Mel-spaced band centers, as in AEON_FRONTEND_CONFIG_DEFAULT
+    mel = lambda f: 2595.0 * math.log10(1.0 + f / 700.0)
+    hz = lambda m: 700.0 * (10.0 ** (m / 2595.0) - 1.0)
+    step = (mel(f_high) - mel(f_low)) / n_bands
+    return [hz(mel(f_low) + (b + 0.5) * step) for b in range(n_bands)]
+
+def write_pcm(frames, rate=8000, hop=160):
+    # EONS stream: 2 int16 channels per sample, [PCM, target]
+    # Each band value becomes a tone at its center, 20 ms per frame, with
+    # the level the front-end maps back to it (1.0 = full scale, 0 = -90 dB)
+    centers = band_centers()
+    phases = [0.0] * len(centers)
+    out = sys.stdout.buffer
+    out.write(b"EONS" + struct.pack("<BBH", 1, 0, 2))
+    out.write(struct.pack("<I", len(frames) * hop))
+    for s_noisy, l in frames:
+        samples = []
+        for _ in range(hop):
+            v = random.gauss(0, 1)
+            for b, f in enumerate(centers):
+                phases[b] += 2 * math.pi * f / rate
+                level = 32767 / len(centers) * 10 ** ((s_noisy[b] - 1) * 90 / 20)
+                v += level * math.sin(phases[b])
+            samples += [max(-32768, min(32767, round(v))), l]
+        out.write(struct.pack(f"<{2 * hop}h", *samples))
+
 if __name__ == "__main__":
-    generate_audio_stream(2000)
+    frames = generate_audio_stream(2000)
+    if "--pcm" in sys.argv[1:]:
+        write_pcm(frames)
+    elif "--binary" in sys.argv[1:]:
+        write_binary(frames)
+    else:
+        write_csv(frames)
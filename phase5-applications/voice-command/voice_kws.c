@@ -4,28 +4,30 @@
  * Memory: < 4KB
  *
  * Logic available:
- * 1. Read 4 floats (Spectral Bands).
+ * 1. Read 4 spectral bands + target per frame, in blocks.
  * 2. Update Reservoir.
  * 3. Train on first N samples (Supervised Learning Simulation).
  * 4. Predict probability of Keyword.
+ *
+ * Usage: voice_kws [file|-] < frames
+ * Frames come as CSV (B1,B2,B3,B4,TARGET) or as an EONS binary stream
+ * of 5 channels (see aeon_stream_open); a binary file or redirected
+ * stdin is mapped and replayed without parsing or copying.
+ *
+ * A 2-channel stream is raw 8 kHz PCM plus the keyword target per
+ * sample: the on-device Goertzel front-end turns it into the 4 bands
+ * (one frame every 20 ms), so no host feature extractor is needed.
  */
 
 #include "../../phase2-core/libAeon/libAeon.h"
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
-
-// Adjust Core for Multi-Input
-// Note: libAeon default typically single input. We need config.
-// But libAeon.h defines macros via AEON_INPUT_SIZE
-// We must redefine AEON_INPUT_SIZE BEFORE including libAeon...
-// BUT libAeon.c is compiled separately or linked.
-// Ideally we recompile libAeon with -DAEON_INPUT_SIZE=4.
-// For this prototype, we'll manually handle the input array size
-// or assume we rebuild for this app. We'll use a local include hack if needed
-// or just modify the make command to define it.
 
-// Let's assume we compile with -DAEON_INPUT_SIZE=4
+// Multi-Input: the reservoir shape is chosen at runtime (4 spectral bands,
+// 1 keyword output), so libAeon does not need to be rebuilt for this app.
+#define N_BANDS 4
+#define N_CHANNELS (N_BANDS + 1) // Bands, then the keyword target
+#define PCM_CHANNELS 2            // PCM sample, then the keyword target
 
 #define TRAIN_SAMPLES 1000
 #define THRESHOLD 0.7f
@@ -37,78 +39,110 @@
 int16_t aeon_float_to_fixed(float f) { return (int16_t)(f * AEON_SCALE); }
 float aeon_fixed_to_float(int16_t i) { return (float)i / AEON_SCALE; }
 
-int main() {
-  aeon_core_t core;
-  aeon_birth(&core, 123); // Seed
-
-  // Arrays for training
-  // We need heap for this amount of training data maybe?
-  // 1000 samples * 4 inputs * 2 bytes = 8KB. Might blow stack on small device.
-  // For PC sim, malloc is fine.
-  aeon_state_t *inputs = malloc(TRAIN_SAMPLES * 4 * sizeof(aeon_state_t));
-  aeon_state_t *targets = malloc(TRAIN_SAMPLES * 1 * sizeof(aeon_state_t));
+int main(int argc, char *argv[]) {
+  int err;
+  aeon_stream_t *frames_in =
+      aeon_stream_open(argc > 1 ? argv[1] : "-", 8, 0, NULL, &err);
+  if (frames_in == NULL || (frames_in->channels != PCM_CHANNELS &&
+                            frames_in->channels < N_CHANNELS)) {
+    fprintf(stderr, "Error: no %d-channel frames or PCM to read (%d)\n",
+            N_CHANNELS, err);
+    aeon_stream_close(frames_in);
+    return 1;
+  }
 
-  float b1, b2, b3, b4;
-  int target_in;
-  char line[256];
+  // 4 mel bands over 300-3400 Hz, 32 ms window every 20 ms
+  int pcm_mode = frames_in->channels == PCM_CHANNELS;
+  aeon_frontend_t frontend;
+  aeon_frontend_config_t fe_config = AEON_FRONTEND_CONFIG_DEFAULT;
+  fe_config.n_bands = N_BANDS;
+  if (pcm_mode)
+    aeon_frontend_begin(&frontend, &fe_config);
+
+  aeon_config_t config = AEON_CONFIG_DEFAULT;
+  config.input_size = N_BANDS;
+  config.output_size = 1;
+  aeon_dyn_core_t *core = aeon_core_create(&config, NULL);
+  if (core == NULL) {
+    fprintf(stderr, "Error: could not create reservoir\n");
+    aeon_stream_close(frames_in);
+    return 1;
+  }
+  aeon_core_birth(core, 123); // Seed
+
+  // Streaming trainer: samples are accumulated as they arrive, so there is
+  // no TRAIN_SAMPLES x N_BANDS buffer (memory depends only on the reservoir).
+  aeon_trainer_t *trainer =
+      aeon_trainer_create(config.reservoir_size, config.output_size, NULL);
+  if (trainer == NULL) {
+    fprintf(stderr, "Error: could not create trainer\n");
+    aeon_core_destroy(core);
+    aeon_stream_close(frames_in);
+    return 1;
+  }
+  aeon_trainer_begin(trainer, 1.0f, 50);
 
   int sample_idx = 0;
   int test_mode = 0;
 
-  // Skip header
-  fgets(line, sizeof(line), stdin);
-
   printf("EON VOICE KWS STARTED\n");
   printf("Status: RECORDING/TRAINING (%d samples)...\n", TRAIN_SAMPLES);
 
-  while (fgets(line, sizeof(line), stdin)) {
-    if (sscanf(line, "%f,%f,%f,%f,%d", &b1, &b2, &b3, &b4, &target_in) != 5)
-      continue;
-
-    aeon_state_t in_vec[4];
-    in_vec[0] = aeon_float_to_fixed(b1);
-    in_vec[1] = aeon_float_to_fixed(b2);
-    in_vec[2] = aeon_float_to_fixed(b3);
-    in_vec[3] = aeon_float_to_fixed(b4);
-
-    aeon_state_t tgt_val = aeon_float_to_fixed((float)target_in);
-
-    if (!test_mode) {
-      // Collecting Training Data
-      memcpy(&inputs[sample_idx * 4], in_vec, 4 * sizeof(aeon_state_t));
-      targets[sample_idx] = tgt_val;
-      sample_idx++;
-
-      if (sample_idx >= TRAIN_SAMPLES) {
-        // Train
-        printf("Status: TRAINING... ");
-
-        // Note: aeon_train expects contiguous arrays.
-        // Our inputs are flat (N * 4).
-
-        aeon_train(&core, inputs, targets, TRAIN_SAMPLES, 50);
-        printf("DONE.\nStatus: LISTENING...\n");
-        test_mode = 1;
-
-        // Cleanup
-        free(inputs);
-        free(targets);
+  const int16_t *block;
+  int32_t n_frames;
+  while ((n_frames = aeon_stream_next(frames_in, &block)) > 0) {
+    for (int32_t f = 0; f < n_frames; f++) {
+      const int16_t *frame = &block[f * frames_in->channels];
+      aeon_state_t in_vec[N_BANDS];
+      aeon_state_t tgt_val;
+      if (pcm_mode) {
+        // One PCM sample; the bands come straight out every hop
+        if (aeon_frontend_push(&frontend, &frame[0], 1, in_vec) == 0)
+          continue;
+        aeon_stream_state(frames_in, frame, 1, 1, &tgt_val);
+      } else {
+        aeon_stream_state(frames_in, frame, 0, N_BANDS, in_vec);
+        aeon_stream_state(frames_in, frame, N_BANDS, 1, &tgt_val);
       }
-    } else {
-      // Inference
-      aeon_update(&core, in_vec);
-
-      aeon_state_t out[1];
-      aeon_predict(&core, out);
-
-      float prob = aeon_fixed_to_float(out[0]);
 
-      if (prob > THRESHOLD) {
-        printf("DETECTED: EON (Conf: %.2f) at sample %d\n", prob, sample_idx);
+      if (!test_mode) {
+        // Training: update the reservoir and accumulate this sample
+        aeon_core_trainer_push(trainer, core, in_vec, &tgt_val);
+        sample_idx++;
+
+        if (sample_idx >= TRAIN_SAMPLES) {
+          // Solve W_out from what has been accumulated
+          printf("Status: TRAINING... ");
+          aeon_core_trainer_finalize(trainer, core);
+          printf("DONE.\nStatus: LISTENING...\n");
+          test_mode = 1;
+
+          // Cleanup
+          aeon_trainer_destroy(trainer);
+          trainer = NULL;
+        }
+      } else {
+        // Inference
+        aeon_core_update(core, in_vec);
+
+        aeon_state_t out[1];
+        aeon_core_predict(core, out);
+
+        float prob = aeon_fixed_to_float(out[0]);
+
+        if (prob > THRESHOLD) {
+          printf("DETECTED: EON (Conf: %.2f) at sample %d\n", prob,
+                 sample_idx);
+        }
+        sample_idx++;
       }
-      sample_idx++;
     }
   }
+  if (n_frames < 0)
+    fprintf(stderr, "Error: truncated or unreadable frames (%d)\n", n_frames);
 
+  aeon_trainer_destroy(trainer);
+  aeon_core_destroy(core);
+  aeon_stream_close(frames_in);
   return 0;
 }
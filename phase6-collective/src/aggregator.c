@@ -0,0 +1,628 @@
+/**
+ * @file aggregator.c
+ * @brief Native aggregation server for Eon weight exchange packets.
+ *
+ * Nodes send eon_packet_header_t frames as UDP datagrams. Updates are
+ * bucketed by reservoir seed (only nodes that share a seed share W_out)
+ * and merged once `quorum` updates have arrived or the flush interval
+ * expires. The merged weights go back to every node that sent to that
+ * seed, as a packet of the same type.
+ *
+ *   PACKET_TYPE_UPDATE: per-weight majority vote on the sign bits. Votes
+ *                       are counted 64 weights at a time in bit-sliced
+ *                       counters; popcount measures how far each update
+ *                       is from the last consensus. An even split keeps
+ *                       the last published sign; before the first
+ *                       publish, the first update of the bucket stands
+ *                       in for it.
+ *   PACKET_TYPE_QUANT:  mean of the dequantized weights, re-quantized with
+ *                       the senders' bits and block size.
+ *
+ * DELTA and QUANT_ACK are peer-to-peer (they need the receiver's
+ * reference) and are counted as unsupported.
+ *
+ * Frames are parsed in place in the receive buffers: the header is read
+ * through the packed struct and the sign bits straight from the payload.
+ * The loop is epoll over the socket and a flush timerfd, draining up to
+ * AGG_BATCH datagrams per recvmmsg call (Linux only).
+ *
+ * Build: gcc -O2 -o aggregator src/aggregator.c src/quantization.c -lm
+ * Usage: ./aggregator [-p port] [-q quorum] [-t flush_ms] [-b packets]
+ */
+
+#define _GNU_SOURCE
+#include "eon_protocol.h"
+#include "quantization.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#define AGG_DEFAULT_PORT 4747
+#define AGG_DEFAULT_QUORUM 8
+#define AGG_DEFAULT_FLUSH_MS 1000
+#define AGG_BATCH 64           /**< Datagrams per recvmmsg */
+#define AGG_SLOT_SIZE 16384    /**< Largest datagram accepted */
+#define AGG_MAX_BUCKETS 1024   /**< Distinct seeds (power of two) */
+#define AGG_MAX_SUBSCRIBERS 32 /**< Nodes that receive each merge */
+#define AGG_PLANES 8           /**< Counter bits: up to 255 votes a round */
+#define AGG_MAX_VOTES ((1u << AGG_PLANES) - 1)
+
+typedef struct {
+  uint64_t packets;
+  uint64_t bytes;
+  uint64_t malformed;   /**< Bad magic, truncated or undecodable */
+  uint64_t unsupported; /**< DELTA, QUANT_ACK and unknown types */
+  uint64_t mismatched;  /**< Shape differs from the seed's bucket */
+  uint64_t full;        /**< No free bucket for a new seed */
+  uint64_t published;
+} agg_stats_t;
+
+typedef struct {
+  bool used;
+  uint8_t type; /**< PACKET_TYPE_UPDATE or PACKET_TYPE_QUANT */
+  uint8_t bits; /**< QUANT only */
+  uint16_t block;
+  uint16_t num_weights;
+  uint32_t seed;
+  uint16_t votes;    /**< Updates in the current round */
+  uint16_t sequence; /**< Rounds published */
+  size_t words;      /**< 64-bit words of packed signs */
+  uint64_t *planes;  /**< UPDATE: AGG_PLANES counters per word, bit-sliced */
+  uint64_t *merged;  /**< UPDATE: last published signs (breaks ties),
+                          the first update until the first publish */
+  uint64_t disagreement; /**< Bits voted against `merged` this round */
+  float *sum;            /**< QUANT: running sum of the weights */
+  float *scratch;        /**< QUANT: one decoded update */
+  uint64_t round_start_ms;
+  struct sockaddr_in subscribers[AGG_MAX_SUBSCRIBERS];
+  int n_subscribers;
+} agg_bucket_t;
+
+typedef struct {
+  agg_bucket_t buckets[AGG_MAX_BUCKETS];
+  unsigned quorum;
+  unsigned flush_ms;
+  int fd; /**< -1 in benchmark mode: merges are built but not sent */
+  bool verbose;
+  agg_stats_t stats;
+  uint8_t out[AGG_SLOT_SIZE];
+} agg_server_t;
+
+static agg_server_t server;
+static uint8_t slots[AGG_BATCH][AGG_SLOT_SIZE];
+static volatile sig_atomic_t running = 1;
+
+static void on_signal(int sig) {
+  (void)sig;
+  running = 0;
+}
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+/* ============================================================
+ * BIT-SLICED VOTE COUNTERS
+ * ============================================================ */
+
+/* Add one vote to 64 lanes: ripple-carry through the counter planes */
+static inline void vote_add(uint64_t *c, uint64_t x) {
+  for (int p = 0; p < AGG_PLANES && x != 0; p++) {
+    uint64_t carry = c[p] & x;
+    c[p] ^= x;
+    x = carry;
+  }
+}
+
+/* Lanes whose count is >= k, comparing from the top plane down */
+static inline uint64_t count_at_least(const uint64_t *c, unsigned k) {
+  uint64_t gt = 0, eq = ~0ULL;
+  for (int p = AGG_PLANES - 1; p >= 0; p--) {
+    if ((k >> p) & 1u) {
+      eq &= c[p];
+    } else {
+      gt |= eq & c[p];
+      eq &= ~c[p];
+    }
+  }
+  return gt | eq;
+}
+
+/* Word w of a packed sign payload (little-endian, zero past the end) */
+static inline uint64_t load_word(const uint8_t *payload, size_t bytes,
+                                 size_t w) {
+  uint64_t x = 0;
+  size_t at = w * 8;
+  if (at + 8 <= bytes) {
+    memcpy(&x, payload + at, 8);
+  } else {
+    for (size_t k = 0; at + k < bytes; k++)
+      x |= (uint64_t)payload[at + k] << (8 * k);
+  }
+  return x;
+}
+
+/* ============================================================
+ * BUCKETS
+ * ============================================================ */
+
+static agg_bucket_t *find_bucket(agg_server_t *s, uint32_t seed) {
+  uint32_t i = (seed * 0x9E3779B9u) & (AGG_MAX_BUCKETS - 1);
+  for (uint32_t probe = 0; probe < AGG_MAX_BUCKETS; probe++) {
+    agg_bucket_t *b = &s->buckets[i];
+    if (!b->used || b->seed == seed)
+      return b;
+    i = (i + 1) & (AGG_MAX_BUCKETS - 1);
+  }
+  return NULL;
+}
+
+static bool bucket_init(agg_bucket_t *b, uint32_t seed, uint8_t type,
+                        uint16_t num_weights, uint8_t bits, uint16_t block) {
+  memset(b, 0, sizeof(*b));
+  b->seed = seed;
+  b->type = type;
+  b->num_weights = num_weights;
+  b->bits = bits;
+  b->block = block;
+  b->words = ((size_t)num_weights + 63) / 64;
+  if (type == PACKET_TYPE_UPDATE) {
+    b->planes = calloc(b->words * AGG_PLANES, sizeof(uint64_t));
+    b->merged = calloc(b->words, sizeof(uint64_t));
+    if (b->planes == NULL || b->merged == NULL)
+      goto fail;
+  } else {
+    b->sum = calloc(num_weights, sizeof(float));
+    b->scratch = malloc((size_t)num_weights * sizeof(float));
+    if (b->sum == NULL || b->scratch == NULL)
+      goto fail;
+  }
+  b->used = true;
+  return true;
+
+fail:
+  free(b->planes);
+  free(b->merged);
+  free(b->sum);
+  free(b->scratch);
+  memset(b, 0, sizeof(*b));
+  return false;
+}
+
+static void add_subscriber(agg_bucket_t *b, const struct sockaddr_in *from) {
+  if (from == NULL)
+    return;
+  for (int i = 0; i < b->n_subscribers; i++) {
+    if (b->subscribers[i].sin_addr.s_addr == from->sin_addr.s_addr &&
+        b->subscribers[i].sin_port == from->sin_port)
+      return;
+  }
+  if (b->n_subscribers < AGG_MAX_SUBSCRIBERS)
+    b->subscribers[b->n_subscribers++] = *from;
+}
+
+/* ============================================================
+ * MERGE AND PUBLISH
+ * ============================================================ */
+
+static size_t build_merged(agg_server_t *s, agg_bucket_t *b) {
+  uint8_t *out = s->out;
+  eon_packet_header_t *header = (eon_packet_header_t *)out;
+  memcpy(header->magic, "EON", 3);
+  header->type = b->type;
+  header->seed = b->seed;
+  header->num_weights = b->num_weights;
+  size_t offset = sizeof(eon_packet_header_t);
+
+  if (b->type == PACKET_TYPE_UPDATE) {
+    /* Majority wins; an even split keeps the previous sign (or the
+     * first update's, in the first round) */
+    unsigned half = b->votes / 2u;
+    for (size_t w = 0; w < b->words; w++) {
+      const uint64_t *c = &b->planes[w * AGG_PLANES];
+      uint64_t win = count_at_least(c, half + 1u);
+      if ((b->votes & 1u) == 0) {
+        uint64_t tie = count_at_least(c, half) & ~win;
+        win |= tie & b->merged[w];
+      }
+      b->merged[w] = win;
+    }
+    size_t bytes = ((size_t)b->num_weights + 7) / 8;
+    for (size_t k = 0; k < bytes; k++)
+      out[offset + k] = (uint8_t)(b->merged[k / 8] >> (8 * (k % 8)));
+    memset(b->planes, 0, b->words * AGG_PLANES * sizeof(uint64_t));
+    return offset + bytes;
+  }
+
+  eon_quant_header_t *q = (eon_quant_header_t *)(out + offset);
+  q->bits = b->bits;
+  q->reserved = 0;
+  q->block_size = b->block;
+  q->sequence = b->sequence;
+  q->ref_sequence = 0;
+  offset += sizeof(eon_quant_header_t);
+
+  float inv = 1.0f / (float)b->votes;
+  for (int i = 0; i < b->num_weights; i++)
+    b->scratch[i] = b->sum[i] * inv;
+  memset(b->sum, 0, (size_t)b->num_weights * sizeof(float));
+  int bytes = quantize_nbit(b->scratch, b->num_weights, b->bits, b->block,
+                            out + offset, sizeof(s->out) - offset);
+  return bytes > 0 ? offset + (size_t)bytes : 0;
+}
+
+static void publish(agg_server_t *s, agg_bucket_t *b, uint64_t now) {
+  b->sequence++;
+  size_t len = build_merged(s, b);
+
+  if (s->verbose) {
+    uint64_t voted = (uint64_t)b->votes * b->num_weights;
+    if (b->type == PACKET_TYPE_UPDATE)
+      printf("[AGG] seed 0x%08X round %u: %u votes, %.1f%% agreement, "
+             "%zu bytes to %d nodes\n",
+             b->seed, b->sequence, b->votes,
+             100.0 * (1.0 - (double)b->disagreement / (double)voted), len,
+             b->n_subscribers);
+    else
+      printf("[AGG] seed 0x%08X round %u: %u votes, %d-bit mean, "
+             "%zu bytes to %d nodes\n",
+             b->seed, b->sequence, b->votes, b->bits, len, b->n_subscribers);
+  }
+
+  if (s->fd >= 0 && len > 0) {
+    for (int i = 0; i < b->n_subscribers; i++)
+      sendto(s->fd, s->out, len, MSG_DONTWAIT,
+             (const struct sockaddr *)&b->subscribers[i],
+             sizeof(b->subscribers[i]));
+  }
+
+  s->stats.published++;
+  b->votes = 0;
+  b->disagreement = 0;
+  b->round_start_ms = now;
+}
+
+/* Publish rounds left open longer than the flush interval */
+static void flush_expired(agg_server_t *s, uint64_t now) {
+  for (int i = 0; i < AGG_MAX_BUCKETS; i++) {
+    agg_bucket_t *b = &s->buckets[i];
+    if (b->used && b->votes > 0 && now - b->round_start_ms >= s->flush_ms)
+      publish(s, b, now);
+  }
+}
+
+/* ============================================================
+ * PACKET HANDLING
+ * ============================================================ */
+
+/* Parse one frame in place and add it to its seed's round */
+static void handle_packet(agg_server_t *s, const uint8_t *buf, size_t len,
+                          const struct sockaddr_in *from, uint64_t now) {
+  s->stats.packets++;
+  s->stats.bytes += len;
+
+  if (len < sizeof(eon_packet_header_t) || memcmp(buf, "EON", 3) != 0) {
+    s->stats.malformed++;
+    return;
+  }
+  const eon_packet_header_t *header = (const eon_packet_header_t *)buf;
+  const uint8_t *payload = buf + sizeof(eon_packet_header_t);
+  size_t payload_len = len - sizeof(eon_packet_header_t);
+  uint16_t n = header->num_weights;
+
+  const eon_quant_header_t *q = NULL;
+  if (header->type == PACKET_TYPE_UPDATE) {
+    if (n == 0 || payload_len < ((size_t)n + 7) / 8) {
+      s->stats.malformed++;
+      return;
+    }
+  } else if (header->type == PACKET_TYPE_QUANT) {
+    if (n == 0 || payload_len < sizeof(eon_quant_header_t)) {
+      s->stats.malformed++;
+      return;
+    }
+    q = (const eon_quant_header_t *)payload;
+    payload += sizeof(eon_quant_header_t);
+    payload_len -= sizeof(eon_quant_header_t);
+    if (quantize_nbit_size(n, q->bits, q->block_size) == 0) {
+      s->stats.malformed++;
+      return;
+    }
+  } else {
+    s->stats.unsupported++;
+    return;
+  }
+
+  agg_bucket_t *b = find_bucket(s, header->seed);
+  if (b == NULL) {
+    s->stats.full++;
+    return;
+  }
+  if (!b->used) {
+    if (!bucket_init(b, header->seed, header->type, n, q ? q->bits : 0,
+                     q ? q->block_size : 0)) {
+      s->stats.full++;
+      return;
+    }
+    b->round_start_ms = now;
+  }
+  if (b->type != header->type || b->num_weights != n ||
+      (q != NULL && (b->bits != q->bits || b->block != q->block_size))) {
+    s->stats.mismatched++;
+    return;
+  }
+
+  if (b->type == PACKET_TYPE_UPDATE) {
+    size_t bytes = ((size_t)n + 7) / 8;
+    /* A fresh bucket has no consensus yet: an all-zero one would settle
+     * every tie of the first round as negative */
+    bool first = b->sequence == 0 && b->votes == 0;
+    for (size_t w = 0; w < b->words; w++) {
+      uint64_t x = load_word(payload, bytes, w);
+      if (first)
+        b->merged[w] = x;
+      b->disagreement += (uint64_t)__builtin_popcountll(x ^ b->merged[w]);
+      vote_add(&b->planes[w * AGG_PLANES], x);
+    }
+  } else {
+    if (dequantize_nbit(payload, payload_len, n, b->bits, b->block,
+                        b->scratch) == 0) {
+      s->stats.malformed++;
+      return;
+    }
+    for (int i = 0; i < n; i++)
+      b->sum[i] += b->scratch[i];
+  }
+
+  add_subscriber(b, from);
+  if (b->votes == 0)
+    b->round_start_ms = now;
+  b->votes++;
+  if (b->votes >= s->quorum || b->votes >= AGG_MAX_VOTES)
+    publish(s, b, now);
+}
+
+/* ============================================================
+ * SERVER LOOP
+ * ============================================================ */
+
+static void drain_socket(agg_server_t *s) {
+  struct mmsghdr msgs[AGG_BATCH];
+  struct iovec iov[AGG_BATCH];
+  struct sockaddr_in from[AGG_BATCH];
+
+  for (;;) {
+    for (int i = 0; i < AGG_BATCH; i++) {
+      iov[i].iov_base = slots[i];
+      iov[i].iov_len = AGG_SLOT_SIZE;
+      memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      msgs[i].msg_hdr.msg_name = &from[i];
+      msgs[i].msg_hdr.msg_namelen = sizeof(from[i]);
+    }
+    int got = recvmmsg(s->fd, msgs, AGG_BATCH, MSG_DONTWAIT, NULL);
+    if (got <= 0)
+      return;
+
+    uint64_t now = now_ms();
+    for (int i = 0; i < got; i++) {
+      if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+        s->stats.packets++;
+        s->stats.malformed++;
+        continue;
+      }
+      handle_packet(s, slots[i], msgs[i].msg_len, &from[i], now);
+    }
+    if (got < AGG_BATCH)
+      return;
+  }
+}
+
+static int serve(agg_server_t *s, uint16_t port) {
+  s->fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (s->fd < 0) {
+    perror("socket");
+    return 1;
+  }
+  int rcvbuf = 4 << 20;
+  setsockopt(s->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  if (bind(s->fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    perror("bind");
+    close(s->fd);
+    return 1;
+  }
+
+  int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
+  unsigned tick = s->flush_ms / 4 > 0 ? s->flush_ms / 4 : 1;
+  struct itimerspec its;
+  its.it_interval.tv_sec = tick / 1000;
+  its.it_interval.tv_nsec = (long)(tick % 1000) * 1000000L;
+  its.it_value = its.it_interval;
+  int ep = epoll_create1(0);
+  if (tfd < 0 || ep < 0 || timerfd_settime(tfd, 0, &its, NULL) < 0) {
+    perror("epoll/timerfd");
+    close(s->fd);
+    return 1;
+  }
+
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.fd = s->fd;
+  epoll_ctl(ep, EPOLL_CTL_ADD, s->fd, &ev);
+  ev.data.fd = tfd;
+  epoll_ctl(ep, EPOLL_CTL_ADD, tfd, &ev);
+
+  printf("[AGG] Listening on udp/%u (quorum %u, flush %u ms)\n", port,
+         s->quorum, s->flush_ms);
+
+  while (running) {
+    struct epoll_event events[2];
+    int n = epoll_wait(ep, events, 2, -1);
+    if (n < 0 && errno != EINTR) {
+      perror("epoll_wait");
+      break;
+    }
+    for (int i = 0; i < n; i++) {
+      if (events[i].data.fd == s->fd) {
+        drain_socket(s);
+      } else {
+        uint64_t expirations;
+        if (read(tfd, &expirations, sizeof(expirations)) > 0)
+          flush_expired(s, now_ms());
+      }
+    }
+  }
+
+  close(ep);
+  close(tfd);
+  close(s->fd);
+  return 0;
+}
+
+/* ============================================================
+ * BENCHMARK
+ * ============================================================ */
+
+/*
+ * In-process load: `nodes` noisy copies of a true sign vector per seed
+ * (each bit flipped with probability 1/5), fed into handle_packet
+ * without sockets. Reports packets/s and how much of the truth the
+ * majority recovered.
+ */
+static int benchmark(agg_server_t *s, long total) {
+  enum { SEEDS = 16, NODES = 32, WEIGHTS = 256 };
+  static float truth[SEEDS][WEIGHTS];
+  static uint8_t packets[SEEDS][NODES][sizeof(eon_packet_header_t) +
+                                       WEIGHTS / 8];
+  size_t packet_size = sizeof(packets[0][0]);
+  float noisy[WEIGHTS];
+
+  srand(1234);
+  for (int sd = 0; sd < SEEDS; sd++) {
+    for (int i = 0; i < WEIGHTS; i++)
+      truth[sd][i] = (rand() & 1) ? 0.25f : -0.25f;
+    for (int nd = 0; nd < NODES; nd++) {
+      for (int i = 0; i < WEIGHTS; i++)
+        noisy[i] = (rand() % 5 == 0) ? -truth[sd][i] : truth[sd][i];
+      eon_packet_header_t *h = (eon_packet_header_t *)packets[sd][nd];
+      memcpy(h->magic, "EON", 3);
+      h->type = PACKET_TYPE_UPDATE;
+      h->seed = 0xE0000000u + (uint32_t)sd;
+      h->num_weights = WEIGHTS;
+      quantize_1bit(noisy, WEIGHTS, packets[sd][nd] + sizeof(*h));
+    }
+  }
+
+  s->fd = -1;
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for (long p = 0; p < total; p++) {
+    long nd = (p / SEEDS) % NODES;
+    handle_packet(s, packets[p % SEEDS][nd], packet_size, NULL, 0);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  double secs = (double)(t1.tv_sec - t0.tv_sec) +
+                (double)(t1.tv_nsec - t0.tv_nsec) * 1e-9;
+
+  /* Compare the last merge of each seed against its true signs */
+  int hits = 0;
+  for (int sd = 0; sd < SEEDS; sd++) {
+    agg_bucket_t *b = find_bucket(s, 0xE0000000u + (uint32_t)sd);
+    float merged[WEIGHTS];
+    uint8_t bytes[WEIGHTS / 8];
+    for (int k = 0; k < WEIGHTS / 8; k++)
+      bytes[k] = (uint8_t)(b->merged[k / 8] >> (8 * (k % 8)));
+    dequantize_1bit(bytes, WEIGHTS, merged, 0.25f);
+    for (int i = 0; i < WEIGHTS; i++)
+      hits += merged[i] == truth[sd][i];
+  }
+
+  printf("[AGG] %ld packets (%d seeds x %d weights, quorum %u) in %.3f s\n",
+         total, SEEDS, WEIGHTS, s->quorum, secs);
+  printf("[AGG] %.2f M packets/s, %llu merges\n", (double)total / secs * 1e-6,
+         (unsigned long long)s->stats.published);
+  printf("[AGG] Majority recovers %.1f%% of true signs (each node 80%%)\n",
+         100.0 * hits / (SEEDS * WEIGHTS));
+  return 0;
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+int main(int argc, char **argv) {
+  agg_server_t *s = &server;
+  unsigned port = AGG_DEFAULT_PORT;
+  long bench = 0;
+  s->quorum = AGG_DEFAULT_QUORUM;
+  s->flush_ms = AGG_DEFAULT_FLUSH_MS;
+  s->verbose = true;
+  s->fd = -1;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "p:q:t:b:")) != -1) {
+    switch (opt) {
+    case 'p':
+      port = (unsigned)atoi(optarg);
+      break;
+    case 'q':
+      s->quorum = (unsigned)atoi(optarg);
+      break;
+    case 't':
+      s->flush_ms = (unsigned)atoi(optarg);
+      break;
+    case 'b':
+      bench = atol(optarg);
+      break;
+    default:
+      fprintf(stderr,
+              "Usage: %s [-p port] [-q quorum] [-t flush_ms] [-b packets]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  if (s->quorum == 0 || s->quorum > AGG_MAX_VOTES)
+    s->quorum = AGG_DEFAULT_QUORUM;
+  if (s->flush_ms == 0)
+    s->flush_ms = AGG_DEFAULT_FLUSH_MS;
+
+  int rc;
+  if (bench > 0) {
+    s->verbose = false;
+    rc = benchmark(s, bench);
+  } else {
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    rc = serve(s, (uint16_t)port);
+  }
+
+  printf("[AGG] packets %llu, bytes %llu, merges %llu, malformed %llu, "
+         "unsupported %llu, mismatched %llu, full %llu\n",
+         (unsigned long long)s->stats.packets,
+         (unsigned long long)s->stats.bytes,
+         (unsigned long long)s->stats.published,
+         (unsigned long long)s->stats.malformed,
+         (unsigned long long)s->stats.unsupported,
+         (unsigned long long)s->stats.mismatched,
+         (unsigned long long)s->stats.full);
+  return rc;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file eon_protocol.h
+ * @brief Eon weight exchange packet definitions (see docs/protocol_spec.md).
+ *
+ * Every packet starts with eon_packet_header_t. Quantized packets follow
+ * it with eon_quant_header_t and the block payload from quantization.h.
+ * Multi-byte fields are little-endian, as written by ESP32 and x86 nodes.
+ */
+
+#ifndef EON_PROTOCOL_H
+#define EON_PROTOCOL_H
+
+#include <stdint.h>
+
+/* Packet types */
+#define PACKET_TYPE_UPDATE 0x01 /**< W_out signs, 1 bit per weight */
+#define PACKET_TYPE_QUANT 0x10  /**< W_out, 2/4/8 bits with block scales */
+#define PACKET_TYPE_DELTA 0x11  /**< Residual against an acknowledged W_out */
+#define PACKET_TYPE_QUANT_ACK 0x12 /**< Receiver applied `sequence` */
+#define PACKET_TYPE_PREDICTIONS 0x20 /**< Batched node predictions */
+
+typedef struct __attribute__((packed)) {
+  char magic[3];
+  uint8_t type;
+  uint32_t seed;
+  uint16_t num_weights;
+  // Payload follows
+} eon_packet_header_t;
+
+/** Follows eon_packet_header_t in QUANT, DELTA and QUANT_ACK packets */
+typedef struct __attribute__((packed)) {
+  uint8_t bits;          /**< Bits per weight: 2, 4 or 8 */
+  uint8_t reserved;      /**< Must be 0 */
+  uint16_t block_size;   /**< Weights per block */
+  uint16_t sequence;     /**< Sender's update counter */
+  uint16_t ref_sequence; /**< DELTA: acknowledged update it applies to */
+  // Block payload follows (none in QUANT_ACK)
+} eon_quant_header_t;
+
+#endif
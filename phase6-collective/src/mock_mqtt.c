@@ -1,30 +1,60 @@
 /**
  * @file mock_mqtt.c
- * @brief Simulates MQTT packet generation for Eon 1-Bit Weight Exchange.
+ * @brief Simulates MQTT packet generation for Eon weight exchange
+ *        (1-bit signs, multi-bit blocks and deltas).
  */
 
+#include "eon_protocol.h"
 #include "quantization.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
-// Protocol Definition
+// Protocol Definition (eon_protocol.h)
 // Header: [ 'E', 'O', 'N', TYPE ]
 // Type 0x01: W_OUT_UPDATE_1BIT
+// Type 0x10/0x11: W_OUT_QUANT / W_OUT_DELTA (+ eon_quant_header_t)
 // Seed: 4 bytes (uint32_t little endian)
 // Payload: Quantized bits
 
-#define PACKET_TYPE_UPDATE 0x01
 #define SEED 0xDEADBEEF // Example seed
 
-typedef struct __attribute__((packed)) {
-  char magic[3];
-  uint8_t type;
-  uint32_t seed;
-  uint16_t num_weights;
-  // Payload follows
-} eon_packet_header_t;
+static float rmse(const float *a, const float *b, int n) {
+  float sum = 0.0f;
+  for (int i = 0; i < n; i++)
+    sum += (a[i] - b[i]) * (a[i] - b[i]);
+  return sqrtf(sum / n);
+}
+
+/* Build a QUANT packet, or a DELTA against reference when that is
+ * smaller; returns its size */
+static size_t build_quant_packet(uint8_t *packet, size_t capacity,
+                                 const float *weights, const float *reference,
+                                 int n_weights, int bits, uint16_t sequence,
+                                 uint16_t ref_sequence, float *reconstructed) {
+  eon_packet_header_t *header = (eon_packet_header_t *)packet;
+  memcpy(header->magic, "EON", 3);
+  header->seed = SEED;
+  header->num_weights = (uint16_t)n_weights;
+
+  eon_quant_header_t *q =
+      (eon_quant_header_t *)(packet + sizeof(eon_packet_header_t));
+  q->bits = (uint8_t)bits;
+  q->reserved = 0;
+  q->block_size = QUANT_DEFAULT_BLOCK;
+  q->sequence = sequence;
+
+  size_t offset = sizeof(eon_packet_header_t) + sizeof(eon_quant_header_t);
+  int is_delta;
+  int bytes = quantize_update(weights, reference, n_weights, bits,
+                              QUANT_DEFAULT_BLOCK, 1e-3f, packet + offset,
+                              capacity - offset, reconstructed, &is_delta);
+  header->type = is_delta ? PACKET_TYPE_DELTA : PACKET_TYPE_QUANT;
+  q->ref_sequence = is_delta ? ref_sequence : 0;
+  return bytes > 0 ? offset + (size_t)bytes : 0;
+}
 
 void mock_mqtt_publish(const char *topic, const uint8_t *payload, size_t len) {
   printf("[MQTT] Publish to '%s' (%zu bytes):\n", topic, len);
@@ -41,6 +71,7 @@ void mock_mqtt_publish(const char *topic, const uint8_t *payload, size_t len) {
 
 int main() {
   printf("Eon 1-Bit Weight Exchange Simulation (ESP32)\n");
+  printf("1-bit backend: %s\n", quantize_1bit_backend());
 
   // Simulate training weights (N=100)
   int n_weights = 100;
@@ -97,6 +128,62 @@ int main() {
   printf("Sign Consistency: %d / %d (%.1f%%)\n", matching_signs, n_weights,
          (float)matching_signs * 100.0f / n_weights);
 
+  float mean_abs = 0.0f;
+  for (int i = 0; i < n_weights; i++)
+    mean_abs += fabsf(weights[i]);
+  mean_abs /= n_weights;
+  dequantize_1bit(packet + sizeof(eon_packet_header_t), n_weights, recovered,
+                  mean_abs);
+  printf("1-bit RMSE (scale = mean |w|): %.4f in %zu bytes\n",
+         rmse(weights, recovered, n_weights), packet_size);
+  free(packet);
+
+  // Multi-bit modes: same weights, per-block scale and zero point
+  printf("\n[Multi-bit] Block size %d\n", QUANT_DEFAULT_BLOCK);
+  size_t capacity = sizeof(eon_packet_header_t) + sizeof(eon_quant_header_t) +
+                    quantize_delta_max_size(n_weights, 8, QUANT_DEFAULT_BLOCK);
+  packet = malloc(capacity);
+  const int modes[3] = {2, 4, 8};
+  for (int m = 0; m < 3; m++) {
+    size_t size = build_quant_packet(packet, capacity, weights, NULL,
+                                     n_weights, modes[m], 1, 0, NULL);
+    size_t offset = sizeof(eon_packet_header_t) + sizeof(eon_quant_header_t);
+    dequantize_nbit(packet + offset, size - offset, n_weights, modes[m],
+                    QUANT_DEFAULT_BLOCK, recovered);
+    printf("%d-bit RMSE: %.4f in %zu bytes\n", modes[m],
+           rmse(weights, recovered, n_weights), size);
+  }
+
+  // Delta: the peer acknowledged the 4-bit update and the node keeps
+  // training from it; a few weights of the first block drift a little
+  float acked[100];
+  size_t size = build_quant_packet(packet, capacity, weights, NULL, n_weights,
+                                   4, 1, 0, NULL);
+  size_t full_size = size;
+  size_t offset = sizeof(eon_packet_header_t) + sizeof(eon_quant_header_t);
+  dequantize_nbit(packet + offset, size - offset, n_weights, 4,
+                  QUANT_DEFAULT_BLOCK, acked);
+  memcpy(weights, acked, sizeof(acked));
+  for (int i = 0; i < QUANT_DEFAULT_BLOCK; i += 8)
+    weights[i] += (i / 8) % 2 ? 0.01f : -0.01f;
+
+  float sender_view[100];
+  size = build_quant_packet(packet, capacity, weights, acked, n_weights, 4, 2,
+                            1, sender_view);
+  memcpy(recovered, acked, sizeof(acked));
+  if (packet[3] == PACKET_TYPE_DELTA)
+    dequantize_delta(packet + offset, size - offset, n_weights, 4,
+                     QUANT_DEFAULT_BLOCK, recovered);
+  else
+    dequantize_nbit(packet + offset, size - offset, n_weights, 4,
+                    QUANT_DEFAULT_BLOCK, recovered);
+  printf("4-bit %s RMSE: %.4f in %zu bytes (full %zu, %s sender view)\n",
+         packet[3] == PACKET_TYPE_DELTA ? "delta" : "full update",
+         rmse(weights, recovered, n_weights), size, full_size,
+         memcmp(recovered, sender_view, sizeof(recovered)) == 0 ? "matches"
+                                                                : "differs from");
+  mock_mqtt_publish("eon/hive/update", packet, size);
+
   free(packet);
   return 0;
 }
@@ -1,23 +1,336 @@
 #include "quantization.h"
+#include <math.h>
 #include <string.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define QUANT_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON)
+#define QUANT_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* ------------------------------------------------------------------ */
+/* 1-bit kernels                                                       */
+/*                                                                     */
+/* Weight i is bit (i % 8) of byte i / 8. Kernels only see whole       */
+/* bytes (8 weights each); the public functions handle the tail.       */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+  const char *name;
+  /** out[b] = signs of w[8b .. 8b+7] (bit set when w >= 0) */
+  void (*pack)(const float *w, size_t n_bytes, uint8_t *out);
+  /** out[i] = bit i ? pos : -pos */
+  void (*unpack_f32)(const uint8_t *in, size_t n_bytes, float pos, float *out);
+  /** Same, straight to Q8.8 */
+  void (*unpack_q88)(const uint8_t *in, size_t n_bytes, int16_t pos,
+                     int16_t *out);
+} quant_1bit_ops_t;
+
+static uint8_t pack_byte(const float *w) {
+  uint8_t byte = 0;
+  for (int j = 0; j < 8; j++)
+    byte |= (uint8_t)((w[j] >= 0.0f) << j);
+  return byte;
+}
+
+/* Scalar: 64 weights per word, one store of 8 bytes */
+static void pack_scalar(const float *w, size_t n_bytes, uint8_t *out) {
+  size_t b = 0;
+  for (; b + 8 <= n_bytes; b += 8) {
+    const float *p = w + b * 8;
+    uint64_t word = 0;
+    for (int j = 0; j < 64; j++)
+      word |= (uint64_t)(p[j] >= 0.0f) << j;
+    for (int k = 0; k < 8; k++)
+      out[b + k] = (uint8_t)(word >> (8 * k));
+  }
+  for (; b < n_bytes; b++)
+    out[b] = pack_byte(w + b * 8);
+}
+
+static uint64_t load_word(const uint8_t *in, size_t n) {
+  uint64_t word = 0;
+  for (size_t k = 0; k < n; k++)
+    word |= (uint64_t)in[k] << (8 * k);
+  return word;
+}
+
+/* Branchless: a clear bit flips the float sign bit of pos */
+static void unpack_f32_scalar(const uint8_t *in, size_t n_bytes, float pos,
+                              float *out) {
+  uint32_t pos_bits;
+  memcpy(&pos_bits, &pos, sizeof(pos_bits));
+  for (size_t b = 0; b < n_bytes; b += 8) {
+    size_t n = n_bytes - b < 8 ? n_bytes - b : 8;
+    uint64_t neg = ~load_word(in + b, n);
+    float *o = out + b * 8;
+    for (size_t j = 0; j < n * 8; j++) {
+      uint32_t v = pos_bits ^ ((uint32_t)(neg >> j) << 31);
+      memcpy(&o[j], &v, sizeof(v));
+    }
+  }
+}
+
+/* Branchless: m = 0 or -1, (pos ^ m) - m = pos or -pos */
+static void unpack_q88_scalar(const uint8_t *in, size_t n_bytes, int16_t pos,
+                              int16_t *out) {
+  for (size_t b = 0; b < n_bytes; b += 8) {
+    size_t n = n_bytes - b < 8 ? n_bytes - b : 8;
+    uint64_t neg = ~load_word(in + b, n);
+    int16_t *o = out + b * 8;
+    for (size_t j = 0; j < n * 8; j++) {
+      int16_t m = (int16_t)-(int16_t)((neg >> j) & 1);
+      o[j] = (int16_t)((pos ^ m) - m);
+    }
+  }
+}
+
+static const quant_1bit_ops_t ops_scalar = {"scalar", pack_scalar,
+                                            unpack_f32_scalar,
+                                            unpack_q88_scalar};
+
+#ifdef QUANT_SIMD_X86
+
+/* SSE2: two movemasks of 4 lanes per byte */
+__attribute__((target("sse2"))) static void
+pack_sse2(const float *w, size_t n_bytes, uint8_t *out) {
+  const __m128 zero = _mm_setzero_ps();
+  for (size_t b = 0; b < n_bytes; b++) {
+    const float *p = w + b * 8;
+    int lo = _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(p), zero));
+    int hi = _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(p + 4), zero));
+    out[b] = (uint8_t)(lo | (hi << 4));
+  }
+}
+
+__attribute__((target("sse2"))) static void
+unpack_f32_sse2(const uint8_t *in, size_t n_bytes, float pos, float *out) {
+  const __m128i bits_lo = _mm_setr_epi32(1, 2, 4, 8);
+  const __m128i bits_hi = _mm_setr_epi32(16, 32, 64, 128);
+  const __m128 vpos = _mm_set1_ps(pos);
+  const __m128 vneg = _mm_set1_ps(-pos);
+  for (size_t b = 0; b < n_bytes; b++) {
+    __m128i v = _mm_set1_epi32(in[b]);
+    __m128 m_lo = _mm_castsi128_ps(
+        _mm_cmpeq_epi32(_mm_and_si128(v, bits_lo), bits_lo));
+    __m128 m_hi = _mm_castsi128_ps(
+        _mm_cmpeq_epi32(_mm_and_si128(v, bits_hi), bits_hi));
+    _mm_storeu_ps(out + b * 8, _mm_or_ps(_mm_and_ps(m_lo, vpos),
+                                         _mm_andnot_ps(m_lo, vneg)));
+    _mm_storeu_ps(out + b * 8 + 4, _mm_or_ps(_mm_and_ps(m_hi, vpos),
+                                             _mm_andnot_ps(m_hi, vneg)));
+  }
+}
+
+__attribute__((target("sse2"))) static void
+unpack_q88_sse2(const uint8_t *in, size_t n_bytes, int16_t pos, int16_t *out) {
+  const __m128i bits = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+  const __m128i vpos = _mm_set1_epi16(pos);
+  const __m128i vneg = _mm_set1_epi16((int16_t)-pos);
+  for (size_t b = 0; b < n_bytes; b++) {
+    __m128i v = _mm_set1_epi16(in[b]);
+    __m128i m = _mm_cmpeq_epi16(_mm_and_si128(v, bits), bits);
+    _mm_storeu_si128((__m128i *)(out + b * 8),
+                     _mm_or_si128(_mm_and_si128(m, vpos),
+                                  _mm_andnot_si128(m, vneg)));
+  }
+}
+
+static const quant_1bit_ops_t ops_sse2 = {"sse2", pack_sse2, unpack_f32_sse2,
+                                          unpack_q88_sse2};
+
+/* AVX2: one movemask of 8 lanes per byte, 16 Q8.8 lanes per 2 bytes */
+__attribute__((target("avx2"))) static void
+pack_avx2(const float *w, size_t n_bytes, uint8_t *out) {
+  const __m256 zero = _mm256_setzero_ps();
+  size_t b = 0;
+  for (; b + 4 <= n_bytes; b += 4) {
+    const float *p = w + b * 8;
+    uint32_t m0 = (uint32_t)_mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(p), zero, _CMP_GE_OQ));
+    uint32_t m1 = (uint32_t)_mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(p + 8), zero, _CMP_GE_OQ));
+    uint32_t m2 = (uint32_t)_mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(p + 16), zero, _CMP_GE_OQ));
+    uint32_t m3 = (uint32_t)_mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(p + 24), zero, _CMP_GE_OQ));
+    out[b] = (uint8_t)m0;
+    out[b + 1] = (uint8_t)m1;
+    out[b + 2] = (uint8_t)m2;
+    out[b + 3] = (uint8_t)m3;
+  }
+  for (; b < n_bytes; b++) {
+    out[b] = (uint8_t)_mm256_movemask_ps(
+        _mm256_cmp_ps(_mm256_loadu_ps(w + b * 8), zero, _CMP_GE_OQ));
+  }
+}
+
+__attribute__((target("avx2"))) static void
+unpack_f32_avx2(const uint8_t *in, size_t n_bytes, float pos, float *out) {
+  const __m256i bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  const __m256 vpos = _mm256_set1_ps(pos);
+  const __m256 vneg = _mm256_set1_ps(-pos);
+  for (size_t b = 0; b < n_bytes; b++) {
+    __m256i v = _mm256_set1_epi32(in[b]);
+    __m256i m = _mm256_cmpeq_epi32(_mm256_and_si256(v, bits), bits);
+    _mm256_storeu_ps(out + b * 8,
+                     _mm256_blendv_ps(vneg, vpos, _mm256_castsi256_ps(m)));
+  }
+}
+
+__attribute__((target("avx2"))) static void
+unpack_q88_avx2(const uint8_t *in, size_t n_bytes, int16_t pos, int16_t *out) {
+  const __m256i bits =
+      _mm256_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048,
+                        4096, 8192, 16384, (int16_t)0x8000);
+  const __m256i vpos = _mm256_set1_epi16(pos);
+  const __m256i vneg = _mm256_set1_epi16((int16_t)-pos);
+  size_t b = 0;
+  for (; b + 2 <= n_bytes; b += 2) {
+    __m256i v = _mm256_set1_epi16((int16_t)(in[b] | (in[b + 1] << 8)));
+    __m256i m = _mm256_cmpeq_epi16(_mm256_and_si256(v, bits), bits);
+    _mm256_storeu_si256((__m256i *)(out + b * 8),
+                        _mm256_blendv_epi8(vneg, vpos, m));
+  }
+  if (b < n_bytes)
+    unpack_q88_sse2(in + b, n_bytes - b, pos, out + b * 8);
+}
+
+static const quant_1bit_ops_t ops_avx2 = {"avx2", pack_avx2, unpack_f32_avx2,
+                                          unpack_q88_avx2};
+
+#endif /* QUANT_SIMD_X86 */
+
+#ifdef QUANT_SIMD_NEON
+
+/* NEON: per-lane bit masks, OR-reduced to one byte (ARMv7 and AArch64) */
+static void pack_neon(const float *w, size_t n_bytes, uint8_t *out) {
+  static const uint32_t lo[4] = {1, 2, 4, 8};
+  static const uint32_t hi[4] = {16, 32, 64, 128};
+  const uint32x4_t bits_lo = vld1q_u32(lo);
+  const uint32x4_t bits_hi = vld1q_u32(hi);
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  for (size_t b = 0; b < n_bytes; b++) {
+    const float *p = w + b * 8;
+    uint32x4_t m = vorrq_u32(
+        vandq_u32(vcgeq_f32(vld1q_f32(p), zero), bits_lo),
+        vandq_u32(vcgeq_f32(vld1q_f32(p + 4), zero), bits_hi));
+    uint32x2_t r = vorr_u32(vget_low_u32(m), vget_high_u32(m));
+    out[b] = (uint8_t)(vget_lane_u32(r, 0) | vget_lane_u32(r, 1));
+  }
+}
+
+static void unpack_f32_neon(const uint8_t *in, size_t n_bytes, float pos,
+                            float *out) {
+  static const uint32_t lo[4] = {1, 2, 4, 8};
+  static const uint32_t hi[4] = {16, 32, 64, 128};
+  const uint32x4_t bits_lo = vld1q_u32(lo);
+  const uint32x4_t bits_hi = vld1q_u32(hi);
+  const float32x4_t vpos = vdupq_n_f32(pos);
+  const float32x4_t vneg = vdupq_n_f32(-pos);
+  for (size_t b = 0; b < n_bytes; b++) {
+    uint32x4_t v = vdupq_n_u32(in[b]);
+    vst1q_f32(out + b * 8, vbslq_f32(vtstq_u32(v, bits_lo), vpos, vneg));
+    vst1q_f32(out + b * 8 + 4, vbslq_f32(vtstq_u32(v, bits_hi), vpos, vneg));
+  }
+}
+
+static void unpack_q88_neon(const uint8_t *in, size_t n_bytes, int16_t pos,
+                            int16_t *out) {
+  static const uint16_t lanes[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+  const uint16x8_t bits = vld1q_u16(lanes);
+  const int16x8_t vpos = vdupq_n_s16(pos);
+  const int16x8_t vneg = vdupq_n_s16((int16_t)-pos);
+  for (size_t b = 0; b < n_bytes; b++) {
+    uint16x8_t m = vtstq_u16(vdupq_n_u16(in[b]), bits);
+    vst1q_s16(out + b * 8, vbslq_s16(m, vpos, vneg));
+  }
+}
+
+static const quant_1bit_ops_t ops_neon = {"neon", pack_neon, unpack_f32_neon,
+                                          unpack_q88_neon};
+
+#endif /* QUANT_SIMD_NEON */
+
+/* ------------------------------------------------------------------ */
+/* Dispatch                                                            */
+/* ------------------------------------------------------------------ */
+
+static const quant_1bit_ops_t *best_ops(void) {
+#if defined(QUANT_SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return &ops_avx2;
+  if (__builtin_cpu_supports("sse2"))
+    return &ops_sse2;
+#elif defined(QUANT_SIMD_NEON)
+  return &ops_neon;
+#endif
+  return &ops_scalar;
+}
+
+/* Lazy: concurrent first calls all store the same pointer */
+static const quant_1bit_ops_t *active_ops = NULL;
+
+static const quant_1bit_ops_t *ops(void) {
+  if (active_ops == NULL)
+    active_ops = best_ops();
+  return active_ops;
+}
+
+const char *quantize_1bit_backend(void) { return ops()->name; }
+
+int quantize_1bit_select(const char *name) {
+  if (name == NULL) {
+    active_ops = best_ops();
+    return 0;
+  }
+  if (strcmp(name, ops_scalar.name) == 0) {
+    active_ops = &ops_scalar;
+    return 0;
+  }
+#if defined(QUANT_SIMD_X86)
+  __builtin_cpu_init();
+  if (strcmp(name, ops_avx2.name) == 0 && __builtin_cpu_supports("avx2")) {
+    active_ops = &ops_avx2;
+    return 0;
+  }
+  if (strcmp(name, ops_sse2.name) == 0 && __builtin_cpu_supports("sse2")) {
+    active_ops = &ops_sse2;
+    return 0;
+  }
+#elif defined(QUANT_SIMD_NEON)
+  if (strcmp(name, ops_neon.name) == 0) {
+    active_ops = &ops_neon;
+    return 0;
+  }
+#endif
+  return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/* 1-bit API                                                           */
+/* ------------------------------------------------------------------ */
+
 int quantize_1bit(const float *weights, int count, uint8_t *output) {
   if (!weights || !output || count <= 0)
     return 0;
 
-  int bytes = (count + 7) / 8;
-  memset(output, 0, bytes);
-
-  for (int i = 0; i < count; i++) {
-    if (weights[i] >= 0) {
-      // Set the bit corresponding to index i
-      // Byte index: i / 8
-      // Bit index: i % 8
-      output[i / 8] |= (1 << (i % 8));
-    }
-    // Else leave as 0 (representing negative)
+  size_t full = (size_t)count / 8;
+  int tail = count % 8;
+  ops()->pack(weights, full, output);
+  if (tail) {
+    // Unused high bits of the last byte stay 0
+    uint8_t byte = 0;
+    for (int j = 0; j < tail; j++)
+      byte |= (uint8_t)((weights[full * 8 + j] >= 0.0f) << j);
+    output[full] = byte;
   }
-  return bytes;
+  return (count + 7) / 8;
 }
 
 void dequantize_1bit(const uint8_t *input, int count, float *weights,
@@ -25,14 +338,275 @@ void dequantize_1bit(const uint8_t *input, int count, float *weights,
   if (!input || !weights || count <= 0)
     return;
 
-  for (int i = 0; i < count; i++) {
-    int byte_idx = i / 8;
-    int bit_idx = i % 8;
+  size_t full = (size_t)count / 8;
+  ops()->unpack_f32(input, full, scale, weights);
+  for (int j = 0; j < count % 8; j++)
+    weights[full * 8 + j] = ((input[full] >> j) & 1) ? scale : -scale;
+}
+
+void dequantize_1bit_into_fixed(const uint8_t *input, int count,
+                                int16_t *weights, int16_t magnitude) {
+  if (!input || !weights || count <= 0)
+    return;
+
+  size_t full = (size_t)count / 8;
+  ops()->unpack_q88(input, full, magnitude, weights);
+  for (int j = 0; j < count % 8; j++)
+    weights[full * 8 + j] =
+        ((input[full] >> j) & 1) ? magnitude : (int16_t)-magnitude;
+}
+
+/* ------------------------------------------------------------------ */
+/* Multi-bit quantization                                              */
+/* ------------------------------------------------------------------ */
+
+static int valid_nbit(int count, int bits, int block) {
+  return count > 0 && block > 0 && (bits == 2 || bits == 4 || bits == 8);
+}
+
+/* Bytes of one encoded block of n weights */
+static size_t block_bytes(int n, int bits) {
+  return QUANT_BLOCK_PARAMS + ((size_t)n * bits + 7) / 8;
+}
+
+static void put_f32(uint8_t *p, float v) {
+  uint32_t u;
+  memcpy(&u, &v, sizeof(u));
+  p[0] = (uint8_t)u;
+  p[1] = (uint8_t)(u >> 8);
+  p[2] = (uint8_t)(u >> 16);
+  p[3] = (uint8_t)(u >> 24);
+}
+
+static float get_f32(const uint8_t *p) {
+  uint32_t u = (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+               ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+  float v;
+  memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+/* Encode values[i] - base[i] (base may be NULL) as one block of n weights;
+ * returns bytes written */
+static size_t encode_block(const float *values, const float *base, int n,
+                           int bits, uint8_t *out) {
+  const int qmax = (1 << bits) - 1;
+  float lo = 0.0f, hi = 0.0f;
+  for (int i = 0; i < n; i++) {
+    float v = base ? values[i] - base[i] : values[i];
+    if (v < lo)
+      lo = v;
+    if (v > hi)
+      hi = v;
+  }
+
+  float scale = (hi - lo) / qmax;
+  int zp = 0;
+  if (scale > 0.0f) {
+    zp = (int)floorf(-lo / scale + 0.5f);
+    if (zp > qmax)
+      zp = qmax;
+  }
+  put_f32(out, scale);
+  out[4] = (uint8_t)zp;
+
+  uint8_t *codes = out + QUANT_BLOCK_PARAMS;
+  size_t code_bytes = ((size_t)n * bits + 7) / 8;
+  memset(codes, 0, code_bytes);
+  float inv = scale > 0.0f ? 1.0f / scale : 0.0f;
+  for (int i = 0; i < n; i++) {
+    float v = base ? values[i] - base[i] : values[i];
+    int q = (int)floorf(v * inv + 0.5f) + zp;
+    if (q < 0)
+      q = 0;
+    if (q > qmax)
+      q = qmax;
+    // bits divides 8: a code never straddles two bytes
+    int bit = i * bits;
+    codes[bit / 8] |= (uint8_t)(q << (bit % 8));
+  }
+  return QUANT_BLOCK_PARAMS + code_bytes;
+}
+
+/* Decode one block; values[i] = scale * (code - zp) + base[i] (base may be
+ * NULL). Returns bytes consumed. */
+static size_t decode_block(const uint8_t *in, int n, int bits,
+                           const float *base, float *values) {
+  const int mask = (1 << bits) - 1;
+  float scale = get_f32(in);
+  int zp = in[4];
+  const uint8_t *codes = in + QUANT_BLOCK_PARAMS;
 
-    if (input[byte_idx] & (1 << bit_idx)) {
-      weights[i] = scale;
-    } else {
-      weights[i] = -scale;
+  for (int i = 0; i < n; i++) {
+    int bit = i * bits;
+    int q = (codes[bit / 8] >> (bit % 8)) & mask;
+    float v = scale * (float)(q - zp);
+    values[i] = base ? base[i] + v : v;
+  }
+  return block_bytes(n, bits);
+}
+
+size_t quantize_nbit_size(int count, int bits, int block) {
+  if (!valid_nbit(count, bits, block))
+    return 0;
+  int full = count / block;
+  int tail = count % block;
+  return (size_t)full * block_bytes(block, bits) +
+         (tail ? block_bytes(tail, bits) : 0);
+}
+
+int quantize_nbit(const float *weights, int count, int bits, int block,
+                  uint8_t *output, size_t capacity) {
+  if (!weights || !output)
+    return 0;
+  size_t needed = quantize_nbit_size(count, bits, block);
+  if (needed == 0 || capacity < needed)
+    return 0;
+
+  size_t pos = 0;
+  for (int start = 0; start < count; start += block) {
+    int n = count - start < block ? count - start : block;
+    pos += encode_block(weights + start, NULL, n, bits, output + pos);
+  }
+  return (int)pos;
+}
+
+int dequantize_nbit(const uint8_t *input, size_t len, int count, int bits,
+                    int block, float *weights) {
+  if (!input || !weights)
+    return 0;
+  size_t needed = quantize_nbit_size(count, bits, block);
+  if (needed == 0 || len < needed)
+    return 0;
+
+  size_t pos = 0;
+  for (int start = 0; start < count; start += block) {
+    int n = count - start < block ? count - start : block;
+    pos += decode_block(input + pos, n, bits, NULL, weights + start);
+  }
+  return (int)pos;
+}
+
+/* ------------------------------------------------------------------ */
+/* Delta encoding                                                      */
+/* ------------------------------------------------------------------ */
+
+size_t quantize_delta_max_size(int count, int bits, int block) {
+  size_t blocks_size = quantize_nbit_size(count, bits, block);
+  if (blocks_size == 0)
+    return 0;
+  int n_blocks = (count + block - 1) / block;
+  return (size_t)(n_blocks + 7) / 8 + blocks_size;
+}
+
+/* 1 if some residual of the block is above threshold */
+static int block_changed(const float *weights, const float *reference, int n,
+                         float threshold) {
+  for (int i = 0; i < n; i++) {
+    if (fabsf(weights[i] - reference[i]) > threshold)
+      return 1;
+  }
+  return 0;
+}
+
+int quantize_delta(const float *weights, const float *reference, int count,
+                   int bits, int block, float threshold, uint8_t *output,
+                   size_t capacity, float *reconstructed) {
+  if (!weights || !reference || !output || !valid_nbit(count, bits, block))
+    return 0;
+
+  int n_blocks = (count + block - 1) / block;
+  size_t bitmap_bytes = (size_t)(n_blocks + 7) / 8;
+  if (capacity < bitmap_bytes)
+    return 0;
+  memset(output, 0, bitmap_bytes);
+
+  size_t pos = bitmap_bytes;
+  for (int b = 0; b < n_blocks; b++) {
+    int start = b * block;
+    int n = count - start < block ? count - start : block;
+
+    if (!block_changed(weights + start, reference + start, n, threshold)) {
+      if (reconstructed && reconstructed != reference)
+        memcpy(reconstructed + start, reference + start, n * sizeof(float));
+      continue;
     }
+
+    if (capacity - pos < block_bytes(n, bits))
+      return 0;
+    output[b / 8] |= (uint8_t)(1 << (b % 8));
+
+    size_t written = encode_block(weights + start, reference + start, n,
+                                  bits, output + pos);
+    if (reconstructed)
+      decode_block(output + pos, n, bits, reference + start,
+                   reconstructed + start);
+    pos += written;
   }
+  return (int)pos;
+}
+
+int dequantize_delta(const uint8_t *input, size_t len, int count, int bits,
+                     int block, float *weights) {
+  if (!input || !weights || !valid_nbit(count, bits, block))
+    return 0;
+
+  int n_blocks = (count + block - 1) / block;
+  size_t bitmap_bytes = (size_t)(n_blocks + 7) / 8;
+  if (len < bitmap_bytes)
+    return 0;
+
+  // Validate the full length before touching the weights
+  size_t needed = bitmap_bytes;
+  for (int b = 0; b < n_blocks; b++) {
+    if (input[b / 8] & (1 << (b % 8))) {
+      int start = b * block;
+      int n = count - start < block ? count - start : block;
+      needed += block_bytes(n, bits);
+    }
+  }
+  if (len < needed)
+    return 0;
+
+  size_t pos = bitmap_bytes;
+  for (int b = 0; b < n_blocks; b++) {
+    if (!(input[b / 8] & (1 << (b % 8))))
+      continue;
+    int start = b * block;
+    int n = count - start < block ? count - start : block;
+    pos += decode_block(input + pos, n, bits, weights + start,
+                        weights + start);
+  }
+  return (int)pos;
+}
+
+int quantize_update(const float *weights, const float *reference, int count,
+                    int bits, int block, float threshold, uint8_t *output,
+                    size_t capacity, float *reconstructed, int *is_delta) {
+  if (!weights || !output || !is_delta || !valid_nbit(count, bits, block))
+    return 0;
+
+  // Size the delta first, so neither encoder runs twice
+  size_t full = quantize_nbit_size(count, bits, block);
+  size_t delta = full;
+  if (reference) {
+    int n_blocks = (count + block - 1) / block;
+    delta = (size_t)(n_blocks + 7) / 8;
+    for (int start = 0; start < count; start += block) {
+      int n = count - start < block ? count - start : block;
+      if (block_changed(weights + start, reference + start, n, threshold))
+        delta += block_bytes(n, bits);
+    }
+  }
+
+  *is_delta = reference && delta < full;
+  if (*is_delta)
+    return quantize_delta(weights, reference, count, bits, block, threshold,
+                          output, capacity, reconstructed);
+
+  int written = quantize_nbit(weights, count, bits, block, output, capacity);
+  if (written > 0 && reconstructed)
+    dequantize_nbit(output, (size_t)written, count, bits, block,
+                    reconstructed);
+  return written;
 }
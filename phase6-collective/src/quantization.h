@@ -25,4 +25,128 @@ int quantize_1bit(const float *weights, int count, uint8_t *output);
 void dequantize_1bit(const uint8_t *input, int count, float *weights,
                      float scale);
 
+/**
+ * @brief Decompress 1-bit packed array straight to Q8.8 fixed point.
+ *
+ * Writes the int16 weights libAeon uses in fixed-point builds
+ * (aeon_weight_t), with no float array in between.
+ *
+ * @param magnitude Q8.8 magnitude to assign (e.g., 64 -> +0.25 / -0.25).
+ */
+void dequantize_1bit_into_fixed(const uint8_t *input, int count,
+                                int16_t *weights, int16_t magnitude);
+
+/**
+ * @brief Name of the active 1-bit backend ("scalar", "sse2", "avx2", "neon").
+ *
+ * The best one for the CPU is picked on first use.
+ */
+const char *quantize_1bit_backend(void);
+
+/**
+ * @brief Force a 1-bit backend by name (NULL = best available).
+ *
+ * @return 0 on success, -1 if unknown or not supported by this CPU.
+ */
+int quantize_1bit_select(const char *name);
+
+/*
+ * Multi-bit quantization (2, 4 or 8 bits per weight).
+ *
+ * Weights are split into blocks of `block` elements. Each block is encoded
+ * as [scale: float32 LE][zero_point: uint8][codes], with codes packed
+ * LSB-first and w = scale * (code - zero_point). The block range always
+ * includes 0, so zero (pruned) weights are restored exactly.
+ */
+
+/** Default weights per block */
+#define QUANT_DEFAULT_BLOCK 64
+
+/** Parameter bytes per block (scale + zero point) */
+#define QUANT_BLOCK_PARAMS 5
+
+/**
+ * @brief Bytes quantize_nbit writes for `count` weights.
+ *
+ * @return Size in bytes, or 0 if bits/block are invalid.
+ */
+size_t quantize_nbit_size(int count, int bits, int block);
+
+/**
+ * @brief Quantize floats to `bits` bits each with per-block scale/zero point.
+ *
+ * @param bits 2, 4 or 8.
+ * @param block Weights per block (> 0).
+ * @param capacity Size of output (at least quantize_nbit_size()).
+ * @return Number of bytes written, or 0 on invalid arguments.
+ */
+int quantize_nbit(const float *weights, int count, int bits, int block,
+                  uint8_t *output, size_t capacity);
+
+/**
+ * @brief Decode a quantize_nbit payload.
+ *
+ * @param len Bytes available in input.
+ * @return Number of bytes consumed, or 0 if input is truncated or invalid.
+ */
+int dequantize_nbit(const uint8_t *input, size_t len, int count, int bits,
+                    int block, float *weights);
+
+/*
+ * Delta encoding against the weights a peer last acknowledged.
+ *
+ * The sender quantizes the residual (weights - reference), block by
+ * block. Blocks whose residual stays within `threshold` are skipped.
+ * Layout: [changed-block bitmap, LSB-first][quantize_nbit block for each
+ * changed block]. Residuals span a much smaller range than the weights,
+ * so the same bits give finer steps. The sender gets the receiver's
+ * exact reconstruction back to use as the next reference once
+ * acknowledged.
+ */
+
+/** Worst-case bytes quantize_delta writes (every block changed) */
+size_t quantize_delta_max_size(int count, int bits, int block);
+
+/**
+ * @brief Encode weights as a quantized residual against reference.
+ *
+ * @param reference Weights the receiver holds (its last acknowledged state).
+ * @param threshold Max |residual| of a block that is left unchanged.
+ * @param reconstructed Optional: receives what the receiver will hold after
+ *                      applying this packet (may alias reference).
+ * @return Number of bytes written, or 0 on invalid arguments.
+ */
+int quantize_delta(const float *weights, const float *reference, int count,
+                   int bits, int block, float threshold, uint8_t *output,
+                   size_t capacity, float *reconstructed);
+
+/**
+ * @brief Apply a quantize_delta payload in place.
+ *
+ * @param weights In: reference weights. Out: updated weights.
+ * @return Number of bytes consumed, or 0 if input is truncated or invalid
+ *         (weights are left untouched in that case).
+ */
+int dequantize_delta(const uint8_t *input, size_t len, int count, int bits,
+                     int block, float *weights);
+
+/**
+ * @brief Encode whichever of a delta and a full quantize_nbit payload is
+ *        smaller.
+ *
+ * A delta with most blocks changed costs its bitmap on top of the full
+ * payload, so it is only sent when strictly smaller. Ties go to the full
+ * payload, which does not depend on the receiver's reference.
+ *
+ * @param reference Acknowledged weights, or NULL to always send in full.
+ * @param capacity At least quantize_delta_max_size() is always enough.
+ * @param reconstructed Optional, as in quantize_delta.
+ * @param is_delta Out: 1 for a delta (PACKET_TYPE_DELTA), 0 for a full
+ *                 payload (PACKET_TYPE_QUANT).
+ * @return Number of bytes written, or 0 on invalid arguments.
+ */
+int quantize_update(const float *weights, const float *reference, int count,
+                    int bits, int block, float threshold, uint8_t *output,
+                    size_t capacity, float *reconstructed, int *is_delta);
+
 #endif
@@ -0,0 +1,306 @@
+/**
+ * @file test_aggregator.c
+ * @brief Regression tests for handle_packet in src/aggregator.c
+ *
+ * The server is compiled into this file (its main renamed) and frames are
+ * fed to handle_packet directly with fd = -1, so merges are built into
+ * server.out but never sent.
+ *
+ * Build: gcc -O2 -o test_aggregator tests/test_aggregator.c \
+ *            src/quantization.c -lm
+ */
+
+#define main aggregator_main
+#include "../src/aggregator.c"
+#undef main
+
+#include <math.h>
+
+#define ANSI_COLOR_GREEN "\x1b[32m"
+#define ANSI_COLOR_RED "\x1b[31m"
+#define ANSI_COLOR_RESET "\x1b[0m"
+
+#define N_SIGNS 70 /**< Not a multiple of 64 or 8: covers the tails */
+#define N_QUANT 40
+#define HEADER_SIZE sizeof(eon_packet_header_t)
+#define QUANT_HEADER_SIZE sizeof(eon_quant_header_t)
+
+static void test_passed(const char *test_name) {
+  printf(ANSI_COLOR_GREEN "✓ PASS: %s" ANSI_COLOR_RESET "\n", test_name);
+}
+
+static void test_failed(const char *test_name, const char *reason) {
+  printf(ANSI_COLOR_RED "✗ FAIL: %s - %s" ANSI_COLOR_RESET "\n", test_name,
+         reason);
+  exit(1);
+}
+
+/* Free every bucket and start over with a fresh, socketless server */
+static void reset_server(agg_server_t *s, unsigned quorum) {
+  for (int i = 0; i < AGG_MAX_BUCKETS; i++) {
+    free(s->buckets[i].planes);
+    free(s->buckets[i].merged);
+    free(s->buckets[i].sum);
+    free(s->buckets[i].scratch);
+  }
+  memset(s, 0, sizeof(*s));
+  s->quorum = quorum;
+  s->flush_ms = AGG_DEFAULT_FLUSH_MS;
+  s->fd = -1;
+  s->verbose = false;
+}
+
+static size_t put_header(uint8_t *buf, uint8_t type, uint32_t seed,
+                         uint16_t n) {
+  eon_packet_header_t *h = (eon_packet_header_t *)buf;
+  memcpy(h->magic, "EON", 3);
+  h->type = type;
+  h->seed = seed;
+  h->num_weights = n;
+  return HEADER_SIZE;
+}
+
+static size_t make_update(uint8_t *buf, uint32_t seed, const float *w,
+                          int n) {
+  size_t len = put_header(buf, PACKET_TYPE_UPDATE, seed, (uint16_t)n);
+  return len + (size_t)quantize_1bit(w, n, buf + len);
+}
+
+static size_t make_quant(uint8_t *buf, uint32_t seed, const float *w, int n,
+                         int bits, int block) {
+  size_t len = put_header(buf, PACKET_TYPE_QUANT, seed, (uint16_t)n);
+  eon_quant_header_t *q = (eon_quant_header_t *)(buf + len);
+  memset(q, 0, sizeof(*q));
+  q->bits = (uint8_t)bits;
+  q->block_size = (uint16_t)block;
+  len += QUANT_HEADER_SIZE;
+  return len + (size_t)quantize_nbit(w, n, bits, block, buf + len,
+                                     AGG_SLOT_SIZE - len);
+}
+
+static struct sockaddr_in node(uint16_t port) {
+  struct sockaddr_in a;
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  a.sin_port = htons(port);
+  return a;
+}
+
+static void random_signs(float *w, int n) {
+  for (int i = 0; i < n; i++)
+    w[i] = (rand() & 1) ? 0.25f : -0.25f;
+}
+
+/* Published header must match the bucket the merge came from */
+static void check_out_header(const char *test_name, uint8_t type,
+                             uint32_t seed, uint16_t n) {
+  const eon_packet_header_t *h = (const eon_packet_header_t *)server.out;
+  if (memcmp(h->magic, "EON", 3) != 0 || h->type != type ||
+      h->seed != seed || h->num_weights != n) {
+    test_failed(test_name, "Wrong header on the merged packet");
+  }
+}
+
+int main(void) {
+  printf("=== Eon Aggregator Tests ===\n");
+  srand(1234);
+
+  agg_server_t *s = &server;
+  static uint8_t buf[AGG_SLOT_SIZE];
+  float votes[3][N_SIGNS];
+  struct sockaddr_in from[3] = {node(5001), node(5002), node(5003)};
+  uint8_t expected[(N_SIGNS + 7) / 8];
+
+  // TEST 1: Malformed frames are counted and never open a bucket
+  reset_server(s, 3);
+  random_signs(votes[0], N_SIGNS);
+  size_t len = make_update(buf, 0xA0, votes[0], N_SIGNS);
+  handle_packet(s, buf, HEADER_SIZE - 1, &from[0], 0);
+  buf[2] = 'X';
+  handle_packet(s, buf, len, &from[0], 0);
+  buf[2] = 'N';
+  handle_packet(s, buf, len - 1, &from[0], 0); // sign bits truncated
+  put_header(buf, PACKET_TYPE_UPDATE, 0xA0, 0);
+  handle_packet(s, buf, len, &from[0], 0);
+  len = make_quant(buf, 0xA1, votes[0], N_QUANT, 4, 16);
+  handle_packet(s, buf, HEADER_SIZE + QUANT_HEADER_SIZE - 1, &from[0], 0);
+  handle_packet(s, buf, len - 1, &from[0], 0); // blocks truncated
+  ((eon_quant_header_t *)(buf + HEADER_SIZE))->bits = 3;
+  handle_packet(s, buf, len, &from[0], 0);
+  if (s->stats.packets != 7 || s->stats.malformed != 7 ||
+      s->stats.published != 0) {
+    test_failed("Malformed Frames", "Wrong malformed count");
+  }
+  if (find_bucket(s, 0xA0)->used) {
+    test_failed("Malformed Frames", "Malformed UPDATE opened a bucket");
+  }
+  test_passed("Malformed Frames");
+
+  // TEST 2: Peer-to-peer and unknown types are unsupported
+  reset_server(s, 3);
+  const uint8_t other_types[3] = {PACKET_TYPE_DELTA, PACKET_TYPE_QUANT_ACK,
+                                  0x7F};
+  for (int t = 0; t < 3; t++) {
+    len = make_quant(buf, 0xB0, votes[0], N_QUANT, 4, 16);
+    ((eon_packet_header_t *)buf)->type = other_types[t];
+    handle_packet(s, buf, len, &from[0], 0);
+  }
+  if (s->stats.unsupported != 3 || s->stats.malformed != 0 ||
+      find_bucket(s, 0xB0)->used) {
+    test_failed("Unsupported Types", "DELTA/QUANT_ACK not rejected");
+  }
+  test_passed("Unsupported Types");
+
+  // TEST 3: Quorum publishes the per-weight majority of the sign bits
+  reset_server(s, 3);
+  for (int v = 0; v < 3; v++)
+    random_signs(votes[v], N_SIGNS);
+  for (int v = 0; v < 3; v++) {
+    len = make_update(buf, 0xC0, votes[v], N_SIGNS);
+    handle_packet(s, buf, len, &from[v], 10);
+    if (s->stats.published != (v == 2 ? 1u : 0u)) {
+      test_failed("Majority Vote", "Published before the quorum");
+    }
+  }
+  memset(expected, 0, sizeof(expected));
+  for (int i = 0; i < N_SIGNS; i++) {
+    int positive = 0;
+    for (int v = 0; v < 3; v++)
+      positive += votes[v][i] >= 0.0f;
+    if (positive >= 2)
+      expected[i / 8] |= (uint8_t)(1 << (i % 8));
+  }
+  check_out_header("Majority Vote", PACKET_TYPE_UPDATE, 0xC0, N_SIGNS);
+  if (memcmp(server.out + HEADER_SIZE, expected, sizeof(expected)) != 0) {
+    test_failed("Majority Vote", "Merged signs are not the majority");
+  }
+  agg_bucket_t *b = find_bucket(s, 0xC0);
+  if (b->n_subscribers != 3 || b->votes != 0 || b->sequence != 1) {
+    test_failed("Majority Vote", "Round not closed after publishing");
+  }
+  len = make_update(buf, 0xC0, votes[0], N_SIGNS);
+  handle_packet(s, buf, len, &from[0], 20);
+  if (b->n_subscribers != 3) {
+    test_failed("Majority Vote", "Repeat sender subscribed twice");
+  }
+  test_passed("Majority Vote");
+
+  // TEST 4: An even split keeps the previously published sign (the
+  // first update's on a fresh bucket)
+  reset_server(s, 2);
+  float flipped[N_SIGNS];
+  random_signs(votes[0], N_SIGNS);
+  for (int i = 0; i < N_SIGNS; i++)
+    flipped[i] = -votes[0][i];
+  const float *rounds[4][2] = {{votes[0], votes[0]},
+                               {votes[0], flipped},
+                               {flipped, flipped},
+                               {flipped, votes[0]}};
+  const float *winner[4] = {votes[0], votes[0], flipped, flipped};
+  for (int r = 0; r < 4; r++) {
+    for (int v = 0; v < 2; v++) {
+      len = make_update(buf, 0xD0, rounds[r][v], N_SIGNS);
+      handle_packet(s, buf, len, &from[v], (uint64_t)r);
+    }
+    quantize_1bit(winner[r], N_SIGNS, expected);
+    if (s->stats.published != (uint64_t)r + 1 ||
+        memcmp(server.out + HEADER_SIZE, expected, sizeof(expected)) != 0) {
+      test_failed("Tie Break", "Tie did not keep the previous sign");
+    }
+  }
+  // With nothing published yet, the first update breaks the ties: an
+  // all-zero start would publish every split weight as negative
+  const uint32_t fresh_seeds[2] = {0xD2, 0xD3};
+  for (int k = 0; k < 2; k++) {
+    const float *first = k == 0 ? votes[0] : flipped;
+    const float *second = k == 0 ? flipped : votes[0];
+    len = make_update(buf, fresh_seeds[k], first, N_SIGNS);
+    handle_packet(s, buf, len, &from[0], 10);
+    len = make_update(buf, fresh_seeds[k], second, N_SIGNS);
+    handle_packet(s, buf, len, &from[1], 10);
+    quantize_1bit(first, N_SIGNS, expected);
+    check_out_header("Tie Break", PACKET_TYPE_UPDATE, fresh_seeds[k],
+                     N_SIGNS);
+    if (memcmp(server.out + HEADER_SIZE, expected, sizeof(expected)) != 0) {
+      test_failed("Tie Break", "First-round tie did not follow the first");
+    }
+  }
+  test_passed("Tie Break");
+
+  // TEST 5: Frames whose shape differs from the seed's bucket
+  uint64_t published = s->stats.published;
+  len = make_update(buf, 0xD0, votes[0], N_SIGNS - 8);
+  handle_packet(s, buf, len, &from[0], 10);
+  len = make_quant(buf, 0xD0, votes[0], N_SIGNS, 4, 16);
+  handle_packet(s, buf, len, &from[0], 10);
+  if (s->stats.mismatched != 2 || s->stats.published != published ||
+      find_bucket(s, 0xD0)->votes != 0) {
+    test_failed("Shape Mismatch", "Mismatched frame was merged");
+  }
+  len = make_quant(buf, 0xD1, votes[0], N_QUANT, 4, 16);
+  handle_packet(s, buf, len, &from[0], 10);
+  len = make_quant(buf, 0xD1, votes[0], N_QUANT, 8, 16);
+  handle_packet(s, buf, len, &from[0], 10);
+  len = make_quant(buf, 0xD1, votes[0], N_QUANT, 4, 8);
+  handle_packet(s, buf, len, &from[0], 10);
+  if (s->stats.mismatched != 4 || find_bucket(s, 0xD1)->votes != 1) {
+    test_failed("Shape Mismatch", "QUANT bits/block mismatch accepted");
+  }
+  test_passed("Shape Mismatch");
+
+  // TEST 6: QUANT rounds publish the mean, re-quantized the same way
+  reset_server(s, 3);
+  float weights[3][N_QUANT], decoded[N_QUANT], mean[N_QUANT], merged[N_QUANT];
+  memset(mean, 0, sizeof(mean));
+  for (int v = 0; v < 3; v++) {
+    for (int i = 0; i < N_QUANT; i++)
+      weights[v][i] = (float)(rand() % 2001 - 1000) / 1000.0f;
+    len = make_quant(buf, 0xE0, weights[v], N_QUANT, 8, 16);
+    handle_packet(s, buf, len, &from[v], 0);
+    size_t at = HEADER_SIZE + QUANT_HEADER_SIZE;
+    dequantize_nbit(buf + at, len - at, N_QUANT, 8, 16, decoded);
+    for (int i = 0; i < N_QUANT; i++)
+      mean[i] += decoded[i] / 3.0f;
+  }
+  check_out_header("Quantized Mean", PACKET_TYPE_QUANT, 0xE0, N_QUANT);
+  const eon_quant_header_t *q =
+      (const eon_quant_header_t *)(server.out + HEADER_SIZE);
+  if (s->stats.published != 1 || q->bits != 8 || q->block_size != 16 ||
+      q->sequence != 1) {
+    test_failed("Quantized Mean", "Wrong quantization header");
+  }
+  size_t at = HEADER_SIZE + QUANT_HEADER_SIZE;
+  if (dequantize_nbit(server.out + at, sizeof(server.out) - at, N_QUANT, 8,
+                      16, merged) == 0) {
+    test_failed("Quantized Mean", "Merged payload does not decode");
+  }
+  for (int i = 0; i < N_QUANT; i++) {
+    // Half an 8-bit step of a [-1, 1] block
+    if (fabsf(merged[i] - mean[i]) > 1.0f / 255.0f + 1e-6f) {
+      test_failed("Quantized Mean", "Merged weights are not the mean");
+    }
+  }
+  test_passed("Quantized Mean");
+
+  // TEST 7: Rounds short of the quorum publish after flush_ms
+  reset_server(s, 8);
+  random_signs(votes[0], N_SIGNS);
+  len = make_update(buf, 0xF0, votes[0], N_SIGNS);
+  handle_packet(s, buf, len, &from[0], 100);
+  flush_expired(s, 100 + s->flush_ms - 1);
+  if (s->stats.published != 0) {
+    test_failed("Flush Interval", "Published before flush_ms");
+  }
+  flush_expired(s, 100 + s->flush_ms);
+  quantize_1bit(votes[0], N_SIGNS, expected);
+  if (s->stats.published != 1 ||
+      memcmp(server.out + HEADER_SIZE, expected, sizeof(expected)) != 0) {
+    test_failed("Flush Interval", "Open round not flushed");
+  }
+  test_passed("Flush Interval");
+
+  reset_server(s, 0);
+  printf("All tests passed successfully.\n");
+  return 0;
+}
@@ -0,0 +1,390 @@
+/**
+ * @file test_quantization.c
+ * @brief Regression tests for src/quantization.c
+ *
+ * Every 1-bit backend the CPU supports is checked against the original
+ * per-bit loops, including the tails and the sign rules (-0.0 packs as
+ * positive, NaN as negative). The 2/4/8-bit block codec and the delta
+ * encoding are checked for round-trip error and truncated input, and
+ * quantize_update for falling back to the full payload.
+ *
+ * Build: gcc -O2 -o test_quantization tests/test_quantization.c \
+ *            src/quantization.c -lm
+ */
+
+#include "../src/quantization.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ANSI_COLOR_GREEN "\x1b[32m"
+#define ANSI_COLOR_RED "\x1b[31m"
+#define ANSI_COLOR_RESET "\x1b[0m"
+
+#define MAX_COUNT 300
+#define CANARY 0x5A
+
+static void test_passed(const char *test_name) {
+  printf(ANSI_COLOR_GREEN "✓ PASS: %s" ANSI_COLOR_RESET "\n", test_name);
+}
+
+static void test_failed(const char *test_name, const char *reason) {
+  printf(ANSI_COLOR_RED "✗ FAIL: %s - %s" ANSI_COLOR_RESET "\n", test_name,
+         reason);
+  exit(1);
+}
+
+/* The per-bit loops quantize_1bit/dequantize_1bit started from */
+static void reference_pack(const float *w, int count, uint8_t *out) {
+  memset(out, 0, (size_t)(count + 7) / 8);
+  for (int i = 0; i < count; i++) {
+    if (w[i] >= 0)
+      out[i / 8] |= (uint8_t)(1 << (i % 8));
+  }
+}
+
+static float reference_unpack(const uint8_t *in, int i, float scale) {
+  return (in[i / 8] & (1 << (i % 8))) ? scale : -scale;
+}
+
+/* Weights mixing ordinary values with the cases the sign rule covers */
+static void fill_weights(float *w, int n) {
+  const float special[] = {0.0f,      -0.0f,     NAN,        -NAN,
+                           INFINITY,  -INFINITY, 1e-45f,     -1e-45f,
+                           FLT_MIN, -FLT_MIN};
+  const int n_special = (int)(sizeof(special) / sizeof(special[0]));
+  for (int i = 0; i < n; i++) {
+    if (rand() % 4 == 0)
+      w[i] = special[rand() % n_special];
+    else
+      w[i] = (float)(rand() % 2001 - 1000) / 1000.0f;
+  }
+}
+
+/* Largest |error| allowed for a block: half a step of its range */
+static float block_tolerance(const float *v, const float *base, int n,
+                             int bits) {
+  float lo = 0.0f, hi = 0.0f;
+  for (int i = 0; i < n; i++) {
+    float d = base ? v[i] - base[i] : v[i];
+    if (d < lo)
+      lo = d;
+    if (d > hi)
+      hi = d;
+  }
+  return (hi - lo) / (float)((1 << bits) - 1) * 0.5f + 1e-6f;
+}
+
+int main(void) {
+  printf("=== Eon Quantization Tests ===\n");
+  srand(1234);
+
+  // TEST 1: Backend selection
+  const char *backends[] = {"scalar", "sse2", "avx2", "neon"};
+  if (quantize_1bit_select("scalar") != 0 ||
+      strcmp(quantize_1bit_backend(), "scalar") != 0) {
+    test_failed("Backend Selection", "scalar backend not selectable");
+  }
+  if (quantize_1bit_select("mmx") != -1) {
+    test_failed("Backend Selection", "Unknown backend accepted");
+  }
+  quantize_1bit_select(NULL);
+  printf("Best backend: %s\n", quantize_1bit_backend());
+  test_passed("Backend Selection");
+
+  // TEST 2: Every backend packs and unpacks like the per-bit loops.
+  // Inputs start one element off alignment and a canary past the end
+  // catches kernels that write beyond `count`.
+  static float weights[MAX_COUNT + 2];
+  static float unpacked[MAX_COUNT + 2];
+  static int16_t fixed[MAX_COUNT + 2];
+  uint8_t packed[MAX_COUNT / 8 + 2], expected[MAX_COUNT / 8 + 2];
+  uint8_t bits[MAX_COUNT / 8 + 2];
+  const int16_t magnitudes[2] = {64, 32767};
+
+  for (int b = 0; b < 4; b++) {
+    if (quantize_1bit_select(backends[b]) != 0) {
+      printf("Backend %s: not supported here, skipped\n", backends[b]);
+      continue;
+    }
+    for (int count = 1; count <= MAX_COUNT; count++) {
+      int bytes = (count + 7) / 8;
+      float *w = weights + 1;
+      fill_weights(w, count);
+
+      memset(packed, CANARY, sizeof(packed));
+      reference_pack(w, count, expected);
+      if (quantize_1bit(w, count, packed) != bytes ||
+          memcmp(packed, expected, (size_t)bytes) != 0) {
+        test_failed("1-bit Backends", "Pack differs from the per-bit loop");
+      }
+      if (packed[bytes] != CANARY) {
+        test_failed("1-bit Backends", "Pack wrote past the last byte");
+      }
+
+      for (int k = 0; k < bytes; k++)
+        bits[k] = (uint8_t)rand();
+      float *u = unpacked + 1;
+      u[count] = (float)CANARY;
+      dequantize_1bit(bits, count, u, 0.1f);
+      for (int i = 0; i < count; i++) {
+        float ref = reference_unpack(bits, i, 0.1f);
+        if (memcmp(&u[i], &ref, sizeof(ref)) != 0) {
+          test_failed("1-bit Backends", "Unpack differs from the loop");
+        }
+      }
+      if (u[count] != (float)CANARY) {
+        test_failed("1-bit Backends", "Unpack wrote past count");
+      }
+
+      int16_t *q = fixed + 1;
+      for (int m = 0; m < 2; m++) {
+        q[count] = CANARY;
+        dequantize_1bit_into_fixed(bits, count, q, magnitudes[m]);
+        for (int i = 0; i < count; i++) {
+          int16_t ref = (bits[i / 8] & (1 << (i % 8)))
+                            ? magnitudes[m]
+                            : (int16_t)-magnitudes[m];
+          if (q[i] != ref) {
+            test_failed("1-bit Backends", "Q8.8 unpack differs from loop");
+          }
+        }
+        if (q[count] != CANARY) {
+          test_failed("1-bit Backends", "Q8.8 unpack wrote past count");
+        }
+      }
+    }
+    printf("Backend %s: counts 1..%d match\n", backends[b], MAX_COUNT);
+  }
+  quantize_1bit_select(NULL);
+  test_passed("1-bit Backends");
+
+  // TEST 3: Sign rules on the wire
+  const float signs[8] = {-0.0f, 0.0f, NAN, -NAN, 1.0f, -1.0f, INFINITY,
+                          -INFINITY};
+  for (int b = 0; b < 4; b++) {
+    if (quantize_1bit_select(backends[b]) != 0)
+      continue;
+    float eight[16];
+    for (int i = 0; i < 16; i++)
+      eight[i] = signs[i % 8];
+    uint8_t out[2];
+    quantize_1bit(eight, 16, out);
+    // Bits LSB-first: -0.0, 0.0, 1.0 and +inf are positive
+    if (out[0] != 0x53 || out[1] != 0x53) {
+      test_failed("Sign Rules", "Wrong bits for -0.0, NaN or inf");
+    }
+  }
+  quantize_1bit_select(NULL);
+  test_passed("Sign Rules");
+
+  // TEST 4: N-bit round trip, tail blocks included
+  const int nbits[3] = {2, 4, 8};
+  const int blocks[3] = {64, 7, 1000};
+  const int counts[3] = {1, 100, MAX_COUNT};
+  static float restored[MAX_COUNT];
+  static uint8_t payload[MAX_COUNT * 2 + 1024];
+
+  for (int b = 0; b < 3; b++) {
+    for (int k = 0; k < 3; k++) {
+      for (int c = 0; c < 3; c++) {
+        int bits_n = nbits[b], block = blocks[k], count = counts[c];
+        for (int i = 0; i < count; i++) {
+          weights[i] = (i % 5 == 0)
+                           ? 0.0f
+                           : (float)(rand() % 2001 - 1000) / 500.0f;
+        }
+        size_t size = quantize_nbit_size(count, bits_n, block);
+        int written = quantize_nbit(weights, count, bits_n, block, payload,
+                                    sizeof(payload));
+        if (size == 0 || written != (int)size) {
+          test_failed("N-bit Round Trip", "Size does not match bytes written");
+        }
+        if (dequantize_nbit(payload, size, count, bits_n, block, restored) !=
+            written) {
+          test_failed("N-bit Round Trip", "Decoder consumed a different size");
+        }
+        for (int start = 0; start < count; start += block) {
+          int n = count - start < block ? count - start : block;
+          float tol = block_tolerance(weights + start, NULL, n, bits_n);
+          for (int i = start; i < start + n; i++) {
+            if (fabsf(restored[i] - weights[i]) > tol) {
+              test_failed("N-bit Round Trip", "Error above half a step");
+            }
+            if (weights[i] == 0.0f && restored[i] != 0.0f) {
+              test_failed("N-bit Round Trip", "Zero weight not restored");
+            }
+          }
+        }
+      }
+    }
+  }
+  test_passed("N-bit Round Trip");
+
+  // TEST 5: N-bit invalid arguments and truncated input
+  if (quantize_nbit_size(MAX_COUNT, 3, 64) != 0 ||
+      quantize_nbit_size(MAX_COUNT, 4, 0) != 0 ||
+      quantize_nbit_size(0, 4, 64) != 0) {
+    test_failed("N-bit Truncation", "Invalid bits/block/count accepted");
+  }
+  size_t full = quantize_nbit_size(MAX_COUNT, 4, 64);
+  if (quantize_nbit(weights, MAX_COUNT, 4, 64, payload, full - 1) != 0) {
+    test_failed("N-bit Truncation", "Encoder ignored a short buffer");
+  }
+  quantize_nbit(weights, MAX_COUNT, 4, 64, payload, full);
+  for (int i = 0; i < MAX_COUNT; i++)
+    restored[i] = 42.0f;
+  if (dequantize_nbit(payload, full - 1, MAX_COUNT, 4, 64, restored) != 0 ||
+      dequantize_nbit(payload, full, MAX_COUNT, 3, 64, restored) != 0) {
+    test_failed("N-bit Truncation", "Decoder accepted a short payload");
+  }
+  for (int i = 0; i < MAX_COUNT; i++) {
+    if (restored[i] != 42.0f) {
+      test_failed("N-bit Truncation", "Rejected payload wrote weights");
+    }
+  }
+  test_passed("N-bit Truncation");
+
+  // TEST 6: Delta encoding skips quiet blocks and matches the receiver
+  static float reference[MAX_COUNT], reconstructed[MAX_COUNT];
+  static float receiver[MAX_COUNT];
+  const float threshold = 0.01f;
+  for (int b = 0; b < 3; b++) {
+    for (int k = 0; k < 2; k++) {
+      int bits_n = nbits[b], block = blocks[k];
+      int n_blocks = (MAX_COUNT + block - 1) / block;
+      for (int i = 0; i < MAX_COUNT; i++) {
+        reference[i] = (float)(rand() % 2001 - 1000) / 1000.0f;
+        // Odd blocks move by more than the threshold, even ones stay within
+        int moved = (i / block) % 2;
+        float step = moved ? (float)(rand() % 201 - 100) / 1000.0f
+                           : (float)(rand() % 21 - 10) / 1000.0f * threshold;
+        weights[i] = reference[i] + step;
+      }
+      if (weights[block] == reference[block])
+        weights[block] += 2.0f * threshold;
+
+      int written = quantize_delta(weights, reference, MAX_COUNT, bits_n,
+                                   block, threshold, payload, sizeof(payload),
+                                   reconstructed);
+      if (written <= 0 ||
+          (size_t)written >=
+              quantize_delta_max_size(MAX_COUNT, bits_n, block)) {
+        test_failed("Delta Encoding", "Quiet blocks were not skipped");
+      }
+      for (int blk = 0; blk < n_blocks; blk++) {
+        int flagged = (payload[blk / 8] >> (blk % 8)) & 1;
+        if (flagged != blk % 2) {
+          test_failed("Delta Encoding", "Wrong changed-block bitmap");
+        }
+        int start = blk * block;
+        int n = MAX_COUNT - start < block ? MAX_COUNT - start : block;
+        float tol = flagged ? block_tolerance(weights + start,
+                                              reference + start, n, bits_n)
+                            : threshold;
+        for (int i = start; i < start + n; i++) {
+          if (!flagged && reconstructed[i] != reference[i]) {
+            test_failed("Delta Encoding", "Skipped block changed");
+          }
+          if (fabsf(reconstructed[i] - weights[i]) > tol) {
+            test_failed("Delta Encoding", "Residual error above half a step");
+          }
+        }
+      }
+
+      memcpy(receiver, reference, sizeof(receiver));
+      if (dequantize_delta(payload, (size_t)written, MAX_COUNT, bits_n, block,
+                           receiver) != written ||
+          memcmp(receiver, reconstructed, sizeof(receiver)) != 0) {
+        test_failed("Delta Encoding", "Receiver differs from reconstructed");
+      }
+
+      // reconstructed may alias reference
+      memcpy(receiver, reference, sizeof(receiver));
+      quantize_delta(weights, receiver, MAX_COUNT, bits_n, block, threshold,
+                     payload, sizeof(payload), receiver);
+      if (memcmp(receiver, reconstructed, sizeof(receiver)) != 0) {
+        test_failed("Delta Encoding", "Aliased reconstruction differs");
+      }
+    }
+  }
+  test_passed("Delta Encoding");
+
+  // TEST 7: Truncated delta leaves the weights untouched
+  int written = quantize_delta(weights, reference, MAX_COUNT, 4, 64, 0.0f,
+                               payload, sizeof(payload), NULL);
+  if (quantize_delta(weights, reference, MAX_COUNT, 4, 64, 0.0f, payload,
+                     (size_t)written - 1, NULL) != 0) {
+    test_failed("Delta Truncation", "Encoder ignored a short buffer");
+  }
+  quantize_delta(weights, reference, MAX_COUNT, 4, 64, 0.0f, payload,
+                 sizeof(payload), NULL);
+  memcpy(receiver, reference, sizeof(receiver));
+  if (dequantize_delta(payload, (size_t)written - 1, MAX_COUNT, 4, 64,
+                       receiver) != 0 ||
+      dequantize_delta(payload, 0, MAX_COUNT, 4, 64, receiver) != 0 ||
+      dequantize_delta(payload, (size_t)written, MAX_COUNT, 3, 64,
+                       receiver) != 0) {
+    test_failed("Delta Truncation", "Decoder accepted a bad payload");
+  }
+  if (memcmp(receiver, reference, sizeof(receiver)) != 0) {
+    test_failed("Delta Truncation", "Rejected payload wrote weights");
+  }
+  test_passed("Delta Truncation");
+
+  // TEST 8: quantize_update sends a delta only when it is smaller
+  // than the full payload, and the receiver ends up where the sender
+  // thinks it is either way
+  static float sender_view[MAX_COUNT];
+  const int n_blocks = (MAX_COUNT + 63) / 64;
+  for (int moved_blocks = 1; moved_blocks <= n_blocks; moved_blocks++) {
+    for (int i = 0; i < MAX_COUNT; i++) {
+      reference[i] = (float)(rand() % 2001 - 1000) / 1000.0f;
+      weights[i] = reference[i];
+    }
+    for (int blk = 0; blk < moved_blocks; blk++)
+      weights[blk * 64] += 0.1f;
+
+    int is_delta = -1;
+    written = quantize_update(weights, reference, MAX_COUNT, 4, 64, 1e-3f,
+                              payload, sizeof(payload), sender_view,
+                              &is_delta);
+    size_t full = quantize_nbit_size(MAX_COUNT, 4, 64);
+    if (written <= 0 || (size_t)written > full ||
+        is_delta != ((size_t)written < full)) {
+      test_failed("Delta Fallback", "Sent a delta no smaller than full");
+    }
+    // A single changed block must travel as a delta
+    if (moved_blocks == 1 && !is_delta) {
+      test_failed("Delta Fallback", "One changed block was sent in full");
+    }
+    // Every block changed: the bitmap would make the delta larger
+    if (moved_blocks == n_blocks && is_delta) {
+      test_failed("Delta Fallback", "Delta larger than the full payload");
+    }
+
+    memcpy(receiver, reference, sizeof(receiver));
+    int consumed =
+        is_delta ? dequantize_delta(payload, (size_t)written, MAX_COUNT, 4,
+                                    64, receiver)
+                 : dequantize_nbit(payload, (size_t)written, MAX_COUNT, 4, 64,
+                                   receiver);
+    if (consumed != written ||
+        memcmp(receiver, sender_view, sizeof(receiver)) != 0) {
+      test_failed("Delta Fallback", "Receiver differs from reconstructed");
+    }
+  }
+  int is_delta = -1;
+  if (quantize_update(weights, NULL, MAX_COUNT, 4, 64, 1e-3f, payload,
+                      sizeof(payload), NULL, &is_delta) !=
+          (int)quantize_nbit_size(MAX_COUNT, 4, 64) ||
+      is_delta != 0) {
+    test_failed("Delta Fallback", "No reference must send in full");
+  }
+  test_passed("Delta Fallback");
+
+  printf("All tests passed successfully.\n");
+  return 0;
+}